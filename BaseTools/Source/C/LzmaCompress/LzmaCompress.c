@@ -18,6 +18,22 @@
 
 #include "Sdk/C/Alloc.h"
 #include "Sdk/C/7zFile.h"
+#ifdef _WIN32
+#include "Sdk/C/Threads.h"
+typedef CCriticalSection CHUNK_LOCK;
+#define ChunkLock_Init(p)   CriticalSection_Init(p)
+#define ChunkLock_Delete(p) CriticalSection_Delete(p)
+#define ChunkLock_Enter(p)  CriticalSection_Enter(p)
+#define ChunkLock_Leave(p)  CriticalSection_Leave(p)
+#else
+#include <pthread.h>
+#include <unistd.h>
+typedef pthread_mutex_t CHUNK_LOCK;
+#define ChunkLock_Init(p)   pthread_mutex_init(p, NULL)
+#define ChunkLock_Delete(p) pthread_mutex_destroy(p)
+#define ChunkLock_Enter(p)  pthread_mutex_lock(p)
+#define ChunkLock_Leave(p)  pthread_mutex_unlock(p)
+#endif
 #include "Sdk/C/7zVersion.h"
 #include "Sdk/C/LzmaDec.h"
 #include "Sdk/C/LzmaEnc.h"
@@ -27,6 +43,33 @@
 
 #define LZMA_HEADER_SIZE (LZMA_PROPS_SIZE + 8)
 
+//
+// Chunked format, see MdeModulePkg/Include/Guid/LzmaDecompress.h: a header,
+// an index of (Offset, Size) pairs and independent LZMA streams that each
+// decode to BlockSize bytes, except for the last one.
+//
+#define LZMA_CHUNKED_SIGNATURE      0x434D5A4C  // 'L', 'Z', 'M', 'C'
+#define LZMA_CHUNKED_HEADER_SIZE    24
+#define LZMA_CHUNKED_BLOCK_SIZE     8
+#define LZMA_CHUNKED_MIN_BLOCK_SIZE (1 << 16)
+#define LZMA_CHUNKED_MAX_THREADS    64
+
+typedef struct {
+  const Byte     *inBuffer;
+  size_t         inSize;
+  Byte           *outBuffer;
+  size_t         outSize;
+  SRes           res;
+} CHUNK_BLOCK;
+
+typedef struct {
+  CHUNK_BLOCK    *blocks;
+  UInt32         blockCount;
+  UInt32         nextBlock;
+  CLzmaEncProps  *props;
+  CHUNK_LOCK     lock;
+} CHUNK_QUEUE;
+
 typedef enum {
   NoConverter,
   X86Converter,
@@ -41,6 +84,9 @@ const char *kInvalidParamValMessage = "Invalid parameter value";
 
 static BoolInt mQuietMode = False;
 static CONVERTER_TYPE mConType = NoConverter;
+static BoolInt mChunked = False;
+static UINT64 mBlockSize = 1 << 20;
+static UINT64 mThreads = 0;
 
 UINT64 mDictionarySize = 28;
 UINT64 mCompressionMode = 2;
@@ -60,6 +106,12 @@ void PrintHelp(char *buffer)
              "  -d: decode file\n"
              "  -o FileName, --output FileName: specify the output filename\n"
              "  --f86: enable converter for x86 code\n"
+             "  --chunked: use the chunked format, made of independent blocks that\n"
+             "             can be decoded concurrently\n"
+             "  --block-size Size: set the decoded size of a block of the chunked\n"
+             "             format in bytes, default: 1048576 (1MB)\n"
+             "  --threads Count: set the number of encoder threads for the chunked\n"
+             "             format, default: the number of processors\n"
              "  -v, --verbose: increase output messages\n"
              "  -q, --quiet: reduce output messages\n"
              "  --debug [0-9]: set debug level\n"
@@ -238,6 +290,296 @@ Done:
   return res;
 }
 
+static UInt32 GetProcessorCount(void)
+{
+#ifdef _WIN32
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return (UInt32)info.dwNumberOfProcessors;
+#else
+  long count = sysconf(_SC_NPROCESSORS_ONLN);
+  return (count > 0) ? (UInt32)count : 1;
+#endif
+}
+
+static void PutUInt32(Byte *buffer, UInt32 value)
+{
+  int i;
+  for (i = 0; i < 4; i++)
+    buffer[i] = (Byte)(value >> (8 * i));
+}
+
+static UInt32 GetUInt32(const Byte *buffer)
+{
+  return (UInt32)buffer[0] | ((UInt32)buffer[1] << 8) | ((UInt32)buffer[2] << 16) | ((UInt32)buffer[3] << 24);
+}
+
+static void EncodeBlocks(CHUNK_QUEUE *queue)
+{
+  for (;;)
+  {
+    UInt32 index;
+    CHUNK_BLOCK *block;
+    size_t outSizeProcessed;
+    size_t outPropsSize = LZMA_PROPS_SIZE;
+    int i;
+
+    ChunkLock_Enter(&queue->lock);
+    index = queue->nextBlock++;
+    ChunkLock_Leave(&queue->lock);
+    if (index >= queue->blockCount)
+      break;
+
+    block = &queue->blocks[index];
+    for (i = 0; i < 8; i++)
+      block->outBuffer[i + LZMA_PROPS_SIZE] = (Byte)((UInt64)block->inSize >> (8 * i));
+
+    outSizeProcessed = block->outSize - LZMA_HEADER_SIZE;
+    block->res = LzmaEncode(block->outBuffer + LZMA_HEADER_SIZE, &outSizeProcessed,
+        block->inBuffer, block->inSize, queue->props, block->outBuffer, &outPropsSize, 0,
+        NULL, &g_Alloc, &g_Alloc);
+    block->outSize = LZMA_HEADER_SIZE + outSizeProcessed;
+  }
+}
+
+#ifdef _WIN32
+static THREAD_FUNC_DECL EncodeBlocksThread(void *p)
+{
+  EncodeBlocks((CHUNK_QUEUE *)p);
+  return 0;
+}
+#else
+static void *EncodeBlocksThread(void *p)
+{
+  EncodeBlocks((CHUNK_QUEUE *)p);
+  return NULL;
+}
+#endif
+
+static SRes EncodeChunked(ISeqOutStream *outStream, ISeqInStream *inStream, UInt64 fileSize, CLzmaEncProps *props)
+{
+  SRes res;
+  size_t inSize = (size_t)fileSize;
+  size_t blockSize = (size_t)mBlockSize;
+  Byte *inBuffer = 0;
+  Byte *header = 0;
+  CHUNK_BLOCK *blocks = 0;
+  CHUNK_QUEUE queue;
+  UInt32 blockCount;
+  UInt32 threadCount;
+  UInt32 offset;
+  UInt32 i;
+  size_t headerSize;
+#ifdef _WIN32
+  CThread threads[LZMA_CHUNKED_MAX_THREADS];
+#else
+  pthread_t threads[LZMA_CHUNKED_MAX_THREADS];
+#endif
+
+  if (inSize == 0)
+    return SZ_ERROR_INPUT_EOF;
+  if (fileSize > 0xFFFFFFFF)
+    return SZ_ERROR_PARAM;
+
+  inBuffer = (Byte *)MyAlloc(inSize);
+  if (inBuffer == 0)
+    return SZ_ERROR_MEM;
+
+  if (SeqInStream_Read(inStream, inBuffer, inSize) != SZ_OK) {
+    res = SZ_ERROR_READ;
+    goto Done;
+  }
+
+  blockCount = (UInt32)((inSize + blockSize - 1) / blockSize);
+  headerSize = LZMA_CHUNKED_HEADER_SIZE + (size_t)blockCount * LZMA_CHUNKED_BLOCK_SIZE;
+  header = (Byte *)MyAlloc(headerSize);
+  blocks = (CHUNK_BLOCK *)MyAlloc(blockCount * sizeof(CHUNK_BLOCK));
+  if (header == 0 || blocks == 0) {
+    res = SZ_ERROR_MEM;
+    goto Done;
+  }
+
+  memset(blocks, 0, blockCount * sizeof(CHUNK_BLOCK));
+  for (i = 0; i < blockCount; i++) {
+    blocks[i].inBuffer = inBuffer + (size_t)i * blockSize;
+    blocks[i].inSize = (i + 1 < blockCount) ? blockSize : inSize - (size_t)i * blockSize;
+    // we allocate 105% of original size + 64KB for output buffer
+    blocks[i].outSize = blocks[i].inSize / 20 * 21 + (1 << 16);
+    blocks[i].outBuffer = (Byte *)MyAlloc(blocks[i].outSize);
+    if (blocks[i].outBuffer == 0) {
+      res = SZ_ERROR_MEM;
+      goto Done;
+    }
+  }
+
+  //
+  // Every block is encoded on its own, so a dictionary larger than a block
+  // only costs memory.
+  //
+  props->reduceSize = blockSize;
+
+  queue.blocks = blocks;
+  queue.blockCount = blockCount;
+  queue.nextBlock = 0;
+  queue.props = props;
+  ChunkLock_Init(&queue.lock);
+
+  threadCount = (mThreads != 0) ? (UInt32)mThreads : GetProcessorCount();
+  if (threadCount > blockCount)
+    threadCount = blockCount;
+  if (threadCount > LZMA_CHUNKED_MAX_THREADS)
+    threadCount = LZMA_CHUNKED_MAX_THREADS;
+
+  //
+  // The main thread encodes blocks too, so one fewer thread is started.
+  //
+  for (i = 0; i + 1 < threadCount; i++) {
+#ifdef _WIN32
+    Thread_Construct(&threads[i]);
+    if (Thread_Create(&threads[i], EncodeBlocksThread, &queue) != 0)
+      break;
+#else
+    if (pthread_create(&threads[i], NULL, EncodeBlocksThread, &queue) != 0)
+      break;
+#endif
+  }
+
+  threadCount = i;
+  EncodeBlocks(&queue);
+
+  for (i = 0; i < threadCount; i++) {
+#ifdef _WIN32
+    Thread_Wait(&threads[i]);
+    Thread_Close(&threads[i]);
+#else
+    pthread_join(threads[i], NULL);
+#endif
+  }
+
+  ChunkLock_Delete(&queue.lock);
+
+  PutUInt32(header, LZMA_CHUNKED_SIGNATURE);
+  PutUInt32(header + 4, (UInt32)blockSize);
+  PutUInt32(header + 8, blockCount);
+  PutUInt32(header + 12, 0);
+  PutUInt32(header + 16, (UInt32)inSize);
+  PutUInt32(header + 20, 0);
+
+  res = SZ_OK;
+  offset = (UInt32)headerSize;
+  for (i = 0; i < blockCount; i++) {
+    if (blocks[i].res != SZ_OK) {
+      res = blocks[i].res;
+      goto Done;
+    }
+    PutUInt32(header + LZMA_CHUNKED_HEADER_SIZE + i * LZMA_CHUNKED_BLOCK_SIZE, offset);
+    PutUInt32(header + LZMA_CHUNKED_HEADER_SIZE + i * LZMA_CHUNKED_BLOCK_SIZE + 4, (UInt32)blocks[i].outSize);
+    offset += (UInt32)blocks[i].outSize;
+  }
+
+  if (outStream->Write(outStream, header, headerSize) != headerSize) {
+    res = SZ_ERROR_WRITE;
+    goto Done;
+  }
+
+  for (i = 0; i < blockCount; i++) {
+    if (outStream->Write(outStream, blocks[i].outBuffer, blocks[i].outSize) != blocks[i].outSize) {
+      res = SZ_ERROR_WRITE;
+      goto Done;
+    }
+  }
+
+Done:
+  if (blocks != 0) {
+    for (i = 0; i < blockCount; i++)
+      MyFree(blocks[i].outBuffer);
+  }
+  MyFree(blocks);
+  MyFree(header);
+  MyFree(inBuffer);
+
+  return res;
+}
+
+static SRes DecodeChunked(ISeqOutStream *outStream, ISeqInStream *inStream, UInt64 fileSize)
+{
+  SRes res;
+  size_t inSize = (size_t)fileSize;
+  Byte *inBuffer = 0;
+  Byte *outBuffer = 0;
+  UInt32 blockSize;
+  UInt32 blockCount;
+  UInt32 outSize;
+  UInt32 i;
+
+  if (inSize < LZMA_CHUNKED_HEADER_SIZE)
+    return SZ_ERROR_INPUT_EOF;
+
+  inBuffer = (Byte *)MyAlloc(inSize);
+  if (inBuffer == 0)
+    return SZ_ERROR_MEM;
+
+  if (SeqInStream_Read(inStream, inBuffer, inSize) != SZ_OK) {
+    res = SZ_ERROR_READ;
+    goto Done;
+  }
+
+  blockSize = GetUInt32(inBuffer + 4);
+  blockCount = GetUInt32(inBuffer + 8);
+  outSize = GetUInt32(inBuffer + 16);
+  if (GetUInt32(inBuffer) != LZMA_CHUNKED_SIGNATURE || GetUInt32(inBuffer + 20) != 0 || blockSize == 0 ||
+      blockCount != (UInt32)(((UInt64)outSize + blockSize - 1) / blockSize) ||
+      blockCount > (inSize - LZMA_CHUNKED_HEADER_SIZE) / LZMA_CHUNKED_BLOCK_SIZE) {
+    res = SZ_ERROR_DATA;
+    goto Done;
+  }
+
+  if (outSize == 0) {
+    res = SZ_OK;
+    goto Done;
+  }
+
+  outBuffer = (Byte *)MyAlloc(outSize);
+  if (outBuffer == 0) {
+    res = SZ_ERROR_MEM;
+    goto Done;
+  }
+
+  for (i = 0; i < blockCount; i++) {
+    const Byte *entry = inBuffer + LZMA_CHUNKED_HEADER_SIZE + i * LZMA_CHUNKED_BLOCK_SIZE;
+    UInt32 offset = GetUInt32(entry);
+    UInt32 size = GetUInt32(entry + 4);
+    SizeT decodedSize = (i + 1 < blockCount) ? blockSize : outSize - i * blockSize;
+    SizeT expectedSize = decodedSize;
+    SizeT inSizePure;
+    ELzmaStatus status;
+
+    if (offset > inSize || size > inSize - offset || size < LZMA_HEADER_SIZE) {
+      res = SZ_ERROR_DATA;
+      goto Done;
+    }
+
+    inSizePure = size - LZMA_HEADER_SIZE;
+    res = LzmaDecode(outBuffer + (size_t)i * blockSize, &decodedSize, inBuffer + offset + LZMA_HEADER_SIZE,
+        &inSizePure, inBuffer + offset, LZMA_PROPS_SIZE, LZMA_FINISH_END, &status, &g_Alloc);
+    if (res != SZ_OK)
+      goto Done;
+    if (decodedSize != expectedSize) {
+      res = SZ_ERROR_DATA;
+      goto Done;
+    }
+  }
+
+  if (outStream->Write(outStream, outBuffer, outSize) != outSize)
+    res = SZ_ERROR_WRITE;
+
+Done:
+  MyFree(outBuffer);
+  MyFree(inBuffer);
+
+  return res;
+}
+
 int main2(int numArgs, const char *args[], char *rs)
 {
   CFileSeqInStream inStream;
@@ -272,6 +614,21 @@ int main2(int numArgs, const char *args[], char *rs)
       modeWasSet = True;
     } else if (strcmp(args[param], "--f86") == 0) {
       mConType = X86Converter;
+    } else if (strcmp(args[param], "--chunked") == 0) {
+      mChunked = True;
+    } else if (strcmp(args[param], "--block-size") == 0) {
+      if (numArgs < (param + 2)) {
+        return PrintUserError(rs);
+      }
+      AsciiStringToUint64(args[++param], FALSE, &mBlockSize);
+      if ((mBlockSize < LZMA_CHUNKED_MIN_BLOCK_SIZE) || (mBlockSize > 0x80000000)) {
+        return PrintError(rs, kInvalidParamValMessage);
+      }
+    } else if (strcmp(args[param], "--threads") == 0) {
+      if (numArgs < (param + 2)) {
+        return PrintUserError(rs);
+      }
+      AsciiStringToUint64(args[++param], FALSE, &mThreads);
     } else if (strcmp(args[param], "-o") == 0 ||
                strcmp(args[param], "--output") == 0) {
       if (numArgs < (param + 2)) {
@@ -342,6 +699,10 @@ int main2(int numArgs, const char *args[], char *rs)
     return PrintUserError(rs);
   }
 
+  if (mChunked && (mConType != NoConverter)) {
+    return PrintError(rs, "--f86 can not be used with --chunked");
+  }
+
   {
     size_t t4 = sizeof(UInt32);
     size_t t8 = sizeof(UInt64);
@@ -364,14 +725,22 @@ int main2(int numArgs, const char *args[], char *rs)
     if (!mQuietMode) {
       printf("Encoding\n");
     }
-    res = Encode(&outStream.vt, &inStream.vt, fileSize, &props);
+    if (mChunked) {
+      res = EncodeChunked(&outStream.vt, &inStream.vt, fileSize, &props);
+    } else {
+      res = Encode(&outStream.vt, &inStream.vt, fileSize, &props);
+    }
   }
   else
   {
     if (!mQuietMode) {
       printf("Decoding\n");
     }
-    res = Decode(&outStream.vt, &inStream.vt, fileSize);
+    if (mChunked) {
+      res = DecodeChunked(&outStream.vt, &inStream.vt, fileSize);
+    } else {
+      res = Decode(&outStream.vt, &inStream.vt, fileSize);
+    }
   }
 
   File_Close(&outStream.file);
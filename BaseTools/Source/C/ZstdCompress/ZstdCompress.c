@@ -0,0 +1,498 @@
+/** @file
+  Zstandard Compress/Decompress tool (ZstdCompress)
+
+  The encoded file is a sequence of Zstandard frames that record the size of
+  their decoded contents, as expected by ZstdCustomDecompressLib.
+
+  Copyright (c) 2026, TianoCore and contributors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ZSTD_STATIC_LINKING_ONLY
+#include "zstd/lib/zstd.h"
+
+#include "ParseInf.h"
+#include "EfiUtilityMsgs.h"
+#include "CommonLib.h"
+
+#define UTILITY_NAME            "ZstdCompress"
+#define UTILITY_MAJOR_VERSION   0
+#define UTILITY_MINOR_VERSION   1
+
+#define ZSTD_NULL               0
+#define ZSTD_ENCODE             1
+#define ZSTD_DECODE             2
+
+//
+// Decoding speed of Zstandard does not depend much on the level, so the
+// default favors the compression ratio.
+//
+#define DEFAULT_LEVEL           19
+
+VOID
+Version (
+  VOID
+  )
+/*++
+
+Routine Description:
+
+  Displays the standard utility information to SDTOUT
+
+Arguments:
+
+  None
+
+Returns:
+
+  None
+
+--*/
+{
+  fprintf (
+    stdout,
+    "%s Version %d.%d %s (zstd %s)\n",
+    UTILITY_NAME,
+    UTILITY_MAJOR_VERSION,
+    UTILITY_MINOR_VERSION,
+    __BUILD_VERSION,
+    ZSTD_versionString ()
+    );
+}
+
+VOID
+Usage (
+  VOID
+  )
+/*++
+
+Routine Description:
+
+  Displays the utility usage syntax to STDOUT
+
+Arguments:
+
+  None
+
+Returns:
+
+  None
+
+--*/
+{
+  //
+  // Summary usage
+  //
+  fprintf (stdout, "Usage: ZstdCompress -e|-d [options] <input_file>\n\n");
+
+  //
+  // Copyright declaration
+  //
+  fprintf (stdout, "Copyright (c) 2026, TianoCore and contributors. All rights reserved.\n\n");
+
+  //
+  // Details Option
+  //
+  fprintf (stdout, "optional arguments:\n");
+  fprintf (stdout, "  -h, --help            Show this help message and exit\n");
+  fprintf (stdout, "  --version             Show program's version number and exit\n");
+  fprintf (stdout, "  --debug [DEBUG]       Output DEBUG statements, where DEBUG_LEVEL is 0 (min)\n\
+                        - 9 (max)\n");
+  fprintf (stdout, "  -v, --verbose         Print informational statements\n");
+  fprintf (stdout, "  -q, --quiet           Returns the exit code, error messages will be\n\
+                        displayed\n");
+  fprintf (stdout, "  -s, --silent          Returns only the exit code; informational and error\n\
+                        messages are not displayed\n");
+  fprintf (stdout, "  -e, --encode          Compress the input file\n");
+  fprintf (stdout, "  -d, --decode          Decompress the input file\n");
+  fprintf (stdout, "  -l LEVEL, --level LEVEL\n\
+                        Compression level, 1 (fast) - %d (best), default: %d\n", ZSTD_maxCLevel (), DEFAULT_LEVEL);
+  fprintf (stdout, "  -o OUTPUT_FILENAME, --output OUTPUT_FILENAME\n\
+                        Output file name\n");
+}
+
+/**
+  Compress a buffer into a single frame that records the input size.
+
+  @param[in]  Level       The compression level.
+  @param[in]  Input       The buffer to compress.
+  @param[in]  InputSize   The size of Input, in bytes.
+  @param[out] Output      The compressed buffer, allocated with malloc().
+  @param[out] OutputSize  The size of Output, in bytes.
+
+  @retval EFI_SUCCESS           The buffer was compressed.
+  @retval EFI_OUT_OF_RESOURCES  Memory could not be allocated.
+  @retval EFI_ABORTED           The compression failed.
+**/
+STATIC
+EFI_STATUS
+ZstdEncode (
+  IN  INT32   Level,
+  IN  UINT8   *Input,
+  IN  UINT32  InputSize,
+  OUT UINT8   **Output,
+  OUT UINT32  *OutputSize
+  )
+{
+  ZSTD_CCtx  *CCtx;
+  size_t     Capacity;
+  size_t     Result;
+
+  CCtx = ZSTD_createCCtx ();
+  if (CCtx == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  //
+  // The decoder sizes its output buffer from the frame header and only
+  // verifies the integrity of the data through the FFS file checksum.
+  //
+  ZSTD_CCtx_setParameter (CCtx, ZSTD_c_compressionLevel, Level);
+  ZSTD_CCtx_setParameter (CCtx, ZSTD_c_contentSizeFlag, 1);
+  ZSTD_CCtx_setParameter (CCtx, ZSTD_c_checksumFlag, 0);
+
+  Capacity = ZSTD_compressBound (InputSize);
+  *Output  = (UINT8 *)malloc (Capacity);
+  if (*Output == NULL) {
+    ZSTD_freeCCtx (CCtx);
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Result = ZSTD_compress2 (CCtx, *Output, Capacity, Input, InputSize);
+  ZSTD_freeCCtx (CCtx);
+  if (ZSTD_isError (Result)) {
+    Error (NULL, 0, 3000, "Invalid", "compression failed: %s", ZSTD_getErrorName (Result));
+    return EFI_ABORTED;
+  }
+
+  *OutputSize = (UINT32)Result;
+  return EFI_SUCCESS;
+}
+
+/**
+  Decompress a buffer made of frames that record their decoded size.
+
+  @param[in]  Input       The buffer to decompress.
+  @param[in]  InputSize   The size of Input, in bytes.
+  @param[out] Output      The decompressed buffer, allocated with malloc().
+  @param[out] OutputSize  The size of Output, in bytes.
+
+  @retval EFI_SUCCESS           The buffer was decompressed.
+  @retval EFI_OUT_OF_RESOURCES  Memory could not be allocated.
+  @retval EFI_ABORTED           The input is not valid.
+**/
+STATIC
+EFI_STATUS
+ZstdDecode (
+  IN  UINT8   *Input,
+  IN  UINT32  InputSize,
+  OUT UINT8   **Output,
+  OUT UINT32  *OutputSize
+  )
+{
+  unsigned long long  DecodedSize;
+  size_t              Result;
+
+  DecodedSize = ZSTD_findDecompressedSize (Input, InputSize);
+  if ((DecodedSize == ZSTD_CONTENTSIZE_ERROR) || (DecodedSize == ZSTD_CONTENTSIZE_UNKNOWN)) {
+    Error (NULL, 0, 3000, "Invalid", "the input is not made of Zstandard frames with a known size");
+    return EFI_ABORTED;
+  }
+
+  if (DecodedSize > MAX_UINT32) {
+    Error (NULL, 0, 3000, "Invalid", "the decoded size %llu is too large", DecodedSize);
+    return EFI_ABORTED;
+  }
+
+  //
+  // malloc (0) may return NULL.
+  //
+  *Output = (UINT8 *)malloc ((size_t)DecodedSize + 1);
+  if (*Output == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Result = ZSTD_decompress (*Output, (size_t)DecodedSize, Input, InputSize);
+  if (ZSTD_isError (Result) || (Result != DecodedSize)) {
+    Error (NULL, 0, 3000, "Invalid", "decompression failed: %s", ZSTD_isError (Result) ? ZSTD_getErrorName (Result) : "size mismatch");
+    return EFI_ABORTED;
+  }
+
+  *OutputSize = (UINT32)Result;
+  return EFI_SUCCESS;
+}
+
+int
+main (
+  int   argc,
+  CHAR8 *argv[]
+  )
+/*++
+
+Routine Description:
+
+  Main function.
+
+Arguments:
+
+  argc - Number of command line parameters.
+  argv - Array of pointers to parameter strings.
+
+Returns:
+  STATUS_SUCCESS - Utility exits successfully.
+  STATUS_ERROR   - Some error occurred during execution.
+
+--*/
+{
+  EFI_STATUS              Status;
+  CHAR8                   *OutputFileName;
+  CHAR8                   *InputFileName;
+  UINT8                   *FileBuffer;
+  UINT32                  FileSize;
+  UINT8                   *OutputBuffer;
+  UINT32                  OutputSize;
+  UINT64                  LogLevel;
+  UINT64                  Level;
+  UINT8                   FileAction;
+  FILE                    *InFile;
+  FILE                    *OutFile;
+
+  //
+  // Init local variables
+  //
+  LogLevel       = 0;
+  Level          = DEFAULT_LEVEL;
+  Status         = EFI_SUCCESS;
+  InputFileName  = NULL;
+  OutputFileName = NULL;
+  FileAction     = ZSTD_NULL;
+  InFile         = NULL;
+  OutFile        = NULL;
+  FileBuffer     = NULL;
+  OutputBuffer   = NULL;
+  OutputSize     = 0;
+
+  SetUtilityName (UTILITY_NAME);
+
+  if (argc == 1) {
+    Error (NULL, 0, 1001, "Missing options", "no options input");
+    Usage ();
+    return STATUS_ERROR;
+  }
+
+  //
+  // Parse command line
+  //
+  argc --;
+  argv ++;
+
+  if ((stricmp (argv[0], "-h") == 0) || (stricmp (argv[0], "--help") == 0)) {
+    Usage ();
+    return STATUS_SUCCESS;
+  }
+
+  if (stricmp (argv[0], "--version") == 0) {
+    Version ();
+    return STATUS_SUCCESS;
+  }
+
+  while (argc > 0) {
+    if ((stricmp (argv[0], "-o") == 0) || (stricmp (argv[0], "--output") == 0)) {
+      if (argv[1] == NULL || argv[1][0] == '-') {
+        Error (NULL, 0, 1003, "Invalid option value", "Output File name is missing for -o option");
+        goto Finish;
+      }
+      OutputFileName = argv[1];
+      argc -= 2;
+      argv += 2;
+      continue;
+    }
+
+    if ((stricmp (argv[0], "-e") == 0) || (stricmp (argv[0], "--encode") == 0)) {
+      FileAction     = ZSTD_ENCODE;
+      argc --;
+      argv ++;
+      continue;
+    }
+
+    if ((stricmp (argv[0], "-d") == 0) || (stricmp (argv[0], "--decode") == 0)) {
+      FileAction     = ZSTD_DECODE;
+      argc --;
+      argv ++;
+      continue;
+    }
+
+    if ((stricmp (argv[0], "-l") == 0) || (stricmp (argv[0], "--level") == 0)) {
+      if (argv[1] == NULL) {
+        Error (NULL, 0, 1003, "Invalid option value", "Level is missing for %s option", argv[0]);
+        goto Finish;
+      }
+      Status = AsciiStringToUint64 (argv[1], FALSE, &Level);
+      if (EFI_ERROR (Status) || (Level < 1) || (Level > (UINT64)ZSTD_maxCLevel ())) {
+        Error (NULL, 0, 1003, "Invalid option value", "Level range is 1-%d, current input level is %s", ZSTD_maxCLevel (), argv[1]);
+        goto Finish;
+      }
+      argc -= 2;
+      argv += 2;
+      continue;
+    }
+
+    if ((stricmp (argv[0], "-v") == 0) || (stricmp (argv[0], "--verbose") == 0)) {
+      SetPrintLevel (VERBOSE_LOG_LEVEL);
+      VerboseMsg ("Verbose output Mode Set!");
+      argc --;
+      argv ++;
+      continue;
+    }
+
+    if ((stricmp (argv[0], "-q") == 0) || (stricmp (argv[0], "--quiet") == 0)) {
+      SetPrintLevel (KEY_LOG_LEVEL);
+      KeyMsg ("Quiet output Mode Set!");
+      argc --;
+      argv ++;
+      continue;
+    }
+
+    if ((stricmp (argv[0], "-s") == 0) || (stricmp (argv[0], "--silent") == 0)) {
+      SetPrintLevel (KEY_LOG_LEVEL + 1);
+      argc --;
+      argv ++;
+      continue;
+    }
+
+    if (stricmp (argv[0], "--debug") == 0) {
+      Status = AsciiStringToUint64 (argv[1], FALSE, &LogLevel);
+      if (EFI_ERROR (Status)) {
+        Error (NULL, 0, 1003, "Invalid option value", "%s = %s", argv[0], argv[1]);
+        goto Finish;
+      }
+      if (LogLevel > 9) {
+        Error (NULL, 0, 1003, "Invalid option value", "Debug Level range is 0-9, current input level is %d", (int) LogLevel);
+        goto Finish;
+      }
+      SetPrintLevel (LogLevel);
+      DebugMsg (NULL, 0, 9, "Debug Mode Set", "Debug Output Mode Level %s is set!", argv[1]);
+      argc -= 2;
+      argv += 2;
+      continue;
+    }
+
+    if (argv[0][0] == '-') {
+      Error (NULL, 0, 1000, "Unknown option", argv[0]);
+      goto Finish;
+    }
+
+    //
+    // Get Input file file name.
+    //
+    InputFileName = argv[0];
+    argc --;
+    argv ++;
+  }
+
+  VerboseMsg ("%s tool start.", UTILITY_NAME);
+
+  //
+  // Check Input parameters
+  //
+  if (FileAction == ZSTD_NULL) {
+    Error (NULL, 0, 1001, "Missing option", "either the encode or the decode option must be specified!");
+    return STATUS_ERROR;
+  } else if (FileAction == ZSTD_ENCODE) {
+    VerboseMsg ("File will be encoded by Zstandard at level %u", (unsigned) Level);
+  } else if (FileAction == ZSTD_DECODE) {
+    VerboseMsg ("File will be decoded by Zstandard");
+  }
+
+  if (InputFileName == NULL) {
+    Error (NULL, 0, 1001, "Missing option", "Input files are not specified");
+    goto Finish;
+  } else {
+    VerboseMsg ("Input file name is %s", InputFileName);
+  }
+
+  if (OutputFileName == NULL) {
+    Error (NULL, 0, 1001, "Missing option", "Output file are not specified");
+    goto Finish;
+  } else {
+    VerboseMsg ("Output file name is %s", OutputFileName);
+  }
+
+  //
+  // Open Input file and read file data.
+  //
+  InFile = fopen (LongFilePath (InputFileName), "rb");
+  if (InFile == NULL) {
+    Error (NULL, 0, 0001, "Error opening file", InputFileName);
+    return STATUS_ERROR;
+  }
+
+  fseek (InFile, 0, SEEK_END);
+  FileSize = ftell (InFile);
+  fseek (InFile, 0, SEEK_SET);
+
+  FileBuffer = (UINT8 *) malloc (FileSize + 1);
+  if (FileBuffer == NULL) {
+    Error (NULL, 0, 4001, "Resource", "memory cannot be allocated!");
+    fclose (InFile);
+    goto Finish;
+  }
+
+  if (fread (FileBuffer, 1, FileSize, InFile) != FileSize) {
+    Error (NULL, 0, 0004, "Error reading file", InputFileName);
+    fclose (InFile);
+    goto Finish;
+  }
+  fclose (InFile);
+  VerboseMsg ("the size of the input file is %u bytes", (unsigned) FileSize);
+
+  if (FileAction == ZSTD_ENCODE) {
+    Status = ZstdEncode ((INT32)Level, FileBuffer, FileSize, &OutputBuffer, &OutputSize);
+  } else {
+    Status = ZstdDecode (FileBuffer, FileSize, &OutputBuffer, &OutputSize);
+  }
+
+  if (Status == EFI_OUT_OF_RESOURCES) {
+    Error (NULL, 0, 4001, "Resource", "memory cannot be allocated!");
+    goto Finish;
+  } else if (EFI_ERROR (Status)) {
+    goto Finish;
+  }
+
+  //
+  // Done, write output file.
+  //
+  OutFile = fopen (LongFilePath (OutputFileName), "wb");
+  if (OutFile == NULL) {
+    Error (NULL, 0, 0001, "Error opening file", OutputFileName);
+    goto Finish;
+  }
+
+  if (fwrite (OutputBuffer, 1, OutputSize, OutFile) != OutputSize) {
+    Error (NULL, 0, 0002, "Error writing file", OutputFileName);
+    goto Finish;
+  }
+  VerboseMsg ("the size of the %s file is %u bytes", FileAction == ZSTD_ENCODE ? "encoded" : "decoded", (unsigned) OutputSize);
+
+Finish:
+  if (FileBuffer != NULL) {
+    free (FileBuffer);
+  }
+
+  if (OutputBuffer != NULL) {
+    free (OutputBuffer);
+  }
+
+  if (OutFile != NULL) {
+    fclose (OutFile);
+  }
+
+  VerboseMsg ("%s tool done with return code is 0x%x.", UTILITY_NAME, GetUtilityStatus ());
+
+  return GetUtilityStatus ();
+}
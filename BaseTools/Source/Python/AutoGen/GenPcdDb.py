@@ -22,6 +22,11 @@ import Common.LongFilePathOs as os
 
 DATABASE_VERSION = 7
 
+## The ExMapTable is sorted by (ExGuidIndex, ExTokenNumber) so that the PCD
+#  drivers can binary search it. Recorded in the ExMapLayout byte of the header.
+#  Databases generated before this byte existed carry the 0xDA pad value there.
+EXMAP_LAYOUT_SORTED = 0x01
+
 gPcdDatabaseAutoGenC = TemplateString("""
 //
 // External PCD database debug information
@@ -188,7 +193,8 @@ typedef struct {
   //UINT16                LocalTokenCount;  // LOCAL_TOKEN_NUMBER for all
   //UINT16                ExTokenCount;     // EX_TOKEN_NUMBER for DynamicEx
   //UINT16                GuidTableCount;   // The Number of Guid in GuidTable
-  //UINT8                 Pad[6];
+  //UINT8                 ExMapLayout;      // EXMAP_LAYOUT_SORTED
+  //UINT8                 Pad[5];
   ${PHASE}_PCD_DATABASE_INIT    Init;
   ${PHASE}_PCD_DATABASE_UNINIT  Uninit;
 } ${PHASE}_PCD_DATABASE;
@@ -819,8 +825,10 @@ def BuildExDataBase(Dict):
     b = pack('=H', GuidTableCount)
 
     Buffer += b
-    b = pack('=B', Pad)
+    b = pack('=B', EXMAP_LAYOUT_SORTED)
     Buffer += b
+
+    b = pack('=B', Pad)
     Buffer += b
     Buffer += b
     Buffer += b
@@ -1487,6 +1495,17 @@ def CreatePcdDatabasePhaseSpecificAutoGen (Platform, DynamicPcdList, Phase):
             Dict['EXMAPPING_TABLE_LOCAL_TOKEN'].append(str(GeneratedTokenNumber + 1) + 'U')
             Dict['EXMAPPING_TABLE_GUID_INDEX'].append(str(GuidList.index(TokenSpaceGuid)) + 'U')
 
+    #
+    # Sort the ExMapTable by (ExGuidIndex, ExTokenNumber) so that the PCD Driver/PEIM
+    # can look up a DynamicEx PCD with a binary search instead of a linear scan.
+    #
+    if Dict['EXMAPPING_TABLE_EXTOKEN']:
+        ExMapTable = sorted(zip(Dict['EXMAPPING_TABLE_EXTOKEN'], Dict['EXMAPPING_TABLE_LOCAL_TOKEN'], Dict['EXMAPPING_TABLE_GUID_INDEX']),
+                            key=lambda Item: (GetIntegerValue(Item[2]), GetIntegerValue(Item[0])))
+        Dict['EXMAPPING_TABLE_EXTOKEN'] = [Item[0] for Item in ExMapTable]
+        Dict['EXMAPPING_TABLE_LOCAL_TOKEN'] = [Item[1] for Item in ExMapTable]
+        Dict['EXMAPPING_TABLE_GUID_INDEX'] = [Item[2] for Item in ExMapTable]
+
     if Platform.Platform.PcdInfoFlag:
         for index in range(len(Dict['PCD_TOKENSPACE_MAP'])):
             TokenSpaceIndex = StringTableSize
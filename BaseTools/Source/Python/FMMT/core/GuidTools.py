@@ -99,7 +99,9 @@ class GUIDTools:
         struct2stream(ModifyGuidFormat("ee4e5898-3914-4259-9d6e-dc7bd79403cf")): GUIDTool("ee4e5898-3914-4259-9d6e-dc7bd79403cf", "LZMA", "LzmaCompress"),
         struct2stream(ModifyGuidFormat("fc1bcdb0-7d31-49aa-936a-a4600d9dd083")): GUIDTool("fc1bcdb0-7d31-49aa-936a-a4600d9dd083", "CRC32", "GenCrc32"),
         struct2stream(ModifyGuidFormat("d42ae6bd-1352-4bfb-909a-ca72a6eae889")): GUIDTool("d42ae6bd-1352-4bfb-909a-ca72a6eae889", "LZMAF86", "LzmaF86Compress"),
+        struct2stream(ModifyGuidFormat("fb2c94ff-29a0-4755-9c38-bf58fb547467")): GUIDTool("fb2c94ff-29a0-4755-9c38-bf58fb547467", "LZMACHUNKED", "LzmaChunkedCompress"),
         struct2stream(ModifyGuidFormat("3d532050-5cda-4fd0-879e-0f7f630d5afb")): GUIDTool("3d532050-5cda-4fd0-879e-0f7f630d5afb", "BROTLI", "BrotliCompress"),
+        struct2stream(ModifyGuidFormat("3d455c4a-6314-4e17-b299-d5c0c6f7f6a3")): GUIDTool("3d455c4a-6314-4e17-b299-d5c0c6f7f6a3", "ZSTD", "ZstdCompress"),
     }
 
     def __init__(self, tooldef_file: str=None) -> None:
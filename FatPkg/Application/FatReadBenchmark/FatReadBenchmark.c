@@ -0,0 +1,339 @@
+/** @file
+  A shell application that measures the sequential read speed of a file
+  through the Simple File System protocol.
+
+  The file is read from start to end in blocks of a fixed size, the way OS
+  loaders read kernels and initial RAM disks from the ESP. Reads smaller than
+  the data cache pages of the FAT driver go through its data cache and its
+  read-ahead, so running the application on a file of several hundred MB with
+  different block sizes and PcdFatReadAheadMaxPages values compares read-ahead
+  windows.
+
+  Copyright (c) 2026, TianoCore and contributors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/PrintLib.h>
+#include <Library/TimerLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/UefiLib.h>
+
+#include <Protocol/ShellParameters.h>
+#include <Protocol/Shell.h>
+#include <Protocol/SimpleFileSystem.h>
+
+#define MAJOR_VERSION  1
+#define MINOR_VERSION  0
+
+#define DEFAULT_BLOCK_SIZE  SIZE_4KB
+#define DEFAULT_PASSES      3
+
+STATIC UINTN   mBlockSize = DEFAULT_BLOCK_SIZE;
+STATIC UINTN   mPasses    = DEFAULT_PASSES;
+STATIC UINT64  mCounterStart;
+STATIC UINT64  mCounterEnd;
+
+/**
+   Display current version.
+**/
+STATIC
+VOID
+ShowVersion (
+  VOID
+  )
+{
+  Print (L"FatReadBenchmark Version %d.%02d\n", MAJOR_VERSION, MINOR_VERSION);
+}
+
+/**
+   Display Usage and Help information.
+**/
+STATIC
+VOID
+ShowHelp (
+  VOID
+  )
+{
+  Print (L"Measure the sequential read speed of a file through SimpleFileSystem.\n");
+  Print (L"\n");
+  Print (L"FatReadBenchmark [-b BlockSize] [-n Passes] File\n");
+  Print (L"\n");
+  Print (L"  BlockSize  Size in bytes of each read, %d by default.\n", DEFAULT_BLOCK_SIZE);
+  Print (L"  Passes     Number of times the file is read, %d by default.\n", DEFAULT_PASSES);
+  Print (L"  File       The file to read. Use a file of several hundred MB so\n");
+  Print (L"             that it does not fit in the caches of the storage stack.\n");
+}
+
+/**
+  Return the number of ticks between two performance counter values.
+
+  @param[in] Start  The counter value at the start of the measurement.
+  @param[in] End    The counter value at the end of the measurement.
+
+  @return The elapsed ticks.
+**/
+STATIC
+UINT64
+GetElapsedTicks (
+  IN UINT64  Start,
+  IN UINT64  End
+  )
+{
+  if (mCounterEnd < mCounterStart) {
+    //
+    // The counter counts down.
+    //
+    return (Start >= End) ? Start - End : (Start - mCounterEnd) + (mCounterStart - End);
+  }
+
+  return (End >= Start) ? End - Start : (mCounterEnd - Start) + (End - mCounterStart);
+}
+
+/**
+  Open a file given on the command line through the Simple File System
+  protocol of the volume it is on.
+
+  @param[in]  FileName        The file to be opened.
+  @param[out] File            Returns the opened file.
+
+  @retval EFI_SUCCESS    The file was opened.
+  @retval EFI_NOT_FOUND  Shell protocol or file not found.
+  @retval others         The file could not be opened.
+**/
+STATIC
+EFI_STATUS
+OpenFile (
+  IN  CHAR16             *FileName,
+  OUT EFI_FILE_PROTOCOL  **File
+  )
+{
+  EFI_STATUS                Status;
+  EFI_SHELL_PROTOCOL        *ShellProtocol;
+  EFI_DEVICE_PATH_PROTOCOL  *DevicePath;
+  EFI_DEVICE_PATH_PROTOCOL  *RemainingPath;
+
+  Status = gBS->LocateProtocol (&gEfiShellProtocolGuid, NULL, (VOID **)&ShellProtocol);
+  if (EFI_ERROR (Status)) {
+    return EFI_NOT_FOUND;
+  }
+
+  DevicePath = ShellProtocol->GetDevicePathFromFilePath (FileName);
+  if (DevicePath == NULL) {
+    return EFI_NOT_FOUND;
+  }
+
+  RemainingPath = DevicePath;
+  Status        = EfiOpenFileByDevicePath (&RemainingPath, File, EFI_FILE_MODE_READ, 0);
+  FreePool (DevicePath);
+  return Status;
+}
+
+/**
+  Read a file from start to end once.
+
+  @param[in]  File            The file to read.
+  @param[in]  Buffer          A buffer of mBlockSize bytes.
+  @param[out] FileSize        Returns the number of bytes read.
+  @param[out] Nanoseconds     Returns the time taken by the reads.
+
+  @retval EFI_SUCCESS    The file was read.
+  @retval others         A read failed.
+**/
+STATIC
+EFI_STATUS
+ReadFilePass (
+  IN  EFI_FILE_PROTOCOL  *File,
+  IN  VOID               *Buffer,
+  OUT UINT64             *FileSize,
+  OUT UINT64             *Nanoseconds
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       ReadSize;
+  UINT64      Start;
+
+  Status = File->SetPosition (File, 0);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  *FileSize = 0;
+  Start     = GetPerformanceCounter ();
+  do {
+    ReadSize = mBlockSize;
+    Status   = File->Read (File, &ReadSize, Buffer);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    *FileSize += ReadSize;
+  } while (ReadSize == mBlockSize);
+
+  *Nanoseconds = GetTimeInNanoSecond (GetElapsedTicks (Start, GetPerformanceCounter ()));
+  return EFI_SUCCESS;
+}
+
+/**
+  Print the size, time and throughput of reads.
+
+  @param[in] Label        The label of the line.
+  @param[in] Bytes        The number of bytes read.
+  @param[in] Nanoseconds  The time taken by the reads.
+**/
+STATIC
+VOID
+PrintRate (
+  IN CHAR16  *Label,
+  IN UINT64  Bytes,
+  IN UINT64  Nanoseconds
+  )
+{
+  UINT64  Rate;
+
+  //
+  // Bytes per microsecond are MB/s; keep one decimal.
+  //
+  Rate = 0;
+  if (Nanoseconds != 0) {
+    Rate = DivU64x64Remainder (MultU64x32 (Bytes, 10000), Nanoseconds, NULL);
+  }
+
+  Print (
+    L"%-8s %14ld %12ld %8ld.%d\n",
+    Label,
+    Bytes,
+    DivU64x32 (Nanoseconds, 1000),
+    DivU64x32 (Rate, 10),
+    ModU64x32 (Rate, 10)
+    );
+}
+
+/**
+  FAT read benchmark entry point.
+
+  @param[in] ImageHandle     The image handle.
+  @param[in] SystemTable     The system table.
+
+  @retval EFI_SUCCESS            The benchmark ran.
+  @retval EFI_INVALID_PARAMETER  Invalid command line.
+  @retval Others                 The file could not be opened or read.
+**/
+EFI_STATUS
+EFIAPI
+FatReadBenchmarkMain (
+  IN EFI_HANDLE        ImageHandle,
+  IN EFI_SYSTEM_TABLE  *SystemTable
+  )
+{
+  EFI_STATUS                     Status;
+  EFI_SHELL_PARAMETERS_PROTOCOL  *ShellParameters;
+  UINTN                          Argc;
+  CHAR16                         **Argv;
+  UINTN                          Index;
+  CHAR16                         *FileName;
+  EFI_FILE_PROTOCOL              *File;
+  VOID                           *Buffer;
+  UINT64                         FileSize;
+  UINT64                         Nanoseconds;
+  UINT64                         TotalBytes;
+  UINT64                         TotalNanoseconds;
+  CHAR16                         Label[8];
+
+  Status = gBS->HandleProtocol (ImageHandle, &gEfiShellParametersProtocolGuid, (VOID **)&ShellParameters);
+  if (EFI_ERROR (Status)) {
+    Print (L"FatReadBenchmark: This application must be run from the UEFI Shell\n");
+    return Status;
+  }
+
+  Argc = ShellParameters->Argc;
+  Argv = ShellParameters->Argv;
+
+  if ((Argc < 2) || (StrCmp (Argv[1], L"-h") == 0) || (StrCmp (Argv[1], L"-?") == 0)) {
+    ShowHelp ();
+    return (Argc < 2) ? EFI_INVALID_PARAMETER : EFI_SUCCESS;
+  }
+
+  if (StrCmp (Argv[1], L"-v") == 0) {
+    ShowVersion ();
+    return EFI_SUCCESS;
+  }
+
+  FileName = NULL;
+  for (Index = 1; Index < Argc; Index++) {
+    if (StrCmp (Argv[Index], L"-b") == 0) {
+      if ((Index + 1 == Argc) || (StrDecimalToUintn (Argv[Index + 1]) == 0)) {
+        Print (L"FatReadBenchmark: Invalid block size\n");
+        return EFI_INVALID_PARAMETER;
+      }
+
+      mBlockSize = StrDecimalToUintn (Argv[++Index]);
+      continue;
+    }
+
+    if (StrCmp (Argv[Index], L"-n") == 0) {
+      if ((Index + 1 == Argc) || (StrDecimalToUintn (Argv[Index + 1]) == 0)) {
+        Print (L"FatReadBenchmark: Invalid pass count\n");
+        return EFI_INVALID_PARAMETER;
+      }
+
+      mPasses = StrDecimalToUintn (Argv[++Index]);
+      continue;
+    }
+
+    if (FileName != NULL) {
+      ShowHelp ();
+      return EFI_INVALID_PARAMETER;
+    }
+
+    FileName = Argv[Index];
+  }
+
+  if (FileName == NULL) {
+    ShowHelp ();
+    return EFI_INVALID_PARAMETER;
+  }
+
+  GetPerformanceCounterProperties (&mCounterStart, &mCounterEnd);
+
+  Status = OpenFile (FileName, &File);
+  if (EFI_ERROR (Status)) {
+    Print (L"FatReadBenchmark: Failed to open %s - %r\n", FileName, Status);
+    return Status;
+  }
+
+  Buffer = AllocatePool (mBlockSize);
+  if (Buffer == NULL) {
+    File->Close (File);
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Print (L"Reading %s in blocks of %d bytes\n", FileName, (UINT32)mBlockSize);
+  Print (L"%-8s %14s %12s %10s\n", L"Pass", L"Bytes", L"us", L"MB/s");
+
+  TotalBytes       = 0;
+  TotalNanoseconds = 0;
+  for (Index = 0; Index < mPasses; Index++) {
+    Status = ReadFilePass (File, Buffer, &FileSize, &Nanoseconds);
+    if (EFI_ERROR (Status)) {
+      Print (L"FatReadBenchmark: Failed to read %s - %r\n", FileName, Status);
+      break;
+    }
+
+    UnicodeSPrint (Label, sizeof (Label), L"%d", (UINT32)(Index + 1));
+    PrintRate (Label, FileSize, Nanoseconds);
+    TotalBytes       += FileSize;
+    TotalNanoseconds += Nanoseconds;
+  }
+
+  if (!EFI_ERROR (Status)) {
+    PrintRate (L"Total", TotalBytes, TotalNanoseconds);
+  }
+
+  FreePool (Buffer);
+  File->Close (File);
+  return Status;
+}
@@ -9,6 +9,254 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include "Fat.h"
 
+/**
+
+  Free the preloaded copy of the directory.
+
+  @param  ODir                  - The directory.
+
+**/
+VOID
+FatReleaseODirPreload (
+  IN FAT_ODIR  *ODir
+  )
+{
+  if (ODir->PreloadBuffer != NULL) {
+    FreePool (ODir->PreloadBuffer);
+    ODir->PreloadBuffer = NULL;
+    ODir->PreloadSize   = 0;
+  }
+
+  ODir->Preloaded = FALSE;
+}
+
+/**
+
+  Read the whole directory with one access, so that its entries are loaded
+  from memory instead of one entry at a time. Entries are still parsed lazily;
+  the copy is freed once the end of the directory has been reached.
+
+  @param  OFile                 - The directory being loaded.
+
+**/
+VOID
+FatPreloadODir (
+  IN FAT_OFILE  *OFile
+  )
+{
+  FAT_ODIR    *ODir;
+  UINT8       *Buffer;
+  UINTN       BufferSize;
+  EFI_STATUS  Status;
+
+  ODir = OFile->ODir;
+  if (ODir->Preloaded) {
+    return;
+  }
+
+  ODir->Preloaded = TRUE;
+  BufferSize      = OFile->FileSize;
+  if ((BufferSize == 0) || (BufferSize > FAT_MAX_DIRENTRY_COUNT * sizeof (FAT_DIRECTORY_ENTRY))) {
+    return;
+  }
+
+  Buffer = AllocatePool (BufferSize);
+  if (Buffer == NULL) {
+    return;
+  }
+
+  Status = FatAccessOFile (OFile, ReadData, 0, &BufferSize, Buffer, NULL);
+  if (EFI_ERROR (Status)) {
+    FreePool (Buffer);
+    return;
+  }
+
+  ODir->PreloadBuffer = Buffer;
+  ODir->PreloadSize   = BufferSize;
+}
+
+/**
+
+  Compare two name CRCs for QuickSort.
+
+  @param  Buffer1               - The first CRC.
+  @param  Buffer2               - The second CRC.
+
+  @return The order of the two CRCs.
+
+**/
+STATIC
+INTN
+EFIAPI
+FatCompareNameCrc (
+  IN CONST VOID  *Buffer1,
+  IN CONST VOID  *Buffer2
+  )
+{
+  UINT32  Crc1;
+  UINT32  Crc2;
+
+  Crc1 = *(CONST UINT32 *)Buffer1;
+  Crc2 = *(CONST UINT32 *)Buffer2;
+  return (Crc1 < Crc2) ? -1 : (Crc1 > Crc2);
+}
+
+/**
+
+  Build the name index of a fully loaded directory.
+
+  @param  ODir                  - The directory.
+
+  @return The name index, or NULL if the index would not fit in
+          PcdFatDirIndexCacheMaxSize or there is not enough memory.
+
+**/
+STATIC
+FAT_DIR_INDEX *
+FatCreateDirIndex (
+  IN FAT_ODIR  *ODir
+  )
+{
+  FAT_DIR_INDEX  *DirIndex;
+  FAT_DIRENT     *DirEnt;
+  LIST_ENTRY     *Link;
+  UINTN          Count;
+  UINT32         Swap;
+
+  ASSERT (ODir->EndOfDir);
+
+  Count = 0;
+  for (Link = ODir->ChildList.ForwardLink; Link != &ODir->ChildList; Link = Link->ForwardLink) {
+    Count += 2;
+  }
+
+  if (FAT_DIR_INDEX_SIZE (Count) > PcdGet32 (PcdFatDirIndexCacheMaxSize)) {
+    return NULL;
+  }
+
+  DirIndex = AllocatePool (FAT_DIR_INDEX_SIZE (Count));
+  if (DirIndex == NULL) {
+    return NULL;
+  }
+
+  DirIndex->Signature = FAT_DIRINDEX_SIGNATURE;
+  DirIndex->Count     = 0;
+  for (Link = ODir->ChildList.ForwardLink; Link != &ODir->ChildList; Link = Link->ForwardLink) {
+    DirEnt                               = DIRENT_FROM_LINK (Link);
+    DirIndex->NameCrc[DirIndex->Count++] = FatLongNameCrc (DirEnt->FileString);
+    DirIndex->NameCrc[DirIndex->Count++] = FatShortNameCrc (DirEnt->Entry.FileName);
+  }
+
+  QuickSort (DirIndex->NameCrc, DirIndex->Count, sizeof (UINT32), FatCompareNameCrc, &Swap);
+  return DirIndex;
+}
+
+/**
+
+  Check the name index of the directory for a name.
+
+  @param  ODir                  - The directory.
+  @param  NameCrc               - FatLongNameCrc or FatShortNameCrc of the name.
+
+  @retval TRUE                  - The directory has no name index, or the name may be in the directory.
+  @retval FALSE                 - The name is not in the directory.
+
+**/
+BOOLEAN
+FatDirIndexMayContain (
+  IN FAT_ODIR  *ODir,
+  IN UINT32    NameCrc
+  )
+{
+  FAT_DIR_INDEX  *DirIndex;
+  UINTN          Low;
+  UINTN          High;
+  UINTN          Middle;
+
+  DirIndex = ODir->NameIndex;
+  if (DirIndex == NULL) {
+    return TRUE;
+  }
+
+  Low  = 0;
+  High = DirIndex->Count;
+  while (Low < High) {
+    Middle = (Low + High) / 2;
+    if (DirIndex->NameCrc[Middle] < NameCrc) {
+      Low = Middle + 1;
+    } else if (DirIndex->NameCrc[Middle] > NameCrc) {
+      High = Middle;
+    } else {
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+/**
+
+  Drop the name index of the directory because its names are changing.
+
+  @param  ODir                  - The directory.
+
+**/
+VOID
+FatDropDirIndex (
+  IN FAT_ODIR  *ODir
+  )
+{
+  if (ODir->NameIndex != NULL) {
+    FreePool (ODir->NameIndex);
+    ODir->NameIndex = NULL;
+  }
+}
+
+/**
+
+  Keep the name index of a directory that falls out of the directory cache.
+  The least recently evicted indexes are dropped beyond PcdFatDirIndexCacheMaxCount
+  indexes or PcdFatDirIndexCacheMaxSize bytes.
+
+  @param  Volume                - FAT file system volume.
+  @param  ODir                  - The directory being evicted.
+
+**/
+STATIC
+VOID
+FatSaveDirIndex (
+  IN FAT_VOLUME  *Volume,
+  IN FAT_ODIR    *ODir
+  )
+{
+  FAT_DIR_INDEX  *DirIndex;
+
+  DirIndex = ODir->NameIndex;
+  if ((DirIndex == NULL) && ODir->EndOfDir) {
+    DirIndex = FatCreateDirIndex (ODir);
+  }
+
+  ODir->NameIndex = NULL;
+  if (DirIndex == NULL) {
+    return;
+  }
+
+  DirIndex->DirCacheTag = ODir->DirCacheTag;
+  InsertHeadList (&Volume->DirIndexList, &DirIndex->Link);
+  Volume->DirIndexCount++;
+  Volume->DirIndexSize += FAT_DIR_INDEX_SIZE (DirIndex->Count);
+
+  while ((Volume->DirIndexCount > PcdGet32 (PcdFatDirIndexCacheMaxCount)) ||
+         (Volume->DirIndexSize > PcdGet32 (PcdFatDirIndexCacheMaxSize)))
+  {
+    DirIndex = DIRINDEX_FROM_LINK (Volume->DirIndexList.BackLink);
+    RemoveEntryList (&DirIndex->Link);
+    Volume->DirIndexCount--;
+    Volume->DirIndexSize -= FAT_DIR_INDEX_SIZE (DirIndex->Count);
+    FreePool (DirIndex);
+  }
+}
+
 /**
 
   Free the directory structure and release the memory.
@@ -37,6 +285,8 @@ FatFreeODir (
     FatFreeDirEnt (DirEnt);
   }
 
+  FatReleaseODirPreload (ODir);
+  FatDropDirIndex (ODir);
   FreePool (ODir);
 }
 
@@ -61,6 +311,7 @@ FatAllocateODir (
     // Initialize the directory entry list
     //
     ODir->Signature = FAT_ODIR_SIGNATURE;
+    ODir->CacheSize = sizeof (FAT_ODIR);
     InitializeListHead (&ODir->ChildList);
     ODir->CurrentCursor = &ODir->ChildList;
   }
@@ -72,6 +323,8 @@ FatAllocateODir (
 
   Discard the directory structure when an OFile will be freed.
   Volume will cache this directory if the OFile does not represent a deleted file.
+  The cache holds at most PcdFatDirCacheMaxCount directories taking at most
+  PcdFatDirCacheMaxSize bytes; the least recently used directories are evicted.
 
   @param  OFile                 - The OFile whose directory structure is to be discarded.
 
@@ -86,32 +339,36 @@ FatDiscardODir (
 
   Volume = OFile->Volume;
   ODir   = OFile->ODir;
-  if (!OFile->DirEnt->Invalid) {
+  FatReleaseODirPreload (ODir);
+  if (OFile->DirEnt->Invalid) {
     //
-    // If OFile does not represent a deleted file, then we will cache the directory
-    // We use OFile's first cluster as the directory's tag
+    // Release ODir Structure
     //
-    ODir->DirCacheTag = OFile->FileCluster;
-    InsertHeadList (&Volume->DirCacheList, &ODir->DirCacheLink);
-    if (Volume->DirCacheCount == FAT_MAX_DIR_CACHE_COUNT) {
-      //
-      // Replace the least recent used directory
-      //
-      ODir = ODIR_FROM_DIRCACHELINK (Volume->DirCacheList.BackLink);
-      RemoveEntryList (&ODir->DirCacheLink);
-    } else {
-      //
-      // No need to find a replace
-      //
-      Volume->DirCacheCount++;
-      ODir = NULL;
-    }
+    FatFreeODir (ODir);
+    return;
   }
 
   //
-  // Release ODir Structure
+  // If OFile does not represent a deleted file, then we will cache the directory
+  // We use OFile's first cluster as the directory's tag
   //
-  if (ODir != NULL) {
+  ODir->DirCacheTag = OFile->FileCluster;
+  InsertHeadList (&Volume->DirCacheList, &ODir->DirCacheLink);
+  Volume->DirCacheCount++;
+  Volume->DirCacheSize += ODir->CacheSize;
+
+  //
+  // Replace the least recent used directories, keeping their names in the
+  // name index cache
+  //
+  while ((Volume->DirCacheCount > PcdGet32 (PcdFatDirCacheMaxCount)) ||
+         ((Volume->DirCacheCount > 0) && (Volume->DirCacheSize > PcdGet32 (PcdFatDirCacheMaxSize))))
+  {
+    ODir = ODIR_FROM_DIRCACHELINK (Volume->DirCacheList.BackLink);
+    RemoveEntryList (&ODir->DirCacheLink);
+    Volume->DirCacheCount--;
+    Volume->DirCacheSize -= ODir->CacheSize;
+    FatSaveDirIndex (Volume, ODir);
     FatFreeODir (ODir);
   }
 }
@@ -121,7 +378,8 @@ FatDiscardODir (
 
   Request the directory structure when an OFile is newly generated.
   If the directory structure is cached by volume, then just return this directory;
-  Otherwise, allocate a new one for OFile.
+  Otherwise, allocate a new one for OFile, with the name index of the directory
+  if one was kept when it was evicted.
 
   @param  OFile                 - The OFile which requests directory structure.
 
@@ -131,11 +389,12 @@ FatRequestODir (
   IN FAT_OFILE  *OFile
   )
 {
-  UINTN       DirCacheTag;
-  FAT_VOLUME  *Volume;
-  FAT_ODIR    *ODir;
-  FAT_ODIR    *CurrentODir;
-  LIST_ENTRY  *CurrentODirLink;
+  UINTN          DirCacheTag;
+  FAT_VOLUME     *Volume;
+  FAT_ODIR       *ODir;
+  FAT_ODIR       *CurrentODir;
+  LIST_ENTRY     *CurrentODirLink;
+  FAT_DIR_INDEX  *DirIndex;
 
   Volume      = OFile->Volume;
   ODir        = NULL;
@@ -149,7 +408,8 @@ FatRequestODir (
     if (CurrentODir->DirCacheTag == DirCacheTag) {
       RemoveEntryList (&CurrentODir->DirCacheLink);
       Volume->DirCacheCount--;
-      ODir = CurrentODir;
+      Volume->DirCacheSize -= CurrentODir->CacheSize;
+      ODir                  = CurrentODir;
       break;
     }
   }
@@ -159,6 +419,26 @@ FatRequestODir (
     // This directory is not cached, then allocate a new one
     //
     ODir = FatAllocateODir (OFile);
+
+    for (CurrentODirLink  = Volume->DirIndexList.ForwardLink;
+         CurrentODirLink != &Volume->DirIndexList;
+         CurrentODirLink  = CurrentODirLink->ForwardLink
+         )
+    {
+      DirIndex = DIRINDEX_FROM_LINK (CurrentODirLink);
+      if (DirIndex->DirCacheTag == DirCacheTag) {
+        RemoveEntryList (&DirIndex->Link);
+        Volume->DirIndexCount--;
+        Volume->DirIndexSize -= FAT_DIR_INDEX_SIZE (DirIndex->Count);
+        if (ODir != NULL) {
+          ODir->NameIndex = DirIndex;
+        } else {
+          FreePool (DirIndex);
+        }
+
+        break;
+      }
+    }
   }
 
   OFile->ODir = ODir;
@@ -176,7 +456,8 @@ FatCleanupODirCache (
   IN FAT_VOLUME  *Volume
   )
 {
-  FAT_ODIR  *ODir;
+  FAT_ODIR       *ODir;
+  FAT_DIR_INDEX  *DirIndex;
 
   while (Volume->DirCacheCount > 0) {
     ODir = ODIR_FROM_DIRCACHELINK (Volume->DirCacheList.BackLink);
@@ -184,4 +465,15 @@ FatCleanupODirCache (
     FatFreeODir (ODir);
     Volume->DirCacheCount--;
   }
+
+  Volume->DirCacheSize = 0;
+
+  while (Volume->DirIndexCount > 0) {
+    DirIndex = DIRINDEX_FROM_LINK (Volume->DirIndexList.BackLink);
+    RemoveEntryList (&DirIndex->Link);
+    FreePool (DirIndex);
+    Volume->DirIndexCount--;
+  }
+
+  Volume->DirIndexSize = 0;
 }
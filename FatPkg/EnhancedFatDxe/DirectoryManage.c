@@ -30,8 +30,10 @@ FatAccessEntry (
   IN OUT VOID       *Entry
   )
 {
-  UINTN  Position;
-  UINTN  BufferSize;
+  UINTN       Position;
+  UINTN       BufferSize;
+  FAT_ODIR    *ODir;
+  EFI_STATUS  Status;
 
   Position = EntryPos * sizeof (FAT_DIRECTORY_ENTRY);
   if (Position >= Parent->FileSize) {
@@ -45,7 +47,23 @@ FatAccessEntry (
   }
 
   BufferSize = sizeof (FAT_DIRECTORY_ENTRY);
-  return FatAccessOFile (Parent, IoMode, Position, &BufferSize, Entry, NULL);
+  ODir       = Parent->ODir;
+  if ((ODir != NULL) && (Position + BufferSize <= ODir->PreloadSize)) {
+    if (IoMode == ReadData) {
+      CopyMem (Entry, ODir->PreloadBuffer + Position, BufferSize);
+      return EFI_SUCCESS;
+    }
+  }
+
+  Status = FatAccessOFile (Parent, IoMode, Position, &BufferSize, Entry, NULL);
+  if (!EFI_ERROR (Status) && (ODir != NULL) && (Position + BufferSize <= ODir->PreloadSize)) {
+    //
+    // Keep the preloaded copy of the directory up to date
+    //
+    CopyMem (ODir->PreloadBuffer + Position, Entry, BufferSize);
+  }
+
+  return Status;
 }
 
 /**
@@ -326,6 +344,7 @@ FatAddDirEnt (
 
   InsertTailList (DirEnt->Link.BackLink, &DirEnt->Link);
   FatInsertToHashTable (ODir, DirEnt);
+  ODir->CacheSize += sizeof (FAT_DIRENT) + StrSize (DirEnt->FileString);
 }
 
 /**
@@ -363,6 +382,11 @@ FatLoadNextDirEnt (
   ASSERT (!ODir->EndOfDir);
   DirEnt = NULL;
 
+  //
+  // Read the rest of the directory with one access on the first load
+  //
+  FatPreloadODir (OFile);
+
   for ( ; ;) {
     //
     // Read the next directory entry until we find a valid directory entry (excluding lfn entry)
@@ -421,6 +445,7 @@ FatLoadNextDirEnt (
     ODir->CurrentEndPos++;
   } else {
     ODir->EndOfDir = TRUE;
+    FatReleaseODirPreload (ODir);
   }
 
   *PtrDirEnt = DirEnt;
@@ -535,6 +560,19 @@ FatSearchODir (
     DirEnt = *FatShortNameHashSearch (ODir, File8Dot3Name);
   }
 
+  if ((DirEnt == NULL) && !ODir->EndOfDir) {
+    //
+    // The name index of an earlier, fully loaded instance of this directory
+    // tells if the name is not in the directory at all
+    //
+    if (!FatDirIndexMayContain (ODir, FatLongNameCrc (FileNameString)) &&
+        !(PossibleShortName && FatDirIndexMayContain (ODir, FatShortNameCrc (File8Dot3Name))))
+    {
+      *PtrDirEnt = NULL;
+      return EFI_SUCCESS;
+    }
+  }
+
   if (DirEnt == NULL) {
     //
     // We fail to get the directory entry from hash table; we then
@@ -1051,6 +1089,19 @@ FatCreateDirEnt (
   ASSERT (OFile != NULL);
   ODir = OFile->ODir;
   ASSERT (ODir != NULL);
+
+  //
+  // The 8.3 name generation needs all the names of the directory, which a
+  // lookup answered by the name index may not have loaded
+  //
+  FatDropDirIndex (ODir);
+  while (!ODir->EndOfDir) {
+    Status = FatLoadNextDirEnt (OFile, &DirEnt);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
   DirEnt = AllocateZeroPool (sizeof (FAT_DIRENT));
   if (DirEnt == NULL) {
     return EFI_OUT_OF_RESOURCES;
@@ -1106,6 +1157,7 @@ FatRemoveDirEnt (
   FAT_ODIR  *ODir;
 
   ODir = OFile->ODir;
+  FatDropDirIndex (ODir);
   if (ODir->CurrentCursor == &DirEnt->Link) {
     //
     // Move the directory cursor to its previous directory entry
@@ -1121,6 +1173,7 @@ FatRemoveDirEnt (
   // Remove from hash table
   //
   FatDeleteFromHashTable (ODir, DirEnt);
+  ODir->CacheSize          -= sizeof (FAT_DIRENT) + StrSize (DirEnt->FileString);
   DirEnt->Entry.FileName[0] = DELETE_ENTRY_MARK;
   DirEnt->Invalid           = TRUE;
   return FatStoreDirEnt (OFile, DirEnt);
@@ -1234,6 +1287,10 @@ FatCloseDirEnt (
     RemoveEntryList (&OFile->ChildLink);
   }
 
+  if (OFile->Extents != NULL) {
+    FreePool (OFile->Extents);
+  }
+
   FreePool (OFile);
   DirEnt->OFile = NULL;
   if (DirEnt->Invalid == TRUE) {
@@ -208,6 +208,271 @@ CacheFatDiskIo (
   return Status;
 }
 
+/**
+
+  Return the address of the cache page held by a Cache Tag.
+
+  @param  DiskCache             - The disk cache.
+  @param  CacheTag              - The Cache Tag.
+
+  @return The address of the cache page.
+
+**/
+STATIC
+UINT8 *
+FatCachePageAddress (
+  IN DISK_CACHE  *DiskCache,
+  IN CACHE_TAG   *CacheTag
+  )
+{
+  return DiskCache->CacheBase + ((UINTN)(CacheTag - DiskCache->CacheTag) << DiskCache->PageAlignment);
+}
+
+/**
+
+  Look up the Cache Tag that holds PageNo.
+
+  @param  DiskCache             - The disk cache.
+  @param  PageNo                - The page to look up.
+
+  @return The Cache Tag of the page, or NULL if the page is not in the cache.
+
+**/
+STATIC
+CACHE_TAG *
+FatFindCacheTag (
+  IN DISK_CACHE  *DiskCache,
+  IN UINTN       PageNo
+  )
+{
+  CACHE_TAG  *CacheTag;
+  UINTN      Way;
+
+  CacheTag = &DiskCache->CacheTag[(PageNo & DiskCache->SetMask) * DiskCache->WayCount];
+  for (Way = 0; Way < DiskCache->WayCount; Way++, CacheTag++) {
+    if ((CacheTag->PageNo == PageNo) && (CacheTag->RealSize > 0)) {
+      return CacheTag;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+
+  Choose the Cache Tag to replace for PageNo: an unused way of its set if there is
+  one, otherwise the least recently used way.
+
+  @param  DiskCache             - The disk cache.
+  @param  PageNo                - The page to be loaded.
+  @param  Clean                 - Only consider ways that can be replaced without any
+                                  disk access, i.e. that are not dirty.
+
+  @return The Cache Tag to replace, or NULL if Clean is TRUE and no way qualifies.
+
+**/
+STATIC
+CACHE_TAG *
+FatGetVictimCacheTag (
+  IN DISK_CACHE  *DiskCache,
+  IN UINTN       PageNo,
+  IN BOOLEAN     Clean
+  )
+{
+  CACHE_TAG  *CacheTag;
+  CACHE_TAG  *Victim;
+  UINTN      Way;
+
+  Victim   = NULL;
+  CacheTag = &DiskCache->CacheTag[(PageNo & DiskCache->SetMask) * DiskCache->WayCount];
+  for (Way = 0; Way < DiskCache->WayCount; Way++, CacheTag++) {
+    if (CacheTag->RealSize == 0) {
+      return CacheTag;
+    }
+
+    if (Clean && CacheTag->Dirty) {
+      continue;
+    }
+
+    if ((Victim == NULL) || (CacheTag->LastUse < Victim->LastUse)) {
+      Victim = CacheTag;
+    }
+  }
+
+  return Victim;
+}
+
+/**
+
+  Read a run of consecutive data pages from the disk in a single request and
+  load them into the data cache. Pages that only find dirty ways in their set
+  are dropped.
+
+  @param  Volume                - FAT file system volume.
+  @param  PageNo                - The first page of the run.
+  @param  PageCount             - The number of pages of the run.
+
+  @retval EFI_SUCCESS           - The pages were read.
+  @retval EFI_END_OF_MEDIA      - The run starts beyond the end of the data region.
+  @return Others                - An error occurred when reading the disk.
+
+**/
+STATIC
+EFI_STATUS
+FatReadAheadPages (
+  IN FAT_VOLUME  *Volume,
+  IN UINTN       PageNo,
+  IN UINTN       PageCount
+  )
+{
+  EFI_STATUS  Status;
+  DISK_CACHE  *DiskCache;
+  CACHE_TAG   *CacheTag;
+  UINT64      EntryPos;
+  UINT64      MaxSize;
+  UINTN       Size;
+  UINTN       RealSize;
+  UINTN       Index;
+  UINT8       PageAlignment;
+
+  DiskCache     = &Volume->DiskCache[CacheData];
+  PageAlignment = DiskCache->PageAlignment;
+  EntryPos      = DiskCache->BaseAddress + LShiftU64 (PageNo, PageAlignment);
+  if (EntryPos >= DiskCache->LimitAddress) {
+    return EFI_END_OF_MEDIA;
+  }
+
+  Size    = PageCount << PageAlignment;
+  MaxSize = DiskCache->LimitAddress - EntryPos;
+  if (MaxSize < Size) {
+    Size = (UINTN)MaxSize;
+  }
+
+  Status = FatDiskIo (Volume, ReadDisk, EntryPos, Size, DiskCache->ReadAheadBuffer, NULL);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  for (Index = 0; Size > 0; Index++) {
+    RealSize = MIN (Size, (UINTN)1 << PageAlignment);
+    Size    -= RealSize;
+
+    CacheTag = FatGetVictimCacheTag (DiskCache, PageNo + Index, TRUE);
+    if (CacheTag == NULL) {
+      continue;
+    }
+
+    if (CacheTag->RealSize > 0) {
+      DiskCache->EvictionCount++;
+    }
+
+    CopyMem (
+      FatCachePageAddress (DiskCache, CacheTag),
+      DiskCache->ReadAheadBuffer + (Index << PageAlignment),
+      RealSize
+      );
+    ClearCacheTagDirtyState (CacheTag);
+    CacheTag->PageNo   = PageNo + Index;
+    CacheTag->RealSize = RealSize;
+    CacheTag->LastUse  = ++DiskCache->UseStamp;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+
+  Detect sequential reads of the data region.
+
+  The read-ahead window starts at FAT_READ_AHEAD_MIN_PAGES pages when a read
+  continues the previous one and doubles on every further sequential read, up
+  to ReadAheadMaxWindow. Any read that does not start on the last page read or
+  on the next one closes the window.
+
+  @param  DiskCache             - The data cache.
+  @param  StartPageNo           - The first page of the read.
+  @param  EndPageNo             - The last page of the read.
+
+  @retval TRUE                  - The read continues a sequential stream.
+  @retval FALSE                 - The read does not advance a sequential stream.
+
+**/
+STATIC
+BOOLEAN
+FatTrackSequentialRead (
+  IN DISK_CACHE  *DiskCache,
+  IN UINTN       StartPageNo,
+  IN UINTN       EndPageNo
+  )
+{
+  UINTN  LastPageNo;
+
+  LastPageNo = DiskCache->ReadAheadLastPageNo;
+  if ((DiskCache->ReadAheadMaxWindow == 0) || ((StartPageNo == LastPageNo) && (EndPageNo == LastPageNo))) {
+    return FALSE;
+  }
+
+  DiskCache->ReadAheadLastPageNo = EndPageNo;
+  if ((StartPageNo != LastPageNo) && (StartPageNo != LastPageNo + 1)) {
+    DiskCache->ReadAheadWindow     = 0;
+    DiskCache->ReadAheadNextPageNo = 0;
+    return FALSE;
+  }
+
+  DiskCache->ReadAheadWindow = MIN (
+                                 MAX (DiskCache->ReadAheadWindow * 2, FAT_READ_AHEAD_MIN_PAGES),
+                                 DiskCache->ReadAheadMaxWindow
+                                 );
+  return TRUE;
+}
+
+/**
+
+  Load a sequentially read data page into the data cache together with the
+  read-ahead window that follows it.
+
+  The pages missing from the cache are read with one disk request per run of
+  consecutive pages, instead of one request per page as the reader reaches
+  them. Read-ahead never evicts a dirty page.
+
+  @param  Volume                - FAT file system volume.
+  @param  PageNo                - The page about to be read through the cache.
+
+**/
+STATIC
+VOID
+FatReadAhead (
+  IN FAT_VOLUME  *Volume,
+  IN UINTN       PageNo
+  )
+{
+  EFI_STATUS  Status;
+  DISK_CACHE  *DiskCache;
+  UINTN       EndPageNo;
+  UINTN       RunEndPageNo;
+
+  DiskCache = &Volume->DiskCache[CacheData];
+  EndPageNo = PageNo + DiskCache->ReadAheadWindow;
+  for (PageNo = MAX (PageNo, DiskCache->ReadAheadNextPageNo); PageNo <= EndPageNo; PageNo = RunEndPageNo) {
+    RunEndPageNo = PageNo;
+    while ((RunEndPageNo <= EndPageNo) && (FatFindCacheTag (DiskCache, RunEndPageNo) == NULL)) {
+      RunEndPageNo++;
+    }
+
+    if (RunEndPageNo == PageNo) {
+      RunEndPageNo++;
+      continue;
+    }
+
+    Status = FatReadAheadPages (Volume, PageNo, RunEndPageNo - PageNo);
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+  }
+
+  DiskCache->ReadAheadNextPageNo = PageNo;
+}
+
 /**
 
   This function is used by the Data Cache.
@@ -238,43 +503,40 @@ FatFlushDataCacheRange (
   )
 {
   UINTN       PageNo;
-  UINTN       GroupNo;
-  UINTN       GroupMask;
   UINTN       PageSize;
   UINT8       PageAlignment;
   DISK_CACHE  *DiskCache;
   CACHE_TAG   *CacheTag;
-  UINT8       *BaseAddress;
 
   DiskCache     = &Volume->DiskCache[CacheData];
-  BaseAddress   = DiskCache->CacheBase;
-  GroupMask     = DiskCache->GroupMask;
   PageAlignment = DiskCache->PageAlignment;
   PageSize      = (UINTN)1 << PageAlignment;
 
   for (PageNo = StartPageNo; PageNo < EndPageNo; PageNo++) {
-    GroupNo  = PageNo & GroupMask;
-    CacheTag = &DiskCache->CacheTag[GroupNo];
-    if ((CacheTag->RealSize > 0) && (CacheTag->PageNo == PageNo)) {
+    CacheTag = FatFindCacheTag (DiskCache, PageNo);
+    if (CacheTag == NULL) {
+      continue;
+    }
+
+    //
+    // When reading data from disk directly, if some dirty data
+    // in cache is in this range, this data in the Buffer needs to
+    // be updated with the cache's dirty data.
+    //
+    if (IoMode == ReadDisk) {
+      if ((CacheTag->RealSize > 0) && CacheTag->Dirty) {
+        CopyMem (
+          Buffer + ((PageNo - StartPageNo) << PageAlignment),
+          FatCachePageAddress (DiskCache, CacheTag),
+          PageSize
+          );
+      }
+    } else {
       //
-      // When reading data from disk directly, if some dirty data
-      // in cache is in this range, this data in the Buffer needs to
-      // be updated with the cache's dirty data.
+      // Make all valid entries in this range invalid.
       //
-      if (IoMode == ReadDisk) {
-        if (CacheTag->Dirty) {
-          CopyMem (
-            Buffer + ((PageNo - StartPageNo) << PageAlignment),
-            BaseAddress + (GroupNo << PageAlignment),
-            PageSize
-            );
-        }
-      } else {
-        //
-        // Make all valid entries in this range invalid.
-        //
-        CacheTag->RealSize = 0;
-      }
+      ClearCacheTagDirtyState (CacheTag);
+      CacheTag->RealSize = 0;
     }
   }
 }
@@ -304,7 +566,6 @@ FatExchangeCachePage (
   )
 {
   EFI_STATUS  Status;
-  UINTN       GroupNo;
   UINTN       PageNo;
   UINTN       WriteCount;
   UINTN       RealSize;
@@ -316,9 +577,8 @@ FatExchangeCachePage (
 
   DiskCache     = &Volume->DiskCache[DataType];
   PageNo        = CacheTag->PageNo;
-  GroupNo       = PageNo & DiskCache->GroupMask;
   PageAlignment = DiskCache->PageAlignment;
-  PageAddress   = DiskCache->CacheBase + (GroupNo << PageAlignment);
+  PageAddress   = FatCachePageAddress (DiskCache, CacheTag);
   EntryPos      = (DiskCache->BaseAddress + LShiftU64 (PageNo, PageAlignment));
   RealSize      = CacheTag->RealSize;
   if (IoMode == ReadDisk) {
@@ -356,6 +616,8 @@ FatExchangeCachePage (
 
   Get one cache page by specified PageNo.
 
+  On a miss the page replaces the least recently used page of its set.
+
   @param  Volume                - FAT file system volume.
   @param  CacheDataType         - The cache type: CACHE_FAT or CACHE_DATA.
   @param  PageNo                - PageNo to match with the cache.
@@ -368,38 +630,52 @@ FatExchangeCachePage (
 STATIC
 EFI_STATUS
 FatGetCachePage (
-  IN FAT_VOLUME       *Volume,
-  IN CACHE_DATA_TYPE  CacheDataType,
-  IN UINTN            PageNo,
-  IN CACHE_TAG        *CacheTag
+  IN  FAT_VOLUME       *Volume,
+  IN  CACHE_DATA_TYPE  CacheDataType,
+  IN  UINTN            PageNo,
+  OUT CACHE_TAG        **CacheTag
   )
 {
   EFI_STATUS  Status;
-  UINTN       OldPageNo;
+  DISK_CACHE  *DiskCache;
+  CACHE_TAG   *Tag;
 
-  OldPageNo = CacheTag->PageNo;
-  if ((CacheTag->RealSize > 0) && (OldPageNo == PageNo)) {
+  DiskCache = &Volume->DiskCache[CacheDataType];
+  Tag       = FatFindCacheTag (DiskCache, PageNo);
+  if (Tag != NULL) {
     //
     // Cache Hit occurred
     //
+    DiskCache->HitCount++;
+    Tag->LastUse = ++DiskCache->UseStamp;
+    *CacheTag    = Tag;
     return EFI_SUCCESS;
   }
 
-  //
-  // Write dirty cache page back to disk
-  //
-  if ((CacheTag->RealSize > 0) && CacheTag->Dirty) {
-    Status = FatExchangeCachePage (Volume, CacheDataType, WriteDisk, CacheTag, NULL);
-    if (EFI_ERROR (Status)) {
-      return Status;
+  Tag = FatGetVictimCacheTag (DiskCache, PageNo, FALSE);
+  DiskCache->MissCount++;
+  if (Tag->RealSize > 0) {
+    DiskCache->EvictionCount++;
+
+    //
+    // Write dirty cache page back to disk
+    //
+    if (Tag->Dirty) {
+      Status = FatExchangeCachePage (Volume, CacheDataType, WriteDisk, Tag, NULL);
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
     }
   }
 
   //
   // Load new data from disk;
   //
-  CacheTag->PageNo = PageNo;
-  Status           = FatExchangeCachePage (Volume, CacheDataType, ReadDisk, CacheTag, NULL);
+  Tag->PageNo   = PageNo;
+  Tag->RealSize = 0;
+  Tag->LastUse  = ++DiskCache->UseStamp;
+  *CacheTag     = Tag;
+  Status        = FatExchangeCachePage (Volume, CacheDataType, ReadDisk, Tag, NULL);
 
   return Status;
 }
@@ -438,14 +714,15 @@ FatAccessUnalignedCachePage (
   VOID        *Destination;
   DISK_CACHE  *DiskCache;
   CACHE_TAG   *CacheTag;
-  UINTN       GroupNo;
 
   DiskCache = &Volume->DiskCache[CacheDataType];
-  GroupNo   = PageNo & DiskCache->GroupMask;
-  CacheTag  = &DiskCache->CacheTag[GroupNo];
-  Status    = FatGetCachePage (Volume, CacheDataType, PageNo, CacheTag);
+  if ((CacheDataType == CacheData) && (IoMode == ReadDisk) && FatTrackSequentialRead (DiskCache, PageNo, PageNo)) {
+    FatReadAhead (Volume, PageNo);
+  }
+
+  Status = FatGetCachePage (Volume, CacheDataType, PageNo, &CacheTag);
   if (!EFI_ERROR (Status)) {
-    Source      = DiskCache->CacheBase + (GroupNo << DiskCache->PageAlignment) + Offset;
+    Source      = FatCachePageAddress (DiskCache, CacheTag) + Offset;
     Destination = Buffer;
     if (IoMode != ReadDisk) {
       SetCacheTagDirty (DiskCache, CacheTag, Offset, Length);
@@ -562,6 +839,10 @@ FatAccessCache (
     // to be updated.
     //
     FatFlushDataCacheRange (Volume, IoMode, PageNo, OverRunPageNo, Buffer);
+    if (IoMode == ReadDisk) {
+      FatTrackSequentialRead (DiskCache, PageNo, OverRunPageNo - 1);
+    }
+
     Buffer     += AlignedSize;
     BufferSize -= AlignedSize;
   }
@@ -599,8 +880,7 @@ FatVolumeFlushCache (
 {
   EFI_STATUS       Status;
   CACHE_DATA_TYPE  CacheDataType;
-  UINTN            GroupIndex;
-  UINTN            GroupMask;
+  UINTN            Index;
   DISK_CACHE       *DiskCache;
   CACHE_TAG        *CacheTag;
 
@@ -610,9 +890,8 @@ FatVolumeFlushCache (
       //
       // Data cache or fat cache is dirty, write the dirty data back
       //
-      GroupMask = DiskCache->GroupMask;
-      for (GroupIndex = 0; GroupIndex <= GroupMask; GroupIndex++) {
-        CacheTag = &DiskCache->CacheTag[GroupIndex];
+      for (Index = 0; Index < DiskCache->PageCount; Index++) {
+        CacheTag = &DiskCache->CacheTag[Index];
         if ((CacheTag->RealSize > 0) && CacheTag->Dirty) {
           //
           // Write back all Dirty Data Cache Page to disk
@@ -635,6 +914,117 @@ FatVolumeFlushCache (
   return Status;
 }
 
+/**
+
+  Free the disk cache of the volume and report its statistics.
+
+  @param  Volume                - FAT file system volume.
+
+**/
+VOID
+FatFreeDiskCache (
+  IN FAT_VOLUME  *Volume
+  )
+{
+  CACHE_DATA_TYPE  CacheDataType;
+  DISK_CACHE       *DiskCache;
+
+  for (CacheDataType = (CACHE_DATA_TYPE)0; CacheDataType < CacheMaxType; CacheDataType++) {
+    DiskCache = &Volume->DiskCache[CacheDataType];
+    if (DiskCache->PageCount > 0) {
+      DEBUG ((
+        DEBUG_INFO,
+        "FatFreeDiskCache: %a cache %Lu pages, %Lu hits, %Lu misses, %Lu evictions\n",
+        (CacheDataType == CacheFat) ? "FAT" : "Data",
+        (UINT64)DiskCache->PageCount,
+        DiskCache->HitCount,
+        DiskCache->MissCount,
+        DiskCache->EvictionCount
+        ));
+    }
+
+    if (DiskCache->CacheTag != NULL) {
+      FreePool (DiskCache->CacheTag);
+    }
+  }
+
+  if (Volume->CacheBuffer != NULL) {
+    FreePool (Volume->CacheBuffer);
+  }
+}
+
+/**
+
+  Size the data cache from the free memory of the system, within the
+  PcdFatDataCacheMaxSize limit.
+
+  @param  PageAlignment         - The page alignment of the data cache.
+
+  @return The number of data cache pages, a power of two between
+          FAT_DATACACHE_MIN_PAGE_COUNT and FAT_DATACACHE_MAX_PAGE_COUNT.
+
+**/
+STATIC
+UINTN
+FatGetDataCachePageCount (
+  IN UINT8  PageAlignment
+  )
+{
+  EFI_STATUS             Status;
+  EFI_MEMORY_DESCRIPTOR  *MemoryMap;
+  EFI_MEMORY_DESCRIPTOR  *Entry;
+  UINTN                  MemoryMapSize;
+  UINTN                  MapKey;
+  UINTN                  DescriptorSize;
+  UINT32                 DescriptorVersion;
+  UINT64                 FreePages;
+  UINT64                 PageCount;
+  UINT64                 MaxPageCount;
+
+  MaxPageCount = RShiftU64 (PcdGet32 (PcdFatDataCacheMaxSize), PageAlignment);
+  if (MaxPageCount <= FAT_DATACACHE_MIN_PAGE_COUNT) {
+    return FAT_DATACACHE_MIN_PAGE_COUNT;
+  }
+
+  MaxPageCount  = MIN (MaxPageCount, FAT_DATACACHE_MAX_PAGE_COUNT);
+  MemoryMapSize = 0;
+  Status        = gBS->GetMemoryMap (&MemoryMapSize, NULL, &MapKey, &DescriptorSize, &DescriptorVersion);
+  if (Status != EFI_BUFFER_TOO_SMALL) {
+    return FAT_DATACACHE_MIN_PAGE_COUNT;
+  }
+
+  //
+  // Allocating the buffer may split a descriptor
+  //
+  MemoryMapSize += 2 * DescriptorSize;
+  MemoryMap      = AllocatePool (MemoryMapSize);
+  if (MemoryMap == NULL) {
+    return FAT_DATACACHE_MIN_PAGE_COUNT;
+  }
+
+  FreePages = 0;
+  Status    = gBS->GetMemoryMap (&MemoryMapSize, MemoryMap, &MapKey, &DescriptorSize, &DescriptorVersion);
+  if (!EFI_ERROR (Status)) {
+    for (Entry = MemoryMap;
+         (UINTN)Entry < (UINTN)MemoryMap + MemoryMapSize;
+         Entry = NEXT_MEMORY_DESCRIPTOR (Entry, DescriptorSize))
+    {
+      if (Entry->Type == EfiConventionalMemory) {
+        FreePages += Entry->NumberOfPages;
+      }
+    }
+  }
+
+  FreePool (MemoryMap);
+
+  PageCount = RShiftU64 (FreePages, FAT_DATACACHE_MEMORY_SHIFT + PageAlignment - EFI_PAGE_SHIFT);
+  if (PageCount <= FAT_DATACACHE_MIN_PAGE_COUNT) {
+    return FAT_DATACACHE_MIN_PAGE_COUNT;
+  }
+
+  return (UINTN)GetPowerOfTwo64 (MIN (PageCount, MaxPageCount));
+}
+
 /**
 
   Initialize the disk cache according to Volume's FatType.
@@ -652,8 +1042,10 @@ FatInitializeDiskCache (
 {
   DISK_CACHE  *DiskCache;
   UINTN       FatCacheGroupCount;
+  UINTN       DataCachePageCount;
   UINTN       DataCacheSize;
   UINTN       FatCacheSize;
+  UINTN       ReadAheadSize;
   UINT8       *CacheBuffer;
 
   DiskCache = Volume->DiskCache;
@@ -670,25 +1062,63 @@ FatInitializeDiskCache (
     DiskCache[CacheData].PageAlignment = FAT_DATACACHE_PAGE_MAX_ALIGNMENT;
   }
 
-  DiskCache[CacheData].GroupMask    = FAT_DATACACHE_GROUP_COUNT - 1;
+  DiskCache[CacheData].WayCount     = FAT_DATACACHE_WAY_COUNT;
   DiskCache[CacheData].BaseAddress  = Volume->RootPos;
   DiskCache[CacheData].LimitAddress = Volume->VolumeSize;
-  DiskCache[CacheFat].GroupMask     = FatCacheGroupCount - 1;
+  DiskCache[CacheFat].SetMask       = FatCacheGroupCount - 1;
+  DiskCache[CacheFat].WayCount      = 1;
   DiskCache[CacheFat].BaseAddress   = Volume->FatPos;
   DiskCache[CacheFat].LimitAddress  = Volume->FatPos + Volume->FatSize;
   FatCacheSize                      = FatCacheGroupCount << DiskCache[CacheFat].PageAlignment;
-  DataCacheSize                     = FAT_DATACACHE_GROUP_COUNT << DiskCache[CacheData].PageAlignment;
+
+  DiskCache[CacheFat].CacheTag = AllocateZeroPool (FatCacheGroupCount * sizeof (CACHE_TAG));
+  if (DiskCache[CacheFat].CacheTag == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  DiskCache[CacheFat].PageCount = FatCacheGroupCount;
+
   //
-  // Allocate the Fat Cache buffer
+  // A read-ahead reads the page being accessed and the window that follows it
+  // into a buffer placed after the data cache
   //
-  CacheBuffer = AllocateZeroPool (FatCacheSize + DataCacheSize);
+  DiskCache[CacheData].ReadAheadMaxWindow = MIN (PcdGet32 (PcdFatReadAheadMaxPages), FAT_READ_AHEAD_MAX_PAGES);
+  ReadAheadSize                           = 0;
+  if (DiskCache[CacheData].ReadAheadMaxWindow != 0) {
+    ReadAheadSize = (DiskCache[CacheData].ReadAheadMaxWindow + 1) << DiskCache[CacheData].PageAlignment;
+  }
+
+  //
+  // Allocate the Fat Cache buffer, shrink the data cache if memory is short
+  //
+  DataCachePageCount = FatGetDataCachePageCount (DiskCache[CacheData].PageAlignment);
+  do {
+    DataCacheSize = DataCachePageCount << DiskCache[CacheData].PageAlignment;
+    CacheBuffer   = AllocateZeroPool (FatCacheSize + DataCacheSize + ReadAheadSize);
+    if (CacheBuffer != NULL) {
+      DiskCache[CacheData].CacheTag = AllocateZeroPool (DataCachePageCount * sizeof (CACHE_TAG));
+      if (DiskCache[CacheData].CacheTag != NULL) {
+        break;
+      }
+
+      FreePool (CacheBuffer);
+      CacheBuffer = NULL;
+    }
+
+    DataCachePageCount /= 2;
+  } while (DataCachePageCount >= FAT_DATACACHE_MIN_PAGE_COUNT);
+
   if (CacheBuffer == NULL) {
     return EFI_OUT_OF_RESOURCES;
   }
 
-  Volume->CacheBuffer            = CacheBuffer;
-  DiskCache[CacheFat].CacheBase  = CacheBuffer;
-  DiskCache[CacheData].CacheBase = CacheBuffer + FatCacheSize;
+  DiskCache[CacheData].PageCount = DataCachePageCount;
+  DiskCache[CacheData].SetMask   = DataCachePageCount / FAT_DATACACHE_WAY_COUNT - 1;
+
+  Volume->CacheBuffer                  = CacheBuffer;
+  DiskCache[CacheFat].CacheBase        = CacheBuffer;
+  DiskCache[CacheData].CacheBase       = CacheBuffer + FatCacheSize;
+  DiskCache[CacheData].ReadAheadBuffer = CacheBuffer + FatCacheSize + DataCacheSize;
 
   DiskCache[CacheFat].BlockSize  = Volume->BlockIo->Media->BlockSize;
   DiskCache[CacheData].BlockSize = Volume->BlockIo->Media->BlockSize;
@@ -35,13 +35,14 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 //
 // The FAT signature
 //
-#define FAT_VOLUME_SIGNATURE   SIGNATURE_32 ('f', 'a', 't', 'v')
-#define FAT_IFILE_SIGNATURE    SIGNATURE_32 ('f', 'a', 't', 'i')
-#define FAT_ODIR_SIGNATURE     SIGNATURE_32 ('f', 'a', 't', 'd')
-#define FAT_DIRENT_SIGNATURE   SIGNATURE_32 ('f', 'a', 't', 'e')
-#define FAT_OFILE_SIGNATURE    SIGNATURE_32 ('f', 'a', 't', 'o')
-#define FAT_TASK_SIGNATURE     SIGNATURE_32 ('f', 'a', 't', 'T')
-#define FAT_SUBTASK_SIGNATURE  SIGNATURE_32 ('f', 'a', 't', 'S')
+#define FAT_VOLUME_SIGNATURE    SIGNATURE_32 ('f', 'a', 't', 'v')
+#define FAT_IFILE_SIGNATURE     SIGNATURE_32 ('f', 'a', 't', 'i')
+#define FAT_ODIR_SIGNATURE      SIGNATURE_32 ('f', 'a', 't', 'd')
+#define FAT_DIRENT_SIGNATURE    SIGNATURE_32 ('f', 'a', 't', 'e')
+#define FAT_OFILE_SIGNATURE     SIGNATURE_32 ('f', 'a', 't', 'o')
+#define FAT_TASK_SIGNATURE      SIGNATURE_32 ('f', 'a', 't', 'T')
+#define FAT_SUBTASK_SIGNATURE   SIGNATURE_32 ('f', 'a', 't', 'S')
+#define FAT_DIRINDEX_SIGNATURE  SIGNATURE_32 ('f', 'a', 't', 'x')
 
 #define ASSERT_VOLUME_LOCKED(a)  ASSERT_LOCKED (&FatFsLock)
 
@@ -55,6 +56,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #define ODIR_FROM_DIRCACHELINK(a)  CR (a, FAT_ODIR, DirCacheLink, FAT_ODIR_SIGNATURE)
 
+#define DIRINDEX_FROM_LINK(a)  CR (a, FAT_DIR_INDEX, Link, FAT_DIRINDEX_SIGNATURE)
+
 #define OFILE_FROM_CHECKLINK(a)  CR (a, FAT_OFILE, CheckLink, FAT_OFILE_SIGNATURE)
 
 #define OFILE_FROM_CHILDLINK(a)  CR (a, FAT_OFILE, ChildLink, FAT_OFILE_SIGNATURE)
@@ -80,10 +83,31 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define FAT_FATCACHE_PAGE_MAX_ALIGNMENT   15
 #define FAT_DATACACHE_PAGE_MIN_ALIGNMENT  13
 #define FAT_DATACACHE_PAGE_MAX_ALIGNMENT  16
-#define FAT_DATACACHE_GROUP_COUNT         64
 #define FAT_FATCACHE_GROUP_MIN_COUNT      1
 #define FAT_FATCACHE_GROUP_MAX_COUNT      16
 
+//
+// The data cache is set associative with LRU replacement inside a set, the FAT
+// cache is direct mapped. The data cache takes 1/2^FAT_DATACACHE_MEMORY_SHIFT of
+// the free memory when the volume is mounted, at most PcdFatDataCacheMaxSize bytes,
+// rounded down to a power of two number of pages between FAT_DATACACHE_MIN_PAGE_COUNT
+// and FAT_DATACACHE_MAX_PAGE_COUNT.
+//
+#define FAT_DATACACHE_WAY_COUNT       8
+#define FAT_DATACACHE_MIN_PAGE_COUNT  64
+#define FAT_DATACACHE_MAX_PAGE_COUNT  512
+#define FAT_DATACACHE_MEMORY_SHIFT    9
+
+//
+// Sequential reads through the data cache prefetch up to PcdFatReadAheadMaxPages
+// pages ahead, in the same disk request as the page being read. The window starts
+// at FAT_READ_AHEAD_MIN_PAGES and doubles on every further sequential read, and
+// never exceeds half of the smallest data cache so that the read-ahead cannot
+// evict the page that is being consumed.
+//
+#define FAT_READ_AHEAD_MIN_PAGES  2
+#define FAT_READ_AHEAD_MAX_PAGES  (FAT_DATACACHE_MIN_PAGE_COUNT / 2)
+
 // For cache block bits, use a UINT64
 typedef UINT64 DIRTY_BLOCKS;
 #define BITS_PER_BYTE         8
@@ -116,7 +140,8 @@ STATIC_ASSERT ((((1 << FAT_DATACACHE_PAGE_MAX_ALIGNMENT) / (1 << MIN_BLOCK_ALIGN
 #define LC_ISO_639_2_ENTRY_SIZE  3
 #define MAX_LANG_CODE_SIZE       100
 
-#define FAT_MAX_DIR_CACHE_COUNT  8
+#define FAT_MIN_EXTENT_COUNT     8
+#define FAT_MAX_EXTENT_COUNT     1024
 #define FAT_MAX_DIRENTRY_COUNT   0xFFFF
 typedef CHAR8 LC_ISO_639_2;
 
@@ -160,6 +185,7 @@ typedef struct {
   UINTN           RealSize;
   BOOLEAN         Dirty;
   DIRTY_BLOCKS    DirtyBlocks[DIRTY_BLOCKS_SIZE];
+  UINTN           LastUse;                    // DISK_CACHE.UseStamp at the last access, for LRU
 } CACHE_TAG;
 
 typedef struct {
@@ -169,8 +195,27 @@ typedef struct {
   UINT32       BlockSize;
   BOOLEAN      Dirty;
   UINT8        PageAlignment;
-  UINTN        GroupMask;
-  CACHE_TAG    CacheTag[FAT_DATACACHE_GROUP_COUNT];
+  UINTN        SetMask;
+  UINTN        WayCount;
+  UINTN        PageCount;                     // (SetMask + 1) * WayCount
+  CACHE_TAG    *CacheTag;                     // WayCount consecutive tags per set
+  UINTN        UseStamp;
+
+  //
+  // Statistics
+  //
+  UINT64       HitCount;
+  UINT64       MissCount;
+  UINT64       EvictionCount;
+
+  //
+  // Sequential access detection for the read-ahead
+  //
+  UINTN        ReadAheadMaxWindow;            // 0 if read-ahead is disabled for this cache
+  UINTN        ReadAheadWindow;               // Current window in pages, 0 if not sequential
+  UINTN        ReadAheadLastPageNo;           // Last page read through the cache
+  UINTN        ReadAheadNextPageNo;           // First page not yet covered by the read-ahead
+  UINT8        *ReadAheadBuffer;              // ReadAheadMaxWindow + 1 pages
 } DISK_CACHE;
 
 //
@@ -201,6 +246,21 @@ struct _FAT_DIRENT {
   FAT_DIRECTORY_ENTRY    Entry;                 // The physical directory entry stored in disk
 };
 
+//
+// The names of a fully loaded directory, kept after the directory falls out of
+// the directory cache so that lookups of names the directory does not contain
+// need not rescan it
+//
+typedef struct {
+  UINTN         Signature;
+  LIST_ENTRY    Link;                         // Linked in Volume->DirIndexList
+  UINTN         DirCacheTag;                  // The identification of the directory, as in FAT_ODIR
+  UINTN         Count;                        // The number of entries in NameCrc
+  UINT32        NameCrc[1];                   // Sorted CRC32 of the upcased long names and of the short names
+} FAT_DIR_INDEX;
+
+#define FAT_DIR_INDEX_SIZE(Count)  (OFFSET_OF (FAT_DIR_INDEX, NameCrc) + MAX ((Count), 1) * sizeof (UINT32))
+
 struct _FAT_ODIR {
   UINTN         Signature;
   UINT32        CurrentEndPos;                // Current end position of the directory
@@ -210,6 +270,11 @@ struct _FAT_ODIR {
   BOOLEAN       EndOfDir;                     // Indicate whether we have reached the end of the directory
   LIST_ENTRY    DirCacheLink;                 // Linked in Volume->DirCacheList when discarded
   UINTN         DirCacheTag;                  // The identification of the directory when in directory cache
+  UINTN         CacheSize;                    // Memory taken by the directory and its entries
+  FAT_DIR_INDEX *NameIndex;                   // Names of the directory when fully loaded before, or NULL
+  UINT8         *PreloadBuffer;               // The directory read in one piece while entries are being loaded
+  UINTN         PreloadSize;
+  BOOLEAN       Preloaded;                    // Whether the preload was attempted
   FAT_DIRENT    *LongNameHashTable[HASH_TABLE_SIZE];
   FAT_DIRENT    *ShortNameHashTable[HASH_TABLE_SIZE];
 };
@@ -243,6 +308,15 @@ typedef struct {
   LIST_ENTRY            Link;
 } FAT_SUBTASK;
 
+//
+// A run of physically contiguous clusters of an OFile
+//
+typedef struct {
+  UINTN    FileCluster;                       // Index of the first cluster of the run within the file
+  UINTN    DiskCluster;                       // First cluster of the run on the disk
+  UINTN    Count;                             // Number of clusters in the run
+} FAT_EXTENT;
+
 //
 // FAT_OFILE - Each opened file
 //
@@ -286,6 +360,14 @@ struct _FAT_OFILE {
   UINT64        PosDisk;        // on the disk
   UINTN         PosRem;         // remaining in this disk run
   //
+  // The cluster chain discovered so far, as runs of contiguous clusters
+  // covering the first ExtentClusters clusters of the file
+  //
+  FAT_EXTENT    *Extents;
+  UINTN         ExtentCount;
+  UINTN         ExtentCapacity;
+  UINTN         ExtentClusters;
+  //
   // The opened parent, full path length and currently opened child files
   //
   FAT_OFILE     *Parent;
@@ -383,6 +465,14 @@ struct _FAT_VOLUME {
   //
   LIST_ENTRY                         DirCacheList;
   UINTN                              DirCacheCount;
+  UINTN                              DirCacheSize;
+
+  //
+  // Name indexes of directories evicted from the directory cache
+  //
+  LIST_ENTRY                         DirIndexList;
+  UINTN                              DirIndexCount;
+  UINTN                              DirIndexSize;
 
   //
   // Disk Cache for this volume
@@ -783,6 +873,18 @@ FatVolumeFlushCache (
   IN FAT_TASK    *Task
   );
 
+/**
+
+  Free the disk cache of the volume and report its statistics.
+
+  @param  Volume                - FAT file system volume.
+
+**/
+VOID
+FatFreeDiskCache (
+  IN FAT_VOLUME  *Volume
+  );
+
 //
 // Flush.c
 //
@@ -1783,6 +1885,34 @@ FatSetVolumeEntry (
 // Hash.c
 //
 
+/**
+
+  Get the CRC32 of the upcased long name.
+
+  @param  LongNameString        - The long name string.
+
+  @return The CRC32 of the upcased long name.
+
+**/
+UINT32
+FatLongNameCrc (
+  IN CHAR16  *LongNameString
+  );
+
+/**
+
+  Get the CRC32 of the short name.
+
+  @param  ShortNameString       - The short name string.
+
+  @return The CRC32 of the short name.
+
+**/
+UINT32
+FatShortNameCrc (
+  IN CHAR8  *ShortNameString
+  );
+
 /**
 
   Search the long name hash table for the directory entry.
@@ -2021,6 +2151,60 @@ FatCleanupODirCache (
   IN FAT_VOLUME  *Volume
   );
 
+/**
+
+  Read the whole directory with one access, so that its entries are loaded
+  from memory instead of one entry at a time.
+
+  @param  OFile                 - The directory being loaded.
+
+**/
+VOID
+FatPreloadODir (
+  IN FAT_OFILE  *OFile
+  );
+
+/**
+
+  Free the preloaded copy of the directory.
+
+  @param  ODir                  - The directory.
+
+**/
+VOID
+FatReleaseODirPreload (
+  IN FAT_ODIR  *ODir
+  );
+
+/**
+
+  Check the name index of the directory for a name.
+
+  @param  ODir                  - The directory.
+  @param  NameCrc               - FatLongNameCrc or FatShortNameCrc of the name.
+
+  @retval TRUE                  - The directory has no name index, or the name may be in the directory.
+  @retval FALSE                 - The name is not in the directory.
+
+**/
+BOOLEAN
+FatDirIndexMayContain (
+  IN FAT_ODIR  *ODir,
+  IN UINT32    NameCrc
+  );
+
+/**
+
+  Drop the name index of the directory because its names are changing.
+
+  @param  ODir                  - The directory.
+
+**/
+VOID
+FatDropDirIndex (
+  IN FAT_ODIR  *ODir
+  );
+
 //
 // Global Variables
 //
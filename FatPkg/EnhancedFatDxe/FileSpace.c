@@ -341,6 +341,145 @@ FatSizeToClusters (
   return Clusters;
 }
 
+/**
+
+  Look up the extent of the OFile containing a cluster of the file.
+
+  @param  OFile                 - The open file.
+  @param  ClusterIndex          - The index of the cluster within the file.
+
+  @return The extent containing the cluster, or NULL if that part of the
+          cluster chain has not been recorded.
+
+**/
+STATIC
+FAT_EXTENT *
+FatLookupExtent (
+  IN FAT_OFILE  *OFile,
+  IN UINTN      ClusterIndex
+  )
+{
+  FAT_EXTENT  *Extent;
+  UINTN       Low;
+  UINTN       High;
+  UINTN       Middle;
+
+  Low  = 0;
+  High = OFile->ExtentCount;
+  while (Low < High) {
+    Middle = (Low + High) / 2;
+    Extent = &OFile->Extents[Middle];
+    if (ClusterIndex < Extent->FileCluster) {
+      High = Middle;
+    } else if (ClusterIndex >= Extent->FileCluster + Extent->Count) {
+      Low = Middle + 1;
+    } else {
+      return Extent;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+
+  Record one more cluster of the OFile's cluster chain. Only the cluster directly
+  following the recorded part of the chain is recorded, so the extents always
+  cover the start of the file without gaps. Recording stops silently once
+  FAT_MAX_EXTENT_COUNT extents are in use or memory runs out.
+
+  @param  OFile                 - The open file.
+  @param  ClusterIndex          - The index of the cluster within the file.
+  @param  Cluster               - The cluster on the disk.
+
+**/
+STATIC
+VOID
+FatAppendExtent (
+  IN FAT_OFILE  *OFile,
+  IN UINTN      ClusterIndex,
+  IN UINTN      Cluster
+  )
+{
+  FAT_EXTENT  *Extent;
+  FAT_EXTENT  *Extents;
+  UINTN       Capacity;
+
+  if (ClusterIndex != OFile->ExtentClusters) {
+    return;
+  }
+
+  if (OFile->ExtentCount > 0) {
+    Extent = &OFile->Extents[OFile->ExtentCount - 1];
+    if (Extent->DiskCluster + Extent->Count == Cluster) {
+      Extent->Count++;
+      OFile->ExtentClusters++;
+      return;
+    }
+  }
+
+  if (OFile->ExtentCount == OFile->ExtentCapacity) {
+    if (OFile->ExtentCapacity >= FAT_MAX_EXTENT_COUNT) {
+      return;
+    }
+
+    Capacity = MAX (OFile->ExtentCapacity * 2, FAT_MIN_EXTENT_COUNT);
+    Extents  = ReallocatePool (
+                 OFile->ExtentCapacity * sizeof (FAT_EXTENT),
+                 Capacity * sizeof (FAT_EXTENT),
+                 OFile->Extents
+                 );
+    if (Extents == NULL) {
+      return;
+    }
+
+    OFile->Extents        = Extents;
+    OFile->ExtentCapacity = Capacity;
+  }
+
+  Extent              = &OFile->Extents[OFile->ExtentCount];
+  Extent->FileCluster = ClusterIndex;
+  Extent->DiskCluster = Cluster;
+  Extent->Count       = 1;
+  OFile->ExtentCount++;
+  OFile->ExtentClusters++;
+}
+
+/**
+
+  Forget the recorded cluster chain of the OFile beyond its first ClusterCount clusters.
+
+  @param  OFile                 - The open file.
+  @param  ClusterCount          - The number of clusters to keep.
+
+**/
+STATIC
+VOID
+FatTruncateExtents (
+  IN FAT_OFILE  *OFile,
+  IN UINTN      ClusterCount
+  )
+{
+  FAT_EXTENT  *Extent;
+
+  while (OFile->ExtentCount > 0) {
+    Extent = &OFile->Extents[OFile->ExtentCount - 1];
+    if (Extent->FileCluster < ClusterCount) {
+      if (Extent->FileCluster + Extent->Count > ClusterCount) {
+        Extent->Count = ClusterCount - Extent->FileCluster;
+      }
+
+      break;
+    }
+
+    OFile->ExtentCount--;
+  }
+
+  if (OFile->ExtentClusters > ClusterCount) {
+    OFile->ExtentClusters = ClusterCount;
+  }
+}
+
 /**
 
   Shrink the end of the open file base on the file size.
@@ -366,6 +505,7 @@ FatShrinkEof (
   ASSERT_VOLUME_LOCKED (Volume);
 
   NewSize = FatSizeToClusters (Volume, OFile->FileSize);
+  FatTruncateExtents (OFile, NewSize);
 
   //
   // Find the address of the last cluster
@@ -550,6 +690,10 @@ Done:
   Seek OFile to requested position, and calculate the number of
   consecutive clusters from the position in the file
 
+  The part of the cluster chain that has been walked is kept in the OFile's
+  extents, so seeking within it is a binary search rather than a walk of
+  the FAT.
+
   @param  OFile                 - The open file.
   @param  Position              - The file's position which will be accessed.
   @param  PosLimit              - The maximum length current reading/writing may access
@@ -568,8 +712,11 @@ FatOFilePosition (
   FAT_VOLUME  *Volume;
   UINTN       ClusterSize;
   UINTN       Cluster;
+  UINTN       ClusterIndex;
   UINTN       StartPos;
   UINTN       Run;
+  UINTN       Count;
+  FAT_EXTENT  *Extent;
 
   Volume      = OFile->Volume;
   ClusterSize = Volume->ClusterSize;
@@ -603,20 +750,38 @@ FatOFilePosition (
       Cluster  = OFile->FileCluster;
     }
 
+    //
+    // Skip the part of the cluster chain that is already recorded
+    //
+    ClusterIndex = Position >> Volume->ClusterAlignment;
+    Extent       = FatLookupExtent (OFile, ClusterIndex);
+    if (Extent != NULL) {
+      StartPos = ClusterIndex << Volume->ClusterAlignment;
+      Cluster  = Extent->DiskCluster + ClusterIndex - Extent->FileCluster;
+    } else if ((OFile->ExtentCount > 0) && ((StartPos >> Volume->ClusterAlignment) < OFile->ExtentClusters)) {
+      Extent   = &OFile->Extents[OFile->ExtentCount - 1];
+      StartPos = (OFile->ExtentClusters - 1) << Volume->ClusterAlignment;
+      Cluster  = Extent->DiskCluster + Extent->Count - 1;
+    }
+
     while (StartPos + ClusterSize <= Position) {
-      StartPos += ClusterSize;
       if ((Cluster == FAT_CLUSTER_FREE) || (Cluster >= FAT_CLUSTER_SPECIAL)) {
         DEBUG ((DEBUG_INIT | DEBUG_ERROR, "FatOFilePosition:" " cluster chain corrupt\n"));
         return EFI_VOLUME_CORRUPTED;
       }
 
-      Cluster = FatGetFatEntry (Volume, Cluster);
+      FatAppendExtent (OFile, StartPos >> Volume->ClusterAlignment, Cluster);
+      StartPos += ClusterSize;
+      Cluster   = FatGetFatEntry (Volume, Cluster);
     }
 
     if ((Cluster < FAT_MIN_CLUSTER) || (Cluster > Volume->MaxCluster + 1)) {
       return EFI_VOLUME_CORRUPTED;
     }
 
+    ClusterIndex = StartPos >> Volume->ClusterAlignment;
+    FatAppendExtent (OFile, ClusterIndex, Cluster);
+
     OFile->PosDisk = Volume->FirstClusterPos +
                      LShiftU64 (Cluster - FAT_MIN_CLUSTER, Volume->ClusterAlignment) +
                      Position - StartPos;
@@ -628,9 +793,22 @@ FatOFilePosition (
     //
     Run = StartPos + ClusterSize - Position;
     if (!FAT_END_OF_FAT_CHAIN (Cluster)) {
-      while ((FatGetFatEntry (Volume, Cluster) == Cluster + 1) && Run < PosLimit) {
+      //
+      // Clusters in the same extent are contiguous without looking at the FAT
+      //
+      Extent = FatLookupExtent (OFile, ClusterIndex);
+      if ((Extent != NULL) && (Run < PosLimit)) {
+        Count = Extent->FileCluster + Extent->Count - 1 - ClusterIndex;
+        Count = MIN (Count, (PosLimit - Run + ClusterSize - 1) >> Volume->ClusterAlignment);
+        Run          += Count << Volume->ClusterAlignment;
+        Cluster      += Count;
+        ClusterIndex += Count;
+      }
+
+      while (Run < PosLimit && (FatGetFatEntry (Volume, Cluster) == Cluster + 1)) {
         Run     += ClusterSize;
         Cluster += 1;
+        FatAppendExtent (OFile, ++ClusterIndex, Cluster);
       }
     }
   }
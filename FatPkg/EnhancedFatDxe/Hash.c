@@ -10,16 +10,15 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 /**
 
-  Get hash value for long name.
+  Get the CRC32 of the upcased long name.
 
-  @param  LongNameString        - The long name string to be hashed.
+  @param  LongNameString        - The long name string.
 
-  @return HashValue.
+  @return The CRC32 of the upcased long name.
 
 **/
-STATIC
 UINT32
-FatHashLongName (
+FatLongNameCrc (
   IN CHAR16  *LongNameString
   )
 {
@@ -34,7 +33,45 @@ FatHashLongName (
     );
   FatStrUpr (UpCasedLongFileName);
   gBS->CalculateCrc32 (UpCasedLongFileName, StrSize (UpCasedLongFileName), &HashValue);
-  return (HashValue & HASH_TABLE_MASK);
+  return HashValue;
+}
+
+/**
+
+  Get hash value for long name.
+
+  @param  LongNameString        - The long name string to be hashed.
+
+  @return HashValue.
+
+**/
+STATIC
+UINT32
+FatHashLongName (
+  IN CHAR16  *LongNameString
+  )
+{
+  return (FatLongNameCrc (LongNameString) & HASH_TABLE_MASK);
+}
+
+/**
+
+  Get the CRC32 of the short name.
+
+  @param  ShortNameString       - The short name string.
+
+  @return The CRC32 of the short name.
+
+**/
+UINT32
+FatShortNameCrc (
+  IN CHAR8  *ShortNameString
+  )
+{
+  UINT32  HashValue;
+
+  gBS->CalculateCrc32 (ShortNameString, FAT_NAME_LEN, &HashValue);
+  return HashValue;
 }
 
 /**
@@ -52,10 +89,7 @@ FatHashShortName (
   IN CHAR8  *ShortNameString
   )
 {
-  UINT32  HashValue;
-
-  gBS->CalculateCrc32 (ShortNameString, FAT_NAME_LEN, &HashValue);
-  return (HashValue & HASH_TABLE_MASK);
+  return (FatShortNameCrc (ShortNameString) & HASH_TABLE_MASK);
 }
 
 /**
@@ -56,6 +56,7 @@ FatAllocateVolume (
   Volume->VolumeInterface.OpenVolume = FatOpenVolume;
   InitializeListHead (&Volume->CheckRef);
   InitializeListHead (&Volume->DirCacheList);
+  InitializeListHead (&Volume->DirIndexList);
   //
   // Initialize Root Directory entry
   //
@@ -464,9 +464,7 @@ FatFreeVolume (
   //
   // Free disk cache
   //
-  if (Volume->CacheBuffer != NULL) {
-    FreePool (Volume->CacheBuffer);
-  }
+  FatFreeDiskCache (Volume);
 
   //
   // Free directory cache
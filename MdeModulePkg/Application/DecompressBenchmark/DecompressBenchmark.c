@@ -0,0 +1,546 @@
+/** @file
+  A shell application that measures the decoding speed of the GUIDed sections
+  of firmware volume images.
+
+  Building the same FV image with each compression GUID (for example LZMA,
+  Brotli and Zstd) and passing all of them to the application compares the
+  decoders on identical input. Every GUIDed section found in the FFS files of
+  an image is decoded repeatedly through ExtractGuidedSectionLib, and the
+  results are summed per GUID.
+
+  Copyright (c) 2026, TianoCore and contributors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+#include <Pi/PiFirmwareVolume.h>
+#include <Pi/PiFirmwareFile.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/ExtractGuidedSectionLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/TimerLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/UefiLib.h>
+
+#include <Protocol/ShellParameters.h>
+#include <Protocol/Shell.h>
+
+#define MAJOR_VERSION  1
+#define MINOR_VERSION  0
+
+#define DEFAULT_ITERATIONS  10
+#define MAX_RESULTS         16
+
+typedef struct {
+  EFI_GUID    Guid;
+  UINTN       Sections;
+  UINT64      InputBytes;
+  UINT64      OutputBytes;
+  UINT64      Nanoseconds;
+} DECODE_RESULT;
+
+typedef struct {
+  EFI_GUID    *Guid;
+  CHAR16      *Name;
+} GUID_NAME;
+
+STATIC GUID_NAME  mGuidNames[] = {
+  { &gLzmaCustomDecompressGuid,        L"LZMA"        },
+  { &gLzmaF86CustomDecompressGuid,     L"LZMAF86"     },
+  { &gLzmaChunkedCustomDecompressGuid, L"LZMACHUNKED" },
+  { &gBrotliCustomDecompressGuid,      L"BROTLI"      },
+  { &gZstdCustomDecompressGuid,        L"ZSTD"        },
+};
+
+STATIC UINTN          mIterations = DEFAULT_ITERATIONS;
+STATIC DECODE_RESULT  mResults[MAX_RESULTS];
+STATIC UINTN          mResultCount;
+STATIC UINTN          mSkippedSections;
+STATIC UINT64         mCounterStart;
+STATIC UINT64         mCounterEnd;
+
+/**
+   Display current version.
+**/
+STATIC
+VOID
+ShowVersion (
+  VOID
+  )
+{
+  Print (L"DecompressBenchmark Version %d.%02d\n", MAJOR_VERSION, MINOR_VERSION);
+}
+
+/**
+   Display Usage and Help information.
+**/
+STATIC
+VOID
+ShowHelp (
+  VOID
+  )
+{
+  Print (L"Measure the decoding speed of the GUIDed sections of FV images.\n");
+  Print (L"\n");
+  Print (L"DecompressBenchmark [-n Iterations] FvFile [FvFile ...]\n");
+  Print (L"\n");
+  Print (L"  Iterations Number of times each section is decoded, %d by default.\n", DEFAULT_ITERATIONS);
+  Print (L"  FvFile     A firmware volume image. Build the same FV with each\n");
+  Print (L"             compression GUID to compare the decoders.\n");
+}
+
+/**
+  Read a file.
+
+  @param[in]  FileName        The file to be read.
+  @param[out] BufferSize      The file buffer size
+  @param[out] Buffer          The file buffer
+
+  @retval EFI_SUCCESS    Read file successfully
+  @retval EFI_NOT_FOUND  Shell protocol or file not found
+  @retval others         Read file failed
+**/
+STATIC
+EFI_STATUS
+ReadFileToBuffer (
+  IN  CHAR16  *FileName,
+  OUT UINTN   *BufferSize,
+  OUT VOID    **Buffer
+  )
+{
+  EFI_STATUS          Status;
+  EFI_SHELL_PROTOCOL  *ShellProtocol;
+  SHELL_FILE_HANDLE   Handle;
+  UINT64              FileSize;
+  UINTN               TempBufferSize;
+  VOID                *TempBuffer;
+
+  Status = gBS->LocateProtocol (&gEfiShellProtocolGuid, NULL, (VOID **)&ShellProtocol);
+  if (EFI_ERROR (Status)) {
+    return EFI_NOT_FOUND;
+  }
+
+  Status = ShellProtocol->OpenFileByName (FileName, &Handle, EFI_FILE_MODE_READ);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = ShellProtocol->GetFileSize (Handle, &FileSize);
+  if (EFI_ERROR (Status)) {
+    ShellProtocol->CloseFile (Handle);
+    return Status;
+  }
+
+  TempBufferSize = (UINTN)FileSize;
+  TempBuffer     = AllocatePool (TempBufferSize);
+  if (TempBuffer == NULL) {
+    ShellProtocol->CloseFile (Handle);
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Status = ShellProtocol->ReadFile (Handle, &TempBufferSize, TempBuffer);
+  ShellProtocol->CloseFile (Handle);
+  if (EFI_ERROR (Status)) {
+    FreePool (TempBuffer);
+    return Status;
+  }
+
+  *BufferSize = TempBufferSize;
+  *Buffer     = TempBuffer;
+  return EFI_SUCCESS;
+}
+
+/**
+  Return the result entry of a GUID, creating it if needed.
+
+  @param[in] Guid   The GUID of the section.
+
+  @return The result entry, or NULL if the table is full.
+**/
+STATIC
+DECODE_RESULT *
+GetResult (
+  IN CONST EFI_GUID  *Guid
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < mResultCount; Index++) {
+    if (CompareGuid (&mResults[Index].Guid, Guid)) {
+      return &mResults[Index];
+    }
+  }
+
+  if (mResultCount == MAX_RESULTS) {
+    return NULL;
+  }
+
+  ZeroMem (&mResults[mResultCount], sizeof (DECODE_RESULT));
+  CopyGuid (&mResults[mResultCount].Guid, Guid);
+  return &mResults[mResultCount++];
+}
+
+/**
+  Return the number of ticks between two performance counter values.
+
+  @param[in] Start  The counter value at the start of the measurement.
+  @param[in] End    The counter value at the end of the measurement.
+
+  @return The elapsed ticks.
+**/
+STATIC
+UINT64
+GetElapsedTicks (
+  IN UINT64  Start,
+  IN UINT64  End
+  )
+{
+  if (mCounterEnd < mCounterStart) {
+    //
+    // The counter counts down.
+    //
+    return (Start >= End) ? Start - End : (Start - mCounterEnd) + (mCounterStart - End);
+  }
+
+  return (End >= Start) ? End - Start : (mCounterEnd - Start) + (End - mCounterStart);
+}
+
+/**
+  Decode one GUIDed section repeatedly and record the time taken.
+
+  @param[in] Section  The GUIDed section.
+  @param[in] Size     The size of the section, in bytes.
+**/
+STATIC
+VOID
+BenchmarkSection (
+  IN CONST EFI_COMMON_SECTION_HEADER  *Section,
+  IN UINT32                           Size
+  )
+{
+  EFI_STATUS      Status;
+  CONST EFI_GUID  *Guid;
+  DECODE_RESULT   *Result;
+  UINT32          OutputSize;
+  UINT32          ScratchSize;
+  UINT16          Attributes;
+  UINT32          AuthenticationStatus;
+  VOID            *Output;
+  VOID            *OutputBuffer;
+  VOID            *Scratch;
+  UINT64          Start;
+  UINT64          Ticks;
+  UINTN           Index;
+
+  if (IS_SECTION2 (Section)) {
+    Guid = &((EFI_GUID_DEFINED_SECTION2 *)Section)->SectionDefinitionGuid;
+  } else {
+    Guid = &((EFI_GUID_DEFINED_SECTION *)Section)->SectionDefinitionGuid;
+  }
+
+  Status = ExtractGuidedSectionGetInfo (Section, &OutputSize, &ScratchSize, &Attributes);
+  if (EFI_ERROR (Status)) {
+    mSkippedSections++;
+    return;
+  }
+
+  Result = GetResult (Guid);
+  if (Result == NULL) {
+    mSkippedSections++;
+    return;
+  }
+
+  Output  = AllocatePool (MAX (OutputSize, 1));
+  Scratch = AllocatePool (MAX (ScratchSize, 1));
+  if ((Output == NULL) || (Scratch == NULL)) {
+    Print (L"DecompressBenchmark: Out of resources decoding a %g section\n", Guid);
+    mSkippedSections++;
+    goto Done;
+  }
+
+  //
+  // The first decoding checks the section and warms up the caches; only the
+  // following ones are timed.
+  //
+  OutputBuffer = Output;
+  Status       = ExtractGuidedSectionDecode (Section, &OutputBuffer, Scratch, &AuthenticationStatus);
+  if (EFI_ERROR (Status)) {
+    Print (L"DecompressBenchmark: Failed to decode a %g section - %r\n", Guid, Status);
+    mSkippedSections++;
+    goto Done;
+  }
+
+  Start = GetPerformanceCounter ();
+  for (Index = 0; Index < mIterations; Index++) {
+    OutputBuffer = Output;
+    ExtractGuidedSectionDecode (Section, &OutputBuffer, Scratch, &AuthenticationStatus);
+  }
+
+  Ticks = GetElapsedTicks (Start, GetPerformanceCounter ());
+
+  Result->Sections++;
+  Result->InputBytes  += Size;
+  Result->OutputBytes += OutputSize;
+  Result->Nanoseconds += GetTimeInNanoSecond (Ticks);
+
+Done:
+  if (Output != NULL) {
+    FreePool (Output);
+  }
+
+  if (Scratch != NULL) {
+    FreePool (Scratch);
+  }
+}
+
+/**
+  Benchmark the GUIDed sections of the files of a firmware volume image.
+
+  @param[in] FvImage  The firmware volume image.
+  @param[in] FvSize   The size of the image, in bytes.
+
+  @retval EFI_SUCCESS            The sections were benchmarked.
+  @retval EFI_VOLUME_CORRUPTED   The image is not a firmware volume.
+**/
+STATIC
+EFI_STATUS
+BenchmarkFv (
+  IN UINT8  *FvImage,
+  IN UINTN  FvSize
+  )
+{
+  EFI_FIRMWARE_VOLUME_HEADER      *FvHeader;
+  EFI_FIRMWARE_VOLUME_EXT_HEADER  *ExtHeader;
+  EFI_FFS_FILE_HEADER             *FileHeader;
+  EFI_COMMON_SECTION_HEADER       *Section;
+  UINT64                          FvLength;
+  UINT64                          Offset;
+  UINT64                          FileEnd;
+  UINT32                          FileSize;
+  UINT32                          FileHeaderSize;
+  UINT32                          SectionSize;
+  UINT32                          SectionHeaderSize;
+
+  FvHeader = (EFI_FIRMWARE_VOLUME_HEADER *)FvImage;
+  if ((FvSize < sizeof (EFI_FIRMWARE_VOLUME_HEADER)) ||
+      (FvHeader->Signature != EFI_FVH_SIGNATURE) ||
+      (FvHeader->HeaderLength > FvHeader->FvLength))
+  {
+    return EFI_VOLUME_CORRUPTED;
+  }
+
+  FvLength = MIN (FvHeader->FvLength, FvSize);
+  Offset   = FvHeader->HeaderLength;
+  if (FvHeader->ExtHeaderOffset != 0) {
+    if ((UINT64)FvHeader->ExtHeaderOffset + sizeof (EFI_FIRMWARE_VOLUME_EXT_HEADER) > FvLength) {
+      return EFI_VOLUME_CORRUPTED;
+    }
+
+    ExtHeader = (EFI_FIRMWARE_VOLUME_EXT_HEADER *)(FvImage + FvHeader->ExtHeaderOffset);
+    Offset    = (UINT64)FvHeader->ExtHeaderOffset + ExtHeader->ExtHeaderSize;
+  }
+
+  for (Offset = ALIGN_VALUE (Offset, 8);
+       Offset + sizeof (EFI_FFS_FILE_HEADER) <= FvLength;
+       Offset = ALIGN_VALUE (FileEnd, 8))
+  {
+    FileHeader = (EFI_FFS_FILE_HEADER *)(FvImage + Offset);
+    if (IsZeroGuid (&FileHeader->Name) || (FileHeader->Type == 0xFF)) {
+      //
+      // Free space.
+      //
+      break;
+    }
+
+    if (IS_FFS_FILE2 (FileHeader)) {
+      if (Offset + sizeof (EFI_FFS_FILE_HEADER2) > FvLength) {
+        break;
+      }
+
+      FileSize       = FFS_FILE2_SIZE (FileHeader);
+      FileHeaderSize = sizeof (EFI_FFS_FILE_HEADER2);
+    } else {
+      FileSize       = FFS_FILE_SIZE (FileHeader);
+      FileHeaderSize = sizeof (EFI_FFS_FILE_HEADER);
+    }
+
+    FileEnd = Offset + FileSize;
+    if ((FileSize < FileHeaderSize) || (FileEnd > FvLength)) {
+      break;
+    }
+
+    if ((FileHeader->Type == EFI_FV_FILETYPE_FFS_PAD) || (FileHeader->Type == EFI_FV_FILETYPE_RAW)) {
+      continue;
+    }
+
+    Section = (EFI_COMMON_SECTION_HEADER *)((UINT8 *)FileHeader + FileHeaderSize);
+    while ((UINT8 *)Section + sizeof (EFI_COMMON_SECTION_HEADER) <= FvImage + FileEnd) {
+      if (IS_SECTION2 (Section)) {
+        SectionHeaderSize = sizeof (EFI_COMMON_SECTION_HEADER2);
+        SectionSize       = ((UINT8 *)Section + sizeof (EFI_COMMON_SECTION_HEADER2) <= FvImage + FileEnd) ?
+                            SECTION2_SIZE (Section) : 0;
+      } else {
+        SectionHeaderSize = sizeof (EFI_COMMON_SECTION_HEADER);
+        SectionSize       = SECTION_SIZE (Section);
+      }
+
+      if ((SectionSize < SectionHeaderSize) || ((UINT8 *)Section + SectionSize > FvImage + FileEnd)) {
+        break;
+      }
+
+      if (Section->Type == EFI_SECTION_GUID_DEFINED) {
+        BenchmarkSection (Section, SectionSize);
+      }
+
+      Section = (EFI_COMMON_SECTION_HEADER *)((UINT8 *)Section + ALIGN_VALUE (SectionSize, 4));
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Print the results summed per GUID.
+**/
+STATIC
+VOID
+PrintResults (
+  VOID
+  )
+{
+  DECODE_RESULT  *Result;
+  CHAR16         *Name;
+  UINTN          Index;
+  UINTN          NameIndex;
+  UINT64         Rate;
+
+  Print (L"%-12s %8s %12s %12s %12s %10s\n", L"Algorithm", L"Sections", L"Input", L"Output", L"us/iter", L"MB/s");
+  for (Index = 0; Index < mResultCount; Index++) {
+    Result = &mResults[Index];
+    Name   = NULL;
+    for (NameIndex = 0; NameIndex < ARRAY_SIZE (mGuidNames); NameIndex++) {
+      if (CompareGuid (mGuidNames[NameIndex].Guid, &Result->Guid)) {
+        Name = mGuidNames[NameIndex].Name;
+        break;
+      }
+    }
+
+    //
+    // Bytes per microsecond are MB/s; keep one decimal.
+    //
+    Rate = 0;
+    if (Result->Nanoseconds != 0) {
+      Rate = DivU64x64Remainder (
+               MultU64x64 (MultU64x32 (Result->OutputBytes, (UINT32)mIterations), 10000),
+               Result->Nanoseconds,
+               NULL
+               );
+    }
+
+    if (Name != NULL) {
+      Print (L"%-12s ", Name);
+    } else {
+      Print (L"%g\n%-12s ", &Result->Guid, L"");
+    }
+
+    Print (
+      L"%8d %12ld %12ld %12ld %8ld.%d\n",
+      (UINT32)Result->Sections,
+      Result->InputBytes,
+      Result->OutputBytes,
+      DivU64x64Remainder (Result->Nanoseconds, MultU64x32 (mIterations, 1000), NULL),
+      DivU64x32 (Rate, 10),
+      ModU64x32 (Rate, 10)
+      );
+  }
+
+  if (mSkippedSections != 0) {
+    Print (L"%d GUIDed sections were skipped.\n", (UINT32)mSkippedSections);
+  }
+}
+
+/**
+  Decompress benchmark entry point.
+
+  @param[in] ImageHandle     The image handle.
+  @param[in] SystemTable     The system table.
+
+  @retval EFI_SUCCESS            The benchmark ran.
+  @retval EFI_INVALID_PARAMETER  Invalid command line.
+  @retval Others                 An FV file could not be read or parsed.
+**/
+EFI_STATUS
+EFIAPI
+DecompressBenchmarkMain (
+  IN EFI_HANDLE        ImageHandle,
+  IN EFI_SYSTEM_TABLE  *SystemTable
+  )
+{
+  EFI_STATUS                     Status;
+  EFI_SHELL_PARAMETERS_PROTOCOL  *ShellParameters;
+  UINTN                          Argc;
+  CHAR16                         **Argv;
+  UINTN                          Index;
+  UINTN                          FvCount;
+  VOID                           *FvImage;
+  UINTN                          FvSize;
+
+  Status = gBS->HandleProtocol (ImageHandle, &gEfiShellParametersProtocolGuid, (VOID **)&ShellParameters);
+  if (EFI_ERROR (Status)) {
+    Print (L"DecompressBenchmark: This application must be run from the UEFI Shell\n");
+    return Status;
+  }
+
+  Argc = ShellParameters->Argc;
+  Argv = ShellParameters->Argv;
+
+  if ((Argc < 2) || (StrCmp (Argv[1], L"-h") == 0) || (StrCmp (Argv[1], L"-?") == 0)) {
+    ShowHelp ();
+    return (Argc < 2) ? EFI_INVALID_PARAMETER : EFI_SUCCESS;
+  }
+
+  if (StrCmp (Argv[1], L"-v") == 0) {
+    ShowVersion ();
+    return EFI_SUCCESS;
+  }
+
+  GetPerformanceCounterProperties (&mCounterStart, &mCounterEnd);
+
+  FvCount = 0;
+  for (Index = 1; Index < Argc; Index++) {
+    if (StrCmp (Argv[Index], L"-n") == 0) {
+      if ((Index + 1 == Argc) || (StrDecimalToUintn (Argv[Index + 1]) == 0)) {
+        Print (L"DecompressBenchmark: Invalid iteration count\n");
+        return EFI_INVALID_PARAMETER;
+      }
+
+      mIterations = StrDecimalToUintn (Argv[++Index]);
+      continue;
+    }
+
+    Status = ReadFileToBuffer (Argv[Index], &FvSize, &FvImage);
+    if (EFI_ERROR (Status)) {
+      Print (L"DecompressBenchmark: Failed to read %s - %r\n", Argv[Index], Status);
+      return Status;
+    }
+
+    Status = BenchmarkFv (FvImage, FvSize);
+    FreePool (FvImage);
+    if (EFI_ERROR (Status)) {
+      Print (L"DecompressBenchmark: %s is not a firmware volume image\n", Argv[Index]);
+      return Status;
+    }
+
+    FvCount++;
+  }
+
+  if (FvCount == 0) {
+    ShowHelp ();
+    return EFI_INVALID_PARAMETER;
+  }
+
+  PrintResults ();
+  return EFI_SUCCESS;
+}
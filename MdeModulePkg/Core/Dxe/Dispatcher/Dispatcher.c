@@ -381,6 +381,106 @@ CoreTrust (
   return EFI_NOT_FOUND;
 }
 
+/**
+  Decompress the sections of the drivers in the mScheduledQueue on the
+  application processors, so that reading their images and firmware volume
+  sections finds them in the section cache.
+
+**/
+STATIC
+VOID
+CorePrefetchScheduledSections (
+  VOID
+  )
+{
+  LIST_ENTRY             *Link;
+  EFI_CORE_DRIVER_ENTRY  *DriverEntry;
+  EFI_CORE_DRIVER_ENTRY  **DriverEntries;
+  UINTN                  Count;
+
+  if (!PcdGetBool (PcdDxeParallelSectionExtraction)) {
+    return;
+  }
+
+  Count = 0;
+  for (Link = mScheduledQueue.ForwardLink; Link != &mScheduledQueue; Link = Link->ForwardLink) {
+    DriverEntry = CR (Link, EFI_CORE_DRIVER_ENTRY, ScheduledLink, EFI_CORE_DRIVER_ENTRY_SIGNATURE);
+    if (DriverEntry->ImageHandle == NULL) {
+      Count++;
+    }
+  }
+
+  if (Count < 2) {
+    return;
+  }
+
+  DriverEntries = AllocatePool (Count * sizeof (EFI_CORE_DRIVER_ENTRY *));
+  if (DriverEntries == NULL) {
+    return;
+  }
+
+  Count = 0;
+  for (Link = mScheduledQueue.ForwardLink; Link != &mScheduledQueue; Link = Link->ForwardLink) {
+    DriverEntry = CR (Link, EFI_CORE_DRIVER_ENTRY, ScheduledLink, EFI_CORE_DRIVER_ENTRY_SIGNATURE);
+    if (DriverEntry->ImageHandle == NULL) {
+      DriverEntries[Count++] = DriverEntry;
+    }
+  }
+
+  CorePrefetchDriverSections (DriverEntries, Count);
+  CoreFreePool (DriverEntries);
+}
+
+/**
+  Read the images of the drivers in the mScheduledQueue and load and relocate
+  them on the application processors, so that the dispatch loop only has to
+  run their entry points. Drivers whose image could not be prepared are loaded
+  by CoreLoadImage () as usual.
+
+**/
+STATIC
+VOID
+CorePrepareScheduledImages (
+  VOID
+  )
+{
+  LIST_ENTRY             *Link;
+  EFI_CORE_DRIVER_ENTRY  *DriverEntry;
+  CORE_PREPARED_IMAGE    **PreparedImages;
+  UINTN                  Count;
+
+  Count = 0;
+  for (Link = mScheduledQueue.ForwardLink; Link != &mScheduledQueue; Link = Link->ForwardLink) {
+    DriverEntry = CR (Link, EFI_CORE_DRIVER_ENTRY, ScheduledLink, EFI_CORE_DRIVER_ENTRY_SIGNATURE);
+    if ((DriverEntry->ImageHandle == NULL) && !DriverEntry->IsFvImage && (DriverEntry->PreparedImage == NULL)) {
+      Count++;
+    }
+  }
+
+  if ((Count < 2) || !CoreIsParallelImageLoadAvailable ()) {
+    return;
+  }
+
+  PreparedImages = AllocatePool (Count * sizeof (CORE_PREPARED_IMAGE *));
+  if (PreparedImages == NULL) {
+    return;
+  }
+
+  Count = 0;
+  for (Link = mScheduledQueue.ForwardLink; Link != &mScheduledQueue; Link = Link->ForwardLink) {
+    DriverEntry = CR (Link, EFI_CORE_DRIVER_ENTRY, ScheduledLink, EFI_CORE_DRIVER_ENTRY_SIGNATURE);
+    if ((DriverEntry->ImageHandle == NULL) && !DriverEntry->IsFvImage && (DriverEntry->PreparedImage == NULL)) {
+      DriverEntry->PreparedImage = CorePrepareImage (DriverEntry->FvFileDevicePath);
+      if (DriverEntry->PreparedImage != NULL) {
+        PreparedImages[Count++] = DriverEntry->PreparedImage;
+      }
+    }
+  }
+
+  CoreLoadPreparedImages (PreparedImages, Count);
+  CoreFreePool (PreparedImages);
+}
+
 /**
   This is the main Dispatcher for DXE and it exits when there are no more
   drivers to run. Drain the mScheduledQueue and load and start a PE
@@ -433,6 +533,9 @@ CoreDispatcher (
 
   ReturnStatus = EFI_NOT_FOUND;
   do {
+    CorePrefetchScheduledSections ();
+    CorePrepareScheduledImages ();
+
     //
     // Drain the Scheduled Queue
     //
@@ -451,6 +554,10 @@ CoreDispatcher (
       //
       if ((DriverEntry->ImageHandle == NULL) && !DriverEntry->IsFvImage) {
         DEBUG ((DEBUG_INFO, "Loading driver %g\n", &DriverEntry->FileName));
+        if (DriverEntry->PreparedImage != NULL) {
+          CoreSetPreparedImage (DriverEntry->PreparedImage);
+        }
+
         Status = CoreLoadImage (
                    FALSE,
                    gDxeCoreImageHandle,
@@ -460,6 +567,11 @@ CoreDispatcher (
                    &DriverEntry->ImageHandle
                    );
 
+        if (DriverEntry->PreparedImage != NULL) {
+          CoreFreePreparedImage (DriverEntry->PreparedImage);
+          DriverEntry->PreparedImage = NULL;
+        }
+
         //
         // Update the driver state to reflect that it's been loaded
         //
@@ -42,14 +42,18 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Protocol/BusSpecificDriverOverride.h>
 #include <Protocol/DriverFamilyOverride.h>
 #include <Protocol/TcgService.h>
+#include <Protocol/Tcg2Protocol.h>
+#include <Protocol/CcMeasurement.h>
 #include <Protocol/HiiPackageList.h>
 #include <Protocol/SmmBase2.h>
 #include <Protocol/PeCoffImageEmulator.h>
 #include <Protocol/MemoryAttribute.h>
+#include <Protocol/MpService.h>
 #include <Guid/MemoryTypeInformation.h>
 #include <Guid/FirmwareFileSystem2.h>
 #include <Guid/FirmwareFileSystem3.h>
 #include <Guid/HobList.h>
+#include <Guid/HobIndexTable.h>
 #include <Guid/DebugImageInfoTable.h>
 #include <Guid/FileInfo.h>
 #include <Guid/Apriori.h>
@@ -63,6 +67,11 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Guid/VectorHandoffTable.h>
 #include <Ppi/VectorHandoffInfo.h>
 #include <Guid/MemoryProfile.h>
+#include <Guid/TimerWheelStatistics.h>
+#include <Guid/FvFileIndex.h>
+#include <Guid/BootServiceTrace.h>
+#include <Guid/GlobalVariable.h>
+#include <Guid/ImageAuthentication.h>
 
 #include <Library/DxeCoreEntryPoint.h>
 #include <Library/DebugLib.h>
@@ -86,6 +95,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/DebugAgentLib.h>
 #include <Library/CpuExceptionHandlerLib.h>
 #include <Library/OrderedCollectionLib.h>
+#include <Library/TimerLib.h>
+#include <Library/SynchronizationLib.h>
 
 //
 // attributes for reserved memory before it is promoted to system memory
@@ -134,6 +145,8 @@ typedef struct {
   EFI_GUID      FvNameGuid;
 } KNOWN_HANDLE;
 
+typedef struct _CORE_PREPARED_IMAGE CORE_PREPARED_IMAGE;
+
 #define EFI_CORE_DRIVER_ENTRY_SIGNATURE  SIGNATURE_32('d','r','v','r')
 typedef struct {
   UINTN                            Signature;
@@ -162,6 +175,8 @@ typedef struct {
 
   EFI_HANDLE                       ImageHandle;
   BOOLEAN                          IsFvImage;
+
+  CORE_PREPARED_IMAGE              *PreparedImage;
 } EFI_CORE_DRIVER_ENTRY;
 
 //
@@ -596,6 +611,37 @@ CoreStall (
   IN UINTN  Microseconds
   );
 
+/**
+  Check whether EFI_MP_SERVICES_PROTOCOL is installed and reports at least
+  one enabled application processor.
+
+  @retval TRUE   Work can be run on the application processors.
+  @retval FALSE  Work must be run on the BSP.
+
+**/
+BOOLEAN
+CoreIsMpAvailable (
+  VOID
+  );
+
+/**
+  Run a procedure on every enabled application processor and on the BSP at
+  the same time.
+
+  @param  Procedure               The procedure to run.
+  @param  Argument                The parameter passed to Procedure.
+
+  @retval EFI_SUCCESS             The application processors ran Procedure.
+  @return Others                  The application processors could not be
+                                  started. Procedure was still run on the BSP.
+
+**/
+EFI_STATUS
+CoreStartupAllProcessors (
+  IN EFI_AP_PROCEDURE  Procedure,
+  IN VOID              *Argument
+  );
+
 /**
   Sets the system's watchdog timer.
 
@@ -1349,6 +1395,71 @@ CoreLoadImage (
   OUT EFI_HANDLE               *ImageHandle
   );
 
+/**
+  Check whether driver images can be loaded on the application processors.
+
+  @retval TRUE   PcdDxeParallelImageLoad is set and EFI_MP_SERVICES_PROTOCOL
+                 reports at least one enabled application processor.
+  @retval FALSE  Images must be loaded on the BSP.
+
+**/
+BOOLEAN
+CoreIsParallelImageLoadAvailable (
+  VOID
+  );
+
+/**
+  Read an image from a firmware volume and allocate the pages it will be
+  loaded into, so that CoreLoadPreparedImages () can load and relocate it
+  on an application processor.
+
+  @param  FilePath                The device path of the image file.
+
+  @return The prepared image, or NULL if the image must be loaded by
+          CoreLoadImage () alone.
+
+**/
+CORE_PREPARED_IMAGE *
+CorePrepareImage (
+  IN EFI_DEVICE_PATH_PROTOCOL  *FilePath
+  );
+
+/**
+  Load and relocate prepared images on the application processors.
+
+  @param  PreparedImages          The images returned by CorePrepareImage ().
+  @param  Count                   The number of entries in PreparedImages.
+
+**/
+VOID
+CoreLoadPreparedImages (
+  IN CORE_PREPARED_IMAGE  **PreparedImages,
+  IN UINTN                Count
+  );
+
+/**
+  Hand a prepared image to the next CoreLoadImage () call for the same
+  device path.
+
+  @param  PreparedImage           The image returned by CorePrepareImage ().
+
+**/
+VOID
+CoreSetPreparedImage (
+  IN CORE_PREPARED_IMAGE  *PreparedImage
+  );
+
+/**
+  Free the parts of a prepared image that CoreLoadImage () did not adopt.
+
+  @param  PreparedImage           The image returned by CorePrepareImage ().
+
+**/
+VOID
+CoreFreePreparedImage (
+  IN CORE_PREPARED_IMAGE  *PreparedImage
+  );
+
 /**
   Unloads an image.
 
@@ -2344,6 +2455,112 @@ CloseSectionStream (
   IN  BOOLEAN  FreeStreamBuffer
   );
 
+/**
+  Create a section stream for the sections of an FFS file. Encapsulation
+  sections found in the stream are looked up in, and added to, the
+  decompressed section cache under the name of the file.
+
+  @param  FileName               The name of the FFS file.
+  @param  SectionStreamLength    Size in bytes of the section stream.
+  @param  SectionStream          Buffer containing the new section stream.
+  @param  SectionStreamHandle    A pointer to a caller allocated UINTN that on
+                                 output contains the new section stream handle.
+
+  @retval EFI_SUCCESS            The section stream is created successfully.
+  @retval EFI_OUT_OF_RESOURCES   memory allocation failed.
+  @retval EFI_INVALID_PARAMETER  Section stream does not end concident with end
+                                 of last section.
+
+**/
+EFI_STATUS
+OpenFileSectionStream (
+  IN     CONST EFI_GUID  *FileName,
+  IN     UINTN           SectionStreamLength,
+  IN     VOID            *SectionStream,
+  OUT UINTN              *SectionStreamHandle
+  );
+
+/**
+  Invalidate the section cache entries of the encapsulation sections in a
+  buffer that is about to be freed. Entries that are not in use are freed,
+  the others are freed when the last stream using them is closed.
+
+  @param  Buffer                 The buffer.
+  @param  Size                   The size of Buffer.
+
+**/
+VOID
+InvalidateSectionCache (
+  IN CONST VOID  *Buffer,
+  IN UINTN       Size
+  );
+
+/**
+  Get the contents of a file of a firmware volume produced by the DXE core in
+  the buffer the firmware volume keeps them in, which is also the buffer
+  ReadSection() opens the section stream of the file on.
+
+  The buffer stays in place until the firmware volume is freed.
+
+  @param  Fv                     The firmware volume.
+  @param  NameGuid               The name of the file.
+  @param  FileData               The contents of the file, without its header.
+  @param  FileSize               The size of FileData.
+  @param  FileType               The type of the file.
+
+  @retval EFI_SUCCESS            The file was found.
+  @retval EFI_UNSUPPORTED        Fv is not produced by the DXE core.
+  @return Others                 The error returned by ReadFile().
+
+**/
+EFI_STATUS
+CoreGetFvFileData (
+  IN  EFI_FIRMWARE_VOLUME2_PROTOCOL  *Fv,
+  IN  CONST EFI_GUID                 *NameGuid,
+  OUT VOID                           **FileData,
+  OUT UINTN                          *FileSize,
+  OUT EFI_FV_FILETYPE                *FileType
+  );
+
+/**
+  Get the FFS header of a file of a firmware volume produced by the DXE core,
+  and the name of the firmware volume, without reading the file.
+
+  @param  Fv                     The firmware volume.
+  @param  NameGuid               The name of the file.
+  @param  FfsHeader              Returns the FFS header of the file.
+  @param  FvName                 Returns the name of the firmware volume from
+                                 its extended header, or a zero GUID if it has
+                                 none.
+
+  @retval EFI_SUCCESS            The file was found.
+  @retval EFI_UNSUPPORTED        Fv is not produced by the DXE core.
+  @return Others                 The error returned by ReadFile().
+
+**/
+EFI_STATUS
+CoreGetFvFileHeader (
+  IN  EFI_FIRMWARE_VOLUME2_PROTOCOL  *Fv,
+  IN  CONST EFI_GUID                 *NameGuid,
+  OUT CONST EFI_FFS_FILE_HEADER      **FfsHeader,
+  OUT EFI_GUID                       *FvName
+  );
+
+/**
+  Decompress the compressed sections of scheduled drivers on the application
+  processors and add them to the decompressed section cache, so that loading
+  the drivers does not have to decompress them one after the other.
+
+  @param  DriverEntries          The drivers that are about to be loaded.
+  @param  Count                  The number of entries in DriverEntries.
+
+**/
+VOID
+CorePrefetchDriverSections (
+  IN EFI_CORE_DRIVER_ENTRY  **DriverEntries,
+  IN UINTN                  Count
+  );
+
 /**
   Creates and initializes the DebugImageInfo Table.  Also creates the configuration
   table and registers it into the system table.
@@ -2360,6 +2577,55 @@ CoreInitializeDebugImageInfoTable (
   VOID
   );
 
+/**
+  Creates the HOB index table of the GUID HOBs in the HOB list and registers it
+  into the system table. The HOB list must not change afterwards, which holds
+  once it has been installed into the system table.
+
+  On success, gHobIndex points to the table so that the HOB library of the
+  DXE Core uses it too.
+
+  @param  HobStart      The pointer to the beginning of the HOB list.
+
+**/
+VOID
+CoreInstallHobIndexTable (
+  IN VOID  *HobStart
+  );
+
+/**
+  Start tracing the boot services selected by PcdDxeServiceTraceMask, and
+  install the trace table into the EFI System Table.
+
+**/
+VOID
+CoreInitializeServiceTrace (
+  VOID
+  );
+
+/**
+  Attribute the boot service calls made from a loaded image to it.
+
+  @param  Image         The image that is about to be started.
+
+**/
+VOID
+CoreRegisterServiceTraceImage (
+  IN LOADED_IMAGE_PRIVATE_DATA  *Image
+  );
+
+/**
+  Stop attributing calls to an image that is unloaded. The statistics of the
+  image are kept.
+
+  @param  Image         The image that is unloaded.
+
+**/
+VOID
+CoreUnregisterServiceTraceImage (
+  IN LOADED_IMAGE_PRIVATE_DATA  *Image
+  );
+
 /**
   Update the CRC32 in the Debug Table.
   Since the CRC32 service is made available by the Runtime driver, we have to
@@ -359,6 +359,16 @@ DxeMain (
   Status = CoreInstallConfigurationTable (&gEfiHobListGuid, HobStart);
   ASSERT_EFI_ERROR (Status);
 
+  //
+  // Index the GUID HOBs of the HOB List for GetNextGuidHob()
+  //
+  CoreInstallHobIndexTable (HobStart);
+
+  //
+  // Time the boot services selected by PcdDxeServiceTraceMask
+  //
+  CoreInitializeServiceTrace ();
+
   //
   // Install Memory Type Information Table into the EFI System Tables's Configuration Table
   //
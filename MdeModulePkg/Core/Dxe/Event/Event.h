@@ -33,6 +33,14 @@ typedef struct {
   LIST_ENTRY    Link;
   UINT64        TriggerTime;
   UINT64        Period;
+  ///
+  /// Insertion order, breaks ties between timers with the same TriggerTime
+  ///
+  UINT64        Sequence;
+  ///
+  /// Timer wheel level the timer is queued on
+  ///
+  UINTN         Level;
 } TIMER_EVENT_INFO;
 
 #define EVENT_SIGNATURE  SIGNATURE_32('e','v','n','t')
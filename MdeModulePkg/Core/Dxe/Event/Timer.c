@@ -9,76 +9,421 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include "DxeMain.h"
 #include "Event.h"
 
+//
+// The timer database is a hierarchical timer wheel. Level 0 has one slot per
+// 2^TIMER_WHEEL_SLOT_SHIFT units of 100ns, and each outer level has one slot
+// per full rotation of the level below it. Timers further out than the outer
+// level can hold are kept on a sorted overflow list. Each slot is sorted by
+// trigger time and then by insertion order, so timers with identical trigger
+// times fire in the order they were set.
+//
+#define TIMER_WHEEL_SLOT_SHIFT    16
+#define TIMER_WHEEL_LEVEL0_BITS   8
+#define TIMER_WHEEL_LEVELN_BITS   6
+#define TIMER_WHEEL_LEVEL0_SLOTS  (1 << TIMER_WHEEL_LEVEL0_BITS)
+#define TIMER_WHEEL_LEVELN_SLOTS  (1 << TIMER_WHEEL_LEVELN_BITS)
+#define TIMER_WHEEL_LEVELS        3
+#define TIMER_WHEEL_OVERFLOW      TIMER_WHEEL_LEVELS
+
+//
+// Shift from a level 0 slot number to the slot number of an outer level
+//
+#define TIMER_WHEEL_LEVEL_SHIFT(Level) \
+  (TIMER_WHEEL_LEVEL0_BITS + ((Level) - 1) * TIMER_WHEEL_LEVELN_BITS)
+
 //
 // Internal data
 //
 
-LIST_ENTRY  mEfiTimerList       = INITIALIZE_LIST_HEAD_VARIABLE (mEfiTimerList);
+LIST_ENTRY  mEfiTimerWheelLevel0[TIMER_WHEEL_LEVEL0_SLOTS];
+LIST_ENTRY  mEfiTimerWheelLevelN[TIMER_WHEEL_LEVELS - 1][TIMER_WHEEL_LEVELN_SLOTS];
+LIST_ENTRY  mEfiTimerOverflowList = INITIALIZE_LIST_HEAD_VARIABLE (mEfiTimerOverflowList);
+UINTN       mEfiTimerWheelCount[TIMER_WHEEL_LEVELS + 1];
+UINT64      mEfiTimerWheelSlot  = 0;
+UINT64      mEfiTimerSequence   = 0;
 EFI_LOCK    mEfiTimerLock       = EFI_INITIALIZE_LOCK_VARIABLE (TPL_HIGH_LEVEL - 1);
 EFI_EVENT   mEfiCheckTimerEvent = NULL;
 
-EFI_LOCK  mEfiSystemTimeLock = EFI_INITIALIZE_LOCK_VARIABLE (TPL_HIGH_LEVEL);
-UINT64    mEfiSystemTime     = 0;
+EFI_LOCK  mEfiSystemTimeLock  = EFI_INITIALIZE_LOCK_VARIABLE (TPL_HIGH_LEVEL);
+UINT64    mEfiSystemTime      = 0;
+UINT64    mEfiTimerNextExpiry = MAX_UINT64;
+
+EDKII_TIMER_WHEEL_STATISTICS  mEfiTimerWheelStatistics = {
+  EDKII_TIMER_WHEEL_STATISTICS_REVISION
+};
 
 //
 // Timer functions
 //
 
 /**
-  Inserts the timer event.
+  Returns the current system time.
+
+  @return The current system time
+
+**/
+UINT64
+CoreCurrentSystemTime (
+  VOID
+  )
+{
+  UINT64  SystemTime;
+
+  CoreAcquireLock (&mEfiSystemTimeLock);
+  SystemTime = mEfiSystemTime;
+  CoreReleaseLock (&mEfiSystemTimeLock);
+
+  return SystemTime;
+}
+
+/**
+  Selects the timer wheel list that a timer belongs on.
+
+  @param  TriggerTime            The trigger time of the timer
+  @param  Level                  Returns the wheel level of the list
+
+  @return The list to queue the timer on
+
+**/
+STATIC
+LIST_ENTRY *
+CoreSelectTimerList (
+  IN  UINT64  TriggerTime,
+  OUT UINTN   *Level
+  )
+{
+  UINT64  Slot;
+  UINTN   Shift;
+
+  Slot = RShiftU64 (TriggerTime, TIMER_WHEEL_SLOT_SHIFT);
+  if (Slot < mEfiTimerWheelSlot) {
+    Slot = mEfiTimerWheelSlot;
+  }
+
+  if (Slot - mEfiTimerWheelSlot < TIMER_WHEEL_LEVEL0_SLOTS) {
+    *Level = 0;
+    return &mEfiTimerWheelLevel0[(UINTN)Slot & (TIMER_WHEEL_LEVEL0_SLOTS - 1)];
+  }
+
+  for (*Level = 1; *Level < TIMER_WHEEL_LEVELS; (*Level)++) {
+    Shift = TIMER_WHEEL_LEVEL_SHIFT (*Level);
+    if (RShiftU64 (Slot, Shift) - RShiftU64 (mEfiTimerWheelSlot, Shift) < TIMER_WHEEL_LEVELN_SLOTS) {
+      return &mEfiTimerWheelLevelN[*Level - 1][(UINTN)RShiftU64 (Slot, Shift) & (TIMER_WHEEL_LEVELN_SLOTS - 1)];
+    }
+  }
+
+  return &mEfiTimerOverflowList;
+}
+
+/**
+  Queues a timer event on the timer wheel in trigger time order.
 
   @param  Event                  Points to the internal structure of timer event
-                                 to be installed
+
+  @return The number of queued timers that were compared against
 
 **/
-VOID
-CoreInsertEventTimer (
+STATIC
+UINTN
+CoreQueueEventTimer (
   IN IEVENT  *Event
   )
 {
-  UINT64      TriggerTime;
+  LIST_ENTRY  *List;
   LIST_ENTRY  *Link;
   IEVENT      *Event2;
+  UINTN       Comparisons;
 
-  ASSERT_LOCKED (&mEfiTimerLock);
+  List = CoreSelectTimerList (Event->Timer.TriggerTime, &Event->Timer.Level);
 
   //
-  // Get the timer's trigger time
+  // Most timers are queued behind the ones already on the list, so search for
+  // the insertion point from the tail
   //
-  TriggerTime = Event->Timer.TriggerTime;
+  Comparisons = 0;
+  for (Link = List->BackLink; Link != List; Link = Link->BackLink) {
+    Event2 = CR (Link, IEVENT, Timer.Link, EVENT_SIGNATURE);
+    Comparisons++;
+
+    if ((Event2->Timer.TriggerTime < Event->Timer.TriggerTime) ||
+        ((Event2->Timer.TriggerTime == Event->Timer.TriggerTime) &&
+         (Event2->Timer.Sequence < Event->Timer.Sequence)))
+    {
+      break;
+    }
+  }
+
+  InsertHeadList (Link, &Event->Timer.Link);
+  mEfiTimerWheelCount[Event->Timer.Level]++;
+
+  return Comparisons;
+}
+
+/**
+  Removes a queued timer event from the timer wheel.
+
+  @param  Event                  Points to the internal structure of timer event
+
+**/
+STATIC
+VOID
+CoreRemoveEventTimer (
+  IN IEVENT  *Event
+  )
+{
+  ASSERT (mEfiTimerWheelCount[Event->Timer.Level] > 0);
+
+  RemoveEntryList (&Event->Timer.Link);
+  Event->Timer.Link.ForwardLink = NULL;
+  mEfiTimerWheelCount[Event->Timer.Level]--;
+}
+
+/**
+  Moves the timers of an outer wheel list to the lists they now belong on.
+
+  @param  List                   The list to cascade
+  @param  Overflow               TRUE if List is the overflow list, of which
+                                 only the timers that fit the wheel are moved
+
+**/
+STATIC
+VOID
+CoreCascadeTimerList (
+  IN LIST_ENTRY  *List,
+  IN BOOLEAN     Overflow
+  )
+{
+  IEVENT  *Event;
+  UINTN   Level;
+
+  while (!IsListEmpty (List)) {
+    Event = CR (List->ForwardLink, IEVENT, Timer.Link, EVENT_SIGNATURE);
+    if (Overflow) {
+      CoreSelectTimerList (Event->Timer.TriggerTime, &Level);
+      if (Level == TIMER_WHEEL_OVERFLOW) {
+        break;
+      }
+    }
+
+    CoreRemoveEventTimer (Event);
+    CoreQueueEventTimer (Event);
+    ASSERT (Event->Timer.Link.ForwardLink != List);
+    mEfiTimerWheelStatistics.TimersCascaded++;
+  }
+}
+
+/**
+  Moves the timer wheel to a new level 0 slot, cascading the outer levels
+  whose slot boundary is crossed.
+
+  @param  Slot                   The new level 0 slot number
+
+**/
+STATIC
+VOID
+CoreAdvanceTimerWheel (
+  IN UINT64  Slot
+  )
+{
+  UINTN  Level;
+  UINTN  Shift;
+
+  mEfiTimerWheelSlot = Slot;
+
+  for (Level = TIMER_WHEEL_LEVELS - 1; Level > 0; Level--) {
+    Shift = TIMER_WHEEL_LEVEL_SHIFT (Level);
+    if ((Slot & (LShiftU64 (1, Shift) - 1)) != 0) {
+      continue;
+    }
+
+    if (Level == TIMER_WHEEL_LEVELS - 1) {
+      CoreCascadeTimerList (&mEfiTimerOverflowList, TRUE);
+    }
+
+    CoreCascadeTimerList (
+      &mEfiTimerWheelLevelN[Level - 1][(UINTN)RShiftU64 (Slot, Shift) & (TIMER_WHEEL_LEVELN_SLOTS - 1)],
+      FALSE
+      );
+  }
+}
+
+/**
+  Finds the next level 0 slot that may hold expired timers or that requires
+  an outer level to be cascaded, skipping over empty parts of the wheel.
+
+  @param  LastSlot               The level 0 slot of the current system time
+
+  @return The level 0 slot to advance to, never beyond LastSlot
+
+**/
+STATIC
+UINT64
+CoreNextTimerWheelSlot (
+  IN UINT64  LastSlot
+  )
+{
+  UINT64  Slot;
+  UINTN   Level;
+  UINTN   Shift;
+
+  Slot = mEfiTimerWheelSlot + 1;
+
+  for (Level = 1; Level <= TIMER_WHEEL_LEVELS; Level++) {
+    if (mEfiTimerWheelCount[Level - 1] != 0) {
+      break;
+    }
+
+    if (Level == TIMER_WHEEL_LEVELS) {
+      //
+      // Only the overflow list may be non-empty. It is cascaded on the
+      // boundaries of the outermost level.
+      //
+      if (mEfiTimerWheelCount[TIMER_WHEEL_OVERFLOW] == 0) {
+        Slot = LastSlot;
+      }
+
+      break;
+    }
+
+    //
+    // Everything below this level is empty, skip to its next slot boundary
+    //
+    Shift = TIMER_WHEEL_LEVEL_SHIFT (Level);
+    Slot  = LShiftU64 (RShiftU64 (mEfiTimerWheelSlot, Shift) + 1, Shift);
+  }
+
+  return MIN (Slot, LastSlot);
+}
+
+/**
+  Recomputes the earliest time at which the timer wheel needs attention.
+  This is either the trigger time of the earliest level 0 timer, or the
+  time of the next outer level cascade.
+
+**/
+STATIC
+VOID
+CoreUpdateTimerNextExpiry (
+  VOID
+  )
+{
+  UINT64      NextExpiry;
+  LIST_ENTRY  *List;
+  UINTN       Index;
+  UINTN       Level;
+  UINTN       Shift;
+  IEVENT      *Event;
+
+  NextExpiry = MAX_UINT64;
 
   //
-  // Insert the timer into the timer database in assending sorted order
+  // Level 0 slots are in trigger time order starting at the current slot
   //
-  for (Link = mEfiTimerList.ForwardLink; Link != &mEfiTimerList; Link = Link->ForwardLink) {
-    Event2 = CR (Link, IEVENT, Timer.Link, EVENT_SIGNATURE);
+  if (mEfiTimerWheelCount[0] != 0) {
+    for (Index = 0; Index < TIMER_WHEEL_LEVEL0_SLOTS; Index++) {
+      List = &mEfiTimerWheelLevel0[(UINTN)(mEfiTimerWheelSlot + Index) & (TIMER_WHEEL_LEVEL0_SLOTS - 1)];
+      if (!IsListEmpty (List)) {
+        Event      = CR (List->ForwardLink, IEVENT, Timer.Link, EVENT_SIGNATURE);
+        NextExpiry = Event->Timer.TriggerTime;
+        break;
+      }
+    }
+  }
 
-    if (Event2->Timer.TriggerTime > TriggerTime) {
+  //
+  // Timers of the outer levels may trigger as soon as their slot is
+  // cascaded, which happens on the next slot boundary of their level
+  //
+  for (Level = 1; Level <= TIMER_WHEEL_LEVELS; Level++) {
+    if (mEfiTimerWheelCount[Level] != 0) {
+      Shift      = TIMER_WHEEL_LEVEL_SHIFT (MIN (Level, TIMER_WHEEL_LEVELS - 1));
+      NextExpiry = MIN (
+                     NextExpiry,
+                     LShiftU64 (LShiftU64 (RShiftU64 (mEfiTimerWheelSlot, Shift) + 1, Shift), TIMER_WHEEL_SLOT_SHIFT)
+                     );
       break;
     }
   }
 
-  InsertTailList (Link, &Event->Timer.Link);
+  CoreAcquireLock (&mEfiSystemTimeLock);
+  mEfiTimerNextExpiry = NextExpiry;
+  CoreReleaseLock (&mEfiSystemTimeLock);
 }
 
 /**
-  Returns the current system time.
+  Counts the timers queued on the timer wheel.
 
-  @return The current system time
+  @return The number of queued timers
 
 **/
+STATIC
 UINT64
-CoreCurrentSystemTime (
+CoreCountPendingTimers (
   VOID
   )
 {
-  UINT64  SystemTime;
+  UINT64  Count;
+  UINTN   Level;
+
+  Count = 0;
+  for (Level = 0; Level <= TIMER_WHEEL_OVERFLOW; Level++) {
+    Count += mEfiTimerWheelCount[Level];
+  }
+
+  return Count;
+}
+
+/**
+  Inserts the timer event.
+
+  @param  Event                  Points to the internal structure of timer event
+                                 to be installed
+
+**/
+VOID
+CoreInsertEventTimer (
+  IN IEVENT  *Event
+  )
+{
+  UINTN   Comparisons;
+  UINT64  Slot;
+
+  ASSERT_LOCKED (&mEfiTimerLock);
+
+  //
+  // The wheel only advances while it holds timers. If it is empty, move it
+  // straight to the current time instead of cascading through idle slots.
+  //
+  if (CoreCountPendingTimers () == 0) {
+    Slot = RShiftU64 (CoreCurrentSystemTime (), TIMER_WHEEL_SLOT_SHIFT);
+    if (Slot > mEfiTimerWheelSlot) {
+      mEfiTimerWheelSlot = Slot;
+    }
+  }
+
+  //
+  // Insert the timer into the timer database in assending sorted order
+  //
+  Event->Timer.Sequence = mEfiTimerSequence++;
+  Comparisons           = CoreQueueEventTimer (Event);
+
+  mEfiTimerWheelStatistics.TimersInserted++;
+  mEfiTimerWheelStatistics.InsertComparisons += Comparisons;
+  if (Comparisons > mEfiTimerWheelStatistics.MaxInsertComparisons) {
+    mEfiTimerWheelStatistics.MaxInsertComparisons = Comparisons;
+  }
+
+  mEfiTimerWheelStatistics.PendingTimers = CoreCountPendingTimers ();
 
+  //
+  // Make sure the next tick past the trigger time processes it
+  //
   CoreAcquireLock (&mEfiSystemTimeLock);
-  SystemTime = mEfiSystemTime;
-  CoreReleaseLock (&mEfiSystemTimeLock);
+  if (Event->Timer.TriggerTime < mEfiTimerNextExpiry) {
+    mEfiTimerNextExpiry = Event->Timer.TriggerTime;
+  }
 
-  return SystemTime;
+  CoreReleaseLock (&mEfiSystemTimeLock);
 }
 
 /**
@@ -96,61 +441,91 @@ CoreCheckTimers (
   IN VOID       *Context
   )
 {
-  UINT64  SystemTime;
-  IEVENT  *Event;
+  UINT64      SystemTime;
+  UINT64      LastSlot;
+  UINT64      Fired;
+  LIST_ENTRY  *List;
+  IEVENT      *Event;
 
   //
   // Check the timer database for expired timers
   //
   CoreAcquireLock (&mEfiTimerLock);
   SystemTime = CoreCurrentSystemTime ();
+  LastSlot   = RShiftU64 (SystemTime, TIMER_WHEEL_SLOT_SHIFT);
+  Fired      = 0;
 
-  while (!IsListEmpty (&mEfiTimerList)) {
-    Event = CR (mEfiTimerList.ForwardLink, IEVENT, Timer.Link, EVENT_SIGNATURE);
+  for ( ; ;) {
+    List = &mEfiTimerWheelLevel0[(UINTN)mEfiTimerWheelSlot & (TIMER_WHEEL_LEVEL0_SLOTS - 1)];
 
-    //
-    // If this timer is not expired, then we're done
-    //
-    if (Event->Timer.TriggerTime > SystemTime) {
-      break;
-    }
+    while (!IsListEmpty (List)) {
+      Event = CR (List->ForwardLink, IEVENT, Timer.Link, EVENT_SIGNATURE);
 
-    //
-    // Remove this timer from the timer queue
-    //
+      //
+      // If this timer is not expired, then we're done
+      //
+      if (Event->Timer.TriggerTime > SystemTime) {
+        break;
+      }
 
-    RemoveEntryList (&Event->Timer.Link);
-    Event->Timer.Link.ForwardLink = NULL;
+      //
+      // Remove this timer from the timer queue
+      //
 
-    //
-    // Signal it
-    //
-    CoreSignalEvent (Event);
+      CoreRemoveEventTimer (Event);
 
-    //
-    // If this is a periodic timer, set it
-    //
-    if (Event->Timer.Period != 0) {
       //
-      // Compute the timers new trigger time
+      // Signal it
       //
-      Event->Timer.TriggerTime = Event->Timer.TriggerTime + Event->Timer.Period;
+      CoreSignalEvent (Event);
+      Fired++;
 
       //
-      // If that's before now, then reset the timer to start from now
+      // If this is a periodic timer, set it
       //
-      if (Event->Timer.TriggerTime <= SystemTime) {
-        Event->Timer.TriggerTime = SystemTime;
-        CoreSignalEvent (mEfiCheckTimerEvent);
+      if (Event->Timer.Period != 0) {
+        //
+        // Compute the timers new trigger time
+        //
+        Event->Timer.TriggerTime = Event->Timer.TriggerTime + Event->Timer.Period;
+
+        //
+        // If that's before now, then reset the timer to start from now
+        //
+        if (Event->Timer.TriggerTime <= SystemTime) {
+          Event->Timer.TriggerTime = SystemTime;
+          CoreSignalEvent (mEfiCheckTimerEvent);
+        }
+
+        //
+        // Add the timer
+        //
+        CoreInsertEventTimer (Event);
       }
+    }
 
-      //
-      // Add the timer
-      //
-      CoreInsertEventTimer (Event);
+    //
+    // Stop at the slot of the current time. Every timer of an earlier slot
+    // has expired and been signaled by now.
+    //
+    if (mEfiTimerWheelSlot >= LastSlot) {
+      break;
     }
+
+    ASSERT (IsListEmpty (List));
+    CoreAdvanceTimerWheel (CoreNextTimerWheelSlot (LastSlot));
   }
 
+  mEfiTimerWheelStatistics.Checks++;
+  mEfiTimerWheelStatistics.TimersFired += Fired;
+  if (Fired > mEfiTimerWheelStatistics.MaxTimersFiredPerCheck) {
+    mEfiTimerWheelStatistics.MaxTimersFiredPerCheck = Fired;
+  }
+
+  mEfiTimerWheelStatistics.PendingTimers = CoreCountPendingTimers ();
+
+  CoreUpdateTimerNextExpiry ();
+
   CoreReleaseLock (&mEfiTimerLock);
 }
 
@@ -164,6 +539,18 @@ CoreInitializeTimer (
   )
 {
   EFI_STATUS  Status;
+  UINTN       Index;
+  UINTN       Level;
+
+  for (Index = 0; Index < TIMER_WHEEL_LEVEL0_SLOTS; Index++) {
+    InitializeListHead (&mEfiTimerWheelLevel0[Index]);
+  }
+
+  for (Level = 1; Level < TIMER_WHEEL_LEVELS; Level++) {
+    for (Index = 0; Index < TIMER_WHEEL_LEVELN_SLOTS; Index++) {
+      InitializeListHead (&mEfiTimerWheelLevelN[Level - 1][Index]);
+    }
+  }
 
   Status = CoreCreateEventInternal (
              EVT_NOTIFY_SIGNAL,
@@ -174,6 +561,12 @@ CoreInitializeTimer (
              &mEfiCheckTimerEvent
              );
   ASSERT_EFI_ERROR (Status);
+
+  //
+  // Publish the timer wheel statistics
+  //
+  Status = CoreInstallConfigurationTable (&gEdkiiTimerWheelStatisticsGuid, &mEfiTimerWheelStatistics);
+  ASSERT_EFI_ERROR (Status);
 }
 
 /**
@@ -189,8 +582,6 @@ CoreTimerTick (
   IN UINT64  Duration
   )
 {
-  IEVENT  *Event;
-
   //
   // Check runtiem flag in case there are ticks while exiting boot services
   //
@@ -202,15 +593,11 @@ CoreTimerTick (
   mEfiSystemTime += Duration;
 
   //
-  // If the head of the list is expired, fire the timer event
-  // to process it
+  // If the earliest timer is expired, or the timer wheel needs to cascade
+  // an outer level, fire the timer event to process it
   //
-  if (!IsListEmpty (&mEfiTimerList)) {
-    Event = CR (mEfiTimerList.ForwardLink, IEVENT, Timer.Link, EVENT_SIGNATURE);
-
-    if (Event->Timer.TriggerTime <= mEfiSystemTime) {
-      CoreSignalEvent (mEfiCheckTimerEvent);
-    }
+  if (mEfiTimerNextExpiry <= mEfiSystemTime) {
+    CoreSignalEvent (mEfiCheckTimerEvent);
   }
 
   CoreReleaseLock (&mEfiSystemTimeLock);
@@ -261,8 +648,7 @@ CoreSetTimer (
   // If the timer is queued to the timer database, remove it
   //
   if (Event->Timer.Link.ForwardLink != NULL) {
-    RemoveEntryList (&Event->Timer.Link);
-    Event->Timer.Link.ForwardLink = NULL;
+    CoreRemoveEventTimer (Event);
   }
 
   Event->Timer.TriggerTime = 0;
@@ -273,6 +273,10 @@ FreeFvDeviceResource (
       //
       // Free the cached file buffer.
       //
+      InvalidateSectionCache (
+        FfsFileEntry->FfsHeader,
+        IS_FFS_FILE2 (FfsFileEntry->FfsHeader) ? FFS_FILE2_SIZE (FfsFileEntry->FfsHeader) : FFS_FILE_SIZE (FfsFileEntry->FfsHeader)
+        );
       CoreFreePool (FfsFileEntry->FfsHeader);
     }
 
@@ -285,6 +289,7 @@ FreeFvDeviceResource (
     //
     // Free the cached FV buffer.
     //
+    InvalidateSectionCache (FvDevice->CachedFv, (UINTN)(FvDevice->EndOfCachedFv - FvDevice->CachedFv));
     CoreFreePool (FvDevice->CachedFv);
   }
 
@@ -296,6 +301,148 @@ FreeFvDeviceResource (
   return;
 }
 
+/**
+  Build the FFS file list of a memory mapped FV from the file index HOB that
+  the PEI Core produced for it.
+
+  The indexed files are validated as the FV walk of FvCheck() would do, but the
+  file headers between them are not walked again. The walk resumes after the
+  last indexed file. If the index does not match the FV, the list is left empty
+  and the whole FV is walked.
+
+  @param  FvDevice              A pointer to the FvDevice whose file list is built.
+  @param  FfsHeader             On input, the first file header of the FV. On
+                                output, the file header following the last
+                                indexed file if the index was used.
+
+  @retval EFI_SUCCESS           The file list was built or left empty.
+  @retval EFI_OUT_OF_RESOURCES  No enough buffer could be allocated.
+
+**/
+STATIC
+EFI_STATUS
+AddFfsFilesFromIndex (
+  IN OUT FV_DEVICE            *FvDevice,
+  IN OUT EFI_FFS_FILE_HEADER  **FfsHeader
+  )
+{
+  EFI_HOB_GUID_TYPE          *GuidHob;
+  EDKII_FV_FILE_INDEX        *FileIndex;
+  EDKII_FV_FILE_INDEX_ENTRY  *Entries;
+  FFS_FILE_LIST_ENTRY        *FfsFileEntry;
+  EFI_FFS_FILE_HEADER        *Header;
+  EFI_FFS_FILE_HEADER        *CacheFfsHeader;
+  EFI_FFS_FILE_STATE         FileState;
+  LIST_ENTRY                 *Link;
+  UINT8                      *Next;
+  UINTN                      FvSize;
+  UINTN                      FileSize;
+  UINT32                     Index;
+  BOOLEAN                    FileCached;
+
+  FvSize = (UINTN)(FvDevice->EndOfCachedFv - FvDevice->CachedFv);
+
+  FileIndex = NULL;
+  for (GuidHob = GetFirstGuidHob (&gEdkiiFvFileIndexHobGuid);
+       GuidHob != NULL;
+       GuidHob = GetNextGuidHob (&gEdkiiFvFileIndexHobGuid, GET_NEXT_HOB (GuidHob)))
+  {
+    FileIndex = GET_GUID_HOB_DATA (GuidHob);
+    if ((FileIndex->FvBase == (EFI_PHYSICAL_ADDRESS)(UINTN)FvDevice->CachedFv) &&
+        (FileIndex->FvLength == FvSize) &&
+        (GET_GUID_HOB_DATA_SIZE (GuidHob) >= FV_FILE_INDEX_SIZE (FileIndex->FileCount)))
+    {
+      break;
+    }
+  }
+
+  if (GuidHob == NULL) {
+    return EFI_SUCCESS;
+  }
+
+  Entries = FV_FILE_INDEX_ENTRIES (FileIndex);
+  Next    = (UINT8 *)*FfsHeader;
+  for (Index = 0; Index < FileIndex->FileCount; Index++) {
+    Header = (EFI_FFS_FILE_HEADER *)(FvDevice->CachedFv + Entries[Index].Offset);
+    if (((UINT8 *)Header < Next) ||
+        (Entries[Index].Offset > FvSize - sizeof (EFI_FFS_FILE_HEADER)) ||
+        (IS_FFS_FILE2 (Header) && (Entries[Index].Offset > FvSize - sizeof (EFI_FFS_FILE_HEADER2))) ||
+        !CompareGuid (&Header->Name, &Entries[Index].Name) ||
+        (Header->Type != Entries[Index].Type) ||
+        !IsValidFfsHeader (FvDevice->ErasePolarity, Header, &FileState) ||
+        (FileState == EFI_FILE_HEADER_VALID) ||
+        (FileState == EFI_FILE_DELETED) ||
+        (IS_FFS_FILE2 (Header) && !FvDevice->IsFfs3Fv))
+    {
+      break;
+    }
+
+    FileSize = IS_FFS_FILE2 (Header) ? FFS_FILE2_SIZE (Header) : FFS_FILE_SIZE (Header);
+    if (FileSize > FvSize - Entries[Index].Offset) {
+      break;
+    }
+
+    CacheFfsHeader = Header;
+    FileCached     = FALSE;
+    if ((Header->Attributes & FFS_ATTRIB_CHECKSUM) == FFS_ATTRIB_CHECKSUM) {
+      //
+      // Cache the file for the checksum calculation and FvReadFile, as FvCheck() does.
+      //
+      CacheFfsHeader = AllocateCopyPool (FileSize, Header);
+      if (CacheFfsHeader == NULL) {
+        return EFI_OUT_OF_RESOURCES;
+      }
+
+      FileCached = TRUE;
+    }
+
+    if (!IsValidFfsFile (FvDevice->ErasePolarity, CacheFfsHeader)) {
+      if (FileCached) {
+        CoreFreePool (CacheFfsHeader);
+      }
+
+      break;
+    }
+
+    FfsFileEntry = AllocateZeroPool (sizeof (FFS_FILE_LIST_ENTRY));
+    if (FfsFileEntry == NULL) {
+      if (FileCached) {
+        CoreFreePool (CacheFfsHeader);
+      }
+
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    FfsFileEntry->FfsHeader  = CacheFfsHeader;
+    FfsFileEntry->FileCached = FileCached;
+    InsertTailList (&FvDevice->FfsFileListHeader, &FfsFileEntry->Link);
+
+    Next = (UINT8 *)ALIGN_POINTER ((UINT8 *)Header + FileSize, 8);
+  }
+
+  if (Index == FileIndex->FileCount) {
+    *FfsHeader = (EFI_FFS_FILE_HEADER *)Next;
+    return EFI_SUCCESS;
+  }
+
+  //
+  // The index does not match the FV, drop the files added from it.
+  //
+  DEBUG ((DEBUG_WARN, "File index of FV 0x%p is stale, walking the FV\n", FvDevice->CachedFv));
+  while (!IsListEmpty (&FvDevice->FfsFileListHeader)) {
+    Link         = GetFirstNode (&FvDevice->FfsFileListHeader);
+    FfsFileEntry = BASE_CR (Link, FFS_FILE_LIST_ENTRY, Link);
+    RemoveEntryList (Link);
+    if (FfsFileEntry->FileCached) {
+      CoreFreePool (FfsFileEntry->FfsHeader);
+    }
+
+    CoreFreePool (FfsFileEntry);
+  }
+
+  return EFI_SUCCESS;
+}
+
 /**
   Check if an FV is consistent and allocate cache for it.
 
@@ -434,7 +581,18 @@ FvCheck (
     FfsHeader = (EFI_FFS_FILE_HEADER *)(FvDevice->CachedFv + FwVolHeader->HeaderLength);
   }
 
-  FfsHeader    = (EFI_FFS_FILE_HEADER *)ALIGN_POINTER (FfsHeader, 8);
+  FfsHeader = (EFI_FFS_FILE_HEADER *)ALIGN_POINTER (FfsHeader, 8);
+
+  //
+  // Take the files that the PEI Core indexed from the file index HOB.
+  //
+  if (FvDevice->IsMemoryMapped) {
+    Status = AddFfsFilesFromIndex (FvDevice, &FfsHeader);
+    if (EFI_ERROR (Status)) {
+      goto Done;
+    }
+  }
+
   TopFvAddress = FvDevice->EndOfCachedFv;
   while (((UINTN)FfsHeader >= (UINTN)FvDevice->CachedFv) && ((UINTN)FfsHeader <= (UINTN)((UINTN)TopFvAddress - sizeof (EFI_FFS_FILE_HEADER)))) {
     if (FileCached) {
@@ -492,7 +492,8 @@ FvReadFileSection (
   // Use FfsEntry to cache Section Extraction Protocol Information
   //
   if (FfsEntry->StreamHandle == 0) {
-    Status = OpenSectionStream (
+    Status = OpenFileSectionStream (
+               &FfsEntry->FfsHeader->Name,
                FileSize,
                FileBuffer,
                &FfsEntry->StreamHandle
@@ -530,3 +531,115 @@ FvReadFileSection (
 Done:
   return Status;
 }
+
+/**
+  Get the contents of a file of a firmware volume produced by the DXE core in
+  the buffer the firmware volume keeps them in, which is also the buffer
+  ReadSection() opens the section stream of the file on.
+
+  The buffer stays in place until the firmware volume is freed.
+
+  @param  Fv                     The firmware volume.
+  @param  NameGuid               The name of the file.
+  @param  FileData               The contents of the file, without its header.
+  @param  FileSize               The size of FileData.
+  @param  FileType               The type of the file.
+
+  @retval EFI_SUCCESS            The file was found.
+  @retval EFI_UNSUPPORTED        Fv is not produced by the DXE core.
+  @return Others                 The error returned by ReadFile().
+
+**/
+EFI_STATUS
+CoreGetFvFileData (
+  IN  EFI_FIRMWARE_VOLUME2_PROTOCOL  *Fv,
+  IN  CONST EFI_GUID                 *NameGuid,
+  OUT VOID                           **FileData,
+  OUT UINTN                          *FileSize,
+  OUT EFI_FV_FILETYPE                *FileType
+  )
+{
+  EFI_STATUS              Status;
+  FV_DEVICE               *FvDevice;
+  EFI_FV_FILE_ATTRIBUTES  FileAttributes;
+  UINT32                  AuthenticationStatus;
+  EFI_FFS_FILE_HEADER     *FfsHeader;
+
+  if (Fv->ReadFile != FvReadFile) {
+    return EFI_UNSUPPORTED;
+  }
+
+  //
+  // Without a buffer, FvReadFile () only caches the file and leaves its
+  // FfsEntry in LastKey
+  //
+  Status = FvReadFile (Fv, NameGuid, NULL, FileSize, FileType, &FileAttributes, &AuthenticationStatus);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  FvDevice  = FV_DEVICE_FROM_THIS (Fv);
+  FfsHeader = FvDevice->LastKey->FfsHeader;
+  if (IS_FFS_FILE2 (FfsHeader)) {
+    *FileData = (UINT8 *)FfsHeader + sizeof (EFI_FFS_FILE_HEADER2);
+  } else {
+    *FileData = (UINT8 *)FfsHeader + sizeof (EFI_FFS_FILE_HEADER);
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Get the FFS header of a file of a firmware volume produced by the DXE core,
+  and the name of the firmware volume, without reading the file.
+
+  @param  Fv                     The firmware volume.
+  @param  NameGuid               The name of the file.
+  @param  FfsHeader              Returns the FFS header of the file.
+  @param  FvName                 Returns the name of the firmware volume from
+                                 its extended header, or a zero GUID if it has
+                                 none.
+
+  @retval EFI_SUCCESS            The file was found.
+  @retval EFI_UNSUPPORTED        Fv is not produced by the DXE core.
+  @return Others                 The error returned by ReadFile().
+
+**/
+EFI_STATUS
+CoreGetFvFileHeader (
+  IN  EFI_FIRMWARE_VOLUME2_PROTOCOL  *Fv,
+  IN  CONST EFI_GUID                 *NameGuid,
+  OUT CONST EFI_FFS_FILE_HEADER      **FfsHeader,
+  OUT EFI_GUID                       *FvName
+  )
+{
+  EFI_STATUS                      Status;
+  FV_DEVICE                       *FvDevice;
+  UINTN                           FileSize;
+  EFI_FV_FILETYPE                 FileType;
+  EFI_FV_FILE_ATTRIBUTES          FileAttributes;
+  UINT32                          AuthenticationStatus;
+  EFI_FIRMWARE_VOLUME_EXT_HEADER  *FvExtHeader;
+
+  if (Fv->ReadFile != FvReadFile) {
+    return EFI_UNSUPPORTED;
+  }
+
+  Status = FvReadFile (Fv, NameGuid, NULL, &FileSize, &FileType, &FileAttributes, &AuthenticationStatus);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  FvDevice   = FV_DEVICE_FROM_THIS (Fv);
+  *FfsHeader = FvDevice->LastKey->FfsHeader;
+
+  ZeroMem (FvName, sizeof (EFI_GUID));
+  if ((FvDevice->FwVolHeader->ExtHeaderOffset != 0) &&
+      ((UINTN)(FvDevice->EndOfCachedFv - FvDevice->CachedFv) >= FvDevice->FwVolHeader->ExtHeaderOffset + sizeof (EFI_FIRMWARE_VOLUME_EXT_HEADER)))
+  {
+    FvExtHeader = (EFI_FIRMWARE_VOLUME_EXT_HEADER *)(FvDevice->CachedFv + FvDevice->FwVolHeader->ExtHeaderOffset);
+    CopyGuid (FvName, &FvExtHeader->FvName);
+  }
+
+  return EFI_SUCCESS;
+}
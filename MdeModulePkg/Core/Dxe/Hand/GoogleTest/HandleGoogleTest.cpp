@@ -0,0 +1,378 @@
+/** @file
+  Host based tests and benchmark of the DXE core protocol database.
+
+  Handle.c, Locate.c and Notify.c are built as they are in the DXE core. The
+  TPL, lock, pool and driver model services they call are replaced by the
+  stubs of this file.
+
+  Copyright (c) 2026, TianoCore and contributors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+#include <Library/GoogleTestLib.h>
+#include <chrono>
+#include <vector>
+
+extern "C" {
+  #include "DxeMain.h"
+  #include "Handle.h"
+
+  EFI_HANDLE  gDxeCoreImageHandle = NULL;
+
+  EFI_TPL
+  EFIAPI
+  CoreRaiseTpl (
+    IN EFI_TPL  NewTpl
+    )
+  {
+    return TPL_APPLICATION;
+  }
+
+  VOID
+  EFIAPI
+  CoreRestoreTpl (
+    IN EFI_TPL  NewTpl
+    )
+  {
+  }
+
+  EFI_STATUS
+  EFIAPI
+  CoreSignalEvent (
+    IN EFI_EVENT  UserEvent
+    )
+  {
+    return EFI_SUCCESS;
+  }
+
+  EFI_STATUS
+  EFIAPI
+  CoreFreePool (
+    IN VOID  *Buffer
+    )
+  {
+    FreePool (Buffer);
+    return EFI_SUCCESS;
+  }
+
+  EFI_STATUS
+  EFIAPI
+  CoreConnectController (
+    IN  EFI_HANDLE                ControllerHandle,
+    IN  EFI_HANDLE                *DriverImageHandle    OPTIONAL,
+    IN  EFI_DEVICE_PATH_PROTOCOL  *RemainingDevicePath  OPTIONAL,
+    IN  BOOLEAN                   Recursive
+    )
+  {
+    return EFI_SUCCESS;
+  }
+
+  EFI_STATUS
+  EFIAPI
+  CoreDisconnectController (
+    IN  EFI_HANDLE  ControllerHandle,
+    IN  EFI_HANDLE  DriverImageHandle  OPTIONAL,
+    IN  EFI_HANDLE  ChildHandle        OPTIONAL
+    )
+  {
+    return EFI_SUCCESS;
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////
+// Helpers
+/////////////////////////////////////////////////////////////////////////
+
+//
+// The protocol GUIDs of a test. Each test uses its own range, as the
+// protocol entries stay in the database for good.
+//
+static EFI_GUID
+TestProtocolGuid (
+  UINT32  Test,
+  UINT32  Index
+  )
+{
+  EFI_GUID  Guid = {
+    0x6B1D0000 | Test, 0x3A5C, 0x4E27, { 0x9F, 0x10, 0x5D, 0x2C, 0x00, 0x00, 0x00, 0x00 }
+  };
+
+  Guid.Data4[4] = (UINT8)Index;
+  Guid.Data4[5] = (UINT8)(Index >> 8);
+  Guid.Data4[6] = (UINT8)(Index >> 16);
+  Guid.Data4[7] = (UINT8)(Index >> 24);
+  return Guid;
+}
+
+//
+// Swap the last two 32-bit words of a GUID. The protocol database hashes
+// a GUID by folding its words together, so both GUIDs land in the same
+// bucket and in the same slot of the per-handle cache.
+//
+static EFI_GUID
+SameHashGuid (
+  CONST EFI_GUID  &Guid
+  )
+{
+  UINT32    Words[4];
+  UINT32    Word;
+  EFI_GUID  Other;
+
+  CopyMem (Words, &Guid, sizeof (Words));
+  Word     = Words[2];
+  Words[2] = Words[3];
+  Words[3] = Word;
+
+  CopyMem (&Other, Words, sizeof (Other));
+  return Other;
+}
+
+static UINT64
+NanoSecondsSince (
+  std::chrono::steady_clock::time_point  Start
+  )
+{
+  return (UINT64)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now () - Start).count ();
+}
+
+/////////////////////////////////////////////////////////////////////////
+// Tests
+/////////////////////////////////////////////////////////////////////////
+
+class HandleTest : public ::testing::Test {
+protected:
+  std::vector<EFI_HANDLE>  Handles;
+
+  static void
+  SetUpTestSuite (
+    )
+  {
+    CoreInitializeHandleServices ();
+  }
+
+  //
+  // Install Protocol with Interface on a new handle, or on Handle.
+  //
+  EFI_HANDLE
+  Install (
+    EFI_GUID    *Protocol,
+    VOID        *Interface,
+    EFI_HANDLE  Handle = NULL
+    )
+  {
+    EFI_STATUS  Status;
+
+    Status = CoreInstallProtocolInterface (&Handle, Protocol, EFI_NATIVE_INTERFACE, Interface);
+    EXPECT_EQ (Status, EFI_SUCCESS);
+    return Handle;
+  }
+
+  VOID *
+  Lookup (
+    EFI_HANDLE  Handle,
+    EFI_GUID    *Protocol
+    )
+  {
+    VOID  *Interface;
+
+    if (EFI_ERROR (CoreHandleProtocol (Handle, Protocol, &Interface))) {
+      return NULL;
+    }
+
+    return Interface;
+  }
+
+  UINTN
+  CountHandles (
+    EFI_GUID  *Protocol
+    )
+  {
+    EFI_STATUS  Status;
+    UINTN       Count;
+    EFI_HANDLE  *Buffer;
+
+    Status = CoreLocateHandleBuffer (ByProtocol, Protocol, NULL, &Count, &Buffer);
+    if (Status == EFI_NOT_FOUND) {
+      return 0;
+    }
+
+    EXPECT_EQ (Status, EFI_SUCCESS);
+    CoreFreePool (Buffer);
+    return Count;
+  }
+};
+
+//
+// Every handle carrying a protocol is located, and HandleProtocol()
+// returns the interface of that handle.
+//
+TEST_F (HandleTest, InstallLocateUninstall) {
+  EFI_GUID  Protocol;
+  EFI_GUID  Other;
+  UINTN     Index;
+  UINT8     Interfaces[32];
+
+  Protocol = TestProtocolGuid (1, 0);
+  Other    = TestProtocolGuid (1, 1);
+  for (Index = 0; Index < ARRAY_SIZE (Interfaces); Index++) {
+    Handles.push_back (Install (&Protocol, &Interfaces[Index]));
+  }
+
+  EXPECT_EQ (CountHandles (&Protocol), ARRAY_SIZE (Interfaces));
+  EXPECT_EQ (CountHandles (&Other), 0U);
+  for (Index = 0; Index < ARRAY_SIZE (Interfaces); Index++) {
+    EXPECT_EQ (Lookup (Handles[Index], &Protocol), &Interfaces[Index]);
+    EXPECT_EQ (Lookup (Handles[Index], &Other), nullptr);
+  }
+
+  for (Index = 0; Index < ARRAY_SIZE (Interfaces); Index++) {
+    EXPECT_EQ (CoreUninstallProtocolInterface (Handles[Index], &Protocol, &Interfaces[Index]), EFI_SUCCESS);
+  }
+
+  EXPECT_EQ (CountHandles (&Protocol), 0U);
+}
+
+//
+// Two protocols with the same hash share a database bucket and a slot of
+// the per-handle cache. Lookups must still tell them apart, however they
+// alternate.
+//
+TEST_F (HandleTest, SameHashProtocols) {
+  EFI_GUID    First;
+  EFI_GUID    Second;
+  UINT8       Interfaces[2];
+  EFI_HANDLE  Handle;
+  UINTN       Index;
+
+  First  = TestProtocolGuid (2, 0x01020304);
+  Second = SameHashGuid (First);
+  ASSERT_FALSE (CompareGuid (&First, &Second));
+
+  Handle = Install (&First, &Interfaces[0]);
+  EXPECT_EQ (Lookup (Handle, &Second), nullptr);
+  Install (&Second, &Interfaces[1], Handle);
+
+  for (Index = 0; Index < 4; Index++) {
+    EXPECT_EQ (Lookup (Handle, &First), &Interfaces[0]);
+    EXPECT_EQ (Lookup (Handle, &Second), &Interfaces[1]);
+    EXPECT_EQ (Lookup (Handle, &Second), &Interfaces[1]);
+    EXPECT_EQ (Lookup (Handle, &First), &Interfaces[0]);
+  }
+
+  EXPECT_EQ (CountHandles (&First), 1U);
+  EXPECT_EQ (CountHandles (&Second), 1U);
+
+  //
+  // Removing the cached interface must not leave a stale cache slot
+  //
+  EXPECT_EQ (Lookup (Handle, &First), &Interfaces[0]);
+  EXPECT_EQ (CoreUninstallProtocolInterface (Handle, &First, &Interfaces[0]), EFI_SUCCESS);
+  EXPECT_EQ (Lookup (Handle, &First), nullptr);
+  EXPECT_EQ (Lookup (Handle, &Second), &Interfaces[1]);
+  EXPECT_EQ (CoreUninstallProtocolInterface (Handle, &Second, &Interfaces[1]), EFI_SUCCESS);
+}
+
+//
+// A reinstalled interface replaces the cached one.
+//
+TEST_F (HandleTest, Reinstall) {
+  EFI_GUID    Protocol;
+  UINT8       Interfaces[2];
+  EFI_HANDLE  Handle;
+
+  Protocol = TestProtocolGuid (3, 0);
+  Handle   = Install (&Protocol, &Interfaces[0]);
+  EXPECT_EQ (Lookup (Handle, &Protocol), &Interfaces[0]);
+
+  EXPECT_EQ (CoreReinstallProtocolInterface (Handle, &Protocol, &Interfaces[0], &Interfaces[1]), EFI_SUCCESS);
+  EXPECT_EQ (Lookup (Handle, &Protocol), &Interfaces[1]);
+  EXPECT_EQ (CoreUninstallProtocolInterface (Handle, &Protocol, &Interfaces[0]), EFI_NOT_FOUND);
+  EXPECT_EQ (CoreUninstallProtocolInterface (Handle, &Protocol, &Interfaces[1]), EFI_SUCCESS);
+  EXPECT_EQ (Lookup (Handle, &Protocol), nullptr);
+}
+
+//
+// Report the cost of the install, LocateHandleBuffer() and HandleProtocol()
+// paths as the number of handles grows. Each handle carries a few protocols
+// out of a larger set, like the PCI I/O, device path and driver protocols of
+// a device handle. With the hashed database, the install and HandleProtocol()
+// costs should stay flat, while LocateHandleBuffer() grows with the number of
+// handles it returns.
+//
+TEST_F (HandleTest, Benchmark) {
+  static CONST UINTN                     HandleCounts[] = { 64, 256, 1024, 4096 };
+  CONST UINTN                            ProtocolCount  = 128;
+  CONST UINTN                            PerHandle      = 8;
+  std::vector<EFI_GUID>                  Protocols;
+  UINT8                                  Interface;
+  UINTN                                  CountIndex;
+  UINTN                                  HandleIndex;
+  UINTN                                  Index;
+  UINTN                                  Iteration;
+  UINT64                                 InstallNs;
+  UINT64                                 LocateNs;
+  UINT64                                 LookupNs;
+  std::chrono::steady_clock::time_point  Start;
+
+  for (Index = 0; Index < ProtocolCount; Index++) {
+    Protocols.push_back (TestProtocolGuid (4, (UINT32)Index));
+  }
+
+  //
+  // The protocols of a handle are spread 16 apart, so they are all distinct
+  //
+  #define BENCHMARK_PROTOCOL(HandleIndex, Index)  (&Protocols[((HandleIndex) + (Index) * 16) % ProtocolCount])
+
+  printf ("%8s %16s %20s %20s\n", "Handles", "Install (ns)", "LocateHandle (ns)", "HandleProtocol (ns)");
+  for (CountIndex = 0; CountIndex < ARRAY_SIZE (HandleCounts); CountIndex++) {
+    Handles.assign (HandleCounts[CountIndex], (EFI_HANDLE)NULL);
+
+    Start = std::chrono::steady_clock::now ();
+    for (HandleIndex = 0; HandleIndex < Handles.size (); HandleIndex++) {
+      for (Index = 0; Index < PerHandle; Index++) {
+        Handles[HandleIndex] = Install (BENCHMARK_PROTOCOL (HandleIndex, Index), &Interface, Handles[HandleIndex]);
+      }
+    }
+
+    InstallNs = NanoSecondsSince (Start) / (Handles.size () * PerHandle);
+
+    Start = std::chrono::steady_clock::now ();
+    for (Iteration = 0; Iteration < 16; Iteration++) {
+      for (Index = 0; Index < ProtocolCount; Index++) {
+        EXPECT_EQ (CountHandles (&Protocols[Index]), Handles.size () * PerHandle / ProtocolCount);
+      }
+    }
+
+    LocateNs = NanoSecondsSince (Start) / (16 * ProtocolCount);
+
+    Start = std::chrono::steady_clock::now ();
+    for (Iteration = 0; Iteration < 4; Iteration++) {
+      for (HandleIndex = 0; HandleIndex < Handles.size (); HandleIndex++) {
+        for (Index = 0; Index < PerHandle; Index++) {
+          EXPECT_EQ (Lookup (Handles[HandleIndex], BENCHMARK_PROTOCOL (HandleIndex, Index)), &Interface);
+        }
+      }
+    }
+
+    LookupNs = NanoSecondsSince (Start) / (4 * Handles.size () * PerHandle);
+
+    printf ("%8u %16llu %20llu %20llu\n", (UINT32)Handles.size (), InstallNs, LocateNs, LookupNs);
+
+    for (HandleIndex = 0; HandleIndex < Handles.size (); HandleIndex++) {
+      for (Index = 0; Index < PerHandle; Index++) {
+        EXPECT_EQ (CoreUninstallProtocolInterface (Handles[HandleIndex], BENCHMARK_PROTOCOL (HandleIndex, Index), &Interface), EFI_SUCCESS);
+      }
+    }
+  }
+
+  #undef BENCHMARK_PROTOCOL
+}
+
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  testing::InitGoogleTest (&argc, argv);
+  return RUN_ALL_TESTS ();
+}
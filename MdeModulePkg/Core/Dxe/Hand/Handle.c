@@ -10,12 +10,14 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include "Handle.h"
 
 //
-// mProtocolDatabase     - A list of all protocols in the system.  (simple list for now)
+// mProtocolDatabase     - A list of all protocols in the system.
+// mProtocolHashTable    - The protocols in the system, hashed by protocol GUID
 // gHandleList           - A list of all the handles in the system
 // gProtocolDatabaseLock - Lock to protect the mProtocolDatabase
 // gHandleDatabaseKey    -  The Key to show that the handle has been created/modified
 //
 LIST_ENTRY          mProtocolDatabase     = INITIALIZE_LIST_HEAD_VARIABLE (mProtocolDatabase);
+LIST_ENTRY          mProtocolHashTable[PROTOCOL_HASH_BUCKET_COUNT];
 LIST_ENTRY          gHandleList           = INITIALIZE_LIST_HEAD_VARIABLE (gHandleList);
 EFI_LOCK            gProtocolDatabaseLock = EFI_INITIALIZE_LOCK_VARIABLE (TPL_NOTIFY);
 UINT64              gHandleDatabaseKey    = 0;
@@ -79,6 +81,32 @@ PointerCompare (
   return 1;
 }
 
+/**
+  Computes the protocol database hash of a protocol GUID.
+
+  @param  Protocol               The ID of the protocol
+
+  @return The hash value. The low bits select the mProtocolHashTable bucket.
+
+**/
+STATIC
+UINTN
+CoreHashProtocolGuid (
+  IN CONST EFI_GUID  *Protocol
+  )
+{
+  CONST UINT32  *Data;
+  UINT32        Hash;
+
+  Data = (CONST UINT32 *)Protocol;
+  Hash = ReadUnaligned32 (&Data[0]) ^ ReadUnaligned32 (&Data[1]) ^
+         ReadUnaligned32 (&Data[2]) ^ ReadUnaligned32 (&Data[3]);
+  Hash ^= Hash >> 16;
+  Hash ^= Hash >> 8;
+
+  return (UINTN)Hash;
+}
+
 /**
   Initializes "handle" support.
 
@@ -90,6 +118,12 @@ CoreInitializeHandleServices (
   VOID
   )
 {
+  UINTN  Index;
+
+  for (Index = 0; Index < PROTOCOL_HASH_BUCKET_COUNT; Index++) {
+    InitializeListHead (&mProtocolHashTable[Index]);
+  }
+
   gOrderedHandleList = OrderedCollectionInit (PointerCompare, PointerCompare);
 
   if (gOrderedHandleList == NULL) {
@@ -147,22 +181,26 @@ CoreFindProtocolEntry (
   )
 {
   LIST_ENTRY      *Link;
+  LIST_ENTRY      *Bucket;
   PROTOCOL_ENTRY  *Item;
   PROTOCOL_ENTRY  *ProtEntry;
+  UINTN           Hash;
 
   ASSERT_LOCKED (&gProtocolDatabaseLock);
 
   //
-  // Search the database for the matching GUID
+  // Search the hash bucket of the database for the matching GUID
   //
 
+  Hash      = CoreHashProtocolGuid (Protocol);
+  Bucket    = &mProtocolHashTable[Hash & (PROTOCOL_HASH_BUCKET_COUNT - 1)];
   ProtEntry = NULL;
-  for (Link = mProtocolDatabase.ForwardLink;
-       Link != &mProtocolDatabase;
+  for (Link = Bucket->ForwardLink;
+       Link != Bucket;
        Link = Link->ForwardLink)
   {
-    Item = CR (Link, PROTOCOL_ENTRY, AllEntries, PROTOCOL_ENTRY_SIGNATURE);
-    if (CompareGuid (&Item->ProtocolID, Protocol)) {
+    Item = CR (Link, PROTOCOL_ENTRY, HashLink, PROTOCOL_ENTRY_SIGNATURE);
+    if ((Item->Hash == Hash) && CompareGuid (&Item->ProtocolID, Protocol)) {
       //
       // This is the protocol entry
       //
@@ -184,14 +222,16 @@ CoreFindProtocolEntry (
       // Initialize new protocol entry structure
       //
       ProtEntry->Signature = PROTOCOL_ENTRY_SIGNATURE;
+      ProtEntry->Hash      = Hash;
       CopyGuid ((VOID *)&ProtEntry->ProtocolID, Protocol);
       InitializeListHead (&ProtEntry->Protocols);
       InitializeListHead (&ProtEntry->Notify);
 
       //
-      // Add it to protocol database
+      // Add it to protocol database and its hash bucket
       //
       InsertTailList (&mProtocolDatabase, &ProtEntry->AllEntries);
+      InsertTailList (Bucket, &ProtEntry->HashLink);
     }
   }
 
@@ -220,6 +260,7 @@ CoreFindProtocolInterface (
   PROTOCOL_INTERFACE  *Prot;
   PROTOCOL_ENTRY      *ProtEntry;
   LIST_ENTRY          *Link;
+  LIST_ENTRY          **CacheSlot;
 
   ASSERT_LOCKED (&gProtocolDatabaseLock);
   Prot = NULL;
@@ -230,6 +271,19 @@ CoreFindProtocolInterface (
 
   ProtEntry = CoreFindProtocolEntry (Protocol, FALSE);
   if (ProtEntry != NULL) {
+    //
+    // Check the handle's lookup cache first
+    //
+    CacheSlot = &Handle->ProtocolCache[ProtEntry->Hash & (HANDLE_PROTOCOL_CACHE_SIZE - 1)];
+    if (*CacheSlot != NULL) {
+      Prot = CR (*CacheSlot, PROTOCOL_INTERFACE, Link, PROTOCOL_INTERFACE_SIGNATURE);
+      if ((Prot->Interface == Interface) && (Prot->Protocol == ProtEntry)) {
+        return Prot;
+      }
+
+      Prot = NULL;
+    }
+
     //
     // Look at each protocol interface for any matches
     //
@@ -239,6 +293,7 @@ CoreFindProtocolInterface (
       //
       Prot = CR (Link, PROTOCOL_INTERFACE, Link, PROTOCOL_INTERFACE_SIGNATURE);
       if ((Prot->Interface == Interface) && (Prot->Protocol == ProtEntry)) {
+        *CacheSlot = Link;
         break;
       }
 
@@ -249,6 +304,29 @@ CoreFindProtocolInterface (
   return Prot;
 }
 
+/**
+  Drops a protocol interface from the lookup cache of the handle it is installed on.
+  The gProtocolDatabaseLock must be owned
+
+  @param  Prot                   The protocol interface being removed from its handle
+
+**/
+STATIC
+VOID
+CoreInvalidateHandleProtocolCache (
+  IN PROTOCOL_INTERFACE  *Prot
+  )
+{
+  LIST_ENTRY  **CacheSlot;
+
+  ASSERT_LOCKED (&gProtocolDatabaseLock);
+
+  CacheSlot = &Prot->Handle->ProtocolCache[Prot->Protocol->Hash & (HANDLE_PROTOCOL_CACHE_SIZE - 1)];
+  if (*CacheSlot == &Prot->Link) {
+    *CacheSlot = NULL;
+  }
+}
+
 /**
   Check if the given device path is already installed.
 
@@ -872,6 +950,7 @@ CoreUninstallProtocolInterface (
     //
     // Remove the protocol interface from the handle
     //
+    CoreInvalidateHandleProtocolCache (Prot);
     RemoveEntryList (&Prot->Link);
 
     //
@@ -1003,16 +1082,37 @@ CoreGetProtocolInterface (
   PROTOCOL_INTERFACE  *Prot;
   IHANDLE             *Handle;
   LIST_ENTRY          *Link;
+  LIST_ENTRY          **CacheSlot;
 
   Handle = (IHANDLE *)UserHandle;
 
+  //
+  // Lookup the protocol entry for this protocol ID. If the protocol
+  // was never installed, it cannot be on this handle.
+  //
+  ProtEntry = CoreFindProtocolEntry (Protocol, FALSE);
+  if (ProtEntry == NULL) {
+    return NULL;
+  }
+
+  //
+  // Check the handle's lookup cache first
+  //
+  CacheSlot = &Handle->ProtocolCache[ProtEntry->Hash & (HANDLE_PROTOCOL_CACHE_SIZE - 1)];
+  if (*CacheSlot != NULL) {
+    Prot = CR (*CacheSlot, PROTOCOL_INTERFACE, Link, PROTOCOL_INTERFACE_SIGNATURE);
+    if (Prot->Protocol == ProtEntry) {
+      return Prot;
+    }
+  }
+
   //
   // Look at each protocol interface for a match
   //
   for (Link = Handle->Protocols.ForwardLink; Link != &Handle->Protocols; Link = Link->ForwardLink) {
-    Prot      = CR (Link, PROTOCOL_INTERFACE, Link, PROTOCOL_INTERFACE_SIGNATURE);
-    ProtEntry = Prot->Protocol;
-    if (CompareGuid (&ProtEntry->ProtocolID, Protocol)) {
+    Prot = CR (Link, PROTOCOL_INTERFACE, Link, PROTOCOL_INTERFACE_SIGNATURE);
+    if (Prot->Protocol == ProtEntry) {
+      *CacheSlot = Link;
       return Prot;
     }
   }
@@ -11,6 +11,16 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #define EFI_HANDLE_SIGNATURE  SIGNATURE_32('h','n','d','l')
 
+///
+/// Number of buckets in the GUID hash of the protocol database. Must be a power of 2.
+///
+#define PROTOCOL_HASH_BUCKET_COUNT  64
+
+///
+/// Number of slots in the per-handle protocol interface lookup cache. Must be a power of 2.
+///
+#define HANDLE_PROTOCOL_CACHE_SIZE  4
+
 ///
 /// IHANDLE - contains a list of protocol handles
 ///
@@ -23,6 +33,8 @@ typedef struct {
   UINTN         LocateRequest;
   /// The Handle Database Key value when this handle was last created or modified
   UINT64        Key;
+  /// Direct-mapped cache of PROTOCOL_INTERFACE.Link entries, indexed by PROTOCOL_ENTRY.Hash
+  LIST_ENTRY    *ProtocolCache[HANDLE_PROTOCOL_CACHE_SIZE];
 } IHANDLE;
 
 #define ASSERT_IS_HANDLE(a)  ASSERT((a)->Signature == EFI_HANDLE_SIGNATURE)
@@ -38,6 +50,10 @@ typedef struct {
   UINTN         Signature;
   /// Link Entry inserted to mProtocolDatabase
   LIST_ENTRY    AllEntries;
+  /// Link Entry inserted to the mProtocolHashTable bucket selected by Hash
+  LIST_ENTRY    HashLink;
+  /// Hash of ProtocolID
+  UINTN         Hash;
   /// ID of the protocol
   EFI_GUID      ProtocolID;
   /// All protocol interfaces
@@ -582,12 +582,13 @@ CoreLoadPeImage (
   IN  UINT32                    Attribute
   )
 {
-  EFI_STATUS  Status;
-  BOOLEAN     DstBufAlocated;
-  UINTN       Size;
-  UINTN       Index;
-  UINTN       StartIndex;
-  CHAR8       EfiFileName[512];
+  EFI_STATUS           Status;
+  BOOLEAN              DstBufAlocated;
+  UINTN                Size;
+  UINTN                Index;
+  UINTN                StartIndex;
+  CHAR8                EfiFileName[512];
+  CORE_PREPARED_IMAGE  *PreparedImage;
 
   ZeroMem (&Image->ImageContext, sizeof (Image->ImageContext));
 
@@ -637,11 +638,36 @@ CoreLoadPeImage (
       return EFI_UNSUPPORTED;
   }
 
+  //
+  // Adopt the image if the dispatcher already loaded and relocated it on an
+  // application processor.
+  //
+  PreparedImage = ((IMAGE_FILE_HANDLE *)Pe32Handle)->PreparedImage;
+  if ((PreparedImage != NULL) &&
+      ((DstBuffer != 0) || EFI_ERROR (PreparedImage->Status) ||
+       (PreparedImage->ImageContext.ImageType != Image->ImageContext.ImageType)))
+  {
+    PreparedImage = NULL;
+  }
+
   //
   // Allocate memory of the correct memory type aligned on the required image boundary
   //
   DstBufAlocated = FALSE;
-  if (DstBuffer == 0) {
+  if (PreparedImage != NULL) {
+    CopyMem (&Image->ImageContext, &PreparedImage->ImageContext, sizeof (Image->ImageContext));
+    Image->ImageContext.Handle    = Pe32Handle;
+    Image->ImageContext.ImageRead = (PE_COFF_LOADER_READ_FILE)CoreReadImageFile;
+    Image->NumberOfPages          = PreparedImage->NumberOfPages;
+    Image->ImageBasePage          = PreparedImage->ImageBasePage;
+    PreparedImage->NumberOfPages  = 0;
+    DstBufAlocated                = TRUE;
+
+    //
+    // The image was relocated without the extra action, which must run on the BSP
+    //
+    PeCoffLoaderRelocateImageExtraAction (&Image->ImageContext);
+  } else if (DstBuffer == 0) {
     //
     // Allocate Destination Buffer as caller did not pass it in
     //
@@ -735,42 +761,44 @@ CoreLoadPeImage (
     Image->ImageContext.ImageAddress = DstBuffer;
   }
 
-  Image->ImageBasePage = Image->ImageContext.ImageAddress;
-  if (!Image->ImageContext.IsTeImage) {
-    Image->ImageContext.ImageAddress =
-      (Image->ImageContext.ImageAddress + Image->ImageContext.SectionAlignment - 1) &
-      ~((UINTN)Image->ImageContext.SectionAlignment - 1);
-  }
+  if (PreparedImage == NULL) {
+    Image->ImageBasePage = Image->ImageContext.ImageAddress;
+    if (!Image->ImageContext.IsTeImage) {
+      Image->ImageContext.ImageAddress =
+        (Image->ImageContext.ImageAddress + Image->ImageContext.SectionAlignment - 1) &
+        ~((UINTN)Image->ImageContext.SectionAlignment - 1);
+    }
 
-  //
-  // Load the image from the file into the allocated memory
-  //
-  Status = PeCoffLoaderLoadImage (&Image->ImageContext);
-  if (EFI_ERROR (Status)) {
-    goto Done;
-  }
+    //
+    // Load the image from the file into the allocated memory
+    //
+    Status = PeCoffLoaderLoadImage (&Image->ImageContext);
+    if (EFI_ERROR (Status)) {
+      goto Done;
+    }
 
-  //
-  // If this is a Runtime Driver, then allocate memory for the FixupData that
-  // is used to relocate the image when SetVirtualAddressMap() is called. The
-  // relocation is done by the Runtime AP.
-  //
-  if ((Attribute & EFI_LOAD_PE_IMAGE_ATTRIBUTE_RUNTIME_REGISTRATION) != 0) {
-    if (Image->ImageContext.ImageType == EFI_IMAGE_SUBSYSTEM_EFI_RUNTIME_DRIVER) {
-      Image->ImageContext.FixupData = AllocateRuntimePool ((UINTN)(Image->ImageContext.FixupDataSize));
-      if (Image->ImageContext.FixupData == NULL) {
-        Status = EFI_OUT_OF_RESOURCES;
-        goto Done;
+    //
+    // If this is a Runtime Driver, then allocate memory for the FixupData that
+    // is used to relocate the image when SetVirtualAddressMap() is called. The
+    // relocation is done by the Runtime AP.
+    //
+    if ((Attribute & EFI_LOAD_PE_IMAGE_ATTRIBUTE_RUNTIME_REGISTRATION) != 0) {
+      if (Image->ImageContext.ImageType == EFI_IMAGE_SUBSYSTEM_EFI_RUNTIME_DRIVER) {
+        Image->ImageContext.FixupData = AllocateRuntimePool ((UINTN)(Image->ImageContext.FixupDataSize));
+        if (Image->ImageContext.FixupData == NULL) {
+          Status = EFI_OUT_OF_RESOURCES;
+          goto Done;
+        }
       }
     }
-  }
 
-  //
-  // Relocate the image in memory
-  //
-  Status = PeCoffLoaderRelocateImage (&Image->ImageContext);
-  if (EFI_ERROR (Status)) {
-    goto Done;
+    //
+    // Relocate the image in memory
+    //
+    Status = PeCoffLoaderRelocateImage (&Image->ImageContext);
+    if (EFI_ERROR (Status)) {
+      goto Done;
+    }
   }
 
   //
@@ -956,6 +984,7 @@ CoreUnloadAndCloseImage (
 
   if (Image->Started) {
     UnregisterMemoryProfileImage (Image);
+    CoreUnregisterServiceTraceImage (Image);
   }
 
   UnprotectUefiImage (&Image->Info, Image->LoadedImageDevicePath);
@@ -1238,14 +1267,25 @@ CoreLoadImageCommon (
     }
 
     //
-    // Get the source file buffer by its device path.
+    // Get the source file buffer by its device path, unless the dispatcher
+    // already read and loaded it.
     //
-    FHand.Source = GetFileBufferByFilePath (
-                     BootPolicy,
-                     FilePath,
-                     &FHand.SourceSize,
-                     &AuthenticationStatus
-                     );
+    if ((mPendingPreparedImage != NULL) && (mPendingPreparedImage->FilePath == FilePath) && !BootPolicy) {
+      FHand.PreparedImage                   = mPendingPreparedImage;
+      FHand.Source                          = FHand.PreparedImage->FHand.Source;
+      FHand.SourceSize                      = FHand.PreparedImage->FHand.SourceSize;
+      AuthenticationStatus                  = FHand.PreparedImage->AuthenticationStatus;
+      FHand.PreparedImage->FHand.FreeBuffer = FALSE;
+      mPendingPreparedImage                 = NULL;
+    } else {
+      FHand.Source = CoreGetImageFileBuffer (
+                       BootPolicy,
+                       FilePath,
+                       &FHand.SourceSize,
+                       &AuthenticationStatus
+                       );
+    }
+
     if (FHand.Source == NULL) {
       Status = EFI_NOT_FOUND;
     } else {
@@ -1692,6 +1732,7 @@ CoreStartImage (
   //
   if (SetJumpFlag == 0) {
     RegisterMemoryProfileImage (Image, (Image->ImageContext.ImageType == EFI_IMAGE_SUBSYSTEM_EFI_APPLICATION ? EFI_FV_FILETYPE_APPLICATION : EFI_FV_FILETYPE_DRIVER));
+    CoreRegisterServiceTraceImage (Image);
     //
     // Call the image's entry point
     //
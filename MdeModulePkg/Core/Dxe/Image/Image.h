@@ -14,10 +14,79 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 //
 #define IMAGE_FILE_HANDLE_SIGNATURE  SIGNATURE_32('i','m','g','f')
 typedef struct {
-  UINTN      Signature;
-  BOOLEAN    FreeBuffer;
-  VOID       *Source;
-  UINTN      SourceSize;
+  UINTN                  Signature;
+  BOOLEAN                FreeBuffer;
+  VOID                   *Source;
+  UINTN                  SourceSize;
+  CORE_PREPARED_IMAGE    *PreparedImage;
 } IMAGE_FILE_HANDLE;
 
+//
+// An image read, loaded and relocated by the parallel image loader ahead of
+// the CoreLoadImage () call that adopts it.
+//
+struct _CORE_PREPARED_IMAGE {
+  EFI_DEVICE_PATH_PROTOCOL        *FilePath;
+  IMAGE_FILE_HANDLE               FHand;
+  UINT32                          AuthenticationStatus;
+  PE_COFF_LOADER_IMAGE_CONTEXT    ImageContext;
+  EFI_PHYSICAL_ADDRESS            ImageBasePage;
+  UINTN                           NumberOfPages;
+  EFI_STATUS                      Status;
+};
+
+//
+// Prepared image handed to the next CoreLoadImageCommon () call.
+//
+extern CORE_PREPARED_IMAGE  *mPendingPreparedImage;
+
+/**
+  Get the file buffer of an image, from the image cache if it holds the image
+  of an unchanged FFS file, or by its device path otherwise.
+
+  Images read from a firmware volume with an authentication status of zero are
+  added to the image cache for the next boot. Images taken from the image
+  cache are returned with EFI_AUTH_STATUS_NOT_TESTED, as the region they are
+  kept in is not protected from the OS.
+
+  @param  BootPolicy              Policy for Open Image File.
+  @param  FilePath                The device path of the image file.
+  @param  FileSize                Returns the size of the image file.
+  @param  AuthenticationStatus    Returns the authentication status of the
+                                  image file.
+
+  @return A pool buffer with the image file, or NULL if it cannot be read.
+
+**/
+VOID *
+CoreGetImageFileBuffer (
+  IN  BOOLEAN                         BootPolicy,
+  IN  CONST EFI_DEVICE_PATH_PROTOCOL  *FilePath,
+  OUT UINTN                           *FileSize,
+  OUT UINT32                          *AuthenticationStatus
+  );
+
+/**
+  Read image file (specified by UserHandle) into user specified buffer with specified offset
+  and length.
+
+  @param  UserHandle             Image file handle
+  @param  Offset                 Offset to the source file
+  @param  ReadSize               For input, pointer of size to read; For output,
+                                 pointer of size actually read.
+  @param  Buffer                 Buffer to write into
+
+  @retval EFI_SUCCESS            Successfully read the specified part of file
+                                 into buffer.
+
+**/
+EFI_STATUS
+EFIAPI
+CoreReadImageFile (
+  IN     VOID   *UserHandle,
+  IN     UINTN  Offset,
+  IN OUT UINTN  *ReadSize,
+  OUT    VOID   *Buffer
+  );
+
 #endif
@@ -0,0 +1,431 @@
+/** @file
+  Keep the decompressed images of firmware volume drivers in a memory region
+  that survives warm resets.
+
+  PcdDxeImageCacheBase and PcdDxeImageCacheSize describe a region that the
+  platform leaves untouched across warm resets. Every image read from a
+  firmware volume with an authentication status of zero is copied there,
+  keyed by the name of the firmware volume, the name of its FFS file and the
+  size and CRC32 of the whole FFS file. On the next boot an image whose FFS
+  file is unchanged is taken from the region instead of being decompressed
+  again. The CRC32 of each image is checked before it is used, and the whole
+  region is discarded when its header does not match, as after a cold reset.
+
+  The region is reserved memory that the OS can write, and the CRC32 values
+  are kept in the same region, so they only detect damage and not tampering.
+  The DXE core has neither a SHA-256 implementation nor storage the OS cannot
+  write to keep a reference digest in. Cached images are therefore only used
+  when UEFI Secure Boot is disabled and no TCG measurement protocol is
+  installed, and are returned with EFI_AUTH_STATUS_NOT_TESTED. They are
+  loaded and relocated by CoreLoadPeImage () like any other image.
+
+Copyright (c) 2026, TianoCore and contributors. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "DxeMain.h"
+#include "Image.h"
+
+#define DXE_IMAGE_CACHE_SIGNATURE    SIGNATURE_32 ('D', 'I', 'M', 'C')
+#define DXE_IMAGE_CACHE_VERSION      3
+#define DXE_IMAGE_CACHE_MAX_ENTRIES  256
+
+typedef struct {
+  EFI_GUID    FvName;      // Name of the firmware volume, or zero
+  EFI_GUID    FileName;    // Name of the FFS file
+  UINT32      FileSize;    // Size of the FFS file, from its header
+  UINT32      FileCrc;     // CRC32 of the whole FFS file
+  UINT32      ImageSize;   // Size of the image
+  UINT32      ImageCrc;    // CRC32 of the image
+  UINT64      ImageOffset; // Offset of the image from the start of the region
+} DXE_IMAGE_CACHE_ENTRY;
+
+typedef struct {
+  UINT32                   Signature;
+  UINT32                   Version;
+  UINT32                   HeaderCrc;  // CRC32 of this structure, with HeaderCrc zero
+  UINT32                   EntryCount;
+  UINT64                   RegionSize;
+  UINT64                   UsedSize;   // Bytes used from the start of the region
+  DXE_IMAGE_CACHE_ENTRY    Entry[DXE_IMAGE_CACHE_MAX_ENTRIES];
+} DXE_IMAGE_CACHE_HEADER;
+
+typedef enum {
+  ImageCacheUninitialized,
+  ImageCacheDisabled,
+  ImageCacheReady
+} IMAGE_CACHE_STATE;
+
+STATIC IMAGE_CACHE_STATE       mImageCacheState = ImageCacheUninitialized;
+STATIC DXE_IMAGE_CACHE_HEADER  *mImageCache     = NULL;
+
+/**
+  Update the header CRC of the image cache and write the header back to
+  memory.
+
+**/
+STATIC
+VOID
+UpdateImageCacheHeader (
+  VOID
+  )
+{
+  mImageCache->HeaderCrc = 0;
+  mImageCache->HeaderCrc = CalculateCrc32 (mImageCache, sizeof (DXE_IMAGE_CACHE_HEADER));
+  WriteBackDataCacheRange (mImageCache, sizeof (DXE_IMAGE_CACHE_HEADER));
+}
+
+/**
+  Remove all the images from the image cache.
+
+**/
+STATIC
+VOID
+ResetImageCache (
+  VOID
+  )
+{
+  ZeroMem (mImageCache, sizeof (DXE_IMAGE_CACHE_HEADER));
+  mImageCache->Signature  = DXE_IMAGE_CACHE_SIGNATURE;
+  mImageCache->Version    = DXE_IMAGE_CACHE_VERSION;
+  mImageCache->RegionSize = PcdGet32 (PcdDxeImageCacheSize);
+  mImageCache->UsedSize   = ALIGN_VALUE (sizeof (DXE_IMAGE_CACHE_HEADER), 8);
+  UpdateImageCacheHeader ();
+}
+
+/**
+  Reserve the image cache region and check the images left in it by the
+  previous boot.
+
+  @retval TRUE   The image cache can be used.
+  @retval FALSE  The image cache is disabled.
+
+**/
+STATIC
+BOOLEAN
+InitializeImageCache (
+  VOID
+  )
+{
+  EFI_STATUS            Status;
+  EFI_PHYSICAL_ADDRESS  Base;
+  EFI_BOOT_MODE         BootMode;
+  UINT32                HeaderCrc;
+
+  if (mImageCacheState != ImageCacheUninitialized) {
+    return (BOOLEAN)(mImageCacheState == ImageCacheReady);
+  }
+
+  mImageCacheState = ImageCacheDisabled;
+
+  //
+  // The firmware volumes may be changing under a flash update, and a recovery
+  // boot must not depend on what the failed boot left in memory.
+  //
+  BootMode = GetBootModeHob ();
+  if ((PcdGet64 (PcdDxeImageCacheBase) == 0) ||
+      (PcdGet32 (PcdDxeImageCacheSize) < sizeof (DXE_IMAGE_CACHE_HEADER)) ||
+      ((PcdGet64 (PcdDxeImageCacheBase) & EFI_PAGE_MASK) != 0) ||
+      (BootMode == BOOT_ON_FLASH_UPDATE) ||
+      (BootMode == BOOT_IN_RECOVERY_MODE))
+  {
+    return FALSE;
+  }
+
+  Base   = PcdGet64 (PcdDxeImageCacheBase);
+  Status = CoreAllocatePages (
+             AllocateAddress,
+             EfiReservedMemoryType,
+             EFI_SIZE_TO_PAGES (PcdGet32 (PcdDxeImageCacheSize)),
+             &Base
+             );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_WARN, "Image cache region 0x%lx is not available - %r\n", PcdGet64 (PcdDxeImageCacheBase), Status));
+    return FALSE;
+  }
+
+  mImageCache = (DXE_IMAGE_CACHE_HEADER *)(UINTN)Base;
+
+  HeaderCrc              = mImageCache->HeaderCrc;
+  mImageCache->HeaderCrc = 0;
+  if ((mImageCache->Signature != DXE_IMAGE_CACHE_SIGNATURE) ||
+      (mImageCache->Version != DXE_IMAGE_CACHE_VERSION) ||
+      (CalculateCrc32 (mImageCache, sizeof (DXE_IMAGE_CACHE_HEADER)) != HeaderCrc) ||
+      (mImageCache->RegionSize != PcdGet32 (PcdDxeImageCacheSize)) ||
+      (mImageCache->EntryCount > DXE_IMAGE_CACHE_MAX_ENTRIES) ||
+      (mImageCache->UsedSize > mImageCache->RegionSize))
+  {
+    ResetImageCache ();
+  } else {
+    mImageCache->HeaderCrc = HeaderCrc;
+    DEBUG ((DEBUG_INFO, "Image cache holds %d images from the previous boot\n", mImageCache->EntryCount));
+  }
+
+  mImageCacheState = ImageCacheReady;
+  return TRUE;
+}
+
+/**
+  Check that images may be taken from the image cache.
+
+  A cached image may have been modified by the OS, so it must not be used
+  when UEFI Secure Boot or measured boot rely on the images of the firmware
+  volumes. Secure Boot can only be checked once the variable services are
+  available, cached images are not used before.
+
+  @retval TRUE   Images may be taken from the image cache.
+  @retval FALSE  Images must be read from the firmware volumes.
+
+**/
+STATIC
+BOOLEAN
+ImageCacheHitAllowed (
+  VOID
+  )
+{
+  EFI_STATUS  Status;
+  VOID        *Interface;
+  UINT8       SecureBoot;
+  UINTN       DataSize;
+
+  if (!EFI_ERROR (CoreLocateProtocol (&gEfiTcgProtocolGuid, NULL, &Interface)) ||
+      !EFI_ERROR (CoreLocateProtocol (&gEfiTcg2ProtocolGuid, NULL, &Interface)) ||
+      !EFI_ERROR (CoreLocateProtocol (&gEfiCcMeasurementProtocolGuid, NULL, &Interface)) ||
+      EFI_ERROR (CoreLocateProtocol (&gEfiVariableArchProtocolGuid, NULL, &Interface)))
+  {
+    return FALSE;
+  }
+
+  DataSize = sizeof (SecureBoot);
+  Status   = gDxeCoreRT->GetVariable (
+                           EFI_SECURE_BOOT_MODE_NAME,
+                           &gEfiGlobalVariableGuid,
+                           NULL,
+                           &DataSize,
+                           &SecureBoot
+                           );
+  if (Status == EFI_NOT_FOUND) {
+    return TRUE;
+  }
+
+  return (BOOLEAN)(!EFI_ERROR (Status) && (SecureBoot == SECURE_BOOT_MODE_DISABLE));
+}
+
+/**
+  Get the key of an image in the image cache from the FFS file it is read
+  from. The file is not read through the firmware volume protocol, the DXE
+  core already holds it in memory.
+
+  @param  FilePath                The device path of the image file.
+  @param  Entry                   Returns the FvName, FileName, FileSize and
+                                  FileCrc of the image.
+
+  @retval TRUE   The image is read from a firmware volume produced by the DXE
+                 core, and Entry is set.
+  @retval FALSE  The image cannot be cached.
+
+**/
+STATIC
+BOOLEAN
+GetImageCacheKey (
+  IN  CONST EFI_DEVICE_PATH_PROTOCOL  *FilePath,
+  OUT DXE_IMAGE_CACHE_ENTRY           *Entry
+  )
+{
+  EFI_STATUS                     Status;
+  EFI_DEVICE_PATH_PROTOCOL       *RemainingPath;
+  EFI_HANDLE                     FvHandle;
+  EFI_FIRMWARE_VOLUME2_PROTOCOL  *Fv;
+  EFI_GUID                       *FileName;
+  CONST EFI_FFS_FILE_HEADER      *FfsHeader;
+
+  RemainingPath = (EFI_DEVICE_PATH_PROTOCOL *)FilePath;
+  Status        = CoreLocateDevicePath (&gEfiFirmwareVolume2ProtocolGuid, &RemainingPath, &FvHandle);
+  if (EFI_ERROR (Status)) {
+    return FALSE;
+  }
+
+  FileName = EfiGetNameGuidFromFwVolDevicePathNode ((MEDIA_FW_VOL_FILEPATH_DEVICE_PATH *)RemainingPath);
+  if ((FileName == NULL) || !IsDevicePathEnd (NextDevicePathNode (RemainingPath))) {
+    return FALSE;
+  }
+
+  Status = CoreHandleProtocol (FvHandle, &gEfiFirmwareVolume2ProtocolGuid, (VOID **)&Fv);
+  if (EFI_ERROR (Status)) {
+    return FALSE;
+  }
+
+  ZeroMem (Entry, sizeof (DXE_IMAGE_CACHE_ENTRY));
+  Status = CoreGetFvFileHeader (Fv, FileName, &FfsHeader, &Entry->FvName);
+  if (EFI_ERROR (Status)) {
+    return FALSE;
+  }
+
+  CopyGuid (&Entry->FileName, FileName);
+  if (IS_FFS_FILE2 (FfsHeader)) {
+    Entry->FileSize = FFS_FILE2_SIZE (FfsHeader);
+  } else {
+    Entry->FileSize = FFS_FILE_SIZE (FfsHeader);
+  }
+
+  Entry->FileCrc = CalculateCrc32 ((VOID *)FfsHeader, Entry->FileSize);
+
+  return TRUE;
+}
+
+/**
+  Copy an image out of the image cache.
+
+  The caller must hold the TPL at TPL_NOTIFY.
+
+  @param  Key                     The key returned by GetImageCacheKey ().
+  @param  ImageSize               Returns the size of the image.
+
+  @return A pool copy of the image, or NULL if the image is not in the cache.
+
+**/
+STATIC
+VOID *
+GetImageFromCache (
+  IN  CONST DXE_IMAGE_CACHE_ENTRY  *Key,
+  OUT UINTN                        *ImageSize
+  )
+{
+  DXE_IMAGE_CACHE_ENTRY  *Entry;
+  UINT8                  *Image;
+  UINT32                 Index;
+
+  for (Index = 0; Index < mImageCache->EntryCount; Index++) {
+    Entry = &mImageCache->Entry[Index];
+    if ((Entry->FileSize != Key->FileSize) || (Entry->FileCrc != Key->FileCrc) ||
+        !CompareGuid (&Entry->FileName, &Key->FileName) || !CompareGuid (&Entry->FvName, &Key->FvName))
+    {
+      continue;
+    }
+
+    Image = (UINT8 *)mImageCache + (UINTN)Entry->ImageOffset;
+    if ((Entry->ImageOffset > mImageCache->UsedSize) ||
+        (Entry->ImageSize > mImageCache->UsedSize - Entry->ImageOffset) ||
+        (CalculateCrc32 (Image, Entry->ImageSize) != Entry->ImageCrc))
+    {
+      //
+      // The image was damaged, drop the entry so that it is cached again.
+      //
+      ZeroMem (&Entry->FileName, sizeof (EFI_GUID));
+      UpdateImageCacheHeader ();
+      return NULL;
+    }
+
+    *ImageSize = Entry->ImageSize;
+    return AllocateCopyPool (Entry->ImageSize, Image);
+  }
+
+  return NULL;
+}
+
+/**
+  Add an image to the image cache. If the cache is full, it is emptied first,
+  so that images of firmware that is no longer present do not fill it for
+  good.
+
+  The caller must hold the TPL at TPL_NOTIFY.
+
+  @param  Key                     The key returned by GetImageCacheKey ().
+  @param  Image                   The image read from the firmware volume.
+  @param  ImageSize               The size of the image.
+
+**/
+STATIC
+VOID
+AddImageToCache (
+  IN CONST DXE_IMAGE_CACHE_ENTRY  *Key,
+  IN CONST VOID                   *Image,
+  IN UINTN                        ImageSize
+  )
+{
+  DXE_IMAGE_CACHE_ENTRY  *Entry;
+  UINT64                 Size;
+
+  Size = ALIGN_VALUE ((UINT64)ImageSize, 8);
+  if ((ImageSize > MAX_UINT32) ||
+      (Size > mImageCache->RegionSize - ALIGN_VALUE (sizeof (DXE_IMAGE_CACHE_HEADER), 8)))
+  {
+    return;
+  }
+
+  if ((mImageCache->EntryCount == DXE_IMAGE_CACHE_MAX_ENTRIES) ||
+      (Size > mImageCache->RegionSize - mImageCache->UsedSize))
+  {
+    DEBUG ((DEBUG_INFO, "Image cache is full, emptying it\n"));
+    ResetImageCache ();
+  }
+
+  Entry = &mImageCache->Entry[mImageCache->EntryCount];
+  CopyMem (Entry, Key, sizeof (DXE_IMAGE_CACHE_ENTRY));
+  Entry->ImageSize   = (UINT32)ImageSize;
+  Entry->ImageCrc    = CalculateCrc32 ((VOID *)Image, ImageSize);
+  Entry->ImageOffset = mImageCache->UsedSize;
+
+  CopyMem ((UINT8 *)mImageCache + (UINTN)Entry->ImageOffset, Image, ImageSize);
+  WriteBackDataCacheRange ((UINT8 *)mImageCache + (UINTN)Entry->ImageOffset, ImageSize);
+
+  mImageCache->UsedSize += Size;
+  mImageCache->EntryCount++;
+  UpdateImageCacheHeader ();
+}
+
+/**
+  Get the file buffer of an image, from the image cache if it holds the image
+  of an unchanged FFS file, or by its device path otherwise.
+
+  Images read from a firmware volume with an authentication status of zero are
+  added to the image cache for the next boot. Images are only taken from the
+  image cache when ImageCacheHitAllowed () allows it, and are then returned
+  with EFI_AUTH_STATUS_NOT_TESTED, as the region they are kept in is not
+  protected from the OS.
+
+  @param  BootPolicy              Policy for Open Image File.
+  @param  FilePath                The device path of the image file.
+  @param  FileSize                Returns the size of the image file.
+  @param  AuthenticationStatus    Returns the authentication status of the
+                                  image file.
+
+  @return A pool buffer with the image file, or NULL if it cannot be read.
+
+**/
+VOID *
+CoreGetImageFileBuffer (
+  IN  BOOLEAN                         BootPolicy,
+  IN  CONST EFI_DEVICE_PATH_PROTOCOL  *FilePath,
+  OUT UINTN                           *FileSize,
+  OUT UINT32                          *AuthenticationStatus
+  )
+{
+  DXE_IMAGE_CACHE_ENTRY  Key;
+  VOID                   *FileBuffer;
+  EFI_TPL                OldTpl;
+
+  if (!InitializeImageCache () || !GetImageCacheKey (FilePath, &Key)) {
+    return GetFileBufferByFilePath (BootPolicy, FilePath, FileSize, AuthenticationStatus);
+  }
+
+  if (ImageCacheHitAllowed ()) {
+    OldTpl     = CoreRaiseTpl (TPL_NOTIFY);
+    FileBuffer = GetImageFromCache (&Key, FileSize);
+    CoreRestoreTpl (OldTpl);
+    if (FileBuffer != NULL) {
+      *AuthenticationStatus = EFI_AUTH_STATUS_NOT_TESTED;
+      return FileBuffer;
+    }
+  }
+
+  FileBuffer = GetFileBufferByFilePath (BootPolicy, FilePath, FileSize, AuthenticationStatus);
+  if ((FileBuffer != NULL) && (*AuthenticationStatus == 0)) {
+    OldTpl = CoreRaiseTpl (TPL_NOTIFY);
+    AddImageToCache (&Key, FileBuffer, *FileSize);
+    CoreRestoreTpl (OldTpl);
+  }
+
+  return FileBuffer;
+}
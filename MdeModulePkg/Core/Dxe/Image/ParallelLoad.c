@@ -0,0 +1,294 @@
+/** @file
+  Load and relocate the images of scheduled DXE drivers on the application
+  processors.
+
+  The DXE dispatcher reads every image in the scheduled queue and allocates
+  its pages on the BSP, because the firmware volume, section extraction and
+  memory services are not MP safe. The section copy and relocation of those
+  images is pure memory work on buffers that are already owned by the
+  dispatcher, so it is spread over the application processors through
+  EFI_MP_SERVICES_PROTOCOL. CoreLoadImage () later adopts the loaded image
+  instead of loading it again, runs PeCoffLoaderRelocateImageExtraAction ()
+  on the BSP, and the entry points still run on the BSP in dispatch order.
+
+Copyright (c) 2026, TianoCore and contributors. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "DxeMain.h"
+#include "Image.h"
+
+typedef struct {
+  CORE_PREPARED_IMAGE    **PreparedImages;
+  UINT32                 Count;
+  volatile UINT32        NextIndex;
+} PREPARED_IMAGE_QUEUE;
+
+CORE_PREPARED_IMAGE  *mPendingPreparedImage = NULL;
+
+/**
+  Check whether driver images can be loaded on the application processors.
+
+  @retval TRUE   PcdDxeParallelImageLoad is set and EFI_MP_SERVICES_PROTOCOL
+                 reports at least one enabled application processor.
+  @retval FALSE  Images must be loaded on the BSP.
+
+**/
+BOOLEAN
+CoreIsParallelImageLoadAvailable (
+  VOID
+  )
+{
+  return (BOOLEAN)(PcdGetBool (PcdDxeParallelImageLoad) && CoreIsMpAvailable ());
+}
+
+/**
+  Read an image from a firmware volume and allocate the pages it will be
+  loaded into, so that CoreLoadPreparedImages () can load and relocate it
+  on an application processor.
+
+  Only boot service drivers that can be relocated to any address are
+  prepared. Runtime drivers need their fixup data recorded during the
+  relocation, and images loaded at fixed addresses are placed by
+  CoreLoadPeImage (). Images read with a non-zero authentication status are
+  not prepared either, because the status may still change as section
+  extraction protocols are installed by the drivers ahead of them.
+
+  @param  FilePath                The device path of the image file.
+
+  @return The prepared image, or NULL if the image must be loaded by
+          CoreLoadImage () alone.
+
+**/
+CORE_PREPARED_IMAGE *
+CorePrepareImage (
+  IN EFI_DEVICE_PATH_PROTOCOL  *FilePath
+  )
+{
+  EFI_STATUS                    Status;
+  CORE_PREPARED_IMAGE           *PreparedImage;
+  PE_COFF_LOADER_IMAGE_CONTEXT  *ImageContext;
+  UINTN                         Size;
+
+  if (PcdGet64 (PcdLoadModuleAtFixAddressEnable) != 0) {
+    return NULL;
+  }
+
+  PreparedImage = AllocateZeroPool (sizeof (CORE_PREPARED_IMAGE));
+  if (PreparedImage == NULL) {
+    return NULL;
+  }
+
+  PreparedImage->FilePath         = FilePath;
+  PreparedImage->Status           = EFI_NOT_STARTED;
+  PreparedImage->FHand.Signature  = IMAGE_FILE_HANDLE_SIGNATURE;
+  PreparedImage->FHand.FreeBuffer = TRUE;
+  PreparedImage->FHand.Source     = CoreGetImageFileBuffer (
+                                      FALSE,
+                                      FilePath,
+                                      &PreparedImage->FHand.SourceSize,
+                                      &PreparedImage->AuthenticationStatus
+                                      );
+  if ((PreparedImage->FHand.Source == NULL) || (PreparedImage->AuthenticationStatus != 0)) {
+    goto Error;
+  }
+
+  ImageContext            = &PreparedImage->ImageContext;
+  ImageContext->Handle    = &PreparedImage->FHand;
+  ImageContext->ImageRead = (PE_COFF_LOADER_READ_FILE)CoreReadImageFile;
+
+  Status = PeCoffLoaderGetImageInfo (ImageContext);
+  if (EFI_ERROR (Status) ||
+      !EFI_IMAGE_MACHINE_TYPE_SUPPORTED (ImageContext->Machine) ||
+      (ImageContext->ImageType != EFI_IMAGE_SUBSYSTEM_EFI_BOOT_SERVICE_DRIVER) ||
+      ImageContext->RelocationsStripped)
+  {
+    goto Error;
+  }
+
+  ImageContext->ImageCodeMemoryType = EfiBootServicesCode;
+  ImageContext->ImageDataMemoryType = EfiBootServicesData;
+
+  //
+  // Allocate the pages the same way CoreLoadPeImage () would
+  //
+  if (ImageContext->SectionAlignment > EFI_PAGE_SIZE) {
+    Size = (UINTN)ImageContext->ImageSize + ImageContext->SectionAlignment;
+  } else {
+    Size = (UINTN)ImageContext->ImageSize;
+  }
+
+  PreparedImage->NumberOfPages = EFI_SIZE_TO_PAGES (Size);
+
+  Status = EFI_OUT_OF_RESOURCES;
+  if (PcdGetBool (PcdImageLargeAddressLoad) && (ImageContext->ImageAddress >= 0x100000)) {
+    Status = CoreAllocatePages (
+               AllocateAddress,
+               EfiBootServicesCode,
+               PreparedImage->NumberOfPages,
+               &ImageContext->ImageAddress
+               );
+  }
+
+  if (EFI_ERROR (Status)) {
+    Status = CoreAllocatePages (
+               AllocateAnyPages,
+               EfiBootServicesCode,
+               PreparedImage->NumberOfPages,
+               &ImageContext->ImageAddress
+               );
+  }
+
+  if (EFI_ERROR (Status)) {
+    PreparedImage->NumberOfPages = 0;
+    goto Error;
+  }
+
+  PreparedImage->ImageBasePage = ImageContext->ImageAddress;
+  if (!ImageContext->IsTeImage) {
+    ImageContext->ImageAddress =
+      (ImageContext->ImageAddress + ImageContext->SectionAlignment - 1) &
+      ~((UINTN)ImageContext->SectionAlignment - 1);
+  }
+
+  return PreparedImage;
+
+Error:
+  CoreFreePreparedImage (PreparedImage);
+  return NULL;
+}
+
+/**
+  Load and relocate images from the queue until it is empty.
+
+  This runs on the application processors and on the BSP, so it must only
+  touch memory that the dispatcher already owns. The relocation extra action
+  may print or notify a debugger, so it is left to CoreLoadImage ().
+
+  @param  Buffer                  The PREPARED_IMAGE_QUEUE to work on.
+
+**/
+STATIC
+VOID
+EFIAPI
+CoreLoadPreparedImageWorker (
+  IN OUT VOID  *Buffer
+  )
+{
+  PREPARED_IMAGE_QUEUE  *Queue;
+  CORE_PREPARED_IMAGE   *PreparedImage;
+  UINT32                Index;
+
+  Queue = (PREPARED_IMAGE_QUEUE *)Buffer;
+
+  while (TRUE) {
+    Index = InterlockedIncrement (&Queue->NextIndex) - 1;
+    if (Index >= Queue->Count) {
+      break;
+    }
+
+    PreparedImage         = Queue->PreparedImages[Index];
+    PreparedImage->Status = PeCoffLoaderLoadImage (&PreparedImage->ImageContext);
+    if (!EFI_ERROR (PreparedImage->Status)) {
+      PreparedImage->Status = PeCoffLoaderRelocateImageWithoutExtraAction (&PreparedImage->ImageContext);
+    }
+  }
+}
+
+/**
+  Load and relocate prepared images on the application processors.
+
+  The parallel load is logged as the "DxeParallelImageLoad" FPDT record.
+
+  @param  PreparedImages          The images returned by CorePrepareImage ().
+  @param  Count                   The number of entries in PreparedImages.
+
+**/
+VOID
+CoreLoadPreparedImages (
+  IN CORE_PREPARED_IMAGE  **PreparedImages,
+  IN UINTN                Count
+  )
+{
+  EFI_STATUS            Status;
+  PREPARED_IMAGE_QUEUE  Queue;
+  UINT64                CounterStart;
+  UINT64                CounterEnd;
+  UINT64                StartTicks;
+  UINT64                WallTicks;
+
+  if (Count == 0) {
+    return;
+  }
+
+  Queue.PreparedImages = PreparedImages;
+  Queue.Count          = (UINT32)Count;
+  Queue.NextIndex      = 0;
+
+  PERF_INMODULE_BEGIN ("DxeParallelImageLoad");
+  StartTicks = GetPerformanceCounter ();
+
+  Status = CoreStartupAllProcessors (CoreLoadPreparedImageWorker, &Queue);
+
+  WallTicks = GetPerformanceCounter () - StartTicks;
+  PERF_INMODULE_END ("DxeParallelImageLoad");
+
+  //
+  // Performance counters may count down, in which case the difference
+  // taken above is the two's complement of the elapsed ticks.
+  //
+  GetPerformanceCounterProperties (&CounterStart, &CounterEnd);
+  if (CounterStart > CounterEnd) {
+    WallTicks = 0 - WallTicks;
+  }
+
+  DEBUG ((
+    DEBUG_INFO | DEBUG_LOAD,
+    "Loaded %Lu images in parallel (%r): %Lu ns\n",
+    (UINT64)Count,
+    Status,
+    GetTimeInNanoSecond (WallTicks)
+    ));
+}
+
+/**
+  Hand a prepared image to the next CoreLoadImage () call for the same
+  device path.
+
+  @param  PreparedImage           The image returned by CorePrepareImage ().
+
+**/
+VOID
+CoreSetPreparedImage (
+  IN CORE_PREPARED_IMAGE  *PreparedImage
+  )
+{
+  mPendingPreparedImage = PreparedImage;
+}
+
+/**
+  Free the parts of a prepared image that CoreLoadImage () did not adopt.
+
+  @param  PreparedImage           The image returned by CorePrepareImage ().
+
+**/
+VOID
+CoreFreePreparedImage (
+  IN CORE_PREPARED_IMAGE  *PreparedImage
+  )
+{
+  if (mPendingPreparedImage == PreparedImage) {
+    mPendingPreparedImage = NULL;
+  }
+
+  if (PreparedImage->FHand.FreeBuffer && (PreparedImage->FHand.Source != NULL)) {
+    CoreFreePool (PreparedImage->FHand.Source);
+  }
+
+  if (PreparedImage->NumberOfPages != 0) {
+    CoreFreePages (PreparedImage->ImageBasePage, PreparedImage->NumberOfPages);
+  }
+
+  CoreFreePool (PreparedImage);
+}
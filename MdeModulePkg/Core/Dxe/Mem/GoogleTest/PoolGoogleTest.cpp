@@ -0,0 +1,510 @@
+/** @file
+  Host based tests and benchmark of the DXE core pool allocator.
+
+  Pool.c is built as it is in the DXE core. The page allocator, lock, heap
+  guard and memory protection services it calls are replaced by the stubs of
+  this file. The page allocator stub can be limited to a number of pages, to
+  exercise the paths taken when the pool runs out of pages.
+
+  Copyright (c) 2026, TianoCore and contributors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+#include <Library/GoogleTestLib.h>
+#include <chrono>
+#include <cstdlib>
+#include <set>
+#include <vector>
+
+extern "C" {
+  #include "DxeMain.h"
+  #include "Imem.h"
+  #include "HeapGuard.h"
+
+  EFI_LOCK  gMemoryLock = EFI_INITIALIZE_LOCK_VARIABLE (TPL_NOTIFY);
+  BOOLEAN   mOnGuarding = FALSE;
+}
+
+//
+// Locks currently held, and pool pages currently allocated
+//
+static std::set<EFI_LOCK *>  mHeldLocks;
+static std::set<VOID *>      mPoolPages;
+static UINTN                 mPoolPageLimit = MAX_UINTN;
+
+extern "C" {
+  VOID
+  CoreAcquireLock (
+    IN EFI_LOCK  *Lock
+    )
+  {
+    ASSERT (Lock->Lock == EfiLockReleased);
+    Lock->Lock = EfiLockAcquired;
+    mHeldLocks.insert (Lock);
+  }
+
+  EFI_STATUS
+  CoreAcquireLockOrFail (
+    IN EFI_LOCK  *Lock
+    )
+  {
+    if (Lock->Lock == EfiLockAcquired) {
+      return EFI_ACCESS_DENIED;
+    }
+
+    CoreAcquireLock (Lock);
+    return EFI_SUCCESS;
+  }
+
+  VOID
+  CoreReleaseLock (
+    IN EFI_LOCK  *Lock
+    )
+  {
+    ASSERT (Lock->Lock == EfiLockAcquired);
+    Lock->Lock = EfiLockReleased;
+    mHeldLocks.erase (Lock);
+  }
+
+  VOID
+  CoreAcquireMemoryLock (
+    VOID
+    )
+  {
+    CoreAcquireLock (&gMemoryLock);
+  }
+
+  VOID
+  CoreReleaseMemoryLock (
+    VOID
+    )
+  {
+    CoreReleaseLock (&gMemoryLock);
+  }
+
+  VOID *
+  CoreAllocatePoolPages (
+    IN EFI_MEMORY_TYPE  PoolType,
+    IN UINTN            NumberOfPages,
+    IN UINTN            Alignment,
+    IN BOOLEAN          NeedGuard
+    )
+  {
+    VOID  *Pages;
+
+    if (mPoolPages.size () + NumberOfPages > mPoolPageLimit) {
+      return NULL;
+    }
+
+    Pages = aligned_alloc (Alignment, EFI_PAGES_TO_SIZE (NumberOfPages));
+    if (Pages != NULL) {
+      mPoolPages.insert (Pages);
+    }
+
+    return Pages;
+  }
+
+  VOID
+  CoreFreePoolPages (
+    IN EFI_PHYSICAL_ADDRESS  Memory,
+    IN UINTN                 NumberOfPages
+    )
+  {
+    ASSERT (mPoolPages.count ((VOID *)(UINTN)Memory) == 1);
+    mPoolPages.erase ((VOID *)(UINTN)Memory);
+    free ((VOID *)(UINTN)Memory);
+  }
+
+  BOOLEAN
+  IsPoolTypeToGuard (
+    IN EFI_MEMORY_TYPE  MemoryType
+    )
+  {
+    return FALSE;
+  }
+
+  BOOLEAN
+  IsHeapGuardEnabled (
+    UINT8  GuardType
+    )
+  {
+    return FALSE;
+  }
+
+  BOOLEAN
+  EFIAPI
+  IsMemoryGuarded (
+    IN EFI_PHYSICAL_ADDRESS  Address
+    )
+  {
+    return FALSE;
+  }
+
+  VOID
+  SetGuardForMemory (
+    IN EFI_PHYSICAL_ADDRESS  Memory,
+    IN UINTN                 NumberOfPages
+    )
+  {
+  }
+
+  VOID
+  UnsetGuardForMemory (
+    IN EFI_PHYSICAL_ADDRESS  Memory,
+    IN UINTN                 NumberOfPages
+    )
+  {
+  }
+
+  VOID *
+  AdjustPoolHeadA (
+    IN EFI_PHYSICAL_ADDRESS  Memory,
+    IN UINTN                 NoPages,
+    IN UINTN                 Size
+    )
+  {
+    return (VOID *)(UINTN)Memory;
+  }
+
+  VOID *
+  AdjustPoolHeadF (
+    IN EFI_PHYSICAL_ADDRESS  Memory,
+    IN UINTN                 NoPages,
+    IN UINTN                 Size
+    )
+  {
+    return (VOID *)(UINTN)Memory;
+  }
+
+  VOID
+  AdjustMemoryF (
+    IN OUT EFI_PHYSICAL_ADDRESS  *Memory,
+    IN OUT UINTN                 *NumberOfPages
+    )
+  {
+  }
+
+  VOID
+  EFIAPI
+  GuardFreedPagesChecked (
+    IN  EFI_PHYSICAL_ADDRESS  BaseAddress,
+    IN  UINTN                 Pages
+    )
+  {
+  }
+
+  EFI_STATUS
+  EFIAPI
+  ApplyMemoryProtectionPolicy (
+    IN  EFI_MEMORY_TYPE       OldType,
+    IN  EFI_MEMORY_TYPE       NewType,
+    IN  EFI_PHYSICAL_ADDRESS  Memory,
+    IN  UINT64                Length
+    )
+  {
+    return EFI_SUCCESS;
+  }
+
+  EFI_STATUS
+  EFIAPI
+  CoreUpdateProfile (
+    IN EFI_PHYSICAL_ADDRESS   CallerAddress,
+    IN MEMORY_PROFILE_ACTION  Action,
+    IN EFI_MEMORY_TYPE        MemoryType,
+    IN UINTN                  Size,
+    IN VOID                   *Buffer,
+    IN CHAR8                  *ActionString OPTIONAL
+    )
+  {
+    return EFI_SUCCESS;
+  }
+
+  VOID
+  InstallMemoryAttributesTableOnMemoryAllocation (
+    IN EFI_MEMORY_TYPE  MemoryType
+    )
+  {
+  }
+}
+
+//
+// Request sizes that land in the first and in the fifth pool size class,
+// the smallest and largest classes with a magazine, and in the sixth class,
+// which has none.
+//
+#define SMALL_BLOCK_SIZE   64
+#define LARGE_BLOCK_SIZE   900
+#define NO_MAGAZINE_SIZE   1500
+#define MAGAZINE_DEPTH     16
+
+/////////////////////////////////////////////////////////////////////////
+// Tests
+/////////////////////////////////////////////////////////////////////////
+
+class PoolTest : public ::testing::Test {
+protected:
+  void
+  SetUp (
+    ) override
+  {
+    mPoolPageLimit = MAX_UINTN;
+    CoreInitializePool ();
+  }
+
+  //
+  // Give back the pages the test left allocated, in the magazines or with
+  // blocks the test could not free.
+  //
+  void
+  TearDown (
+    ) override
+  {
+    ReleaseHeldLocks ();
+    for (VOID *Pages : mPoolPages) {
+      free (Pages);
+    }
+
+    mPoolPages.clear ();
+  }
+
+  //
+  // An ASSERT of the pool code throws out of it with its locks held
+  //
+  static void
+  ReleaseHeldLocks (
+    )
+  {
+    for (EFI_LOCK *Lock : mHeldLocks) {
+      Lock->Lock = EfiLockReleased;
+    }
+
+    mHeldLocks.clear ();
+  }
+
+  static UINT8 *
+  Allocate (
+    EFI_MEMORY_TYPE  PoolType,
+    UINTN            Size
+    )
+  {
+    VOID  *Buffer;
+
+    if (EFI_ERROR (CoreAllocatePool (PoolType, Size, &Buffer))) {
+      return NULL;
+    }
+
+    return (UINT8 *)Buffer;
+  }
+};
+
+//
+// Freed blocks fill the magazine of their size class up to its depth, and
+// are handed out again last in, first out. Blocks freed past the depth go
+// to the free lists.
+//
+TEST_F (PoolTest, MagazineRefillAndReuse) {
+  UINT8  *Blocks[MAGAZINE_DEPTH + 4];
+  UINTN  Index;
+
+  for (Index = 0; Index < ARRAY_SIZE (Blocks); Index++) {
+    Blocks[Index] = Allocate (EfiBootServicesData, SMALL_BLOCK_SIZE);
+    ASSERT_NE (Blocks[Index], nullptr);
+  }
+
+  for (Index = 0; Index < ARRAY_SIZE (Blocks); Index++) {
+    EXPECT_EQ (CoreFreePool (Blocks[Index]), EFI_SUCCESS);
+  }
+
+  for (Index = MAGAZINE_DEPTH; Index > 0; Index--) {
+    EXPECT_EQ (Allocate (EfiBootServicesData, SMALL_BLOCK_SIZE), Blocks[Index - 1]);
+  }
+
+  //
+  // The magazine is empty, the next block is the last one put on the free
+  // list
+  //
+  EXPECT_EQ (Allocate (EfiBootServicesData, SMALL_BLOCK_SIZE), Blocks[ARRAY_SIZE (Blocks) - 1]);
+}
+
+//
+// A block from a magazine is handed out with its memory cleared and its
+// head and tail rebuilt, whatever size in its class is asked for.
+//
+TEST_F (PoolTest, MagazineBlockIsReinitialized) {
+  UINT8  *Block;
+  UINTN  Index;
+
+  Block = Allocate (EfiBootServicesData, LARGE_BLOCK_SIZE);
+  ASSERT_NE (Block, nullptr);
+  SetMem (Block, LARGE_BLOCK_SIZE, 0x5A);
+  EXPECT_EQ (CoreFreePool (Block), EFI_SUCCESS);
+
+  EXPECT_EQ (Allocate (EfiBootServicesData, LARGE_BLOCK_SIZE - 100), Block);
+  for (Index = 0; Index < LARGE_BLOCK_SIZE - 100; Index++) {
+    ASSERT_EQ (Block[Index], 0xAF);
+  }
+
+  EXPECT_EQ (CoreFreePool (Block), EFI_SUCCESS);
+}
+
+//
+// Only the boot services memory types keep blocks in magazines. The pool
+// page of the other types is released as soon as all its blocks are free.
+//
+TEST_F (PoolTest, MagazineOnlyForBootServicesTypes) {
+  UINT8  *Block;
+
+  Block = Allocate (EfiRuntimeServicesData, SMALL_BLOCK_SIZE);
+  ASSERT_NE (Block, nullptr);
+  EXPECT_EQ (mPoolPages.size (), 1U);
+  EXPECT_EQ (CoreFreePool (Block), EFI_SUCCESS);
+  EXPECT_EQ (mPoolPages.size (), 0U);
+
+  Block = Allocate (EfiBootServicesData, SMALL_BLOCK_SIZE);
+  ASSERT_NE (Block, nullptr);
+  EXPECT_EQ (mPoolPages.size (), 1U);
+  EXPECT_EQ (CoreFreePool (Block), EFI_SUCCESS);
+  EXPECT_EQ (mPoolPages.size (), 1U);
+}
+
+//
+// When no pool page is left, the blocks of the magazines are flushed to the
+// free lists, which releases the pages they pinned, and the allocation is
+// retried.
+//
+TEST_F (PoolTest, MagazineFlushOnPageShortage) {
+  UINT8              *Blocks[6];
+  UINT8              *Block;
+  UINTN              Index;
+  UINTN              Pages;
+  std::set<UINT8 *>  Reused;
+
+  //
+  // Three blocks fit in a page, and the rest of each page is carved into
+  // blocks too small for a NO_MAGAZINE_SIZE request
+  //
+  for (Index = 0; Index < ARRAY_SIZE (Blocks); Index++) {
+    Blocks[Index] = Allocate (EfiBootServicesData, LARGE_BLOCK_SIZE);
+    ASSERT_NE (Blocks[Index], nullptr);
+  }
+
+  for (Index = 0; Index < ARRAY_SIZE (Blocks); Index++) {
+    EXPECT_EQ (CoreFreePool (Blocks[Index]), EFI_SUCCESS);
+  }
+
+  Pages = mPoolPages.size ();
+  EXPECT_EQ (Pages, ARRAY_SIZE (Blocks) / 3);
+
+  mPoolPageLimit = Pages;
+  Block          = Allocate (EfiBootServicesData, NO_MAGAZINE_SIZE);
+  ASSERT_NE (Block, nullptr);
+  EXPECT_EQ (mPoolPages.size (), 1U);
+
+  //
+  // The flushed blocks are not handed out twice
+  //
+  Reused.insert (Block);
+  while ((Block = Allocate (EfiBootServicesData, LARGE_BLOCK_SIZE)) != NULL) {
+    EXPECT_TRUE (Reused.insert (Block).second);
+  }
+
+  EXPECT_EQ (mPoolPages.size (), Pages);
+  EXPECT_GT (Reused.size (), ARRAY_SIZE (Blocks) / 3);
+}
+
+//
+// A block freed twice is still caught once it sits in a magazine.
+//
+TEST_F (PoolTest, DoubleFreeIsCaught) {
+  UINT8  *Block;
+
+  Block = Allocate (EfiBootServicesData, SMALL_BLOCK_SIZE);
+  ASSERT_NE (Block, nullptr);
+  EXPECT_EQ (CoreFreePool (Block), EFI_SUCCESS);
+  EXPECT_THROW (CoreFreePool (Block), std::runtime_error);
+  ReleaseHeldLocks ();
+
+  //
+  // The magazine was not corrupted by the second free
+  //
+  EXPECT_EQ (Allocate (EfiBootServicesData, SMALL_BLOCK_SIZE), Block);
+  EXPECT_NE (Allocate (EfiBootServicesData, SMALL_BLOCK_SIZE), Block);
+}
+
+//
+// An overrun of a block is caught by the tail check, before the block can
+// reach a magazine.
+//
+TEST_F (PoolTest, OverrunIsCaughtOnFree) {
+  UINT8  *Block;
+
+  Block = Allocate (EfiBootServicesData, SMALL_BLOCK_SIZE);
+  ASSERT_NE (Block, nullptr);
+  Block[SMALL_BLOCK_SIZE] ^= 0xFF;
+  EXPECT_THROW (CoreFreePool (Block), std::runtime_error);
+  ReleaseHeldLocks ();
+
+  EXPECT_NE (Allocate (EfiBootServicesData, SMALL_BLOCK_SIZE), Block);
+}
+
+//
+// A write through a stale pointer that hits the head of a block held in a
+// magazine is caught when the block is handed out again.
+//
+TEST_F (PoolTest, UseAfterFreeIsCaughtOnReuse) {
+  UINT8  *Block;
+
+  Block = Allocate (EfiBootServicesData, SMALL_BLOCK_SIZE);
+  ASSERT_NE (Block, nullptr);
+  EXPECT_EQ (CoreFreePool (Block), EFI_SUCCESS);
+
+  SetMem (Block - 3 * sizeof (UINT64), sizeof (UINT64), 0);
+  EXPECT_THROW (Allocate (EfiBootServicesData, SMALL_BLOCK_SIZE), std::runtime_error);
+  ReleaseHeldLocks ();
+}
+
+//
+// Report the allocation rate of a mix of small requests, for a memory type
+// served through the magazines and for one served by the free lists only,
+// which is the path every small request took before the magazines.
+//
+TEST_F (PoolTest, Benchmark) {
+  static CONST UINTN                     Sizes[]  = { 16, 48, 100, 200, 360, 600, 900, 24 };
+  static CONST EFI_MEMORY_TYPE           Types[]  = { EfiLoaderData, EfiBootServicesData };
+  static CONST CHAR8                     *Names[] = { "free lists (EfiLoaderData)", "magazines (EfiBootServicesData)" };
+  CONST UINTN                            Batch    = 32;
+  CONST UINTN                            Rounds   = 20000;
+  std::vector<VOID *>                    Blocks (Batch);
+  std::chrono::steady_clock::time_point  Start;
+  UINTN                                  TypeIndex;
+  UINTN                                  Round;
+  UINTN                                  Index;
+  UINT64                                 Ns;
+
+  printf ("%-34s %16s\n", "Pool path", "Allocs/sec");
+  for (TypeIndex = 0; TypeIndex < ARRAY_SIZE (Types); TypeIndex++) {
+    Start = std::chrono::steady_clock::now ();
+    for (Round = 0; Round < Rounds; Round++) {
+      for (Index = 0; Index < Batch; Index++) {
+        Blocks[Index] = Allocate (Types[TypeIndex], Sizes[(Round + Index) % ARRAY_SIZE (Sizes)]);
+        ASSERT_NE (Blocks[Index], nullptr);
+      }
+
+      for (Index = 0; Index < Batch; Index++) {
+        ASSERT_EQ (CoreFreePool (Blocks[Index]), EFI_SUCCESS);
+      }
+    }
+
+    Ns = (UINT64)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now () - Start).count ();
+    printf ("%-34s %16llu\n", Names[TypeIndex], (UINT64)(Rounds * Batch) * 1000000000ULL / Ns);
+  }
+}
+
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  testing::InitGoogleTest (&argc, argv);
+  return RUN_ALL_TESTS ();
+}
@@ -15,16 +15,26 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #define MEMORY_MAP_SIGNATURE  SIGNATURE_32('m','m','a','p')
 typedef struct {
-  UINTN              Signature;
-  LIST_ENTRY         Link;
-  BOOLEAN            FromPages;
-
-  EFI_MEMORY_TYPE    Type;
-  UINT64             Start;
-  UINT64             End;
-
-  UINT64             VirtualStart;
-  UINT64             Attribute;
+  UINTN                       Signature;
+  LIST_ENTRY                  Link;
+  BOOLEAN                     FromPages;
+
+  EFI_MEMORY_TYPE             Type;
+  UINT64                      Start;
+  UINT64                      End;
+
+  UINT64                      VirtualStart;
+  UINT64                      Attribute;
+
+  //
+  // Nodes of the memory map indexes of Page.c, the size class of the free
+  // memory index holding FreeIndexEntry, and link on the list of the entries
+  // waiting for a node
+  //
+  ORDERED_COLLECTION_ENTRY    *IndexEntry;
+  ORDERED_COLLECTION_ENTRY    *FreeIndexEntry;
+  UINTN                       FreeIndexClass;
+  LIST_ENTRY                  IndexLink;
 } MEMORY_MAP;
 
 //
@@ -99,6 +109,22 @@ CoreFreePoolI (
   OUT EFI_MEMORY_TYPE  *PoolType OPTIONAL
   );
 
+/**
+  Internal function.  Grows the pool of a memory type by one page, for the
+  page allocator to allocate pool while gMemoryLock is held.
+  Caller must have gMemoryLock held
+
+  @param  PoolType               The type of pool to grow
+
+  @retval TRUE                   The pool was grown.
+  @retval FALSE                  The pool could not be grown.
+
+**/
+BOOLEAN
+CoreGrowPool (
+  IN EFI_MEMORY_TYPE  PoolType
+  );
+
 /**
   Enter critical section by gaining lock on gMemoryLock.
 
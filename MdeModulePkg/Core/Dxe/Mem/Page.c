@@ -46,6 +46,25 @@ UINTN       mFreeMapStack = 0;
 LIST_ENTRY  mFreeMemoryMapEntryList           = INITIALIZE_LIST_HEAD_VARIABLE (mFreeMemoryMapEntryList);
 BOOLEAN     mMemoryTypeInformationInitialized = FALSE;
 
+//
+// The descriptors of gMemoryMap allocated from pages are indexed by address in
+// mMemoryMapIndex. Those of type EfiConventionalMemory are also indexed by
+// address in the mFreeMemoryIndex of their size class, the number of pages
+// rounded down to a power of two, so that the search for a free range skips
+// the classes too small for it.
+//
+// The index nodes are allocated from pool while gMemoryLock is held, when the
+// pool cannot take pages by itself. A descriptor whose node cannot be
+// allocated waits on mUnindexedMemoryMapList until CoreFreeMemoryMapStack()
+// grows the pool for it. The descriptors of mMapStack are not indexed. Lookups
+// check both directly.
+//
+#define FREE_MEMORY_INDEX_CLASSES  64
+
+ORDERED_COLLECTION  *mMemoryMapIndex                             = NULL;
+ORDERED_COLLECTION  *mFreeMemoryIndex[FREE_MEMORY_INDEX_CLASSES] = { NULL };
+LIST_ENTRY          mUnindexedMemoryMapList                      = INITIALIZE_LIST_HEAD_VARIABLE (mUnindexedMemoryMapList);
+
 EFI_MEMORY_TYPE_STATISTICS  mMemoryTypeStatistics[EfiMaxMemoryType + 1] = {
   { 0, MAX_ALLOC_ADDRESS, 0, 0, EfiMaxMemoryType, TRUE,  FALSE },  // EfiReservedMemoryType
   { 0, MAX_ALLOC_ADDRESS, 0, 0, EfiMaxMemoryType, FALSE, FALSE },  // EfiLoaderCode
@@ -119,6 +138,304 @@ CoreReleaseMemoryLock (
   CoreReleaseLock (&gMemoryLock);
 }
 
+/**
+  Internal function.  Compares two descriptor entries of the memory map
+  indexes by address.
+
+  @param  UserStruct1            The first MEMORY_MAP entry
+  @param  UserStruct2            The second MEMORY_MAP entry
+
+  @retval <0                     UserStruct1 starts below UserStruct2.
+  @retval  0                     UserStruct1 and UserStruct2 start at the same
+                                 address.
+  @retval >0                     UserStruct1 starts above UserStruct2.
+
+**/
+STATIC
+INTN
+EFIAPI
+MemoryMapEntryCompare (
+  IN CONST VOID  *UserStruct1,
+  IN CONST VOID  *UserStruct2
+  )
+{
+  CONST MEMORY_MAP  *Entry1;
+  CONST MEMORY_MAP  *Entry2;
+
+  Entry1 = UserStruct1;
+  Entry2 = UserStruct2;
+  if (Entry1->Start == Entry2->Start) {
+    return 0;
+  }
+
+  return (Entry1->Start < Entry2->Start) ? -1 : 1;
+}
+
+/**
+  Internal function.  Compares an address with a descriptor entry of the
+  memory map indexes. The entries of the map don't overlap, so an address
+  compares equal to the one entry covering it, which OrderedCollectionFind()
+  then returns.
+
+  @param  StandaloneKey          Pointer to the UINT64 address
+  @param  UserStruct             The MEMORY_MAP entry
+
+  @retval <0                     The address is below the entry.
+  @retval  0                     The entry covers the address.
+  @retval >0                     The address is above the entry.
+
+**/
+STATIC
+INTN
+EFIAPI
+MemoryMapAddressCompare (
+  IN CONST VOID  *StandaloneKey,
+  IN CONST VOID  *UserStruct
+  )
+{
+  UINT64            Address;
+  CONST MEMORY_MAP  *Entry;
+
+  Address = *(CONST UINT64 *)StandaloneKey;
+  Entry   = UserStruct;
+  if (Address < Entry->Start) {
+    return -1;
+  }
+
+  if (Address > Entry->End) {
+    return 1;
+  }
+
+  return 0;
+}
+
+/**
+  Internal function.  Returns the size class of a free range in the free
+  memory indexes.
+
+  @param  NumberOfBytes          The size of the range, at least a page
+
+  @return The number of pages of the range rounded down to a power of two, as
+          the index of that power.
+
+**/
+STATIC
+UINTN
+FreeMemoryIndexClass (
+  IN UINT64  NumberOfBytes
+  )
+{
+  return (UINTN)HighBitSet64 (RShiftU64 (NumberOfBytes, EFI_PAGE_SHIFT));
+}
+
+/**
+  Internal function.  Adds a free descriptor entry to the free memory index of
+  its size class.
+
+  @param  Entry                  The entry, of type EfiConventionalMemory
+
+  @retval TRUE                   The entry was added.
+  @retval FALSE                  An index node could not be allocated.
+
+**/
+STATIC
+BOOLEAN
+InsertFreeMemoryIndex (
+  IN OUT MEMORY_MAP  *Entry
+  )
+{
+  ORDERED_COLLECTION_ENTRY  *IndexEntry;
+  RETURN_STATUS             Status;
+  UINTN                     Class;
+
+  Class = FreeMemoryIndexClass (Entry->End - Entry->Start + 1);
+  if (mFreeMemoryIndex[Class] == NULL) {
+    mFreeMemoryIndex[Class] = OrderedCollectionInit (MemoryMapEntryCompare, MemoryMapAddressCompare);
+    if (mFreeMemoryIndex[Class] == NULL) {
+      return FALSE;
+    }
+  }
+
+  Status = OrderedCollectionInsert (mFreeMemoryIndex[Class], &IndexEntry, Entry);
+  ASSERT (Status != RETURN_ALREADY_STARTED);
+  if (Status != RETURN_SUCCESS) {
+    return FALSE;
+  }
+
+  Entry->FreeIndexEntry = IndexEntry;
+  Entry->FreeIndexClass = Class;
+  return TRUE;
+}
+
+/**
+  Internal function.  Adds a descriptor entry allocated from pages to the
+  memory map indexes it belongs to and is not in yet.
+
+  @param  Entry                  The entry, linked on gMemoryMap
+
+  @retval TRUE                   The entry is in all the indexes it belongs to.
+  @retval FALSE                  An index node could not be allocated.
+
+**/
+STATIC
+BOOLEAN
+IndexMemoryMapEntry (
+  IN OUT MEMORY_MAP  *Entry
+  )
+{
+  ORDERED_COLLECTION_ENTRY  *IndexEntry;
+  RETURN_STATUS             Status;
+
+  ASSERT (Entry->FromPages);
+
+  if (mMemoryMapIndex == NULL) {
+    mMemoryMapIndex = OrderedCollectionInit (MemoryMapEntryCompare, MemoryMapAddressCompare);
+  }
+
+  if ((Entry->IndexEntry == NULL) && (mMemoryMapIndex != NULL)) {
+    Status = OrderedCollectionInsert (mMemoryMapIndex, &IndexEntry, Entry);
+    ASSERT (Status != RETURN_ALREADY_STARTED);
+    if (Status == RETURN_SUCCESS) {
+      Entry->IndexEntry = IndexEntry;
+    }
+  }
+
+  if ((Entry->Type == EfiConventionalMemory) && (Entry->FreeIndexEntry == NULL)) {
+    InsertFreeMemoryIndex (Entry);
+  }
+
+  return (BOOLEAN)((Entry->IndexEntry != NULL) &&
+                   ((Entry->Type != EfiConventionalMemory) || (Entry->FreeIndexEntry != NULL)));
+}
+
+/**
+  Internal function.  Moves a free descriptor entry that has been clipped to
+  the free memory index of its new size class. The entry stays where it is if
+  it cannot be moved, which only makes the search for free ranges check it
+  for requests it has become too small for.
+
+  @param  Entry                  The entry
+
+**/
+STATIC
+VOID
+ReindexFreeMemoryMapEntry (
+  IN OUT MEMORY_MAP  *Entry
+  )
+{
+  ORDERED_COLLECTION_ENTRY  *IndexEntry;
+  UINTN                     Class;
+
+  if ((Entry->FreeIndexEntry == NULL) || (Entry->End < Entry->Start) ||
+      (FreeMemoryIndexClass (Entry->End - Entry->Start + 1) == Entry->FreeIndexClass))
+  {
+    return;
+  }
+
+  IndexEntry = Entry->FreeIndexEntry;
+  Class      = Entry->FreeIndexClass;
+  if (InsertFreeMemoryIndex (Entry)) {
+    OrderedCollectionDelete (mFreeMemoryIndex[Class], IndexEntry, NULL);
+  }
+}
+
+/**
+  Internal function.  Removes a descriptor entry from the memory map indexes
+  and from the list of entries waiting to be indexed.
+
+  @param  Entry                  The entry being removed from gMemoryMap
+
+**/
+STATIC
+VOID
+UnindexMemoryMapEntry (
+  IN OUT MEMORY_MAP  *Entry
+  )
+{
+  if (Entry->IndexEntry != NULL) {
+    OrderedCollectionDelete (mMemoryMapIndex, Entry->IndexEntry, NULL);
+    Entry->IndexEntry = NULL;
+  }
+
+  if (Entry->FreeIndexEntry != NULL) {
+    OrderedCollectionDelete (mFreeMemoryIndex[Entry->FreeIndexClass], Entry->FreeIndexEntry, NULL);
+    Entry->FreeIndexEntry = NULL;
+  }
+
+  if (Entry->IndexLink.ForwardLink != NULL) {
+    RemoveEntryList (&Entry->IndexLink);
+    Entry->IndexLink.ForwardLink = NULL;
+  }
+}
+
+/**
+  Internal function.  Indexes the descriptor entries waiting on
+  mUnindexedMemoryMapList, as far as the pool allows.
+
+**/
+STATIC
+VOID
+IndexPendingMemoryMapEntries (
+  VOID
+  )
+{
+  MEMORY_MAP  *Entry;
+
+  while (!IsListEmpty (&mUnindexedMemoryMapList)) {
+    Entry = CR (mUnindexedMemoryMapList.ForwardLink, MEMORY_MAP, IndexLink, MEMORY_MAP_SIGNATURE);
+    if (!IndexMemoryMapEntry (Entry)) {
+      break;
+    }
+
+    RemoveEntryList (&Entry->IndexLink);
+    Entry->IndexLink.ForwardLink = NULL;
+  }
+}
+
+/**
+  Internal function.  Finds the descriptor entry of gMemoryMap covering an
+  address.
+
+  @param  Address                The address to look up
+
+  @return The entry covering Address, or NULL if Address is not in the map.
+
+**/
+STATIC
+MEMORY_MAP *
+FindMemoryMapEntry (
+  IN UINT64  Address
+  )
+{
+  ORDERED_COLLECTION_ENTRY  *IndexEntry;
+  LIST_ENTRY                *Link;
+  MEMORY_MAP                *Entry;
+  UINTN                     Index;
+
+  if (mMemoryMapIndex != NULL) {
+    IndexEntry = OrderedCollectionFind (mMemoryMapIndex, &Address);
+    if (IndexEntry != NULL) {
+      return OrderedCollectionUserStruct (IndexEntry);
+    }
+  }
+
+  for (Index = 0; Index < mMapDepth; Index++) {
+    Entry = &mMapStack[Index];
+    if ((Entry->Link.ForwardLink != NULL) && (Entry->Start <= Address) && (Entry->End >= Address)) {
+      return Entry;
+    }
+  }
+
+  for (Link = mUnindexedMemoryMapList.ForwardLink; Link != &mUnindexedMemoryMapList; Link = Link->ForwardLink) {
+    Entry = CR (Link, MEMORY_MAP, IndexLink, MEMORY_MAP_SIGNATURE);
+    if ((Entry->IndexEntry == NULL) && (Entry->Start <= Address) && (Entry->End >= Address)) {
+      return Entry;
+    }
+  }
+
+  return NULL;
+}
+
 /**
   Internal function.  Removes a descriptor entry.
 
@@ -130,6 +447,7 @@ RemoveMemoryMapEntry (
   IN OUT MEMORY_MAP  *Entry
   )
 {
+  UnindexMemoryMapEntry (Entry);
   RemoveEntryList (&Entry->Link);
   Entry->Link.ForwardLink = NULL;
 
@@ -161,7 +479,6 @@ CoreAddRange (
   IN UINT64                Attribute
   )
 {
-  LIST_ENTRY  *Link;
   MEMORY_MAP  *Entry;
 
   ASSERT ((Start & EFI_PAGE_MASK) == 0);
@@ -210,23 +527,17 @@ CoreAddRange (
   // and the same Attribute
   //
 
-  Link = gMemoryMap.ForwardLink;
-  while (Link != &gMemoryMap) {
-    Entry = CR (Link, MEMORY_MAP, Link, MEMORY_MAP_SIGNATURE);
-    Link  = Link->ForwardLink;
-
-    if (Entry->Type != Type) {
-      continue;
-    }
-
-    if (Entry->Attribute != Attribute) {
-      continue;
-    }
-
-    if (Entry->End + 1 == Start) {
+  if (Start != 0) {
+    Entry = FindMemoryMapEntry (Start - 1);
+    if ((Entry != NULL) && (Entry->Type == Type) && (Entry->Attribute == Attribute) && (Entry->End + 1 == Start)) {
       Start = Entry->Start;
       RemoveMemoryMapEntry (Entry);
-    } else if (Entry->Start == End + 1) {
+    }
+  }
+
+  if (End != MAX_UINT64) {
+    Entry = FindMemoryMapEntry (End + 1);
+    if ((Entry != NULL) && (Entry->Type == Type) && (Entry->Attribute == Attribute) && (Entry->Start == End + 1)) {
       End = Entry->End;
       RemoveMemoryMapEntry (Entry);
     }
@@ -236,13 +547,16 @@ CoreAddRange (
   // Add descriptor
   //
 
-  mMapStack[mMapDepth].Signature    = MEMORY_MAP_SIGNATURE;
-  mMapStack[mMapDepth].FromPages    = FALSE;
-  mMapStack[mMapDepth].Type         = Type;
-  mMapStack[mMapDepth].Start        = Start;
-  mMapStack[mMapDepth].End          = End;
-  mMapStack[mMapDepth].VirtualStart = 0;
-  mMapStack[mMapDepth].Attribute    = Attribute;
+  mMapStack[mMapDepth].Signature             = MEMORY_MAP_SIGNATURE;
+  mMapStack[mMapDepth].FromPages             = FALSE;
+  mMapStack[mMapDepth].Type                  = Type;
+  mMapStack[mMapDepth].Start                 = Start;
+  mMapStack[mMapDepth].End                   = End;
+  mMapStack[mMapDepth].VirtualStart          = 0;
+  mMapStack[mMapDepth].Attribute             = Attribute;
+  mMapStack[mMapDepth].IndexEntry            = NULL;
+  mMapStack[mMapDepth].FreeIndexEntry        = NULL;
+  mMapStack[mMapDepth].IndexLink.ForwardLink = NULL;
   InsertTailList (&gMemoryMap, &mMapStack[mMapDepth].Link);
 
   mMapDepth += 1;
@@ -315,9 +629,10 @@ CoreFreeMemoryMapStack (
   VOID
   )
 {
-  MEMORY_MAP  *Entry;
-  MEMORY_MAP  *Entry2;
-  LIST_ENTRY  *Link2;
+  MEMORY_MAP                *Entry;
+  MEMORY_MAP                *Entry2;
+  LIST_ENTRY                *Link2;
+  ORDERED_COLLECTION_ENTRY  *IndexEntry;
 
   ASSERT_LOCKED (&gMemoryLock);
 
@@ -333,48 +648,73 @@ CoreFreeMemoryMapStack (
   //
   mFreeMapStack += 1;
 
-  while (mMapDepth != 0) {
-    //
-    // Deque an memory map entry from mFreeMemoryMapEntryList
-    //
-    Entry = AllocateMemoryMapEntry ();
-
-    ASSERT (Entry);
-
-    //
-    // Update to proper entry
-    //
-    mMapDepth -= 1;
-
-    if (mMapStack[mMapDepth].Link.ForwardLink != NULL) {
+  do {
+    while (mMapDepth != 0) {
       //
-      // Move this entry to general memory
+      // Deque an memory map entry from mFreeMemoryMapEntryList
       //
-      RemoveEntryList (&mMapStack[mMapDepth].Link);
-      mMapStack[mMapDepth].Link.ForwardLink = NULL;
+      Entry = AllocateMemoryMapEntry ();
 
-      CopyMem (Entry, &mMapStack[mMapDepth], sizeof (MEMORY_MAP));
-      Entry->FromPages = TRUE;
+      ASSERT (Entry);
 
       //
-      // Find insertion location
+      // Update to proper entry
       //
-      for (Link2 = gMemoryMap.ForwardLink; Link2 != &gMemoryMap; Link2 = Link2->ForwardLink) {
-        Entry2 = CR (Link2, MEMORY_MAP, Link, MEMORY_MAP_SIGNATURE);
-        if (Entry2->FromPages && (Entry2->Start > Entry->Start)) {
-          break;
+      mMapDepth -= 1;
+
+      if (mMapStack[mMapDepth].Link.ForwardLink != NULL) {
+        //
+        // Move this entry to general memory
+        //
+        RemoveEntryList (&mMapStack[mMapDepth].Link);
+        mMapStack[mMapDepth].Link.ForwardLink = NULL;
+
+        CopyMem (Entry, &mMapStack[mMapDepth], sizeof (MEMORY_MAP));
+        Entry->FromPages = TRUE;
+
+        //
+        // Find insertion location. While every other entry allocated from
+        // pages is indexed, it is the one following this entry in the index.
+        //
+        if (!IndexMemoryMapEntry (Entry)) {
+          InsertTailList (&mUnindexedMemoryMapList, &Entry->IndexLink);
         }
-      }
 
-      InsertTailList (Link2, &Entry->Link);
-    } else {
-      //
-      // This item of mMapStack[mMapDepth] has already been dequeued from gMemoryMap list,
-      // so here no need to move it to memory.
-      //
-      InsertTailList (&mFreeMemoryMapEntryList, &Entry->Link);
+        if (IsListEmpty (&mUnindexedMemoryMapList)) {
+          IndexEntry = OrderedCollectionNext (Entry->IndexEntry);
+          if (IndexEntry != NULL) {
+            Entry2 = OrderedCollectionUserStruct (IndexEntry);
+            Link2  = &Entry2->Link;
+          } else {
+            Link2 = &gMemoryMap;
+          }
+        } else {
+          for (Link2 = gMemoryMap.ForwardLink; Link2 != &gMemoryMap; Link2 = Link2->ForwardLink) {
+            Entry2 = CR (Link2, MEMORY_MAP, Link, MEMORY_MAP_SIGNATURE);
+            if (Entry2->FromPages && (Entry2->Start > Entry->Start)) {
+              break;
+            }
+          }
+        }
+
+        InsertTailList (Link2, &Entry->Link);
+      } else {
+        //
+        // This item of mMapStack[mMapDepth] has already been dequeued from gMemoryMap list,
+        // so here no need to move it to memory.
+        //
+        InsertTailList (&mFreeMemoryMapEntryList, &Entry->Link);
+      }
     }
-  }
+
+    //
+    // The index nodes are allocated from pool, which cannot take pages by
+    // itself while gMemoryLock is held. Grow it here, where the map can
+    // change, for the entries that did not get their nodes, and move the
+    // entries this adds to the stack.
+    //
+    IndexPendingMemoryMapEntries ();
+  } while (!IsListEmpty (&mUnindexedMemoryMapList) && CoreGrowPool (EfiBootServicesData));
 
   mFreeMapStack -= 1;
 }
@@ -843,7 +1183,6 @@ CoreConvertPagesEx (
   UINT64           RangeEnd;
   UINT64           Attribute;
   EFI_MEMORY_TYPE  MemType;
-  LIST_ENTRY       *Link;
   MEMORY_MAP       *Entry;
 
   Entry         = NULL;
@@ -868,15 +1207,8 @@ CoreConvertPagesEx (
     //
     // Find the entry that the covers the range
     //
-    for (Link = gMemoryMap.ForwardLink; Link != &gMemoryMap; Link = Link->ForwardLink) {
-      Entry = CR (Link, MEMORY_MAP, Link, MEMORY_MAP_SIGNATURE);
-
-      if ((Entry->Start <= Start) && (Entry->End > Start)) {
-        break;
-      }
-    }
-
-    if (Link == &gMemoryMap) {
+    Entry = FindMemoryMapEntry (Start);
+    if (Entry == NULL) {
       DEBUG ((DEBUG_ERROR | DEBUG_PAGE, "ConvertPages: failed to find range %lx - %lx\n", Start, End));
       return EFI_NOT_FOUND;
     }
@@ -955,18 +1287,22 @@ CoreConvertPagesEx (
     }
 
     //
-    // Pull range out of descriptor
+    // Pull range out of descriptor. Clipping keeps the descriptor where it is
+    // in the address order of the memory map indexes, as the descriptors
+    // don't overlap, but may change its size class.
     //
     if (Entry->Start == Start) {
       //
       // Clip start
       //
       Entry->Start = RangeEnd + 1;
+      ReindexFreeMemoryMapEntry (Entry);
     } else if (Entry->End == RangeEnd) {
       //
       // Clip end
       //
       Entry->End = Start - 1;
+      ReindexFreeMemoryMapEntry (Entry);
     } else {
       //
       // Pull it out of the center, clip current
@@ -986,8 +1322,13 @@ CoreConvertPagesEx (
       //
       mMapStack[mMapDepth].Attribute = Entry->Attribute;
 
+      mMapStack[mMapDepth].IndexEntry            = NULL;
+      mMapStack[mMapDepth].FreeIndexEntry        = NULL;
+      mMapStack[mMapDepth].IndexLink.ForwardLink = NULL;
+
       Entry->End = Start - 1;
       ASSERT (Entry->Start < Entry->End);
+      ReindexFreeMemoryMapEntry (Entry);
 
       Entry = &mMapStack[mMapDepth];
       InsertTailList (&gMemoryMap, &Entry->Link);
@@ -1112,6 +1453,184 @@ CoreUpdateMemoryAttributes (
   CoreReleaseMemoryLock ();
 }
 
+/**
+  Internal function.  Checks if a free descriptor entry can satisfy a page
+  allocation request.
+
+  @param  Entry          The free descriptor entry.
+  @param  MaxAddress     The address that the range must be below.
+  @param  MinAddress     The address that the range must be above.
+  @param  NumberOfBytes  Number of bytes to allocate.
+  @param  Alignment      Bits to align with.
+  @param  NeedGuard      Flag to indicate Guard page is needed or not.
+
+  @return The end address of the highest range of Entry that satisfies the
+          request, or 0 if there is none.
+
+**/
+STATIC
+UINT64
+CheckFreeRange (
+  IN MEMORY_MAP  *Entry,
+  IN UINT64      MaxAddress,
+  IN UINT64      MinAddress,
+  IN UINT64      NumberOfBytes,
+  IN UINTN       Alignment,
+  IN BOOLEAN     NeedGuard
+  )
+{
+  UINT64  DescStart;
+  UINT64  DescEnd;
+  UINT64  DescNumberOfBytes;
+
+  ASSERT (Entry->Type == EfiConventionalMemory);
+
+  //
+  // Don't allocate out of Special-Purpose memory.
+  //
+  if ((Entry->Attribute & EFI_MEMORY_SP) != 0) {
+    return 0;
+  }
+
+  DescStart = Entry->Start;
+  DescEnd   = Entry->End;
+
+  //
+  // If desc is past max allowed address or below min allowed address, skip it
+  //
+  if ((DescStart >= MaxAddress) || (DescEnd < MinAddress)) {
+    return 0;
+  }
+
+  //
+  // If desc ends past max allowed address, clip the end
+  //
+  if (DescEnd >= MaxAddress) {
+    DescEnd = MaxAddress;
+  }
+
+  DescEnd = ((DescEnd + 1) & (~((UINT64)Alignment - 1))) - 1;
+
+  // Skip if DescEnd is less than DescStart after alignment clipping
+  if (DescEnd < DescStart) {
+    return 0;
+  }
+
+  //
+  // Compute the number of bytes we can used from this
+  // descriptor, and see it's enough to satisfy the request
+  //
+  DescNumberOfBytes = DescEnd - DescStart + 1;
+
+  if (DescNumberOfBytes < NumberOfBytes) {
+    return 0;
+  }
+
+  //
+  // If the start of the allocated range is below the min address allowed, skip it
+  //
+  if ((DescEnd - NumberOfBytes + 1) < MinAddress) {
+    return 0;
+  }
+
+  if (NeedGuard) {
+    DescEnd = AdjustMemoryS (
+                DescEnd + 1 - DescNumberOfBytes,
+                DescNumberOfBytes,
+                NumberOfBytes
+                );
+  }
+
+  return DescEnd;
+}
+
+/**
+  Internal function.  Finds the highest free range that satisfies a page
+  allocation request.
+
+  The free descriptor entries don't overlap, so the highest entry that can
+  satisfy the request also provides the highest range. The entries of each
+  size class large enough for the request are visited from the highest
+  address down, until one satisfies the request or they end below MinAddress.
+  The free entries that are not indexed yet are checked as well.
+
+  @param  MaxAddress     The address that the range must be below.
+  @param  MinAddress     The address that the range must be above.
+  @param  NumberOfBytes  Number of bytes to allocate.
+  @param  Alignment      Bits to align with.
+  @param  NeedGuard      Flag to indicate Guard page is needed or not.
+
+  @return The end address of the highest range that satisfies the request, or
+          0 if there is none.
+
+**/
+STATIC
+UINT64
+FindFreeRange (
+  IN UINT64   MaxAddress,
+  IN UINT64   MinAddress,
+  IN UINT64   NumberOfBytes,
+  IN UINTN    Alignment,
+  IN BOOLEAN  NeedGuard
+  )
+{
+  ORDERED_COLLECTION_ENTRY  *IndexEntry;
+  LIST_ENTRY                *Link;
+  MEMORY_MAP                *Entry;
+  UINTN                     Index;
+  UINTN                     Class;
+  UINT64                    Target;
+  UINT64                    DescEnd;
+
+  Target = 0;
+  for (Class = FreeMemoryIndexClass (NumberOfBytes); Class < FREE_MEMORY_INDEX_CLASSES; Class++) {
+    if (mFreeMemoryIndex[Class] == NULL) {
+      continue;
+    }
+
+    for (IndexEntry = OrderedCollectionMax (mFreeMemoryIndex[Class]);
+         IndexEntry != NULL;
+         IndexEntry = OrderedCollectionPrev (IndexEntry))
+    {
+      //
+      // The entries below end below MinAddress, or cannot beat Target
+      //
+      Entry = OrderedCollectionUserStruct (IndexEntry);
+      if ((Entry->End < MinAddress) || (Entry->End <= Target)) {
+        break;
+      }
+
+      DescEnd = CheckFreeRange (Entry, MaxAddress, MinAddress, NumberOfBytes, Alignment, NeedGuard);
+      if (DescEnd != 0) {
+        Target = DescEnd;
+        break;
+      }
+    }
+  }
+
+  for (Index = 0; Index < mMapDepth; Index++) {
+    Entry = &mMapStack[Index];
+    if ((Entry->Link.ForwardLink != NULL) && (Entry->Type == EfiConventionalMemory)) {
+      DescEnd = CheckFreeRange (Entry, MaxAddress, MinAddress, NumberOfBytes, Alignment, NeedGuard);
+      if (DescEnd > Target) {
+        Target = DescEnd;
+      }
+    }
+  }
+
+  for (Link = mUnindexedMemoryMapList.ForwardLink; Link != &mUnindexedMemoryMapList; Link = Link->ForwardLink) {
+    Entry = CR (Link, MEMORY_MAP, IndexLink, MEMORY_MAP_SIGNATURE);
+    if ((Entry->FreeIndexEntry == NULL) && (Entry->Type == EfiConventionalMemory)) {
+      DescEnd = CheckFreeRange (Entry, MaxAddress, MinAddress, NumberOfBytes, Alignment, NeedGuard);
+      if (DescEnd > Target) {
+        Target = DescEnd;
+      }
+    }
+  }
+
+  return Target;
+}
+
 /**
   Internal function. Finds a consecutive free page range below
   the requested address.
@@ -1137,13 +1656,8 @@ CoreFindFreePagesI (
   IN BOOLEAN          NeedGuard
   )
 {
-  UINT64      NumberOfBytes;
-  UINT64      Target;
-  UINT64      DescStart;
-  UINT64      DescEnd;
-  UINT64      DescNumberOfBytes;
-  LIST_ENTRY  *Link;
-  MEMORY_MAP  *Entry;
+  UINT64  NumberOfBytes;
+  UINT64  Target;
 
   if ((MaxAddress < EFI_PAGE_MASK) || (NumberOfPages == 0)) {
     return 0;
@@ -1171,82 +1685,7 @@ CoreFindFreePagesI (
   }
 
   NumberOfBytes = LShiftU64 (NumberOfPages, EFI_PAGE_SHIFT);
-  Target        = 0;
-
-  for (Link = gMemoryMap.ForwardLink; Link != &gMemoryMap; Link = Link->ForwardLink) {
-    Entry = CR (Link, MEMORY_MAP, Link, MEMORY_MAP_SIGNATURE);
-
-    //
-    // If it's not a free entry, don't bother with it
-    //
-    if (Entry->Type != EfiConventionalMemory) {
-      continue;
-    }
-
-    //
-    // Don't allocate out of Special-Purpose memory.
-    //
-    if ((Entry->Attribute & EFI_MEMORY_SP) != 0) {
-      continue;
-    }
-
-    DescStart = Entry->Start;
-    DescEnd   = Entry->End;
-
-    //
-    // If desc is past max allowed address or below min allowed address, skip it
-    //
-    if ((DescStart >= MaxAddress) || (DescEnd < MinAddress)) {
-      continue;
-    }
-
-    //
-    // If desc ends past max allowed address, clip the end
-    //
-    if (DescEnd >= MaxAddress) {
-      DescEnd = MaxAddress;
-    }
-
-    DescEnd = ((DescEnd + 1) & (~((UINT64)Alignment - 1))) - 1;
-
-    // Skip if DescEnd is less than DescStart after alignment clipping
-    if (DescEnd < DescStart) {
-      continue;
-    }
-
-    //
-    // Compute the number of bytes we can used from this
-    // descriptor, and see it's enough to satisfy the request
-    //
-    DescNumberOfBytes = DescEnd - DescStart + 1;
-
-    if (DescNumberOfBytes >= NumberOfBytes) {
-      //
-      // If the start of the allocated range is below the min address allowed, skip it
-      //
-      if ((DescEnd - NumberOfBytes + 1) < MinAddress) {
-        continue;
-      }
-
-      //
-      // If this is the best match so far remember it
-      //
-      if (DescEnd > Target) {
-        if (NeedGuard) {
-          DescEnd = AdjustMemoryS (
-                      DescEnd + 1 - DescNumberOfBytes,
-                      DescNumberOfBytes,
-                      NumberOfBytes
-                      );
-          if (DescEnd == 0) {
-            continue;
-          }
-        }
-
-        Target = DescEnd;
-      }
-    }
-  }
+  Target        = FindFreeRange (MaxAddress, MinAddress, NumberOfBytes, Alignment, NeedGuard);
 
   //
   // If this is a grow down, adjust target to be the allocation base
@@ -1654,7 +2093,6 @@ CoreInternalFreePages (
   )
 {
   EFI_STATUS  Status;
-  LIST_ENTRY  *Link;
   MEMORY_MAP  *Entry;
   UINTN       Alignment;
   BOOLEAN     IsGuarded;
@@ -1668,21 +2106,8 @@ CoreInternalFreePages (
   // Find the entry that the covers the range
   //
   IsGuarded = FALSE;
-  Entry     = NULL;
-  for (Link = gMemoryMap.ForwardLink; Link != &gMemoryMap; Link = Link->ForwardLink) {
-    Entry = CR (Link, MEMORY_MAP, Link, MEMORY_MAP_SIGNATURE);
-    if ((Entry->Start <= Memory) && (Entry->End > Memory)) {
-      break;
-    }
-  }
-
-  if (Link == &gMemoryMap) {
-    Status = EFI_NOT_FOUND;
-    goto Done;
-  }
-
+  Entry     = FindMemoryMapEntry (Memory);
   if (Entry == NULL) {
-    ASSERT (Entry != NULL);
     Status = EFI_NOT_FOUND;
     goto Done;
   }
@@ -12,6 +12,13 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 STATIC EFI_LOCK  mPoolMemoryLock = EFI_INITIALIZE_LOCK_VARIABLE (TPL_NOTIFY);
 
+//
+// TRUE while the pool calls the page allocator with mPoolMemoryLock held. The
+// page allocator allocates and frees the nodes of its memory map indexes from
+// pool, so the pool is re-entered then, in a consistent state.
+//
+STATIC BOOLEAN  mPoolInPageAllocator = FALSE;
+
 #define POOL_FREE_SIGNATURE  SIGNATURE_32('p','f','r','0')
 typedef struct {
   UINT32        Signature;
@@ -59,6 +66,21 @@ STATIC CONST UINT16  mPoolSizeTable[] = {
 
 #define MAX_POOL_SIZE  (MAX_ADDRESS - POOL_OVERHEAD)
 
+//
+// Small blocks of the boot services memory types are recycled through a per
+// size class magazine before they go back to the free lists. A magazine hit skips
+// the bin search, the carving of larger blocks and, on free, the walk that
+// checks whether the whole pool page has become free.
+//
+#define POOL_MAGAZINE_SIGNATURE  SIGNATURE_32('p','m','g','0')
+#define POOL_MAGAZINE_DEPTH      16
+#define POOL_MAGAZINE_CLASSES    5
+
+typedef struct {
+  UINTN        Count;
+  POOL_HEAD    *Entries[POOL_MAGAZINE_DEPTH];
+} POOL_MAGAZINE;
+
 //
 // Globals
 //
@@ -70,6 +92,7 @@ typedef struct {
   EFI_MEMORY_TYPE    MemoryType;
   LIST_ENTRY         FreeList[MAX_POOL_LIST];
   LIST_ENTRY         Link;
+  POOL_MAGAZINE      Magazine[POOL_MAGAZINE_CLASSES];
 } POOL;
 
 //
@@ -126,6 +149,10 @@ CoreInitializePool (
     for (Index = 0; Index < MAX_POOL_LIST; Index++) {
       InitializeListHead (&mPoolHead[Type].FreeList[Index]);
     }
+
+    for (Index = 0; Index < POOL_MAGAZINE_CLASSES; Index++) {
+      mPoolHead[Type].Magazine[Index].Count = 0;
+    }
   }
 }
 
@@ -175,6 +202,10 @@ LookupPoolHead (
       InitializeListHead (&Pool->FreeList[Index]);
     }
 
+    for (Index = 0; Index < POOL_MAGAZINE_CLASSES; Index++) {
+      Pool->Magazine[Index].Count = 0;
+    }
+
     InsertHeadList (&mPoolHeadList, &Pool->Link);
 
     return Pool;
@@ -183,6 +214,56 @@ LookupPoolHead (
   return NULL;
 }
 
+/**
+  Get the magazine caching free blocks of a pool size class.
+
+  Only the boot services memory types have magazines in use. Blocks held in
+  a magazine keep their pool page allocated, which is harmless for memory the
+  OS reclaims at ExitBootServices(), but would fragment and pin the runtime
+  and ACPI memory types reported to the OS. The pool heads of OS/OEM memory
+  types are also released once they are empty.
+
+  @param  Pool                   Pool head of the memory type
+  @param  Index                  Pool size class of the block
+
+  @return The magazine, or NULL if blocks of this class are not cached.
+
+**/
+STATIC
+POOL_MAGAZINE *
+GetPoolMagazine (
+  IN POOL   *Pool,
+  IN UINTN  Index
+  )
+{
+  if ((Index >= POOL_MAGAZINE_CLASSES) ||
+      ((Pool->MemoryType != EfiBootServicesData) &&
+       (Pool->MemoryType != EfiBootServicesCode)))
+  {
+    return NULL;
+  }
+
+  return &Pool->Magazine[Index];
+}
+
+/**
+  Return all the blocks cached in the magazines of a pool head to its free
+  lists, releasing the pool pages that become entirely free.
+
+  @param  Pool                   Pool head of the memory type
+  @param  Granularity            Page allocation granularity of the memory type
+
+  @retval TRUE                   At least one block was returned.
+  @retval FALSE                  The magazines were empty.
+
+**/
+STATIC
+BOOLEAN
+CoreFlushPoolMagazines (
+  IN POOL   *Pool,
+  IN UINTN  Granularity
+  );
+
 /**
   Allocate pool of a particular type.
 
@@ -232,14 +313,23 @@ CoreInternalAllocatePool (
     return EFI_OUT_OF_RESOURCES;
   }
 
-  NeedGuard = IsPoolTypeToGuard (PoolType) && !mOnGuarding;
+  //
+  // The page allocator cannot set Guard pages for its own allocations
+  //
+  NeedGuard = IsPoolTypeToGuard (PoolType) && !mOnGuarding &&
+              (gMemoryLock.Lock != EfiLockAcquired);
 
   //
   // Acquire the memory lock and make the allocation
   //
   Status = CoreAcquireLockOrFail (&mPoolMemoryLock);
   if (EFI_ERROR (Status)) {
-    return EFI_OUT_OF_RESOURCES;
+    if (!mPoolInPageAllocator) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    *Buffer = CoreAllocatePoolI (PoolType, Size, NeedGuard);
+    return (*Buffer != NULL) ? EFI_SUCCESS : EFI_OUT_OF_RESOURCES;
   }
 
   *Buffer = CoreAllocatePoolI (PoolType, Size, NeedGuard);
@@ -273,7 +363,12 @@ CoreAllocatePool (
   EFI_STATUS  Status;
 
   Status = CoreInternalAllocatePool (PoolType, Size, Buffer);
-  if (!EFI_ERROR (Status)) {
+
+  //
+  // The allocations of the page allocator for itself are not recorded, as
+  // the memory profile may be what called the page allocator
+  //
+  if (!EFI_ERROR (Status) && (gMemoryLock.Lock != EfiLockAcquired)) {
     CoreUpdateProfile (
       (EFI_PHYSICAL_ADDRESS)(UINTN)RETURN_ADDRESS (0),
       MemoryProfileActionAllocatePool,
@@ -317,7 +412,9 @@ CoreAllocatePoolPagesI (
     return NULL;
   }
 
-  Buffer = CoreAllocatePoolPages (PoolType, NoPages, Granularity, NeedGuard);
+  mPoolInPageAllocator = TRUE;
+  Buffer               = CoreAllocatePoolPages (PoolType, NoPages, Granularity, NeedGuard);
+  mPoolInPageAllocator = FALSE;
   CoreReleaseMemoryLock ();
 
   if (Buffer != NULL) {
@@ -336,6 +433,49 @@ CoreAllocatePoolPagesI (
   return Buffer;
 }
 
+/**
+  Internal function.  Carves the free space of a pool block into free blocks,
+  the largest first, and puts them onto the free lists.
+
+  @param  Pool                   Pool head of the memory type
+  @param  NewPage                The pool block
+  @param  Offset                 Offset of the free space in the block
+  @param  MaxOffset              Size of the block
+  @param  Index                  Pool size class of the largest free block to
+                                 carve
+
+**/
+STATIC
+VOID
+CoreCarvePoolBlocks (
+  IN POOL   *Pool,
+  IN CHAR8  *NewPage,
+  IN UINTN  Offset,
+  IN UINTN  MaxOffset,
+  IN UINTN  Index
+  )
+{
+  POOL_FREE  *Free;
+  UINTN      FSize;
+
+  while (Offset < MaxOffset) {
+    ASSERT (Index < MAX_POOL_LIST);
+    FSize = LIST_TO_SIZE (Index);
+
+    while (Offset + FSize <= MaxOffset) {
+      Free            = (POOL_FREE *)&NewPage[Offset];
+      Free->Signature = POOL_FREE_SIGNATURE;
+      Free->Index     = (UINT32)Index;
+      InsertHeadList (&Pool->FreeList[Index], &Free->Link);
+      Offset += FSize;
+    }
+
+    Index -= 1;
+  }
+
+  ASSERT (Offset == MaxOffset);
+}
+
 /**
   Internal function to allocate pool of a particular type.
   Caller must have the memory lock held
@@ -354,19 +494,19 @@ CoreAllocatePoolI (
   IN BOOLEAN          NeedGuard
   )
 {
-  POOL       *Pool;
-  POOL_FREE  *Free;
-  POOL_HEAD  *Head;
-  POOL_TAIL  *Tail;
-  CHAR8      *NewPage;
-  VOID       *Buffer;
-  UINTN      Index;
-  UINTN      FSize;
-  UINTN      Offset, MaxOffset;
-  UINTN      NoPages;
-  UINTN      Granularity;
-  BOOLEAN    HasPoolTail;
-  BOOLEAN    PageAsPool;
+  POOL           *Pool;
+  POOL_FREE      *Free;
+  POOL_HEAD      *Head;
+  POOL_TAIL      *Tail;
+  POOL_MAGAZINE  *Magazine;
+  CHAR8          *NewPage;
+  VOID           *Buffer;
+  UINTN          Index;
+  UINTN          Offset, MaxOffset;
+  UINTN          NoPages;
+  UINTN          Granularity;
+  BOOLEAN        HasPoolTail;
+  BOOLEAN        PageAsPool;
 
   ASSERT_LOCKED (&mPoolMemoryLock);
 
@@ -415,6 +555,18 @@ CoreAllocatePoolI (
 
   Head = NULL;
 
+  //
+  // Small unguarded requests are served from the size class magazine first
+  //
+  if (!NeedGuard && !PageAsPool) {
+    Magazine = GetPoolMagazine (Pool, Index);
+    if ((Magazine != NULL) && (Magazine->Count > 0)) {
+      Head = Magazine->Entries[--Magazine->Count];
+      ASSERT (Head->Signature == POOL_MAGAZINE_SIGNATURE);
+      goto Done;
+    }
+  }
+
   //
   // If allocation is over max size, just allocate pages for the request
   // (slow)
@@ -437,6 +589,7 @@ CoreAllocatePoolI (
   //
   // If there's no free pool in the proper list size, go get some more pages
   //
+Retry:
   if (IsListEmpty (&Pool->FreeList[Index])) {
     Offset    = LIST_TO_SIZE (Index);
     MaxOffset = Granularity;
@@ -464,6 +617,18 @@ CoreAllocatePoolI (
                 NeedGuard
                 );
     if (NewPage == NULL) {
+      //
+      // The magazines may pin otherwise free pool pages. Give their blocks
+      // back and retry, unless the page allocator is busy further up the
+      // call stack and could not take them.
+      //
+      if ((gMemoryLock.Lock != EfiLockAcquired) &&
+          CoreFlushPoolMagazines (Pool, Granularity))
+      {
+        Index = SIZE_TO_LIST (Size);
+        goto Retry;
+      }
+
       goto Done;
     }
 
@@ -476,23 +641,7 @@ Carve:
     //
     // Carve up remaining space into free pool blocks
     //
-    Index--;
-    while (Offset < MaxOffset) {
-      ASSERT (Index < MAX_POOL_LIST);
-      FSize = LIST_TO_SIZE (Index);
-
-      while (Offset + FSize <= MaxOffset) {
-        Free            = (POOL_FREE *)&NewPage[Offset];
-        Free->Signature = POOL_FREE_SIGNATURE;
-        Free->Index     = (UINT32)Index;
-        InsertHeadList (&Pool->FreeList[Index], &Free->Link);
-        Offset += FSize;
-      }
-
-      Index -= 1;
-    }
-
-    ASSERT (Offset == MaxOffset);
+    CoreCarvePoolBlocks (Pool, NewPage, Offset, MaxOffset, Index - 1);
     goto Done;
   }
 
@@ -548,6 +697,80 @@ Done:
   return Buffer;
 }
 
+/**
+  Internal function.  Grows the pool of a memory type by one page, and puts
+  all of it onto the free lists. Used by the page allocator, with gMemoryLock
+  held, to make room for the nodes of its memory map indexes. The pool cannot
+  take pages by itself then.
+
+  The page is not passed through ApplyMemoryProtectionPolicy(), as for the
+  pages of the memory map descriptors, since that may allocate memory.
+
+  @param  PoolType               The type of pool to grow
+
+  @retval TRUE                   The pool was grown.
+  @retval FALSE                  The pool could not be grown.
+
+**/
+BOOLEAN
+CoreGrowPool (
+  IN EFI_MEMORY_TYPE  PoolType
+  )
+{
+  POOL        *Pool;
+  CHAR8       *NewPage;
+  UINTN       Granularity;
+  EFI_STATUS  Status;
+  BOOLEAN     InPageAllocator;
+
+  ASSERT_LOCKED (&gMemoryLock);
+
+  //
+  // Every pool block takes whole pages when freed memory is guarded
+  //
+  if (IsHeapGuardEnabled (GUARD_HEAP_TYPE_FREED) && !mOnGuarding) {
+    return FALSE;
+  }
+
+  if ((PoolType == EfiReservedMemoryType) ||
+      (PoolType == EfiACPIMemoryNVS) ||
+      (PoolType == EfiRuntimeServicesCode) ||
+      (PoolType == EfiRuntimeServicesData))
+  {
+    Granularity = RUNTIME_PAGE_ALLOCATION_GRANULARITY;
+  } else {
+    Granularity = DEFAULT_PAGE_ALLOCATION_GRANULARITY;
+  }
+
+  //
+  // The pool lock is only held here if the pool is the caller of the page
+  // allocator
+  //
+  Status = CoreAcquireLockOrFail (&mPoolMemoryLock);
+  if (EFI_ERROR (Status) && !mPoolInPageAllocator) {
+    return FALSE;
+  }
+
+  NewPage = NULL;
+  Pool    = LookupPoolHead (PoolType);
+  if (Pool != NULL) {
+    InPageAllocator      = mPoolInPageAllocator;
+    mPoolInPageAllocator = TRUE;
+    NewPage              = CoreAllocatePoolPages (PoolType, EFI_SIZE_TO_PAGES (Granularity), Granularity, FALSE);
+    mPoolInPageAllocator = InPageAllocator;
+
+    if (NewPage != NULL) {
+      CoreCarvePoolBlocks (Pool, NewPage, 0, Granularity, SIZE_TO_LIST (Granularity) - 1);
+    }
+  }
+
+  if (!EFI_ERROR (Status)) {
+    CoreReleaseLock (&mPoolMemoryLock);
+  }
+
+  return (BOOLEAN)(NewPage != NULL);
+}
+
 /**
   Frees pool.
 
@@ -571,7 +794,12 @@ CoreInternalFreePool (
     return EFI_INVALID_PARAMETER;
   }
 
-  CoreAcquireLock (&mPoolMemoryLock);
+  Status = CoreAcquireLockOrFail (&mPoolMemoryLock);
+  if (EFI_ERROR (Status)) {
+    ASSERT (mPoolInPageAllocator);
+    return CoreFreePoolI (Buffer, PoolType);
+  }
+
   Status = CoreFreePoolI (Buffer, PoolType);
   CoreReleaseLock (&mPoolMemoryLock);
   return Status;
@@ -596,7 +824,7 @@ CoreFreePool (
   EFI_MEMORY_TYPE  PoolType;
 
   Status = CoreInternalFreePool (Buffer, &PoolType);
-  if (!EFI_ERROR (Status)) {
+  if (!EFI_ERROR (Status) && (gMemoryLock.Lock != EfiLockAcquired)) {
     CoreUpdateProfile (
       (EFI_PHYSICAL_ADDRESS)(UINTN)RETURN_ADDRESS (0),
       MemoryProfileActionFreePool,
@@ -628,7 +856,9 @@ CoreFreePoolPagesI (
   )
 {
   CoreAcquireMemoryLock ();
+  mPoolInPageAllocator = TRUE;
   CoreFreePoolPages (Memory, NoPages);
+  mPoolInPageAllocator = FALSE;
   CoreReleaseMemoryLock ();
 
   GuardFreedPagesChecked (Memory, NoPages);
@@ -676,6 +906,131 @@ CoreFreePoolPagesWithGuard (
   }
 }
 
+/**
+  Internal function.  Put a pool block onto the free list of its size class,
+  and free its pool page if every block in the page is now free.
+
+  @param  Pool                   Pool head of the memory type
+  @param  Head                   The pool block to free
+  @param  Index                  Pool size class of the block
+  @param  Granularity            Page allocation granularity of the memory type
+
+**/
+STATIC
+VOID
+CoreFreePoolBlockI (
+  IN POOL       *Pool,
+  IN POOL_HEAD  *Head,
+  IN UINTN      Index,
+  IN UINTN      Granularity
+  )
+{
+  POOL_FREE  *Free;
+  CHAR8      *NewPage;
+  UINTN      Offset;
+  BOOLEAN    AllFree;
+
+  //
+  // Put the pool entry onto the free pool list
+  //
+  Free            = (POOL_FREE *)Head;
+  Free->Signature = POOL_FREE_SIGNATURE;
+  Free->Index     = (UINT32)Index;
+  InsertHeadList (&Pool->FreeList[Index], &Free->Link);
+
+  //
+  // See if all the pool entries in the same page as Free are freed pool
+  // entries. The page is kept when the page allocator frees pool, as it
+  // cannot take it back then.
+  //
+  NewPage = (CHAR8 *)((UINTN)Free & ~(Granularity - 1));
+  Free    = (POOL_FREE *)&NewPage[0];
+  ASSERT (Free != NULL);
+
+  if ((Free->Signature == POOL_FREE_SIGNATURE) && (gMemoryLock.Lock != EfiLockAcquired)) {
+    AllFree = TRUE;
+    Offset  = 0;
+
+    while ((Offset < Granularity) && (AllFree)) {
+      Free = (POOL_FREE *)&NewPage[Offset];
+      ASSERT (Free != NULL);
+      if (Free->Signature != POOL_FREE_SIGNATURE) {
+        AllFree = FALSE;
+      }
+
+      Offset += LIST_TO_SIZE (Free->Index);
+    }
+
+    if (AllFree) {
+      //
+      // All of the pool entries in the same page as Free are free pool
+      // entries
+      // Remove all of these pool entries from the free loop lists.
+      //
+      Free = (POOL_FREE *)&NewPage[0];
+      ASSERT (Free != NULL);
+      Offset = 0;
+
+      while (Offset < Granularity) {
+        Free = (POOL_FREE *)&NewPage[Offset];
+        ASSERT (Free != NULL);
+        RemoveEntryList (&Free->Link);
+        Offset += LIST_TO_SIZE (Free->Index);
+      }
+
+      //
+      // Free the page
+      //
+      CoreFreePoolPagesI (
+        Pool->MemoryType,
+        (EFI_PHYSICAL_ADDRESS)(UINTN)NewPage,
+        EFI_SIZE_TO_PAGES (Granularity)
+        );
+    }
+  }
+}
+
+/**
+  Return all the blocks cached in the magazines of a pool head to its free
+  lists, releasing the pool pages that become entirely free.
+
+  @param  Pool                   Pool head of the memory type
+  @param  Granularity            Page allocation granularity of the memory type
+
+  @retval TRUE                   At least one block was returned.
+  @retval FALSE                  The magazines were empty.
+
+**/
+STATIC
+BOOLEAN
+CoreFlushPoolMagazines (
+  IN POOL   *Pool,
+  IN UINTN  Granularity
+  )
+{
+  POOL_MAGAZINE  *Magazine;
+  POOL_HEAD      *Head;
+  UINTN          Index;
+  BOOLEAN        Flushed;
+
+  Flushed = FALSE;
+  for (Index = 0; Index < POOL_MAGAZINE_CLASSES; Index++) {
+    Magazine = GetPoolMagazine (Pool, Index);
+    if (Magazine == NULL) {
+      continue;
+    }
+
+    while (Magazine->Count > 0) {
+      Head = Magazine->Entries[--Magazine->Count];
+      ASSERT (Head->Signature == POOL_MAGAZINE_SIGNATURE);
+      CoreFreePoolBlockI (Pool, Head, Index, Granularity);
+      Flushed = TRUE;
+    }
+  }
+
+  return Flushed;
+}
+
 /**
   Internal function to free a pool entry.
   Caller must have the memory lock held
@@ -693,20 +1048,17 @@ CoreFreePoolI (
   OUT EFI_MEMORY_TYPE  *PoolType OPTIONAL
   )
 {
-  POOL       *Pool;
-  POOL_HEAD  *Head;
-  POOL_TAIL  *Tail;
-  POOL_FREE  *Free;
-  UINTN      Index;
-  UINTN      NoPages;
-  UINTN      Size;
-  CHAR8      *NewPage;
-  UINTN      Offset;
-  BOOLEAN    AllFree;
-  UINTN      Granularity;
-  BOOLEAN    IsGuarded;
-  BOOLEAN    HasPoolTail;
-  BOOLEAN    PageAsPool;
+  POOL           *Pool;
+  POOL_HEAD      *Head;
+  POOL_TAIL      *Tail;
+  POOL_MAGAZINE  *Magazine;
+  UINTN          Index;
+  UINTN          NoPages;
+  UINTN          Size;
+  UINTN          Granularity;
+  BOOLEAN        IsGuarded;
+  BOOLEAN        HasPoolTail;
+  BOOLEAN        PageAsPool;
 
   ASSERT (Buffer != NULL);
   //
@@ -809,63 +1161,18 @@ CoreFreePoolI (
     }
   } else {
     //
-    // Put the pool entry onto the free pool list
-    //
-    Free = (POOL_FREE *)Head;
-    ASSERT (Free != NULL);
-    Free->Signature = POOL_FREE_SIGNATURE;
-    Free->Index     = (UINT32)Index;
-    InsertHeadList (&Pool->FreeList[Index], &Free->Link);
-
-    //
-    // See if all the pool entries in the same page as Free are freed pool
-    // entries
+    // Keep the block in the size class magazine if there is room. The head
+    // and tail have already been validated above, and the block is marked so
+    // that a double free is caught.
     //
-    NewPage = (CHAR8 *)((UINTN)Free & ~(Granularity - 1));
-    Free    = (POOL_FREE *)&NewPage[0];
-    ASSERT (Free != NULL);
-
-    if (Free->Signature == POOL_FREE_SIGNATURE) {
-      AllFree = TRUE;
-      Offset  = 0;
-
-      while ((Offset < Granularity) && (AllFree)) {
-        Free = (POOL_FREE *)&NewPage[Offset];
-        ASSERT (Free != NULL);
-        if (Free->Signature != POOL_FREE_SIGNATURE) {
-          AllFree = FALSE;
-        }
-
-        Offset += LIST_TO_SIZE (Free->Index);
-      }
-
-      if (AllFree) {
-        //
-        // All of the pool entries in the same page as Free are free pool
-        // entries
-        // Remove all of these pool entries from the free loop lists.
-        //
-        Free = (POOL_FREE *)&NewPage[0];
-        ASSERT (Free != NULL);
-        Offset = 0;
-
-        while (Offset < Granularity) {
-          Free = (POOL_FREE *)&NewPage[Offset];
-          ASSERT (Free != NULL);
-          RemoveEntryList (&Free->Link);
-          Offset += LIST_TO_SIZE (Free->Index);
-        }
-
-        //
-        // Free the page
-        //
-        CoreFreePoolPagesI (
-          Pool->MemoryType,
-          (EFI_PHYSICAL_ADDRESS)(UINTN)NewPage,
-          EFI_SIZE_TO_PAGES (Granularity)
-          );
-      }
+    Magazine = GetPoolMagazine (Pool, Index);
+    if ((Magazine != NULL) && (Magazine->Count < POOL_MAGAZINE_DEPTH)) {
+      Head->Signature                      = POOL_MAGAZINE_SIGNATURE;
+      Magazine->Entries[Magazine->Count++] = Head;
+      return EFI_SUCCESS;
     }
+
+    CoreFreePoolBlockI (Pool, Head, Index, Granularity);
   }
 
   //
@@ -0,0 +1,108 @@
+/** @file
+  Support functions for the HOB index table, which lets the HOB library
+  instances of DXE find GUID HOBs without walking the whole HOB list.
+
+Copyright (c) 2026, TianoCore and contributors. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "DxeMain.h"
+
+/**
+  Compare two HOB index entries by GUID, and then by HOB address.
+
+  @param  Buffer1       The first EDKII_HOB_INDEX_ENTRY.
+  @param  Buffer2       The second EDKII_HOB_INDEX_ENTRY.
+
+  @retval <0            Buffer1 sorts before Buffer2.
+  @retval 0             Buffer1 and Buffer2 are the same entry.
+  @retval >0            Buffer1 sorts after Buffer2.
+
+**/
+STATIC
+INTN
+EFIAPI
+CompareHobIndexEntry (
+  IN CONST VOID  *Buffer1,
+  IN CONST VOID  *Buffer2
+  )
+{
+  CONST EDKII_HOB_INDEX_ENTRY  *Entry1;
+  CONST EDKII_HOB_INDEX_ENTRY  *Entry2;
+  INTN                         Result;
+
+  Entry1 = Buffer1;
+  Entry2 = Buffer2;
+  Result = CompareMem (&Entry1->Name, &Entry2->Name, sizeof (EFI_GUID));
+  if (Result != 0) {
+    return Result;
+  }
+
+  if (Entry1->Hob == Entry2->Hob) {
+    return 0;
+  }
+
+  return (Entry1->Hob < Entry2->Hob) ? -1 : 1;
+}
+
+/**
+  Creates the HOB index table of the GUID HOBs in the HOB list and registers it
+  into the system table. The HOB list must not change afterwards, which holds
+  once it has been installed into the system table.
+
+  On success, gHobIndex points to the table so that the HOB library of the
+  DXE Core uses it too.
+
+  @param  HobStart      The pointer to the beginning of the HOB list.
+
+**/
+VOID
+CoreInstallHobIndexTable (
+  IN VOID  *HobStart
+  )
+{
+  EFI_STATUS             Status;
+  EFI_PEI_HOB_POINTERS   Hob;
+  EDKII_HOB_INDEX_TABLE  *HobIndex;
+  EDKII_HOB_INDEX_ENTRY  *Entry;
+  EDKII_HOB_INDEX_ENTRY  TempEntry;
+  UINTN                  Count;
+
+  Count = 0;
+  for (Hob.Raw = HobStart; !END_OF_HOB_LIST (Hob); Hob.Raw = GET_NEXT_HOB (Hob)) {
+    if (GET_HOB_TYPE (Hob) == EFI_HOB_TYPE_GUID_EXTENSION) {
+      Count++;
+    }
+  }
+
+  HobIndex = AllocatePool (sizeof (EDKII_HOB_INDEX_TABLE) + Count * sizeof (EDKII_HOB_INDEX_ENTRY));
+  if (HobIndex == NULL) {
+    return;
+  }
+
+  HobIndex->HobListStart = (EFI_PHYSICAL_ADDRESS)(UINTN)HobStart;
+  HobIndex->HobListEnd   = (EFI_PHYSICAL_ADDRESS)(UINTN)Hob.Raw;
+  HobIndex->EntryCount   = (UINT32)Count;
+  HobIndex->Reserved     = 0;
+
+  Entry = (EDKII_HOB_INDEX_ENTRY *)(HobIndex + 1);
+  for (Hob.Raw = HobStart; !END_OF_HOB_LIST (Hob); Hob.Raw = GET_NEXT_HOB (Hob)) {
+    if (GET_HOB_TYPE (Hob) == EFI_HOB_TYPE_GUID_EXTENSION) {
+      CopyGuid (&Entry->Name, &Hob.Guid->Name);
+      Entry->Hob = (EFI_PHYSICAL_ADDRESS)(UINTN)Hob.Raw;
+      Entry++;
+    }
+  }
+
+  QuickSort (HobIndex + 1, Count, sizeof (EDKII_HOB_INDEX_ENTRY), CompareHobIndexEntry, &TempEntry);
+
+  Status = CoreInstallConfigurationTable (&gEdkiiHobIndexTableGuid, HobIndex);
+  if (EFI_ERROR (Status)) {
+    CoreFreePool (HobIndex);
+    return;
+  }
+
+  gHobIndex = HobIndex;
+  DEBUG ((DEBUG_INFO, "HOB index table at 0x%p with %d GUID HOBs\n", HobIndex, (UINT32)Count));
+}
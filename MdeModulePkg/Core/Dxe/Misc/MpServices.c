@@ -0,0 +1,109 @@
+/** @file
+  Helpers that let the DXE core spread memory-only work over the
+  application processors through EFI_MP_SERVICES_PROTOCOL.
+
+Copyright (c) 2026, TianoCore and contributors. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "DxeMain.h"
+
+/**
+  Check whether EFI_MP_SERVICES_PROTOCOL is installed and reports at least
+  one enabled application processor.
+
+  @retval TRUE   Work can be run on the application processors.
+  @retval FALSE  Work must be run on the BSP.
+
+**/
+BOOLEAN
+CoreIsMpAvailable (
+  VOID
+  )
+{
+  EFI_STATUS                Status;
+  EFI_MP_SERVICES_PROTOCOL  *MpServices;
+  UINTN                     NumberOfProcessors;
+  UINTN                     NumberOfEnabledProcessors;
+
+  Status = CoreLocateProtocol (&gEfiMpServiceProtocolGuid, NULL, (VOID **)&MpServices);
+  if (EFI_ERROR (Status)) {
+    return FALSE;
+  }
+
+  Status = MpServices->GetNumberOfProcessors (
+                         MpServices,
+                         &NumberOfProcessors,
+                         &NumberOfEnabledProcessors
+                         );
+  return (BOOLEAN)(!EFI_ERROR (Status) && (NumberOfEnabledProcessors > 1));
+}
+
+/**
+  Run a procedure on every enabled application processor and on the BSP at
+  the same time.
+
+  The procedure must pull its work from a queue in Argument, so that the BSP
+  takes its share of the work, or everything if the application processors
+  could not be started. It must only touch memory that the caller already
+  owns, and must not call any boot service.
+
+  The completion of the application processors is signaled from a timer
+  event, so above TPL_APPLICATION the application processors are run to
+  completion first and the BSP only finishes what they left.
+
+  @param  Procedure               The procedure to run.
+  @param  Argument                The parameter passed to Procedure.
+
+  @retval EFI_SUCCESS             The application processors ran Procedure.
+  @return Others                  The error returned by StartupAllAPs (), or
+                                  EFI_NOT_FOUND if EFI_MP_SERVICES_PROTOCOL is
+                                  not installed. Procedure was still run on
+                                  the BSP.
+
+**/
+EFI_STATUS
+CoreStartupAllProcessors (
+  IN EFI_AP_PROCEDURE  Procedure,
+  IN VOID              *Argument
+  )
+{
+  EFI_STATUS                Status;
+  EFI_MP_SERVICES_PROTOCOL  *MpServices;
+  EFI_EVENT                 WaitEvent;
+  UINTN                     Index;
+
+  WaitEvent = NULL;
+  Status    = CoreLocateProtocol (&gEfiMpServiceProtocolGuid, NULL, (VOID **)&MpServices);
+  if (!EFI_ERROR (Status)) {
+    if (gEfiCurrentTpl == TPL_APPLICATION) {
+      Status = CoreCreateEvent (0, TPL_NOTIFY, NULL, NULL, &WaitEvent);
+      if (EFI_ERROR (Status)) {
+        WaitEvent = NULL;
+      }
+    }
+
+    Status = MpServices->StartupAllAPs (
+                           MpServices,
+                           Procedure,
+                           FALSE,
+                           WaitEvent,
+                           0,
+                           Argument,
+                           NULL
+                           );
+  }
+
+  Procedure (Argument);
+
+  if (WaitEvent != NULL) {
+    if (!EFI_ERROR (Status)) {
+      CoreWaitForEvent (1, &WaitEvent, &Index);
+    }
+
+    CoreCloseEvent (WaitEvent);
+  }
+
+  return Status;
+}
@@ -0,0 +1,987 @@
+/** @file
+  Boot service tracing.
+
+  When PcdDxeServiceTraceMask is not zero, the boot services selected by the
+  mask are replaced in the Boot Services Table by wrappers that time each call
+  with the performance counter and attribute it to the image that made it,
+  using the return address of the call. The results are published in the
+  EDKII_BOOT_SERVICE_TRACE_TABLE configuration table for the dp shell command.
+
+  Calls made by the DXE Core to its own services do not go through the Boot
+  Services Table and are not traced. When the memory services are traced, the
+  memory profile attributes their allocations to the DXE Core.
+
+Copyright (c) 2026, TianoCore and contributors. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "DxeMain.h"
+
+//
+// Images that can be told apart, including the unknown caller and the DXE Core.
+//
+#define SERVICE_TRACE_MAX_IMAGE_COUNT  256
+
+#define SERVICE_TRACE_UNKNOWN_IMAGE  0
+
+//
+// The address range of an image that is still loaded.
+//
+typedef struct {
+  UINTN     Base;
+  UINTN     End;
+  UINT16    ImageIndex;
+} SERVICE_TRACE_RANGE;
+
+//
+// A boot service that can be traced.
+//
+typedef struct {
+  UINTN    Offset;       // Offset of the service in EFI_BOOT_SERVICES
+  VOID     *Wrapper;
+} SERVICE_TRACE_WRAPPER;
+
+EDKII_BOOT_SERVICE_TRACE_TABLE  *mServiceTrace = NULL;
+BOOT_SERVICE_TRACE_IMAGE        *mServiceTraceImages;
+BOOT_SERVICE_TRACE_STATS        *mServiceTraceStats;
+BOOT_SERVICE_TRACE_RECORD       *mServiceTraceRing;
+UINT32                          mServiceTraceRingIndex;
+
+//
+// The ranges of the loaded images, sorted by base address.
+//
+SERVICE_TRACE_RANGE  mServiceTraceRanges[SERVICE_TRACE_MAX_IMAGE_COUNT];
+UINTN                mServiceTraceRangeCount;
+
+//
+// The lower bound of each histogram bucket but the first, in counter ticks.
+//
+UINT64  mServiceTraceBucketLimit[BOOT_SERVICE_TRACE_BUCKET_COUNT - 1];
+
+//
+// The boot services called by the wrappers.
+//
+EFI_BOOT_SERVICES  mTracedServices;
+
+/**
+  Return the number of ticks between two values of the performance counter.
+
+  @param  StartTicks    The counter value at the start of the call.
+  @param  EndTicks      The counter value at the end of the call.
+
+  @return The elapsed ticks.
+
+**/
+STATIC
+UINT64
+GetServiceTraceTicks (
+  IN UINT64  StartTicks,
+  IN UINT64  EndTicks
+  )
+{
+  UINT64  CounterStart;
+  UINT64  CounterEnd;
+
+  CounterStart = mServiceTrace->CounterStart;
+  CounterEnd   = mServiceTrace->CounterEnd;
+
+  if (CounterStart < CounterEnd) {
+    if (EndTicks >= StartTicks) {
+      return EndTicks - StartTicks;
+    }
+
+    return (CounterEnd - StartTicks) + (EndTicks - CounterStart);
+  }
+
+  if (StartTicks >= EndTicks) {
+    return StartTicks - EndTicks;
+  }
+
+  return (StartTicks - CounterEnd) + (CounterStart - EndTicks);
+}
+
+/**
+  Find the image that contains an address.
+
+  @param  Address       The address to look up.
+
+  @return The index of the image in the trace table, or
+          SERVICE_TRACE_UNKNOWN_IMAGE if no loaded image contains the address.
+
+**/
+STATIC
+UINT16
+FindServiceTraceImage (
+  IN UINTN  Address
+  )
+{
+  UINTN  Low;
+  UINTN  High;
+  UINTN  Middle;
+
+  //
+  // Find the last range that starts at or before Address.
+  //
+  Low  = 0;
+  High = mServiceTraceRangeCount;
+  while (Low < High) {
+    Middle = Low + (High - Low) / 2;
+    if (mServiceTraceRanges[Middle].Base <= Address) {
+      Low = Middle + 1;
+    } else {
+      High = Middle;
+    }
+  }
+
+  if ((Low > 0) && (Address < mServiceTraceRanges[Low - 1].End)) {
+    return mServiceTraceRanges[Low - 1].ImageIndex;
+  }
+
+  return SERVICE_TRACE_UNKNOWN_IMAGE;
+}
+
+/**
+  Record a call to a traced boot service.
+
+  @param  Service       The BOOT_SERVICE_TRACE_* number of the service.
+  @param  StartTicks    The counter value when the service was called.
+  @param  CallerAddress The return address of the call.
+
+**/
+STATIC
+VOID
+RecordServiceCall (
+  IN UINT8   Service,
+  IN UINT64  StartTicks,
+  IN VOID    *CallerAddress
+  )
+{
+  UINT64                     Ticks;
+  BOOLEAN                    InterruptState;
+  UINT16                     ImageIndex;
+  BOOT_SERVICE_TRACE_STATS   *Stats;
+  BOOT_SERVICE_TRACE_RECORD  *Record;
+  UINTN                      Bucket;
+
+  Ticks = GetServiceTraceTicks (StartTicks, GetPerformanceCounter ());
+
+  //
+  // The services may be called from notification functions at any TPL, so
+  // the tables are updated with the interrupts disabled.
+  //
+  InterruptState = SaveAndDisableInterrupts ();
+
+  ImageIndex = FindServiceTraceImage ((UINTN)CallerAddress);
+  Stats      = &mServiceTraceStats[ImageIndex * BOOT_SERVICE_TRACE_SERVICE_COUNT + Service];
+  Stats->CallCount++;
+  Stats->TotalTicks += Ticks;
+  if (Ticks > Stats->MaxTicks) {
+    Stats->MaxTicks = Ticks;
+  }
+
+  for (Bucket = 0; Bucket < ARRAY_SIZE (mServiceTraceBucketLimit); Bucket++) {
+    if (Ticks < mServiceTraceBucketLimit[Bucket]) {
+      break;
+    }
+  }
+
+  Stats->Histogram[Bucket]++;
+
+  if (mServiceTrace->RingSize != 0) {
+    Record             = &mServiceTraceRing[mServiceTraceRingIndex];
+    Record->StartTicks = StartTicks;
+    Record->Ticks      = (Ticks > MAX_UINT32) ? MAX_UINT32 : (UINT32)Ticks;
+    Record->ImageIndex = ImageIndex;
+    Record->Service    = Service;
+    Record->Reserved   = 0;
+
+    mServiceTraceRingIndex++;
+    if (mServiceTraceRingIndex == mServiceTrace->RingSize) {
+      mServiceTraceRingIndex = 0;
+    }
+
+    mServiceTrace->RingCount++;
+  }
+
+  SetInterruptState (InterruptState);
+}
+
+//
+// Each wrapper calls the original service and records the call against the
+// caller of the wrapper.
+//
+
+STATIC
+EFI_STATUS
+EFIAPI
+TraceAllocatePages (
+  IN     EFI_ALLOCATE_TYPE     Type,
+  IN     EFI_MEMORY_TYPE       MemoryType,
+  IN     UINTN                 Pages,
+  IN OUT EFI_PHYSICAL_ADDRESS  *Memory
+  )
+{
+  UINT64      StartTicks;
+  EFI_STATUS  Status;
+
+  StartTicks = GetPerformanceCounter ();
+  Status     = mTracedServices.AllocatePages (Type, MemoryType, Pages, Memory);
+  RecordServiceCall (BOOT_SERVICE_TRACE_ALLOCATE_PAGES, StartTicks, RETURN_ADDRESS (0));
+  return Status;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+TraceFreePages (
+  IN EFI_PHYSICAL_ADDRESS  Memory,
+  IN UINTN                 Pages
+  )
+{
+  UINT64      StartTicks;
+  EFI_STATUS  Status;
+
+  StartTicks = GetPerformanceCounter ();
+  Status     = mTracedServices.FreePages (Memory, Pages);
+  RecordServiceCall (BOOT_SERVICE_TRACE_FREE_PAGES, StartTicks, RETURN_ADDRESS (0));
+  return Status;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+TraceGetMemoryMap (
+  IN OUT UINTN                  *MemoryMapSize,
+  OUT    EFI_MEMORY_DESCRIPTOR  *MemoryMap,
+  OUT    UINTN                  *MapKey,
+  OUT    UINTN                  *DescriptorSize,
+  OUT    UINT32                 *DescriptorVersion
+  )
+{
+  UINT64      StartTicks;
+  EFI_STATUS  Status;
+
+  StartTicks = GetPerformanceCounter ();
+  Status     = mTracedServices.GetMemoryMap (MemoryMapSize, MemoryMap, MapKey, DescriptorSize, DescriptorVersion);
+  RecordServiceCall (BOOT_SERVICE_TRACE_GET_MEMORY_MAP, StartTicks, RETURN_ADDRESS (0));
+  return Status;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+TraceAllocatePool (
+  IN  EFI_MEMORY_TYPE  PoolType,
+  IN  UINTN            Size,
+  OUT VOID             **Buffer
+  )
+{
+  UINT64      StartTicks;
+  EFI_STATUS  Status;
+
+  StartTicks = GetPerformanceCounter ();
+  Status     = mTracedServices.AllocatePool (PoolType, Size, Buffer);
+  RecordServiceCall (BOOT_SERVICE_TRACE_ALLOCATE_POOL, StartTicks, RETURN_ADDRESS (0));
+  return Status;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+TraceFreePool (
+  IN VOID  *Buffer
+  )
+{
+  UINT64      StartTicks;
+  EFI_STATUS  Status;
+
+  StartTicks = GetPerformanceCounter ();
+  Status     = mTracedServices.FreePool (Buffer);
+  RecordServiceCall (BOOT_SERVICE_TRACE_FREE_POOL, StartTicks, RETURN_ADDRESS (0));
+  return Status;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+TraceCreateEvent (
+  IN  UINT32            Type,
+  IN  EFI_TPL           NotifyTpl,
+  IN  EFI_EVENT_NOTIFY  NotifyFunction OPTIONAL,
+  IN  VOID              *NotifyContext OPTIONAL,
+  OUT EFI_EVENT         *Event
+  )
+{
+  UINT64      StartTicks;
+  EFI_STATUS  Status;
+
+  StartTicks = GetPerformanceCounter ();
+  Status     = mTracedServices.CreateEvent (Type, NotifyTpl, NotifyFunction, NotifyContext, Event);
+  RecordServiceCall (BOOT_SERVICE_TRACE_CREATE_EVENT, StartTicks, RETURN_ADDRESS (0));
+  return Status;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+TraceSetTimer (
+  IN EFI_EVENT        Event,
+  IN EFI_TIMER_DELAY  Type,
+  IN UINT64           TriggerTime
+  )
+{
+  UINT64      StartTicks;
+  EFI_STATUS  Status;
+
+  StartTicks = GetPerformanceCounter ();
+  Status     = mTracedServices.SetTimer (Event, Type, TriggerTime);
+  RecordServiceCall (BOOT_SERVICE_TRACE_SET_TIMER, StartTicks, RETURN_ADDRESS (0));
+  return Status;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+TraceWaitForEvent (
+  IN  UINTN      NumberOfEvents,
+  IN  EFI_EVENT  *Event,
+  OUT UINTN      *Index
+  )
+{
+  UINT64      StartTicks;
+  EFI_STATUS  Status;
+
+  StartTicks = GetPerformanceCounter ();
+  Status     = mTracedServices.WaitForEvent (NumberOfEvents, Event, Index);
+  RecordServiceCall (BOOT_SERVICE_TRACE_WAIT_FOR_EVENT, StartTicks, RETURN_ADDRESS (0));
+  return Status;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+TraceSignalEvent (
+  IN EFI_EVENT  Event
+  )
+{
+  UINT64      StartTicks;
+  EFI_STATUS  Status;
+
+  StartTicks = GetPerformanceCounter ();
+  Status     = mTracedServices.SignalEvent (Event);
+  RecordServiceCall (BOOT_SERVICE_TRACE_SIGNAL_EVENT, StartTicks, RETURN_ADDRESS (0));
+  return Status;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+TraceCloseEvent (
+  IN EFI_EVENT  Event
+  )
+{
+  UINT64      StartTicks;
+  EFI_STATUS  Status;
+
+  StartTicks = GetPerformanceCounter ();
+  Status     = mTracedServices.CloseEvent (Event);
+  RecordServiceCall (BOOT_SERVICE_TRACE_CLOSE_EVENT, StartTicks, RETURN_ADDRESS (0));
+  return Status;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+TraceCheckEvent (
+  IN EFI_EVENT  Event
+  )
+{
+  UINT64      StartTicks;
+  EFI_STATUS  Status;
+
+  StartTicks = GetPerformanceCounter ();
+  Status     = mTracedServices.CheckEvent (Event);
+  RecordServiceCall (BOOT_SERVICE_TRACE_CHECK_EVENT, StartTicks, RETURN_ADDRESS (0));
+  return Status;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+TraceInstallProtocolInterface (
+  IN OUT EFI_HANDLE          *Handle,
+  IN     EFI_GUID            *Protocol,
+  IN     EFI_INTERFACE_TYPE  InterfaceType,
+  IN     VOID                *Interface
+  )
+{
+  UINT64      StartTicks;
+  EFI_STATUS  Status;
+
+  StartTicks = GetPerformanceCounter ();
+  Status     = mTracedServices.InstallProtocolInterface (Handle, Protocol, InterfaceType, Interface);
+  RecordServiceCall (BOOT_SERVICE_TRACE_INSTALL_PROTOCOL_INTERFACE, StartTicks, RETURN_ADDRESS (0));
+  return Status;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+TraceReinstallProtocolInterface (
+  IN EFI_HANDLE  Handle,
+  IN EFI_GUID    *Protocol,
+  IN VOID        *OldInterface,
+  IN VOID        *NewInterface
+  )
+{
+  UINT64      StartTicks;
+  EFI_STATUS  Status;
+
+  StartTicks = GetPerformanceCounter ();
+  Status     = mTracedServices.ReinstallProtocolInterface (Handle, Protocol, OldInterface, NewInterface);
+  RecordServiceCall (BOOT_SERVICE_TRACE_REINSTALL_PROTOCOL_INTERFACE, StartTicks, RETURN_ADDRESS (0));
+  return Status;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+TraceUninstallProtocolInterface (
+  IN EFI_HANDLE  Handle,
+  IN EFI_GUID    *Protocol,
+  IN VOID        *Interface
+  )
+{
+  UINT64      StartTicks;
+  EFI_STATUS  Status;
+
+  StartTicks = GetPerformanceCounter ();
+  Status     = mTracedServices.UninstallProtocolInterface (Handle, Protocol, Interface);
+  RecordServiceCall (BOOT_SERVICE_TRACE_UNINSTALL_PROTOCOL_INTERFACE, StartTicks, RETURN_ADDRESS (0));
+  return Status;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+TraceHandleProtocol (
+  IN  EFI_HANDLE  Handle,
+  IN  EFI_GUID    *Protocol,
+  OUT VOID        **Interface
+  )
+{
+  UINT64      StartTicks;
+  EFI_STATUS  Status;
+
+  StartTicks = GetPerformanceCounter ();
+  Status     = mTracedServices.HandleProtocol (Handle, Protocol, Interface);
+  RecordServiceCall (BOOT_SERVICE_TRACE_HANDLE_PROTOCOL, StartTicks, RETURN_ADDRESS (0));
+  return Status;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+TraceRegisterProtocolNotify (
+  IN  EFI_GUID   *Protocol,
+  IN  EFI_EVENT  Event,
+  OUT VOID       **Registration
+  )
+{
+  UINT64      StartTicks;
+  EFI_STATUS  Status;
+
+  StartTicks = GetPerformanceCounter ();
+  Status     = mTracedServices.RegisterProtocolNotify (Protocol, Event, Registration);
+  RecordServiceCall (BOOT_SERVICE_TRACE_REGISTER_PROTOCOL_NOTIFY, StartTicks, RETURN_ADDRESS (0));
+  return Status;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+TraceLocateHandle (
+  IN     EFI_LOCATE_SEARCH_TYPE  SearchType,
+  IN     EFI_GUID                *Protocol   OPTIONAL,
+  IN     VOID                    *SearchKey  OPTIONAL,
+  IN OUT UINTN                   *BufferSize,
+  OUT    EFI_HANDLE              *Buffer
+  )
+{
+  UINT64      StartTicks;
+  EFI_STATUS  Status;
+
+  StartTicks = GetPerformanceCounter ();
+  Status     = mTracedServices.LocateHandle (SearchType, Protocol, SearchKey, BufferSize, Buffer);
+  RecordServiceCall (BOOT_SERVICE_TRACE_LOCATE_HANDLE, StartTicks, RETURN_ADDRESS (0));
+  return Status;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+TraceLocateDevicePath (
+  IN     EFI_GUID                  *Protocol,
+  IN OUT EFI_DEVICE_PATH_PROTOCOL  **DevicePath,
+  OUT    EFI_HANDLE                *Device
+  )
+{
+  UINT64      StartTicks;
+  EFI_STATUS  Status;
+
+  StartTicks = GetPerformanceCounter ();
+  Status     = mTracedServices.LocateDevicePath (Protocol, DevicePath, Device);
+  RecordServiceCall (BOOT_SERVICE_TRACE_LOCATE_DEVICE_PATH, StartTicks, RETURN_ADDRESS (0));
+  return Status;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+TraceStall (
+  IN UINTN  Microseconds
+  )
+{
+  UINT64      StartTicks;
+  EFI_STATUS  Status;
+
+  StartTicks = GetPerformanceCounter ();
+  Status     = mTracedServices.Stall (Microseconds);
+  RecordServiceCall (BOOT_SERVICE_TRACE_STALL, StartTicks, RETURN_ADDRESS (0));
+  return Status;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+TraceConnectController (
+  IN  EFI_HANDLE                ControllerHandle,
+  IN  EFI_HANDLE                *DriverImageHandle    OPTIONAL,
+  IN  EFI_DEVICE_PATH_PROTOCOL  *RemainingDevicePath  OPTIONAL,
+  IN  BOOLEAN                   Recursive
+  )
+{
+  UINT64      StartTicks;
+  EFI_STATUS  Status;
+
+  StartTicks = GetPerformanceCounter ();
+  Status     = mTracedServices.ConnectController (ControllerHandle, DriverImageHandle, RemainingDevicePath, Recursive);
+  RecordServiceCall (BOOT_SERVICE_TRACE_CONNECT_CONTROLLER, StartTicks, RETURN_ADDRESS (0));
+  return Status;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+TraceDisconnectController (
+  IN  EFI_HANDLE  ControllerHandle,
+  IN  EFI_HANDLE  DriverImageHandle  OPTIONAL,
+  IN  EFI_HANDLE  ChildHandle        OPTIONAL
+  )
+{
+  UINT64      StartTicks;
+  EFI_STATUS  Status;
+
+  StartTicks = GetPerformanceCounter ();
+  Status     = mTracedServices.DisconnectController (ControllerHandle, DriverImageHandle, ChildHandle);
+  RecordServiceCall (BOOT_SERVICE_TRACE_DISCONNECT_CONTROLLER, StartTicks, RETURN_ADDRESS (0));
+  return Status;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+TraceOpenProtocol (
+  IN  EFI_HANDLE  Handle,
+  IN  EFI_GUID    *Protocol,
+  OUT VOID        **Interface  OPTIONAL,
+  IN  EFI_HANDLE  AgentHandle,
+  IN  EFI_HANDLE  ControllerHandle,
+  IN  UINT32      Attributes
+  )
+{
+  UINT64      StartTicks;
+  EFI_STATUS  Status;
+
+  StartTicks = GetPerformanceCounter ();
+  Status     = mTracedServices.OpenProtocol (Handle, Protocol, Interface, AgentHandle, ControllerHandle, Attributes);
+  RecordServiceCall (BOOT_SERVICE_TRACE_OPEN_PROTOCOL, StartTicks, RETURN_ADDRESS (0));
+  return Status;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+TraceCloseProtocol (
+  IN EFI_HANDLE  Handle,
+  IN EFI_GUID    *Protocol,
+  IN EFI_HANDLE  AgentHandle,
+  IN EFI_HANDLE  ControllerHandle
+  )
+{
+  UINT64      StartTicks;
+  EFI_STATUS  Status;
+
+  StartTicks = GetPerformanceCounter ();
+  Status     = mTracedServices.CloseProtocol (Handle, Protocol, AgentHandle, ControllerHandle);
+  RecordServiceCall (BOOT_SERVICE_TRACE_CLOSE_PROTOCOL, StartTicks, RETURN_ADDRESS (0));
+  return Status;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+TraceOpenProtocolInformation (
+  IN  EFI_HANDLE                           Handle,
+  IN  EFI_GUID                             *Protocol,
+  OUT EFI_OPEN_PROTOCOL_INFORMATION_ENTRY  **EntryBuffer,
+  OUT UINTN                                *EntryCount
+  )
+{
+  UINT64      StartTicks;
+  EFI_STATUS  Status;
+
+  StartTicks = GetPerformanceCounter ();
+  Status     = mTracedServices.OpenProtocolInformation (Handle, Protocol, EntryBuffer, EntryCount);
+  RecordServiceCall (BOOT_SERVICE_TRACE_OPEN_PROTOCOL_INFORMATION, StartTicks, RETURN_ADDRESS (0));
+  return Status;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+TraceProtocolsPerHandle (
+  IN  EFI_HANDLE  Handle,
+  OUT EFI_GUID    ***ProtocolBuffer,
+  OUT UINTN       *ProtocolBufferCount
+  )
+{
+  UINT64      StartTicks;
+  EFI_STATUS  Status;
+
+  StartTicks = GetPerformanceCounter ();
+  Status     = mTracedServices.ProtocolsPerHandle (Handle, ProtocolBuffer, ProtocolBufferCount);
+  RecordServiceCall (BOOT_SERVICE_TRACE_PROTOCOLS_PER_HANDLE, StartTicks, RETURN_ADDRESS (0));
+  return Status;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+TraceLocateHandleBuffer (
+  IN     EFI_LOCATE_SEARCH_TYPE  SearchType,
+  IN     EFI_GUID                *Protocol   OPTIONAL,
+  IN     VOID                    *SearchKey  OPTIONAL,
+  OUT    UINTN                   *NoHandles,
+  OUT    EFI_HANDLE              **Buffer
+  )
+{
+  UINT64      StartTicks;
+  EFI_STATUS  Status;
+
+  StartTicks = GetPerformanceCounter ();
+  Status     = mTracedServices.LocateHandleBuffer (SearchType, Protocol, SearchKey, NoHandles, Buffer);
+  RecordServiceCall (BOOT_SERVICE_TRACE_LOCATE_HANDLE_BUFFER, StartTicks, RETURN_ADDRESS (0));
+  return Status;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+TraceLocateProtocol (
+  IN  EFI_GUID  *Protocol,
+  IN  VOID      *Registration  OPTIONAL,
+  OUT VOID      **Interface
+  )
+{
+  UINT64      StartTicks;
+  EFI_STATUS  Status;
+
+  StartTicks = GetPerformanceCounter ();
+  Status     = mTracedServices.LocateProtocol (Protocol, Registration, Interface);
+  RecordServiceCall (BOOT_SERVICE_TRACE_LOCATE_PROTOCOL, StartTicks, RETURN_ADDRESS (0));
+  return Status;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+TraceCreateEventEx (
+  IN       UINT32            Type,
+  IN       EFI_TPL           NotifyTpl,
+  IN       EFI_EVENT_NOTIFY  NotifyFunction OPTIONAL,
+  IN CONST VOID              *NotifyContext OPTIONAL,
+  IN CONST EFI_GUID          *EventGroup    OPTIONAL,
+  OUT      EFI_EVENT         *Event
+  )
+{
+  UINT64      StartTicks;
+  EFI_STATUS  Status;
+
+  StartTicks = GetPerformanceCounter ();
+  Status     = mTracedServices.CreateEventEx (Type, NotifyTpl, NotifyFunction, NotifyContext, EventGroup, Event);
+  RecordServiceCall (BOOT_SERVICE_TRACE_CREATE_EVENT_EX, StartTicks, RETURN_ADDRESS (0));
+  return Status;
+}
+
+//
+// The wrappers, in BOOT_SERVICE_TRACE_* order.
+//
+STATIC CONST SERVICE_TRACE_WRAPPER  mServiceTraceWrappers[BOOT_SERVICE_TRACE_SERVICE_COUNT] = {
+  { OFFSET_OF (EFI_BOOT_SERVICES, AllocatePages),              (VOID *)TraceAllocatePages              },
+  { OFFSET_OF (EFI_BOOT_SERVICES, FreePages),                  (VOID *)TraceFreePages                  },
+  { OFFSET_OF (EFI_BOOT_SERVICES, GetMemoryMap),               (VOID *)TraceGetMemoryMap               },
+  { OFFSET_OF (EFI_BOOT_SERVICES, AllocatePool),               (VOID *)TraceAllocatePool               },
+  { OFFSET_OF (EFI_BOOT_SERVICES, FreePool),                   (VOID *)TraceFreePool                   },
+  { OFFSET_OF (EFI_BOOT_SERVICES, CreateEvent),                (VOID *)TraceCreateEvent                },
+  { OFFSET_OF (EFI_BOOT_SERVICES, SetTimer),                   (VOID *)TraceSetTimer                   },
+  { OFFSET_OF (EFI_BOOT_SERVICES, WaitForEvent),               (VOID *)TraceWaitForEvent               },
+  { OFFSET_OF (EFI_BOOT_SERVICES, SignalEvent),                (VOID *)TraceSignalEvent                },
+  { OFFSET_OF (EFI_BOOT_SERVICES, CloseEvent),                 (VOID *)TraceCloseEvent                 },
+  { OFFSET_OF (EFI_BOOT_SERVICES, CheckEvent),                 (VOID *)TraceCheckEvent                 },
+  { OFFSET_OF (EFI_BOOT_SERVICES, InstallProtocolInterface),   (VOID *)TraceInstallProtocolInterface   },
+  { OFFSET_OF (EFI_BOOT_SERVICES, ReinstallProtocolInterface), (VOID *)TraceReinstallProtocolInterface },
+  { OFFSET_OF (EFI_BOOT_SERVICES, UninstallProtocolInterface), (VOID *)TraceUninstallProtocolInterface },
+  { OFFSET_OF (EFI_BOOT_SERVICES, HandleProtocol),             (VOID *)TraceHandleProtocol             },
+  { OFFSET_OF (EFI_BOOT_SERVICES, RegisterProtocolNotify),     (VOID *)TraceRegisterProtocolNotify     },
+  { OFFSET_OF (EFI_BOOT_SERVICES, LocateHandle),               (VOID *)TraceLocateHandle               },
+  { OFFSET_OF (EFI_BOOT_SERVICES, LocateDevicePath),           (VOID *)TraceLocateDevicePath           },
+  { OFFSET_OF (EFI_BOOT_SERVICES, Stall),                      (VOID *)TraceStall                      },
+  { OFFSET_OF (EFI_BOOT_SERVICES, ConnectController),          (VOID *)TraceConnectController          },
+  { OFFSET_OF (EFI_BOOT_SERVICES, DisconnectController),       (VOID *)TraceDisconnectController       },
+  { OFFSET_OF (EFI_BOOT_SERVICES, OpenProtocol),               (VOID *)TraceOpenProtocol               },
+  { OFFSET_OF (EFI_BOOT_SERVICES, CloseProtocol),              (VOID *)TraceCloseProtocol              },
+  { OFFSET_OF (EFI_BOOT_SERVICES, OpenProtocolInformation),    (VOID *)TraceOpenProtocolInformation    },
+  { OFFSET_OF (EFI_BOOT_SERVICES, ProtocolsPerHandle),         (VOID *)TraceProtocolsPerHandle         },
+  { OFFSET_OF (EFI_BOOT_SERVICES, LocateHandleBuffer),         (VOID *)TraceLocateHandleBuffer         },
+  { OFFSET_OF (EFI_BOOT_SERVICES, LocateProtocol),             (VOID *)TraceLocateProtocol             },
+  { OFFSET_OF (EFI_BOOT_SERVICES, CreateEventEx),              (VOID *)TraceCreateEventEx              }
+};
+
+/**
+  Add an image to the trace table so that its calls are attributed to it.
+
+  @param  ImageHandle   The handle of the image.
+  @param  ImageBase     The address the image is loaded at.
+  @param  ImageSize     The size of the image.
+  @param  FileName      The name of the FFS file of the image, or NULL.
+
+**/
+STATIC
+VOID
+AddServiceTraceImage (
+  IN EFI_HANDLE      ImageHandle,
+  IN VOID            *ImageBase,
+  IN UINT64          ImageSize,
+  IN CONST EFI_GUID  *FileName  OPTIONAL
+  )
+{
+  BOOT_SERVICE_TRACE_IMAGE  *TraceImage;
+  BOOLEAN                   InterruptState;
+  UINTN                     Index;
+  UINT16                    ImageIndex;
+
+  if (mServiceTrace->ImageCount == mServiceTrace->MaxImageCount) {
+    mServiceTrace->DroppedImageCount++;
+    return;
+  }
+
+  ImageIndex            = (UINT16)mServiceTrace->ImageCount;
+  TraceImage            = &mServiceTraceImages[ImageIndex];
+  TraceImage->Handle    = (EFI_PHYSICAL_ADDRESS)(UINTN)ImageHandle;
+  TraceImage->ImageBase = (EFI_PHYSICAL_ADDRESS)(UINTN)ImageBase;
+  TraceImage->ImageSize = ImageSize;
+  if (FileName != NULL) {
+    CopyGuid (&TraceImage->FileName, FileName);
+  }
+
+  InterruptState = SaveAndDisableInterrupts ();
+
+  for (Index = mServiceTraceRangeCount; Index > 0; Index--) {
+    if (mServiceTraceRanges[Index - 1].Base < (UINTN)ImageBase) {
+      break;
+    }
+
+    mServiceTraceRanges[Index] = mServiceTraceRanges[Index - 1];
+  }
+
+  mServiceTraceRanges[Index].Base       = (UINTN)ImageBase;
+  mServiceTraceRanges[Index].End        = (UINTN)ImageBase + (UINTN)ImageSize;
+  mServiceTraceRanges[Index].ImageIndex = ImageIndex;
+  mServiceTraceRangeCount++;
+  mServiceTrace->ImageCount++;
+
+  SetInterruptState (InterruptState);
+}
+
+/**
+  Start tracing the boot services selected by PcdDxeServiceTraceMask, and
+  install the trace table into the EFI System Table.
+
+**/
+VOID
+CoreInitializeServiceTrace (
+  VOID
+  )
+{
+  UINT32      ServiceMask;
+  UINT32      RingSize;
+  UINT64      Frequency;
+  UINT64      CounterStart;
+  UINT64      CounterEnd;
+  UINTN       Index;
+  EFI_STATUS  Status;
+
+  ServiceMask = PcdGet32 (PcdDxeServiceTraceMask) & ((1U << BOOT_SERVICE_TRACE_SERVICE_COUNT) - 1);
+  if (ServiceMask == 0) {
+    return;
+  }
+
+  RingSize            = PcdGet32 (PcdDxeServiceTraceRingSize);
+  mServiceTrace       = AllocateZeroPool (sizeof (EDKII_BOOT_SERVICE_TRACE_TABLE));
+  mServiceTraceImages = AllocateZeroPool (SERVICE_TRACE_MAX_IMAGE_COUNT * sizeof (BOOT_SERVICE_TRACE_IMAGE));
+  mServiceTraceStats  = AllocateZeroPool (SERVICE_TRACE_MAX_IMAGE_COUNT * BOOT_SERVICE_TRACE_SERVICE_COUNT * sizeof (BOOT_SERVICE_TRACE_STATS));
+  mServiceTraceRing   = NULL;
+  if (RingSize != 0) {
+    mServiceTraceRing = AllocateZeroPool (RingSize * sizeof (BOOT_SERVICE_TRACE_RECORD));
+  }
+
+  if ((mServiceTrace == NULL) || (mServiceTraceImages == NULL) || (mServiceTraceStats == NULL) ||
+      ((RingSize != 0) && (mServiceTraceRing == NULL)))
+  {
+    DEBUG ((DEBUG_ERROR, "Boot service trace: out of resources\n"));
+    if (mServiceTrace != NULL) {
+      FreePool (mServiceTrace);
+      mServiceTrace = NULL;
+    }
+
+    if (mServiceTraceImages != NULL) {
+      FreePool (mServiceTraceImages);
+    }
+
+    if (mServiceTraceStats != NULL) {
+      FreePool (mServiceTraceStats);
+    }
+
+    if (mServiceTraceRing != NULL) {
+      FreePool (mServiceTraceRing);
+    }
+
+    return;
+  }
+
+  Frequency = GetPerformanceCounterProperties (&CounterStart, &CounterEnd);
+
+  mServiceTrace->Revision      = EDKII_BOOT_SERVICE_TRACE_TABLE_REVISION;
+  mServiceTrace->ServiceMask   = ServiceMask;
+  mServiceTrace->ServiceCount  = BOOT_SERVICE_TRACE_SERVICE_COUNT;
+  mServiceTrace->BucketCount   = BOOT_SERVICE_TRACE_BUCKET_COUNT;
+  mServiceTrace->MaxImageCount = SERVICE_TRACE_MAX_IMAGE_COUNT;
+  mServiceTrace->RingSize      = RingSize;
+  mServiceTrace->Frequency     = Frequency;
+  mServiceTrace->CounterStart  = CounterStart;
+  mServiceTrace->CounterEnd    = CounterEnd;
+  mServiceTrace->Images        = (EFI_PHYSICAL_ADDRESS)(UINTN)mServiceTraceImages;
+  mServiceTrace->Stats         = (EFI_PHYSICAL_ADDRESS)(UINTN)mServiceTraceStats;
+  mServiceTrace->Ring          = (EFI_PHYSICAL_ADDRESS)(UINTN)mServiceTraceRing;
+
+  //
+  // Bucket N + 1 starts at 2^(N + BOOT_SERVICE_TRACE_BUCKET_SHIFT) nanoseconds.
+  //
+  for (Index = 0; Index < ARRAY_SIZE (mServiceTraceBucketLimit); Index++) {
+    mServiceTraceBucketLimit[Index] = DivU64x32 (
+                                        LShiftU64 (Frequency, Index + BOOT_SERVICE_TRACE_BUCKET_SHIFT),
+                                        1000000000
+                                        );
+  }
+
+  //
+  // Image 0 stands for the unknown callers, image 1 is the DXE Core.
+  //
+  mServiceTrace->ImageCount = 1;
+  AddServiceTraceImage (
+    gDxeCoreImageHandle,
+    gDxeCoreLoadedImage->ImageBase,
+    gDxeCoreLoadedImage->ImageSize,
+    &gEfiCallerIdGuid
+    );
+
+  //
+  // Hook the selected services.
+  //
+  CopyMem (&mTracedServices, gBS, sizeof (EFI_BOOT_SERVICES));
+  for (Index = 0; Index < BOOT_SERVICE_TRACE_SERVICE_COUNT; Index++) {
+    if ((ServiceMask & (1U << Index)) != 0) {
+      *(VOID **)((UINT8 *)gBS + mServiceTraceWrappers[Index].Offset) = mServiceTraceWrappers[Index].Wrapper;
+    }
+  }
+
+  CalculateEfiHdrCrc (&gBS->Hdr);
+
+  Status = CoreInstallConfigurationTable (&gEdkiiBootServiceTraceTableGuid, mServiceTrace);
+  ASSERT_EFI_ERROR (Status);
+
+  DEBUG ((DEBUG_INFO, "Boot service trace: mask 0x%x, ring of %d calls\n", ServiceMask, RingSize));
+}
+
+/**
+  Attribute the boot service calls made from a loaded image to it.
+
+  @param  Image         The image that is about to be started.
+
+**/
+VOID
+CoreRegisterServiceTraceImage (
+  IN LOADED_IMAGE_PRIVATE_DATA  *Image
+  )
+{
+  EFI_GUID  *FileName;
+
+  if (mServiceTrace == NULL) {
+    return;
+  }
+
+  FileName = NULL;
+  if (Image->Info.FilePath != NULL) {
+    FileName = EfiGetNameGuidFromFwVolDevicePathNode ((MEDIA_FW_VOL_FILEPATH_DEVICE_PATH *)Image->Info.FilePath);
+  }
+
+  AddServiceTraceImage (Image->Handle, Image->Info.ImageBase, Image->Info.ImageSize, FileName);
+}
+
+/**
+  Stop attributing calls to an image that is unloaded. The statistics of the
+  image are kept.
+
+  @param  Image         The image that is unloaded.
+
+**/
+VOID
+CoreUnregisterServiceTraceImage (
+  IN LOADED_IMAGE_PRIVATE_DATA  *Image
+  )
+{
+  BOOLEAN  InterruptState;
+  UINTN    Index;
+
+  if (mServiceTrace == NULL) {
+    return;
+  }
+
+  InterruptState = SaveAndDisableInterrupts ();
+
+  for (Index = 0; Index < mServiceTraceRangeCount; Index++) {
+    if (mServiceTraceRanges[Index].Base == (UINTN)Image->Info.ImageBase) {
+      mServiceTraceRangeCount--;
+      CopyMem (
+        &mServiceTraceRanges[Index],
+        &mServiceTraceRanges[Index + 1],
+        (mServiceTraceRangeCount - Index) * sizeof (SERVICE_TRACE_RANGE)
+        );
+      break;
+    }
+  }
+
+  SetInterruptState (InterruptState);
+}
@@ -27,6 +27,19 @@
   3) A support protocol is not found, and the data is not available to be read
      without it.  This results in EFI_PROTOCOL_ERROR.
 
+  Streams opened for the sections of an FFS file with OpenFileSectionStream()
+  keep the decompressed contents of their compression and GUIDed sections in a
+  section cache, keyed by the file name and the address and size of the
+  encapsulation section. The file buffers of the firmware volumes and the
+  cached contents themselves stay in place until the entries of the sections
+  in them are invalidated, so the key identifies the section without reading
+  it. The cache keeps the contents after the streams are closed, up to
+  PcdDxeSectionCacheSize
+  bytes, and is also filled ahead of time by CorePrefetchDriverSections(),
+  which decompresses the sections of scheduled drivers on the application
+  processors. GUIDed sections whose authentication status is produced by the
+  extraction are never cached.
+
 Copyright (c) 2006 - 2018, Intel Corporation. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -67,21 +80,63 @@ typedef struct {
   EFI_EVENT     Event;
 } CORE_SECTION_CHILD_NODE;
 
+#define CORE_SECTION_CACHE_SIGNATURE  SIGNATURE_32('S','X','C','E')
+#define SECTION_CACHE_ENTRY_FROM_LINK(Node) \
+  CR (Node, CORE_SECTION_CACHE_ENTRY, Link, CORE_SECTION_CACHE_SIGNATURE)
+#define SECTION_CACHE_ENTRY_FROM_HASH_LINK(Node) \
+  CR (Node, CORE_SECTION_CACHE_ENTRY, HashLink, CORE_SECTION_CACHE_SIGNATURE)
+
+//
+// Number of buckets of the section cache hash table, a power of two.
+//
+#define SECTION_CACHE_HASH_SIZE  64
+
+typedef struct {
+  UINT32        Signature;
+  //
+  // mSectionCache, least recently used first.
+  //
+  LIST_ENTRY    Link;
+  //
+  // mSectionCacheHash bucket of Section and SectionSize. Section is NULL and
+  // HashLink is not in any bucket once the entry has been invalidated.
+  //
+  LIST_ENTRY    HashLink;
+  EFI_GUID      FileName;
+  CONST VOID    *Section;
+  UINT32        SectionSize;
+  VOID          *Buffer;
+  UINTN         BufferSize;
+  //
+  // Number of open streams that use Buffer as their stream buffer.
+  //
+  UINTN         RefCount;
+} CORE_SECTION_CACHE_ENTRY;
+
 #define CORE_SECTION_STREAM_SIGNATURE  SIGNATURE_32('S','X','S','S')
 #define STREAM_NODE_FROM_LINK(Node) \
   CR (Node, CORE_SECTION_STREAM_NODE, Link, CORE_SECTION_STREAM_SIGNATURE)
 
 typedef struct {
-  UINT32        Signature;
-  LIST_ENTRY    Link;
-  UINTN         StreamHandle;
-  UINT8         *StreamBuffer;
-  UINTN         StreamLength;
-  LIST_ENTRY    Children;
+  UINT32                      Signature;
+  LIST_ENTRY                  Link;
+  UINTN                       StreamHandle;
+  UINT8                       *StreamBuffer;
+  UINTN                       StreamLength;
+  LIST_ENTRY                  Children;
   //
   // Authentication status is from GUIDed encapsulations.
   //
-  UINT32        AuthenticationStatus;
+  UINT32                      AuthenticationStatus;
+  //
+  // The FFS file the stream belongs to, if it is known and StreamBuffer stays
+  // in place until the section cache entries in it are invalidated. CacheEntry
+  // is not NULL if StreamBuffer is owned by the section cache rather than by
+  // the stream.
+  //
+  BOOLEAN                     HasFileName;
+  EFI_GUID                    FileName;
+  CORE_SECTION_CACHE_ENTRY    *CacheEntry;
 } CORE_SECTION_STREAM_NODE;
 
 #define NULL_STREAM_HANDLE  0
@@ -92,6 +147,42 @@ typedef struct {
   VOID                        *Registration;
 } RPN_EVENT_CONTEXT;
 
+typedef struct {
+  EFI_GUID      FileName;
+  VOID          *Section;
+  UINT32        SectionSize;
+  BOOLEAN       Guided;
+  CONST VOID    *Source;
+  VOID          *Output;
+  UINT32        OutputSize;
+  VOID          *Scratch;
+  EFI_STATUS    Status;
+} SECTION_PREFETCH_ITEM;
+
+typedef struct {
+  SECTION_PREFETCH_ITEM    *Items;
+  UINT32                   Count;
+  volatile UINT32          NextIndex;
+} SECTION_PREFETCH_QUEUE;
+
+/**
+  Worker function.  Search stream database for requested stream handle.
+
+  @param  SearchHandle           Indicates which stream to look for.
+  @param  FoundStream            Output pointer to the found stream.
+
+  @retval EFI_SUCCESS            StreamHandle was found and *FoundStream contains
+                                 the stream node.
+  @retval EFI_NOT_FOUND          SearchHandle was not found in the stream
+                                 database.
+
+**/
+EFI_STATUS
+FindStreamNode (
+  IN  UINTN                     SearchHandle,
+  OUT CORE_SECTION_STREAM_NODE  **FoundStream
+  );
+
 /**
   The ExtractSection() function processes the input section and
   allocates a buffer from the pool in which it returns the section
@@ -190,6 +281,16 @@ CustomGuidedSectionExtract (
 //
 LIST_ENTRY  mStreamRoot = INITIALIZE_LIST_HEAD_VARIABLE (mStreamRoot);
 
+LIST_ENTRY  mSectionCache = INITIALIZE_LIST_HEAD_VARIABLE (mSectionCache);
+
+LIST_ENTRY  mSectionCacheHash[SECTION_CACHE_HASH_SIZE];
+BOOLEAN     mSectionCacheHashInitialized = FALSE;
+
+//
+// Total size of the cached sections that are not used by any open stream.
+//
+UINTN  mSectionCacheSize = 0;
+
 EFI_HANDLE  mSectionExtractionHandle = NULL;
 
 EFI_GUIDED_SECTION_EXTRACTION_PROTOCOL  mCustomGuidedSectionExtractionProtocol = {
@@ -385,6 +486,8 @@ OpenSectionStreamEx (
   NewStream->StreamLength = SectionStreamLength;
   InitializeListHead (&NewStream->Children);
   NewStream->AuthenticationStatus = AuthenticationStatus;
+  NewStream->HasFileName          = FALSE;
+  NewStream->CacheEntry           = NULL;
 
   //
   // Add new stream to stream list
@@ -437,6 +540,404 @@ OpenSectionStream (
            );
 }
 
+/**
+  Create a section stream for the sections of an FFS file. Encapsulation
+  sections found in the stream are looked up in, and added to, the
+  decompressed section cache under the name of the file.
+
+  @param  FileName               The name of the FFS file.
+  @param  SectionStreamLength    Size in bytes of the section stream.
+  @param  SectionStream          Buffer containing the new section stream.
+  @param  SectionStreamHandle    A pointer to a caller allocated UINTN that on
+                                 output contains the new section stream handle.
+
+  @retval EFI_SUCCESS            The section stream is created successfully.
+  @retval EFI_OUT_OF_RESOURCES   memory allocation failed.
+  @retval EFI_INVALID_PARAMETER  Section stream does not end concident with end
+                                 of last section.
+
+**/
+EFI_STATUS
+OpenFileSectionStream (
+  IN     CONST EFI_GUID  *FileName,
+  IN     UINTN           SectionStreamLength,
+  IN     VOID            *SectionStream,
+  OUT UINTN              *SectionStreamHandle
+  )
+{
+  EFI_STATUS                Status;
+  CORE_SECTION_STREAM_NODE  *StreamNode;
+  EFI_TPL                   OldTpl;
+
+  Status = OpenSectionStream (SectionStreamLength, SectionStream, SectionStreamHandle);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  OldTpl = CoreRaiseTpl (TPL_NOTIFY);
+  Status = FindStreamNode (*SectionStreamHandle, &StreamNode);
+  ASSERT_EFI_ERROR (Status);
+  if (!EFI_ERROR (Status)) {
+    StreamNode->HasFileName = TRUE;
+    CopyGuid (&StreamNode->FileName, FileName);
+  }
+
+  CoreRestoreTpl (OldTpl);
+  return EFI_SUCCESS;
+}
+
+/**
+  Worker function.  Get the section cache hash bucket of an encapsulation
+  section.
+
+  @param  Section                The encapsulation section.
+  @param  SectionSize            The size of the encapsulation section.
+
+  @return The list of the entries of the bucket.
+
+**/
+LIST_ENTRY *
+SectionCacheBucket (
+  IN CONST VOID  *Section,
+  IN UINT32      SectionSize
+  )
+{
+  UINTN  Index;
+
+  if (!mSectionCacheHashInitialized) {
+    for (Index = 0; Index < SECTION_CACHE_HASH_SIZE; Index++) {
+      InitializeListHead (&mSectionCacheHash[Index]);
+    }
+
+    mSectionCacheHashInitialized = TRUE;
+  }
+
+  Index = (((UINTN)Section >> 3) ^ ((UINTN)Section >> 11) ^ SectionSize) & (SECTION_CACHE_HASH_SIZE - 1);
+  return &mSectionCacheHash[Index];
+}
+
+/**
+  Worker function.  Free a section cache entry and its buffer.
+
+  @param  Entry                  The entry to free. It must not be in use.
+
+**/
+VOID
+FreeSectionCacheEntry (
+  IN CORE_SECTION_CACHE_ENTRY  *Entry
+  )
+{
+  ASSERT (Entry->RefCount == 0);
+
+  RemoveEntryList (&Entry->Link);
+  RemoveEntryList (&Entry->HashLink);
+  mSectionCacheSize -= Entry->BufferSize;
+
+  //
+  // The entries of the sections encapsulated in Buffer are keyed by addresses
+  // that are about to be reused
+  //
+  InvalidateSectionCache (Entry->Buffer, Entry->BufferSize);
+
+  CoreFreePool (Entry->Buffer);
+  CoreFreePool (Entry);
+}
+
+/**
+  Invalidate the section cache entries of the encapsulation sections in a
+  buffer that is about to be freed. Entries that are not in use are freed,
+  the others are freed when the last stream using them is closed.
+
+  @param  Buffer                 The buffer.
+  @param  Size                   The size of Buffer.
+
+**/
+VOID
+InvalidateSectionCache (
+  IN CONST VOID  *Buffer,
+  IN UINTN       Size
+  )
+{
+  LIST_ENTRY                *Link;
+  CORE_SECTION_CACHE_ENTRY  *Entry;
+
+  Link = GetFirstNode (&mSectionCache);
+  while (!IsNull (&mSectionCache, Link)) {
+    Entry = SECTION_CACHE_ENTRY_FROM_LINK (Link);
+    Link  = GetNextNode (&mSectionCache, Link);
+    if ((Entry->Section == NULL) ||
+        ((UINTN)Entry->Section < (UINTN)Buffer) ||
+        ((UINTN)Entry->Section - (UINTN)Buffer >= Size))
+    {
+      continue;
+    }
+
+    RemoveEntryList (&Entry->HashLink);
+    InitializeListHead (&Entry->HashLink);
+    Entry->Section = NULL;
+    if (Entry->RefCount == 0) {
+      //
+      // Freeing the entry may free entries after Link, so start over
+      //
+      FreeSectionCacheEntry (Entry);
+      Link = GetFirstNode (&mSectionCache);
+    }
+  }
+}
+
+/**
+  Worker function.  Evict the least recently used section cache entries that
+  are not in use until the cache fits in PcdDxeSectionCacheSize.
+
+**/
+VOID
+TrimSectionCache (
+  VOID
+  )
+{
+  LIST_ENTRY                *Link;
+  CORE_SECTION_CACHE_ENTRY  *Entry;
+
+  Link = GetFirstNode (&mSectionCache);
+  while ((mSectionCacheSize > PcdGet32 (PcdDxeSectionCacheSize)) && !IsNull (&mSectionCache, Link)) {
+    Entry = SECTION_CACHE_ENTRY_FROM_LINK (Link);
+    if (Entry->RefCount == 0) {
+      FreeSectionCacheEntry (Entry);
+      Link = GetFirstNode (&mSectionCache);
+    } else {
+      Link = GetNextNode (&mSectionCache, Link);
+    }
+  }
+}
+
+/**
+  Worker function.  Look up the decompressed contents of an encapsulation
+  section in the section cache.
+
+  @param  FileName               The name of the FFS file the section is in.
+  @param  Section                The encapsulation section.
+  @param  SectionSize            The size of the encapsulation section.
+
+  @return The cache entry, or NULL if the section is not cached.
+
+**/
+CORE_SECTION_CACHE_ENTRY *
+FindSectionCacheEntry (
+  IN CONST EFI_GUID  *FileName,
+  IN CONST VOID      *Section,
+  IN UINT32          SectionSize
+  )
+{
+  LIST_ENTRY                *Bucket;
+  LIST_ENTRY                *Link;
+  CORE_SECTION_CACHE_ENTRY  *Entry;
+
+  Bucket = SectionCacheBucket (Section, SectionSize);
+  for (Link = GetFirstNode (Bucket); !IsNull (Bucket, Link); Link = GetNextNode (Bucket, Link)) {
+    Entry = SECTION_CACHE_ENTRY_FROM_HASH_LINK (Link);
+    if ((Entry->Section == Section) &&
+        (Entry->SectionSize == SectionSize) &&
+        CompareGuid (&Entry->FileName, FileName))
+    {
+      RemoveEntryList (&Entry->Link);
+      InsertTailList (&mSectionCache, &Entry->Link);
+      return Entry;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Worker function.  Add the decompressed contents of an encapsulation section
+  to the section cache. The cache owns Buffer if an entry is returned.
+
+  @param  FileName               The name of the FFS file the section is in.
+  @param  Section                The encapsulation section.
+  @param  SectionSize            The size of the encapsulation section.
+  @param  Buffer                 The decompressed contents, allocated from pool.
+  @param  BufferSize             The size of Buffer.
+  @param  InUse                  TRUE if a stream is opened on Buffer.
+
+  @return The cache entry, or NULL if the contents could not be cached and
+          Buffer is still owned by the caller.
+
+**/
+CORE_SECTION_CACHE_ENTRY *
+AddSectionCacheEntry (
+  IN CONST EFI_GUID  *FileName,
+  IN CONST VOID      *Section,
+  IN UINT32          SectionSize,
+  IN VOID            *Buffer,
+  IN UINTN           BufferSize,
+  IN BOOLEAN         InUse
+  )
+{
+  CORE_SECTION_CACHE_ENTRY  *Entry;
+
+  if ((BufferSize == 0) || (BufferSize > PcdGet32 (PcdDxeSectionCacheSize))) {
+    return NULL;
+  }
+
+  Entry = AllocatePool (sizeof (CORE_SECTION_CACHE_ENTRY));
+  if (Entry == NULL) {
+    return NULL;
+  }
+
+  Entry->Signature   = CORE_SECTION_CACHE_SIGNATURE;
+  Entry->Section     = Section;
+  Entry->SectionSize = SectionSize;
+  Entry->Buffer      = Buffer;
+  Entry->BufferSize  = BufferSize;
+  Entry->RefCount    = InUse ? 1 : 0;
+  CopyGuid (&Entry->FileName, FileName);
+  InsertTailList (&mSectionCache, &Entry->Link);
+  InsertTailList (SectionCacheBucket (Section, SectionSize), &Entry->HashLink);
+
+  if (!InUse) {
+    mSectionCacheSize += BufferSize;
+    TrimSectionCache ();
+  }
+
+  return Entry;
+}
+
+/**
+  Worker function.  Drop the reference an open stream holds on a section
+  cache entry.
+
+  @param  Entry                  The entry the stream buffer belongs to.
+
+**/
+VOID
+ReleaseSectionCacheEntry (
+  IN CORE_SECTION_CACHE_ENTRY  *Entry
+  )
+{
+  ASSERT (Entry->RefCount > 0);
+
+  Entry->RefCount--;
+  if (Entry->RefCount == 0) {
+    mSectionCacheSize += Entry->BufferSize;
+    if (Entry->Section == NULL) {
+      FreeSectionCacheEntry (Entry);
+    } else {
+      TrimSectionCache ();
+    }
+  }
+}
+
+/**
+  Worker function.  Open the stream of an encapsulation section from the
+  section cache.
+
+  @param  Stream                 The stream that contains the encapsulation
+                                 section.
+  @param  ChildOffset            The offset of the section in Stream.
+  @param  ChildSize              The size of the section.
+  @param  AuthenticationStatus   The authentication status of the new stream.
+  @param  ChildStreamHandle      The handle of the new stream.
+
+  @retval EFI_SUCCESS            The stream was opened on the cached contents.
+  @retval EFI_NOT_FOUND          The section is not cached.
+  @return Others                 Values returned by OpenSectionStreamEx.
+
+**/
+EFI_STATUS
+OpenCachedSectionStream (
+  IN     CORE_SECTION_STREAM_NODE  *Stream,
+  IN     UINT32                    ChildOffset,
+  IN     UINT32                    ChildSize,
+  IN     UINT32                    AuthenticationStatus,
+  OUT    UINTN                     *ChildStreamHandle
+  )
+{
+  EFI_STATUS                Status;
+  CORE_SECTION_CACHE_ENTRY  *Entry;
+  CORE_SECTION_STREAM_NODE  *ChildStream;
+
+  if (!Stream->HasFileName || (PcdGet32 (PcdDxeSectionCacheSize) == 0)) {
+    return EFI_NOT_FOUND;
+  }
+
+  Entry = FindSectionCacheEntry (&Stream->FileName, Stream->StreamBuffer + ChildOffset, ChildSize);
+  if (Entry == NULL) {
+    return EFI_NOT_FOUND;
+  }
+
+  Status = OpenSectionStreamEx (
+             Entry->BufferSize,
+             Entry->Buffer,
+             FALSE,
+             AuthenticationStatus,
+             ChildStreamHandle
+             );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = FindStreamNode (*ChildStreamHandle, &ChildStream);
+  ASSERT_EFI_ERROR (Status);
+
+  ChildStream->HasFileName = TRUE;
+  ChildStream->CacheEntry  = Entry;
+  CopyGuid (&ChildStream->FileName, &Stream->FileName);
+
+  if (Entry->RefCount++ == 0) {
+    mSectionCacheSize -= Entry->BufferSize;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Worker function.  Optionally hand the buffer of the stream of one of the
+  encapsulation sections of a stream over to the section cache. The file
+  identity of the stream is passed on to the new stream if its buffer is
+  then owned by the cache, so that the sections in it can be cached too.
+
+  @param  Stream                 The stream that contains the encapsulation
+                                 section.
+  @param  ChildOffset            The offset of the section in Stream.
+  @param  ChildSize              The size of the section.
+  @param  ChildStreamHandle      The handle of the stream of the section.
+  @param  Cache                  TRUE to add the contents of the section to
+                                 the section cache.
+
+**/
+VOID
+InitializeChildStream (
+  IN CORE_SECTION_STREAM_NODE  *Stream,
+  IN UINT32                    ChildOffset,
+  IN UINT32                    ChildSize,
+  IN UINTN                     ChildStreamHandle,
+  IN BOOLEAN                   Cache
+  )
+{
+  EFI_STATUS                Status;
+  CORE_SECTION_STREAM_NODE  *ChildStream;
+
+  if (!Stream->HasFileName || !Cache) {
+    return;
+  }
+
+  Status = FindStreamNode (ChildStreamHandle, &ChildStream);
+  ASSERT_EFI_ERROR (Status);
+
+  ChildStream->CacheEntry = AddSectionCacheEntry (
+                              &Stream->FileName,
+                              Stream->StreamBuffer + ChildOffset,
+                              ChildSize,
+                              ChildStream->StreamBuffer,
+                              ChildStream->StreamLength,
+                              TRUE
+                              );
+  if (ChildStream->CacheEntry != NULL) {
+    ChildStream->HasFileName = TRUE;
+    CopyGuid (&ChildStream->FileName, &Stream->FileName);
+  }
+}
+
 /**
   Worker function.  Determine if the input stream:child matches the input type.
 
@@ -740,6 +1241,27 @@ CreateChildNode (
         CompressionType       = CompressionHeader->CompressionType;
       }
 
+      //
+      // Reuse the decompressed stream if it is still in the section cache
+      //
+      if (CompressionType == EFI_STANDARD_COMPRESSION) {
+        Status = OpenCachedSectionStream (
+                   Stream,
+                   ChildOffset,
+                   Node->Size,
+                   Stream->AuthenticationStatus,
+                   &Node->EncapsulatedStreamHandle
+                   );
+        if (!EFI_ERROR (Status)) {
+          break;
+        }
+
+        if (Status != EFI_NOT_FOUND) {
+          CoreFreePool (Node);
+          return Status;
+        }
+      }
+
       //
       // Allocate space for the new stream
       //
@@ -826,6 +1348,13 @@ CreateChildNode (
         return Status;
       }
 
+      InitializeChildStream (
+        Stream,
+        ChildOffset,
+        Node->Size,
+        Node->EncapsulatedStreamHandle,
+        (BOOLEAN)(CompressionType == EFI_STANDARD_COMPRESSION)
+        );
       break;
 
     case EFI_SECTION_GUID_DEFINED:
@@ -838,6 +1367,28 @@ CreateChildNode (
         GuidedSectionAttributes = GuidedHeader->Attributes;
       }
 
+      //
+      // The contents of sections that carry no authentication data do not
+      // depend on the extraction protocol, so they can come from the cache.
+      //
+      if ((GuidedSectionAttributes & EFI_GUIDED_SECTION_AUTH_STATUS_VALID) == 0) {
+        Status = OpenCachedSectionStream (
+                   Stream,
+                   ChildOffset,
+                   Node->Size,
+                   Stream->AuthenticationStatus,
+                   &Node->EncapsulatedStreamHandle
+                   );
+        if (!EFI_ERROR (Status)) {
+          break;
+        }
+
+        if (Status != EFI_NOT_FOUND) {
+          CoreFreePool (Node);
+          return Status;
+        }
+      }
+
       if (VerifyGuidedSectionGuid (Node->EncapsulationGuid, &GuidedExtraction)) {
         //
         // NewStreamBuffer is always allocated by ExtractSection... No caller
@@ -884,6 +1435,14 @@ CreateChildNode (
           CoreFreePool (NewStreamBuffer);
           return Status;
         }
+
+        InitializeChildStream (
+          Stream,
+          ChildOffset,
+          Node->Size,
+          Node->EncapsulatedStreamHandle,
+          (BOOLEAN)((GuidedSectionAttributes & EFI_GUIDED_SECTION_AUTH_STATUS_VALID) == 0)
+          );
       } else {
         //
         // There's no GUIDed section extraction protocol available.
@@ -926,6 +1485,8 @@ CreateChildNode (
             CoreFreePool (Node);
             return Status;
           }
+
+          InitializeChildStream (Stream, ChildOffset, Node->Size, Node->EncapsulatedStreamHandle, FALSE);
         }
       }
 
@@ -1442,7 +2003,9 @@ CloseSectionStream (
       FreeChildNode (ChildNode);
     }
 
-    if (FreeStreamBuffer) {
+    if (StreamNode->CacheEntry != NULL) {
+      ReleaseSectionCacheEntry (StreamNode->CacheEntry);
+    } else if (FreeStreamBuffer) {
       CoreFreePool (StreamNode->StreamBuffer);
     }
 
@@ -1651,3 +2214,332 @@ CustomGuidedSectionExtract (
 
   return EFI_SUCCESS;
 }
+
+/**
+  Worker function.  Check whether an encapsulation section at the top of an
+  FFS file can be decompressed on an application processor, and return the
+  sizes of the buffers it needs.
+
+  @param  Section                The encapsulation section.
+  @param  Guided                 TRUE if the section is a GUIDed section.
+  @param  Source                 The data to pass to the decompressor.
+  @param  OutputSize             The size of the decompressed contents.
+  @param  ScratchSize            The size of the scratch buffer.
+
+  @retval TRUE                   The section can be decompressed ahead of time.
+  @retval FALSE                  The section is left to CreateChildNode().
+
+**/
+BOOLEAN
+GetPrefetchSectionInfo (
+  IN  EFI_COMMON_SECTION_HEADER  *Section,
+  OUT BOOLEAN                    *Guided,
+  OUT CONST VOID                 **Source,
+  OUT UINT32                     *OutputSize,
+  OUT UINT32                     *ScratchSize
+  )
+{
+  EFI_STATUS                              Status;
+  UINT32                                  SectionSize;
+  UINT32                                  HeaderSize;
+  UINT32                                  UncompressedLength;
+  UINT8                                   CompressionType;
+  EFI_GUID                                *SectionDefinitionGuid;
+  UINT16                                  Attributes;
+  EFI_GUIDED_SECTION_EXTRACTION_PROTOCOL  *GuidedExtraction;
+
+  if (IS_SECTION2 (Section)) {
+    SectionSize = SECTION2_SIZE (Section);
+  } else {
+    SectionSize = SECTION_SIZE (Section);
+  }
+
+  switch (Section->Type) {
+    case EFI_SECTION_COMPRESSION:
+      if (IS_SECTION2 (Section)) {
+        HeaderSize         = sizeof (EFI_COMPRESSION_SECTION2);
+        UncompressedLength = ((EFI_COMPRESSION_SECTION2 *)Section)->UncompressedLength;
+        CompressionType    = ((EFI_COMPRESSION_SECTION2 *)Section)->CompressionType;
+      } else {
+        HeaderSize         = sizeof (EFI_COMPRESSION_SECTION);
+        UncompressedLength = ((EFI_COMPRESSION_SECTION *)Section)->UncompressedLength;
+        CompressionType    = ((EFI_COMPRESSION_SECTION *)Section)->CompressionType;
+      }
+
+      if ((SectionSize <= HeaderSize) || (CompressionType != EFI_STANDARD_COMPRESSION) || (UncompressedLength == 0)) {
+        return FALSE;
+      }
+
+      *Guided = FALSE;
+      *Source = (UINT8 *)Section + HeaderSize;
+      Status  = UefiDecompressGetInfo (*Source, SectionSize - HeaderSize, OutputSize, ScratchSize);
+      return (BOOLEAN)(!EFI_ERROR (Status) && (*OutputSize == UncompressedLength));
+
+    case EFI_SECTION_GUID_DEFINED:
+      if (IS_SECTION2 (Section)) {
+        SectionDefinitionGuid = &((EFI_GUID_DEFINED_SECTION2 *)Section)->SectionDefinitionGuid;
+        Attributes            = ((EFI_GUID_DEFINED_SECTION2 *)Section)->Attributes;
+      } else {
+        SectionDefinitionGuid = &((EFI_GUID_DEFINED_SECTION *)Section)->SectionDefinitionGuid;
+        Attributes            = ((EFI_GUID_DEFINED_SECTION *)Section)->Attributes;
+      }
+
+      //
+      // Only sections that CreateChildNode() would hand to the extraction
+      // handlers of the DXE core itself produce the same contents here.
+      //
+      if (((Attributes & EFI_GUIDED_SECTION_AUTH_STATUS_VALID) != 0) ||
+          !VerifyGuidedSectionGuid (SectionDefinitionGuid, &GuidedExtraction) ||
+          (GuidedExtraction != &mCustomGuidedSectionExtractionProtocol))
+      {
+        return FALSE;
+      }
+
+      *Guided = TRUE;
+      *Source = Section;
+      Status  = ExtractGuidedSectionGetInfo (Section, OutputSize, ScratchSize, &Attributes);
+      return (BOOLEAN)(!EFI_ERROR (Status) && (*OutputSize != 0));
+
+    default:
+      return FALSE;
+  }
+}
+
+/**
+  Decompress sections from the queue until it is empty.
+
+  This runs on the application processors and on the BSP, so it must only
+  touch the buffers CorePrefetchDriverSections() allocated.
+
+  @param  Buffer                  The SECTION_PREFETCH_QUEUE to work on.
+
+**/
+STATIC
+VOID
+EFIAPI
+PrefetchSectionWorker (
+  IN OUT VOID  *Buffer
+  )
+{
+  SECTION_PREFETCH_QUEUE  *Queue;
+  SECTION_PREFETCH_ITEM   *Item;
+  UINT32                  Index;
+  VOID                    *Output;
+  UINT32                  AuthenticationStatus;
+
+  Queue = (SECTION_PREFETCH_QUEUE *)Buffer;
+
+  while (TRUE) {
+    Index = InterlockedIncrement (&Queue->NextIndex) - 1;
+    if (Index >= Queue->Count) {
+      break;
+    }
+
+    Item = &Queue->Items[Index];
+    if (Item->Guided) {
+      Output       = Item->Output;
+      Item->Status = ExtractGuidedSectionDecode (Item->Source, &Output, Item->Scratch, &AuthenticationStatus);
+      if (!EFI_ERROR (Item->Status) && (Output != Item->Output)) {
+        CopyMem (Item->Output, Output, Item->OutputSize);
+      }
+    } else {
+      Item->Status = UefiDecompress (Item->Source, Item->Output, Item->Scratch);
+    }
+  }
+}
+
+/**
+  Decompress the compressed sections of scheduled drivers on the application
+  processors and add them to the decompressed section cache, so that loading
+  the drivers does not have to decompress them one after the other.
+
+  The sections are found in the file buffers of the firmware volumes, where
+  ReadSection() finds them later, and all buffers are allocated on the BSP.
+  Only the sections at the top level of each file are decompressed, and only
+  as many as fit in the section cache.
+
+  @param  DriverEntries          The drivers that are about to be loaded.
+  @param  Count                  The number of entries in DriverEntries.
+
+**/
+VOID
+CorePrefetchDriverSections (
+  IN EFI_CORE_DRIVER_ENTRY  **DriverEntries,
+  IN UINTN                  Count
+  )
+{
+  EFI_STATUS                 Status;
+  VOID                       **FileBuffers;
+  UINTN                      *FileSizes;
+  SECTION_PREFETCH_QUEUE     Queue;
+  SECTION_PREFETCH_ITEM      *Item;
+  EFI_COMMON_SECTION_HEADER  *Section;
+  EFI_FV_FILETYPE            FileType;
+  UINTN                      Index;
+  UINTN                      Offset;
+  UINT32                     SectionSize;
+  BOOLEAN                    Guided;
+  CONST VOID                 *Source;
+  UINT32                     OutputSize;
+  UINT32                     ScratchSize;
+  UINTN                      TotalSize;
+  UINTN                      MaxItems;
+  EFI_TPL                    OldTpl;
+
+  if (!PcdGetBool (PcdDxeParallelSectionExtraction) || (PcdGet32 (PcdDxeSectionCacheSize) == 0) ||
+      (Count < 2) || !CoreIsMpAvailable ())
+  {
+    return;
+  }
+
+  FileBuffers = AllocateZeroPool (Count * (sizeof (VOID *) + sizeof (UINTN)));
+  if (FileBuffers == NULL) {
+    return;
+  }
+
+  FileSizes = (UINTN *)(FileBuffers + Count);
+
+  //
+  // Find the files and count the sections that may need decompressing
+  //
+  MaxItems = 0;
+  for (Index = 0; Index < Count; Index++) {
+    Status = CoreGetFvFileData (
+               DriverEntries[Index]->Fv,
+               &DriverEntries[Index]->FileName,
+               &FileBuffers[Index],
+               &FileSizes[Index],
+               &FileType
+               );
+    if (EFI_ERROR (Status) || (FileType == EFI_FV_FILETYPE_RAW) ||
+        !IsValidSectionStream (FileBuffers[Index], FileSizes[Index]))
+    {
+      FileBuffers[Index] = NULL;
+      continue;
+    }
+
+    for (Offset = 0; Offset + sizeof (EFI_COMMON_SECTION_HEADER) <= FileSizes[Index]; Offset = ALIGN_VALUE (Offset + SectionSize, 4)) {
+      Section     = (EFI_COMMON_SECTION_HEADER *)((UINT8 *)FileBuffers[Index] + Offset);
+      SectionSize = IS_SECTION2 (Section) ? SECTION2_SIZE (Section) : SECTION_SIZE (Section);
+      if ((Section->Type == EFI_SECTION_COMPRESSION) || (Section->Type == EFI_SECTION_GUID_DEFINED)) {
+        MaxItems++;
+      }
+    }
+  }
+
+  Queue.Items     = AllocateZeroPool (MaxItems * sizeof (SECTION_PREFETCH_ITEM));
+  Queue.Count     = 0;
+  Queue.NextIndex = 0;
+  if ((MaxItems == 0) || (Queue.Items == NULL)) {
+    goto Done;
+  }
+
+  //
+  // Allocate the buffers of the sections that are not cached yet, as long as
+  // the results fit in the cache
+  //
+  TotalSize = 0;
+  for (Index = 0; Index < Count; Index++) {
+    if (FileBuffers[Index] == NULL) {
+      continue;
+    }
+
+    for (Offset = 0; Offset + sizeof (EFI_COMMON_SECTION_HEADER) <= FileSizes[Index]; Offset = ALIGN_VALUE (Offset + SectionSize, 4)) {
+      Section     = (EFI_COMMON_SECTION_HEADER *)((UINT8 *)FileBuffers[Index] + Offset);
+      SectionSize = IS_SECTION2 (Section) ? SECTION2_SIZE (Section) : SECTION_SIZE (Section);
+      if (!GetPrefetchSectionInfo (Section, &Guided, &Source, &OutputSize, &ScratchSize) ||
+          (TotalSize + OutputSize > PcdGet32 (PcdDxeSectionCacheSize)))
+      {
+        continue;
+      }
+
+      OldTpl = CoreRaiseTpl (TPL_NOTIFY);
+      if (FindSectionCacheEntry (&DriverEntries[Index]->FileName, Section, SectionSize) != NULL) {
+        CoreRestoreTpl (OldTpl);
+        continue;
+      }
+
+      CoreRestoreTpl (OldTpl);
+
+      Item         = &Queue.Items[Queue.Count];
+      Item->Output = AllocatePool (OutputSize);
+      if (ScratchSize != 0) {
+        Item->Scratch = AllocatePool (ScratchSize);
+      }
+
+      if ((Item->Output == NULL) || ((ScratchSize != 0) && (Item->Scratch == NULL))) {
+        if (Item->Output != NULL) {
+          CoreFreePool (Item->Output);
+        }
+
+        ZeroMem (Item, sizeof (SECTION_PREFETCH_ITEM));
+        continue;
+      }
+
+      CopyGuid (&Item->FileName, &DriverEntries[Index]->FileName);
+      Item->Section     = Section;
+      Item->SectionSize = SectionSize;
+      Item->Guided      = Guided;
+      Item->Source      = Source;
+      Item->OutputSize  = OutputSize;
+      Item->Status      = EFI_NOT_STARTED;
+      TotalSize        += OutputSize;
+      Queue.Count++;
+    }
+  }
+
+  if (Queue.Count < 2) {
+    //
+    // Nothing to gain from the application processors; leave the section, if
+    // any, to CreateChildNode().
+    //
+    for (Index = 0; Index < Queue.Count; Index++) {
+      Queue.Items[Index].Status = EFI_ABORTED;
+    }
+  } else {
+    PERF_INMODULE_BEGIN ("DxeParallelSectionExtraction");
+    Status = CoreStartupAllProcessors (PrefetchSectionWorker, &Queue);
+    PERF_INMODULE_END ("DxeParallelSectionExtraction");
+
+    DEBUG ((
+      DEBUG_INFO | DEBUG_LOAD,
+      "Decompressed %u sections of %Lu drivers in parallel (%r)\n",
+      Queue.Count,
+      (UINT64)Count,
+      Status
+      ));
+  }
+
+  //
+  // Hand the decompressed sections over to the cache
+  //
+  OldTpl = CoreRaiseTpl (TPL_NOTIFY);
+  for (Index = 0; Index < Queue.Count; Index++) {
+    Item = &Queue.Items[Index];
+    if (Item->Scratch != NULL) {
+      CoreFreePool (Item->Scratch);
+    }
+
+    if (EFI_ERROR (Item->Status) ||
+        (AddSectionCacheEntry (
+           &Item->FileName,
+           Item->Section,
+           Item->SectionSize,
+           Item->Output,
+           Item->OutputSize,
+           FALSE
+           ) == NULL))
+    {
+      CoreFreePool (Item->Output);
+    }
+  }
+
+  CoreRestoreTpl (OldTpl);
+
+Done:
+  if (Queue.Items != NULL) {
+    CoreFreePool (Queue.Items);
+  }
+
+  CoreFreePool (FileBuffers);
+}
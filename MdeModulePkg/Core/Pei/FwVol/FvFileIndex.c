@@ -0,0 +1,276 @@
+/** @file
+  Index of the FFS files of the firmware volumes processed by the PEI Core.
+
+  The file headers of a firmware volume are walked once when the volume is
+  registered, and every file that FindFileEx() can return is recorded in a
+  GUID HOB. Later lookups of the volume, including the rescans of the
+  dispatcher, are answered from the index instead of walking the headers
+  in flash again. The DXE Core reuses the HOB for the same volume.
+
+Copyright (c) 2026, TianoCore and contributors. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "FwVol.h"
+
+//
+// The largest index that fits in a GUID HOB.
+//
+#define FV_FILE_INDEX_MAX_SIZE  (0xFFF8 - sizeof (EFI_HOB_GUID_TYPE))
+
+/**
+  Walk the files of a firmware volume in the order FindFileEx() returns them.
+
+  @param FvHandle    The handle of the FV.
+  @param Index       The index to fill in, or NULL to only count the files.
+
+  @return The number of files found.
+**/
+STATIC
+UINT32
+WalkFvFiles (
+  IN EFI_PEI_FV_HANDLE    FvHandle,
+  IN EDKII_FV_FILE_INDEX  *Index      OPTIONAL
+  )
+{
+  EDKII_FV_FILE_INDEX_ENTRY  *Entry;
+  EFI_FFS_FILE_HEADER        *FfsFileHeader;
+  EFI_PEI_FILE_HANDLE        FileHandle;
+  UINT32                     FileCount;
+
+  FileCount  = 0;
+  FileHandle = NULL;
+  while (!EFI_ERROR (FindFileEx (FvHandle, NULL, EFI_FV_FILETYPE_ALL, &FileHandle, NULL))) {
+    if (Index != NULL) {
+      FfsFileHeader = (EFI_FFS_FILE_HEADER *)FileHandle;
+      Entry         = &FV_FILE_INDEX_ENTRIES (Index)[FileCount];
+      CopyGuid (&Entry->Name, &FfsFileHeader->Name);
+      Entry->Offset = (UINT32)((UINTN)FileHandle - (UINTN)FvHandle);
+      Entry->Type   = FfsFileHeader->Type;
+    }
+
+    FileCount++;
+  }
+
+  return FileCount;
+}
+
+/**
+  Build the file index of a firmware volume and publish it in a GUID HOB.
+
+  Only volumes handled by the FV PPIs of the PEI Core are indexed. If the volume
+  has no files, or too many files for a HOB, it is left without an index and
+  its lookups keep walking the file headers.
+
+  @param CoreFvHandle   The PEI_CORE_FV_HANDLE of the volume to index.
+**/
+VOID
+BuildFvFileIndex (
+  IN PEI_CORE_FV_HANDLE  *CoreFvHandle
+  )
+{
+  EDKII_FV_FILE_INDEX        *Index;
+  EDKII_FV_FILE_INDEX_ENTRY  *Entries;
+  UINT32                     *TypeOrder;
+  UINT32                     TypeStart[256];
+  UINT32                     FileCount;
+  UINT32                     EntryIndex;
+  UINTN                      Type;
+  UINT32                     Sum;
+  UINT32                     Count;
+
+  if ((CoreFvHandle->FileIndex != NULL) ||
+      ((CoreFvHandle->FvPpi != &mPeiFfs2FwVol.Fv) && (CoreFvHandle->FvPpi != &mPeiFfs3FwVol.Fv)))
+  {
+    return;
+  }
+
+  //
+  // The first walk counts the files so that the HOB can be sized, the second
+  // one records them.
+  //
+  FileCount = WalkFvFiles (CoreFvHandle->FvHandle, NULL);
+  if ((FileCount == 0) || (FV_FILE_INDEX_SIZE (FileCount) > FV_FILE_INDEX_MAX_SIZE)) {
+    return;
+  }
+
+  Index = BuildGuidHob (&gEdkiiFvFileIndexHobGuid, FV_FILE_INDEX_SIZE (FileCount));
+  if (Index == NULL) {
+    return;
+  }
+
+  Index->FvBase    = (EFI_PHYSICAL_ADDRESS)(UINTN)CoreFvHandle->FvHandle;
+  Index->FvLength  = CoreFvHandle->FvHeader->FvLength;
+  Index->FileCount = FileCount;
+  Index->Reserved  = 0;
+  if (WalkFvFiles (CoreFvHandle->FvHandle, Index) != FileCount) {
+    ASSERT (FALSE);
+    return;
+  }
+
+  //
+  // Group the entries by type with a counting sort. The entries are already in
+  // offset order, so each group stays in offset order.
+  //
+  Entries   = FV_FILE_INDEX_ENTRIES (Index);
+  TypeOrder = FV_FILE_INDEX_TYPE_ORDER (Index);
+  ZeroMem (TypeStart, sizeof (TypeStart));
+  for (EntryIndex = 0; EntryIndex < FileCount; EntryIndex++) {
+    TypeStart[Entries[EntryIndex].Type]++;
+  }
+
+  Sum = 0;
+  for (Type = 0; Type < ARRAY_SIZE (TypeStart); Type++) {
+    Count           = TypeStart[Type];
+    TypeStart[Type] = Sum;
+    Sum            += Count;
+  }
+
+  for (EntryIndex = 0; EntryIndex < FileCount; EntryIndex++) {
+    TypeOrder[TypeStart[Entries[EntryIndex].Type]++] = EntryIndex;
+  }
+
+  CoreFvHandle->FileIndex = Index;
+  DEBUG ((DEBUG_INFO, "Indexed %d files of FV 0x%p\n", FileCount, CoreFvHandle->FvHandle));
+}
+
+/**
+  Find the first file of the given type located after the given offset.
+
+  @param Index       The file index of the FV.
+  @param Type        The file type to search for.
+  @param Offset      The offset after which to search.
+
+  @return The index of the entry found, or FileCount if there is none.
+**/
+STATIC
+UINT32
+FindNextFileOfType (
+  IN CONST EDKII_FV_FILE_INDEX  *Index,
+  IN EFI_FV_FILETYPE            Type,
+  IN UINT32                     Offset
+  )
+{
+  CONST EDKII_FV_FILE_INDEX_ENTRY  *Entries;
+  CONST EDKII_FV_FILE_INDEX_ENTRY  *Entry;
+  CONST UINT32                     *TypeOrder;
+  UINT32                           Low;
+  UINT32                           High;
+  UINT32                           Middle;
+
+  Entries   = FV_FILE_INDEX_ENTRIES (Index);
+  TypeOrder = FV_FILE_INDEX_TYPE_ORDER (Index);
+
+  //
+  // Find the first entry that sorts after (Type, Offset) in TypeOrder.
+  //
+  Low  = 0;
+  High = Index->FileCount;
+  while (Low < High) {
+    Middle = Low + (High - Low) / 2;
+    Entry  = &Entries[TypeOrder[Middle]];
+    if ((Entry->Type < Type) || ((Entry->Type == Type) && (Entry->Offset <= Offset))) {
+      Low = Middle + 1;
+    } else {
+      High = Middle;
+    }
+  }
+
+  if ((Low < Index->FileCount) && (Entries[TypeOrder[Low]].Type == Type)) {
+    return TypeOrder[Low];
+  }
+
+  return Index->FileCount;
+}
+
+/**
+  Search the file index of a firmware volume with the semantics of FindFileEx().
+
+  If FileName is not NULL, or *FileHandle is NULL, the search starts at the first
+  file of the volume, otherwise it starts at the file following *FileHandle.
+
+  @param Index       The file index of the FV.
+  @param FvHandle    The handle of the FV.
+  @param FileName    The name of the file to search for.
+  @param SearchType  The type of the file to search for. EFI_FV_FILETYPE_ALL
+                     matches any file, PEI_CORE_INTERNAL_FFS_FILE_DISPATCH_TYPE
+                     matches PEIM, combined PEIM/driver and FV image files.
+  @param FileHandle  On input, the file to start the search after. On output,
+                     the file found, or NULL.
+
+  @retval EFI_SUCCESS    The file was found.
+  @retval EFI_NOT_FOUND  No matching file was found.
+**/
+EFI_STATUS
+FindFileInIndex (
+  IN     CONST EDKII_FV_FILE_INDEX  *Index,
+  IN     CONST EFI_PEI_FV_HANDLE    FvHandle,
+  IN     CONST EFI_GUID             *FileName    OPTIONAL,
+  IN     EFI_FV_FILETYPE            SearchType,
+  IN OUT EFI_PEI_FILE_HANDLE        *FileHandle
+  )
+{
+  CONST EDKII_FV_FILE_INDEX_ENTRY  *Entries;
+  UINT32                           Offset;
+  UINT32                           Found;
+  UINT32                           Candidate;
+  UINT32                           Low;
+  UINT32                           High;
+  UINT32                           Middle;
+
+  Entries = FV_FILE_INDEX_ENTRIES (Index);
+  Found   = Index->FileCount;
+
+  if (FileName != NULL) {
+    for (Found = 0; Found < Index->FileCount; Found++) {
+      if (CompareGuid (&Entries[Found].Name, FileName)) {
+        break;
+      }
+    }
+  } else {
+    //
+    // No file starts at offset 0, so it stands for the start of the volume.
+    //
+    Offset = 0;
+    if (*FileHandle != NULL) {
+      Offset = (UINT32)((UINTN)*FileHandle - (UINTN)FvHandle);
+    }
+
+    if (SearchType == EFI_FV_FILETYPE_ALL) {
+      Low  = 0;
+      High = Index->FileCount;
+      while (Low < High) {
+        Middle = Low + (High - Low) / 2;
+        if (Entries[Middle].Offset <= Offset) {
+          Low = Middle + 1;
+        } else {
+          High = Middle;
+        }
+      }
+
+      Found = Low;
+    } else if (SearchType == PEI_CORE_INTERNAL_FFS_FILE_DISPATCH_TYPE) {
+      Found     = FindNextFileOfType (Index, EFI_FV_FILETYPE_PEIM, Offset);
+      Candidate = FindNextFileOfType (Index, EFI_FV_FILETYPE_COMBINED_PEIM_DRIVER, Offset);
+      if (Candidate < Found) {
+        Found = Candidate;
+      }
+
+      Candidate = FindNextFileOfType (Index, EFI_FV_FILETYPE_FIRMWARE_VOLUME_IMAGE, Offset);
+      if (Candidate < Found) {
+        Found = Candidate;
+      }
+    } else if (SearchType != EFI_FV_FILETYPE_FFS_PAD) {
+      Found = FindNextFileOfType (Index, SearchType, Offset);
+    }
+  }
+
+  if (Found >= Index->FileCount) {
+    *FileHandle = NULL;
+    return EFI_NOT_FOUND;
+  }
+
+  *FileHandle = (EFI_PEI_FILE_HANDLE)((UINT8 *)FvHandle + Entries[Found].Offset);
+  return EFI_SUCCESS;
+}
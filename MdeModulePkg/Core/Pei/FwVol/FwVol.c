@@ -283,6 +283,7 @@ FindFileEx (
   UINT8                           FileState;
   UINT8                           DataCheckSum;
   BOOLEAN                         IsFfs3Fv;
+  PEI_CORE_FV_HANDLE              *CoreFvHandle;
 
   //
   // Convert the handle of FV to FV header for memory-mapped firmware volume
@@ -290,6 +291,20 @@ FindFileEx (
   FwVolHeader = (EFI_FIRMWARE_VOLUME_HEADER *)FvHandle;
   FileHeader  = (EFI_FFS_FILE_HEADER **)FileHandle;
 
+  //
+  // Answer the search from the file index of the FV if it has one, unless it
+  // starts after a file handle that does not belong to the FV.
+  //
+  if (AprioriFile == NULL) {
+    CoreFvHandle = FvHandleToCoreHandle (FvHandle);
+    if ((CoreFvHandle != NULL) && (CoreFvHandle->FileIndex != NULL) &&
+        ((FileName != NULL) || (*FileHeader == NULL) ||
+         (((UINTN)*FileHeader > (UINTN)FwVolHeader) && ((UINTN)*FileHeader - (UINTN)FwVolHeader < FwVolHeader->FvLength))))
+    {
+      return FindFileInIndex (CoreFvHandle->FileIndex, FvHandle, FileName, SearchType, FileHandle);
+    }
+  }
+
   IsFfs3Fv = CompareGuid (&FwVolHeader->FileSystemGuid, &gEfiFirmwareFileSystem3Guid);
 
   FvLength = FwVolHeader->FvLength;
@@ -551,6 +566,8 @@ PeiInitializeFv (
     ));
   PrivateData->FvCount++;
 
+  BuildFvFileIndex (&PrivateData->Fv[PrivateData->FvCount - 1]);
+
   //
   // Post a call-back for the FvInfoPPI and FvInfo2PPI services to expose
   // additional FVs to PeiCore.
@@ -694,6 +711,8 @@ FirmwareVolumeInfoPpiNotifyCallback (
       ));
     PrivateData->FvCount++;
 
+    BuildFvFileIndex (&PrivateData->Fv[CurFvCount]);
+
     //
     // Scan and process the new discovered FV for EFI_FV_FILETYPE_FIRMWARE_VOLUME_IMAGE
     //
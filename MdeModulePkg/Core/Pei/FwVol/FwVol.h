@@ -25,6 +25,9 @@ typedef struct {
 #define PEI_FW_VOL_INSTANCE_FROM_FV_THIS(a) \
   CR(a, PEI_FW_VOL_INSTANCE, Fv, PEI_FW_VOL_SIGNATURE)
 
+extern PEI_FW_VOL_INSTANCE  mPeiFfs2FwVol;
+extern PEI_FW_VOL_INSTANCE  mPeiFfs3FwVol;
+
 /**
   Process a firmware volume and create a volume handle.
 
@@ -300,6 +303,47 @@ FindFileEx (
   IN OUT    EFI_PEI_FILE_HANDLE  *AprioriFile  OPTIONAL
   );
 
+/**
+  Build the file index of a firmware volume and publish it in a GUID HOB.
+
+  Only volumes handled by the FV PPIs of the PEI Core are indexed. If the volume
+  has no files, or too many files for a HOB, it is left without an index and
+  its lookups keep walking the file headers.
+
+  @param CoreFvHandle   The PEI_CORE_FV_HANDLE of the volume to index.
+**/
+VOID
+BuildFvFileIndex (
+  IN PEI_CORE_FV_HANDLE  *CoreFvHandle
+  );
+
+/**
+  Search the file index of a firmware volume with the semantics of FindFileEx().
+
+  If FileName is not NULL, or *FileHandle is NULL, the search starts at the first
+  file of the volume, otherwise it starts at the file following *FileHandle.
+
+  @param Index       The file index of the FV.
+  @param FvHandle    The handle of the FV.
+  @param FileName    The name of the file to search for.
+  @param SearchType  The type of the file to search for. EFI_FV_FILETYPE_ALL
+                     matches any file, PEI_CORE_INTERNAL_FFS_FILE_DISPATCH_TYPE
+                     matches PEIM, combined PEIM/driver and FV image files.
+  @param FileHandle  On input, the file to start the search after. On output,
+                     the file found, or NULL.
+
+  @retval EFI_SUCCESS    The file was found.
+  @retval EFI_NOT_FOUND  No matching file was found.
+**/
+EFI_STATUS
+FindFileInIndex (
+  IN     CONST EDKII_FV_FILE_INDEX  *Index,
+  IN     CONST EFI_PEI_FV_HANDLE    FvHandle,
+  IN     CONST EFI_GUID             *FileName    OPTIONAL,
+  IN     EFI_FV_FILETYPE            SearchType,
+  IN OUT EFI_PEI_FILE_HANDLE        *FileHandle
+  );
+
 /**
   Report the information for a newly discovered FV in an unknown format.
 
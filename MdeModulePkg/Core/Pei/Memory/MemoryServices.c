@@ -167,7 +167,7 @@ MigrateMemoryPages (
 }
 
 /**
-  Migrate the base address in firmware volume allocation HOBs
+  Migrate the base address in firmware volume allocation HOBs and FV file index HOBs
   from temporary memory to PEI installed memory.
 
   @param[in] PrivateData      Pointer to PeiCore's private data structure.
@@ -186,6 +186,7 @@ ConvertFvHob (
   EFI_HOB_FIRMWARE_VOLUME   *FirmwareVolumeHob;
   EFI_HOB_FIRMWARE_VOLUME2  *FirmwareVolume2Hob;
   EFI_HOB_FIRMWARE_VOLUME3  *FirmwareVolume3Hob;
+  EDKII_FV_FILE_INDEX       *FileIndex;
 
   DEBUG ((DEBUG_INFO, "Converting FVs in FV HOB.\n"));
 
@@ -205,6 +206,16 @@ ConvertFvHob (
       if (FirmwareVolume3Hob->BaseAddress == OrgFvHandle) {
         FirmwareVolume3Hob->BaseAddress = FvHandle;
       }
+    } else if ((GET_HOB_TYPE (Hob) == EFI_HOB_TYPE_GUID_EXTENSION) &&
+               CompareGuid (&Hob.Guid->Name, &gEdkiiFvFileIndexHobGuid))
+    {
+      //
+      // The files keep their offsets in the migrated FV.
+      //
+      FileIndex = GET_GUID_HOB_DATA (Hob.Guid);
+      if (FileIndex->FvBase == OrgFvHandle) {
+        FileIndex->FvBase = FvHandle;
+      }
     }
   }
 }
@@ -50,6 +50,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Guid/FirmwareFileSystem3.h>
 #include <Guid/AprioriFileName.h>
 #include <Guid/MigratedFvInfo.h>
+#include <Guid/FvFileIndex.h>
 #include <Guid/DelayedDispatch.h>
 
 ///
@@ -152,6 +153,10 @@ typedef struct {
   EFI_PEI_FILE_HANDLE            *FvFileHandles;
   BOOLEAN                        ScanFv;
   UINT32                         AuthenticationStatus;
+  //
+  // Pointer to the file index of the FV in its GUID HOB, NULL if the FV is not indexed.
+  //
+  EDKII_FV_FILE_INDEX            *FileIndex;
 } PEI_CORE_FV_HANDLE;
 
 typedef struct {
@@ -1073,7 +1078,7 @@ MigrateMemoryPages (
   );
 
 /**
-  Migrate the base address in firmware volume allocation HOBs
+  Migrate the base address in firmware volume allocation HOBs and FV file index HOBs
   from temporary memory to PEI installed memory.
 
   @param[in] PrivateData      Pointer to PeiCore's private data structure.
@@ -0,0 +1,150 @@
+/** @file
+  GUID and data structures of the configuration table through which the DXE
+  Core publishes the latency of the boot services called by each image.
+
+  When PcdDxeServiceTraceMask is not zero, the DXE Core times the boot services
+  selected by the mask and attributes every call to the image that made it,
+  from the return address of the call. For each image and service it keeps a
+  call count, the total and largest time taken, and a histogram of the times
+  on a logarithmic scale. The most recent calls are also kept in a ring buffer.
+  The time of a call includes the notification functions that the service
+  dispatched before returning.
+
+  Copyright (c) 2026, TianoCore and contributors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __BOOT_SERVICE_TRACE_H__
+#define __BOOT_SERVICE_TRACE_H__
+
+#define EDKII_BOOT_SERVICE_TRACE_TABLE_GUID \
+  { \
+    0x4b7e2d19, 0x8c6a, 0x4f03, { 0xb5, 0x2e, 0x91, 0x0d, 0x6f, 0x3a, 0xc4, 0x78 } \
+  }
+
+#define EDKII_BOOT_SERVICE_TRACE_TABLE_REVISION  1
+
+///
+/// Boot services that can be traced. Bit N of PcdDxeServiceTraceMask enables
+/// the service numbered N.
+///
+#define BOOT_SERVICE_TRACE_ALLOCATE_PAGES                0
+#define BOOT_SERVICE_TRACE_FREE_PAGES                    1
+#define BOOT_SERVICE_TRACE_GET_MEMORY_MAP                2
+#define BOOT_SERVICE_TRACE_ALLOCATE_POOL                 3
+#define BOOT_SERVICE_TRACE_FREE_POOL                     4
+#define BOOT_SERVICE_TRACE_CREATE_EVENT                  5
+#define BOOT_SERVICE_TRACE_SET_TIMER                     6
+#define BOOT_SERVICE_TRACE_WAIT_FOR_EVENT                7
+#define BOOT_SERVICE_TRACE_SIGNAL_EVENT                  8
+#define BOOT_SERVICE_TRACE_CLOSE_EVENT                   9
+#define BOOT_SERVICE_TRACE_CHECK_EVENT                   10
+#define BOOT_SERVICE_TRACE_INSTALL_PROTOCOL_INTERFACE    11
+#define BOOT_SERVICE_TRACE_REINSTALL_PROTOCOL_INTERFACE  12
+#define BOOT_SERVICE_TRACE_UNINSTALL_PROTOCOL_INTERFACE  13
+#define BOOT_SERVICE_TRACE_HANDLE_PROTOCOL               14
+#define BOOT_SERVICE_TRACE_REGISTER_PROTOCOL_NOTIFY      15
+#define BOOT_SERVICE_TRACE_LOCATE_HANDLE                 16
+#define BOOT_SERVICE_TRACE_LOCATE_DEVICE_PATH            17
+#define BOOT_SERVICE_TRACE_STALL                         18
+#define BOOT_SERVICE_TRACE_CONNECT_CONTROLLER            19
+#define BOOT_SERVICE_TRACE_DISCONNECT_CONTROLLER         20
+#define BOOT_SERVICE_TRACE_OPEN_PROTOCOL                 21
+#define BOOT_SERVICE_TRACE_CLOSE_PROTOCOL                22
+#define BOOT_SERVICE_TRACE_OPEN_PROTOCOL_INFORMATION     23
+#define BOOT_SERVICE_TRACE_PROTOCOLS_PER_HANDLE          24
+#define BOOT_SERVICE_TRACE_LOCATE_HANDLE_BUFFER          25
+#define BOOT_SERVICE_TRACE_LOCATE_PROTOCOL               26
+#define BOOT_SERVICE_TRACE_CREATE_EVENT_EX               27
+#define BOOT_SERVICE_TRACE_SERVICE_COUNT                 28
+
+///
+/// Histogram bucket N counts the calls that took less than
+/// 2^(N + BOOT_SERVICE_TRACE_BUCKET_SHIFT) nanoseconds and were not counted by
+/// a lower bucket. The last bucket counts all the longer calls.
+///
+#define BOOT_SERVICE_TRACE_BUCKET_COUNT  16
+#define BOOT_SERVICE_TRACE_BUCKET_SHIFT  8
+
+///
+/// An image that called the traced services. Image 0 stands for the callers
+/// outside of any image known to the DXE Core.
+///
+typedef struct {
+  ///
+  /// The image handle, which may no longer be valid if the image was unloaded.
+  ///
+  EFI_PHYSICAL_ADDRESS    Handle;
+  EFI_PHYSICAL_ADDRESS    ImageBase;
+  UINT64                  ImageSize;
+  ///
+  /// The name of the FFS file of the image, or zero if the image was not
+  /// loaded from a firmware volume.
+  ///
+  EFI_GUID                FileName;
+} BOOT_SERVICE_TRACE_IMAGE;
+
+///
+/// The calls made by one image to one service. Times are in performance
+/// counter ticks.
+///
+typedef struct {
+  UINT64    CallCount;
+  UINT64    TotalTicks;
+  UINT64    MaxTicks;
+  UINT32    Histogram[BOOT_SERVICE_TRACE_BUCKET_COUNT];
+} BOOT_SERVICE_TRACE_STATS;
+
+///
+/// One call in the ring buffer.
+///
+typedef struct {
+  UINT64    StartTicks;    // Performance counter value when the call was made
+  UINT32    Ticks;         // Time taken by the call, saturated to MAX_UINT32
+  UINT16    ImageIndex;
+  UINT8     Service;
+  UINT8     Reserved;
+} BOOT_SERVICE_TRACE_RECORD;
+
+typedef struct {
+  UINT32                  Revision;
+  UINT32                  ServiceMask;      // PcdDxeServiceTraceMask
+  UINT32                  ServiceCount;     // BOOT_SERVICE_TRACE_SERVICE_COUNT
+  UINT32                  BucketCount;      // BOOT_SERVICE_TRACE_BUCKET_COUNT
+  UINT32                  ImageCount;       // Entries of Images in use
+  UINT32                  MaxImageCount;    // Entries allocated for Images
+  UINT32                  RingSize;         // Entries of Ring
+  ///
+  /// Number of images that did not fit in Images. Their calls are counted
+  /// against image 0.
+  ///
+  UINT32                  DroppedImageCount;
+  ///
+  /// Number of calls written to Ring so far. The most recent call is at
+  /// index (RingCount - 1) % RingSize.
+  ///
+  UINT64                  RingCount;
+  ///
+  /// Frequency of the performance counter in Hz, and its start and end values.
+  ///
+  UINT64                  Frequency;
+  UINT64                  CounterStart;
+  UINT64                  CounterEnd;
+  ///
+  /// BOOT_SERVICE_TRACE_IMAGE[MaxImageCount]
+  ///
+  EFI_PHYSICAL_ADDRESS    Images;
+  ///
+  /// BOOT_SERVICE_TRACE_STATS[MaxImageCount][ServiceCount]
+  ///
+  EFI_PHYSICAL_ADDRESS    Stats;
+  ///
+  /// BOOT_SERVICE_TRACE_RECORD[RingSize]
+  ///
+  EFI_PHYSICAL_ADDRESS    Ring;
+} EDKII_BOOT_SERVICE_TRACE_TABLE;
+
+extern EFI_GUID  gEdkiiBootServiceTraceTableGuid;
+
+#endif
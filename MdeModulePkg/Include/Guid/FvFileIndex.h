@@ -0,0 +1,62 @@
+/** @file
+  FV file index
+
+  The PEI Core walks the FFS file headers of a firmware volume once when the
+  volume is registered and records every file it can return in a GUID HOB, so
+  that later file lookups do not have to walk the headers in flash again. The
+  DXE Core reuses the HOB to build its file list of the same volume.
+
+Copyright (c) 2026, TianoCore and contributors. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __EDKII_FV_FILE_INDEX_GUID_H__
+#define __EDKII_FV_FILE_INDEX_GUID_H__
+
+#define EDKII_FV_FILE_INDEX_HOB_GUID \
+  { \
+    0x6c1bd9a4, 0x3e0f, 0x4d2b, { 0x9a, 0x87, 0x52, 0xe4, 0x1f, 0x3c, 0xb8, 0x06 } \
+  }
+
+///
+/// One FFS file of the firmware volume.
+///
+typedef struct {
+  EFI_GUID    Name;            // Name of the file
+  UINT32      Offset;          // Offset of the file header from the start of the FV
+  UINT8       Type;            // EFI_FV_FILETYPE of the file
+  UINT8       Reserved[3];
+} EDKII_FV_FILE_INDEX_ENTRY;
+
+///
+/// The HOB data is an EDKII_FV_FILE_INDEX followed by FileCount entries in
+/// ascending Offset order, and then by a UINT32 array of FileCount entry
+/// indices that lists the entries grouped by Type, each group in ascending
+/// Offset order.
+///
+/// Files that a lookup of the PEI Core never returns (pad files, deleted files,
+/// files with an invalid state and FFS3 files in an FFS2 volume) are not
+/// recorded.
+///
+typedef struct {
+  EFI_PHYSICAL_ADDRESS    FvBase;     // Current base address of the FV
+  UINT64                  FvLength;   // Length of the FV
+  UINT32                  FileCount;  // Number of entries
+  UINT32                  Reserved;
+  // EDKII_FV_FILE_INDEX_ENTRY    Entry[FileCount];
+  // UINT32                       TypeOrder[FileCount];
+} EDKII_FV_FILE_INDEX;
+
+#define FV_FILE_INDEX_ENTRIES(Index) \
+  ((EDKII_FV_FILE_INDEX_ENTRY *) ((EDKII_FV_FILE_INDEX *) (Index) + 1))
+
+#define FV_FILE_INDEX_TYPE_ORDER(Index) \
+  ((UINT32 *) (FV_FILE_INDEX_ENTRIES (Index) + ((EDKII_FV_FILE_INDEX *) (Index))->FileCount))
+
+#define FV_FILE_INDEX_SIZE(FileCount) \
+  (sizeof (EDKII_FV_FILE_INDEX) + (FileCount) * (sizeof (EDKII_FV_FILE_INDEX_ENTRY) + sizeof (UINT32)))
+
+extern EFI_GUID  gEdkiiFvFileIndexHobGuid;
+
+#endif // #ifndef __EDKII_FV_FILE_INDEX_GUID_H__
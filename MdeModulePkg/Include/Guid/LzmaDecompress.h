@@ -23,7 +23,41 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define LZMAF86_CUSTOM_DECOMPRESS_GUID  \
   { 0xD42AE6BD, 0x1352, 0x4bfb, { 0x90, 0x9A, 0xCA, 0x72, 0xA6, 0xEA, 0xE8, 0x89 } }
 
+///
+/// The Global ID used to identify a section of an FFS file of type
+/// EFI_SECTION_GUID_DEFINED, whose contents have been compressed as a series
+/// of independent LZMA blocks that can be decoded concurrently.
+///
+#define LZMA_CHUNKED_CUSTOM_DECOMPRESS_GUID  \
+  { 0xFB2C94FF, 0x29A0, 0x4755, { 0x9C, 0x38, 0xBF, 0x58, 0xFB, 0x54, 0x74, 0x67 } }
+
+#define LZMA_CHUNKED_SIGNATURE  SIGNATURE_32 ('L', 'Z', 'M', 'C')
+
+///
+/// Header of the data of an LZMA_CHUNKED_CUSTOM_DECOMPRESS_GUID section. It is
+/// followed by BlockCount LZMA_CHUNKED_BLOCK entries. Every block is a
+/// complete LZMA stream, with its own properties and size header, that
+/// decodes to BlockSize bytes, except for the last block which decodes to
+/// the remainder of DecodedSize.
+///
+typedef struct {
+  UINT32    Signature;
+  UINT32    BlockSize;
+  UINT32    BlockCount;
+  UINT32    Reserved;
+  UINT64    DecodedSize;
+} LZMA_CHUNKED_HEADER;
+
+///
+/// Location of a block, relative to the start of the LZMA_CHUNKED_HEADER.
+///
+typedef struct {
+  UINT32    Offset;
+  UINT32    Size;
+} LZMA_CHUNKED_BLOCK;
+
 extern GUID  gLzmaCustomDecompressGuid;
 extern GUID  gLzmaF86CustomDecompressGuid;
+extern GUID  gLzmaChunkedCustomDecompressGuid;
 
 #endif
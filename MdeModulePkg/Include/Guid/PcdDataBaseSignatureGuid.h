@@ -79,6 +79,13 @@ typedef struct {
 
 typedef UINT32 TABLE_OFFSET;
 
+//
+// Value of PCD_DATABASE_INIT.ExMapLayout when the ExMapTable is sorted by
+// ExGuidIndex and then by ExTokenNumber. Databases built before the field
+// existed hold the 0xDA pad byte there and must be searched linearly.
+//
+#define PCD_EXMAP_LAYOUT_SORTED  0x01
+
 typedef struct {
   GUID            Signature;                    // PcdDataBaseGuid.
   UINT32          BuildVersion;
@@ -96,7 +103,8 @@ typedef struct {
   UINT16          LocalTokenCount;              // LOCAL_TOKEN_NUMBER for all.
   UINT16          ExTokenCount;                 // EX_TOKEN_NUMBER for DynamicEx.
   UINT16          GuidTableCount;               // The Number of Guid in GuidTable.
-  UINT8           Pad[6];                       // Pad bytes to satisfy the alignment.
+  UINT8           ExMapLayout;                  // PCD_EXMAP_LAYOUT_SORTED if ExMapTable is sorted.
+  UINT8           Pad[5];                       // Pad bytes to satisfy the alignment.
 
   //
   // Default initialized external PCD database binary structure
@@ -139,6 +139,12 @@ typedef struct {
   VARIABLE_STORE_HEADER    *RuntimeHobCache;
   VARIABLE_STORE_HEADER    *RuntimeNvCache;
   VARIABLE_STORE_HEADER    *RuntimeVolatileCache;
+  ///
+  /// Optional, NULL if the caller keeps no state derived from the content of
+  /// the runtime caches. Callers built before this field was added send a
+  /// payload that ends before it.
+  ///
+  UINT32                   *UpdateCount;
 } SMM_VARIABLE_COMMUNICATE_RUNTIME_VARIABLE_CACHE_CONTEXT;
 
 typedef struct {
@@ -0,0 +1,52 @@
+/** @file
+  GUID of the configuration table through which the DXE Core publishes the
+  statistics of its timer event wheel.
+
+  Copyright (c) 2026, TianoCore and contributors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __TIMER_WHEEL_STATISTICS_H__
+#define __TIMER_WHEEL_STATISTICS_H__
+
+#define EDKII_TIMER_WHEEL_STATISTICS_GUID \
+  { \
+    0x6d3a5b8e, 0x0f27, 0x4c41, { 0x9a, 0x58, 0x2e, 0x1b, 0x7c, 0x94, 0xd3, 0x60 } \
+  }
+
+#define EDKII_TIMER_WHEEL_STATISTICS_REVISION  1
+
+typedef struct {
+  UINT32    Revision;
+  UINT32    Reserved;
+  ///
+  /// Number of times the expired timers were processed.
+  ///
+  UINT64    Checks;
+  ///
+  /// Total number of timer events signaled, and the largest number signaled
+  /// by a single check.
+  ///
+  UINT64    TimersFired;
+  UINT64    MaxTimersFiredPerCheck;
+  ///
+  /// Number of timer insertions, and the number of queued timers that were
+  /// compared against while finding the insertion points.
+  ///
+  UINT64    TimersInserted;
+  UINT64    InsertComparisons;
+  UINT64    MaxInsertComparisons;
+  ///
+  /// Number of timers moved from an outer wheel level to an inner one.
+  ///
+  UINT64    TimersCascaded;
+  ///
+  /// Number of timers currently queued.
+  ///
+  UINT64    PendingTimers;
+} EDKII_TIMER_WHEEL_STATISTICS;
+
+extern EFI_GUID  gEdkiiTimerWheelStatisticsGuid;
+
+#endif
@@ -35,6 +35,12 @@ typedef struct {
   /// TRUE indicates all HOB variables have been flushed in flash.
   ///
   BOOLEAN    HobFlushComplete;
+  ///
+  /// Incremented each time variables are moved inside the runtime caches,
+  /// e.g. by a reclaim, so state derived from the location of the variables,
+  /// such as a variable name index, can be discarded.
+  ///
+  UINT32     UpdateCount;
 } CACHE_INFO_FLAG;
 
 typedef struct {
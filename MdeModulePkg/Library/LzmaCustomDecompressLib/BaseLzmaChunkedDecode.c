@@ -0,0 +1,43 @@
+/** @file
+  Decode the blocks of a chunked LZMA stream one after the other.
+
+  This is used in SEC and PEI, and by any module that cannot use other
+  processors.
+
+  Copyright (c) 2026, TianoCore and contributors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "LzmaDecompressLibInternal.h"
+
+/**
+  Look up whatever LzmaDecodeChunkedBlocks() needs to use other processors.
+
+  This instance only uses the current processor.
+**/
+VOID
+LzmaPrepareChunkedDecode (
+  VOID
+  )
+{
+}
+
+/**
+  Decode all blocks of a chunked Lzma stream with LzmaDecodeChunkedBlock().
+
+  @param  Context     The chunked stream being decoded.
+  @param  Scratch     A scratch buffer of SCRATCH_BUFFER_REQUEST_SIZE bytes.
+**/
+VOID
+LzmaDecodeChunkedBlocks (
+  IN OUT LZMA_CHUNKED_CONTEXT  *Context,
+  IN OUT VOID                  *Scratch
+  )
+{
+  UINT32  Index;
+
+  for (Index = 0; (Index < Context->Header->BlockCount) && !Context->Failed; Index++) {
+    LzmaDecodeChunkedBlock (Context, Index, Scratch);
+  }
+}
@@ -0,0 +1,212 @@
+/** @file
+  Decode the blocks of a chunked LZMA stream on all processors.
+
+  Once EFI_MP_SERVICES_PROTOCOL is installed, a decode started on the boot
+  processor hands the blocks out to the application processors, and the
+  boot processor decodes blocks alongside them. The completion of the
+  application processors is signaled from a timer event, so above
+  TPL_APPLICATION the boot processor only decodes the blocks they left.
+  Decodes started on an application processor, or before the protocol is
+  installed, run on the current processor only.
+
+  Copyright (c) 2026, TianoCore and contributors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <PiDxe.h>
+#include <Protocol/MpService.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/SynchronizationLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+
+#include "LzmaDecompressLibInternal.h"
+
+typedef struct {
+  LZMA_CHUNKED_CONTEXT    *Context;
+  //
+  // One SCRATCH_BUFFER_REQUEST_SIZE buffer per processor, indexed by
+  // processor number.
+  //
+  UINT8                   *Scratch;
+  volatile UINT32         NextBlock;
+} LZMA_CHUNKED_QUEUE;
+
+EFI_MP_SERVICES_PROTOCOL  *mLzmaMpServices = NULL;
+UINTN                     mLzmaBspNumber;
+UINTN                     mLzmaNumberOfProcessors;
+
+/**
+  Look up EFI_MP_SERVICES_PROTOCOL and the number of the boot processor.
+
+  This runs on the boot processor, from LzmaChunkedUefiDecompressGetInfo().
+**/
+VOID
+LzmaPrepareChunkedDecode (
+  VOID
+  )
+{
+  EFI_STATUS                Status;
+  EFI_MP_SERVICES_PROTOCOL  *MpServices;
+  UINTN                     NumberOfProcessors;
+  UINTN                     NumberOfEnabledProcessors;
+
+  if ((mLzmaMpServices != NULL) || (gBS == NULL)) {
+    return;
+  }
+
+  Status = gBS->LocateProtocol (&gEfiMpServiceProtocolGuid, NULL, (VOID **)&MpServices);
+  if (EFI_ERROR (Status)) {
+    return;
+  }
+
+  Status = MpServices->GetNumberOfProcessors (MpServices, &NumberOfProcessors, &NumberOfEnabledProcessors);
+  if (EFI_ERROR (Status) || (NumberOfEnabledProcessors < 2)) {
+    return;
+  }
+
+  Status = MpServices->WhoAmI (MpServices, &mLzmaBspNumber);
+  if (EFI_ERROR (Status)) {
+    return;
+  }
+
+  mLzmaNumberOfProcessors = NumberOfProcessors;
+  mLzmaMpServices         = MpServices;
+}
+
+/**
+  Decode blocks from the queue until it is empty.
+
+  This runs on the application processors and on the boot processor.
+
+  @param  Buffer              The LZMA_CHUNKED_QUEUE to work on.
+**/
+VOID
+EFIAPI
+LzmaDecodeChunkedBlocksWorker (
+  IN OUT VOID  *Buffer
+  )
+{
+  LZMA_CHUNKED_QUEUE  *Queue;
+  UINTN               ProcessorNumber;
+  UINT32              Index;
+
+  Queue = (LZMA_CHUNKED_QUEUE *)Buffer;
+  if (EFI_ERROR (mLzmaMpServices->WhoAmI (mLzmaMpServices, &ProcessorNumber)) ||
+      (ProcessorNumber >= mLzmaNumberOfProcessors))
+  {
+    return;
+  }
+
+  while (!Queue->Context->Failed) {
+    Index = InterlockedIncrement (&Queue->NextBlock) - 1;
+    if (Index >= Queue->Context->Header->BlockCount) {
+      break;
+    }
+
+    LzmaDecodeChunkedBlock (
+      Queue->Context,
+      Index,
+      Queue->Scratch + ProcessorNumber * SCRATCH_BUFFER_REQUEST_SIZE
+      );
+  }
+}
+
+/**
+  Decode all blocks of a chunked Lzma stream with LzmaDecodeChunkedBlock().
+
+  @param  Context     The chunked stream being decoded.
+  @param  Scratch     A scratch buffer of SCRATCH_BUFFER_REQUEST_SIZE bytes.
+**/
+VOID
+LzmaDecodeChunkedBlocks (
+  IN OUT LZMA_CHUNKED_CONTEXT  *Context,
+  IN OUT VOID                  *Scratch
+  )
+{
+  EFI_STATUS          Status;
+  LZMA_CHUNKED_QUEUE  Queue;
+  UINTN               ProcessorNumber;
+  UINT32              Index;
+  EFI_TPL             OldTpl;
+  EFI_EVENT           WaitEvent;
+  UINTN               EventIndex;
+
+  Queue.Scratch = NULL;
+  if ((mLzmaMpServices != NULL) && (Context->Header->BlockCount > 1) &&
+      !EFI_ERROR (mLzmaMpServices->WhoAmI (mLzmaMpServices, &ProcessorNumber)) &&
+      (ProcessorNumber == mLzmaBspNumber))
+  {
+    Queue.Scratch = AllocatePool (mLzmaNumberOfProcessors * SCRATCH_BUFFER_REQUEST_SIZE);
+  }
+
+  if (Queue.Scratch == NULL) {
+    for (Index = 0; (Index < Context->Header->BlockCount) && !Context->Failed; Index++) {
+      LzmaDecodeChunkedBlock (Context, Index, Scratch);
+    }
+
+    return;
+  }
+
+  Queue.Context   = Context;
+  Queue.NextBlock = 0;
+
+  //
+  // Start the application processors without waiting for them where the
+  // completion event can be waited on
+  //
+  WaitEvent = NULL;
+  OldTpl    = gBS->RaiseTPL (TPL_HIGH_LEVEL);
+  gBS->RestoreTPL (OldTpl);
+  if (OldTpl == TPL_APPLICATION) {
+    Status = gBS->CreateEvent (0, TPL_NOTIFY, NULL, NULL, &WaitEvent);
+    if (EFI_ERROR (Status)) {
+      WaitEvent = NULL;
+    }
+  }
+
+  Status = mLzmaMpServices->StartupAllAPs (
+                              mLzmaMpServices,
+                              LzmaDecodeChunkedBlocksWorker,
+                              FALSE,
+                              WaitEvent,
+                              0,
+                              &Queue,
+                              NULL
+                              );
+
+  //
+  // Decode blocks alongside the application processors, or everything if
+  // they could not be started.
+  //
+  LzmaDecodeChunkedBlocksWorker (&Queue);
+
+  if (WaitEvent != NULL) {
+    if (!EFI_ERROR (Status)) {
+      gBS->WaitForEvent (1, &WaitEvent, &EventIndex);
+    }
+
+    gBS->CloseEvent (WaitEvent);
+  }
+
+  FreePool (Queue.Scratch);
+}
+
+/**
+  Register the LZMA handlers in a DXE module.
+
+  @param  ImageHandle   The image handle of the module.
+  @param  SystemTable   A pointer to the EFI System Table.
+
+  @retval  RETURN_SUCCESS            Register successfully.
+  @retval  RETURN_OUT_OF_RESOURCES   No enough memory to store this handler.
+**/
+EFI_STATUS
+EFIAPI
+DxeLzmaDecompressLibConstructor (
+  IN EFI_HANDLE        ImageHandle,
+  IN EFI_SYSTEM_TABLE  *SystemTable
+  )
+{
+  return LzmaDecompressLibConstructor ();
+}
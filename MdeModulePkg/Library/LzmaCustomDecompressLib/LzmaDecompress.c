@@ -11,8 +11,6 @@
 #include "Sdk/C/7zVersion.h"
 #include "Sdk/C/LzmaDec.h"
 
-#define SCRATCH_BUFFER_REQUEST_SIZE  SIZE_64KB
-
 typedef struct {
   ISzAlloc    Functions;
   VOID        *Buffer;
@@ -218,3 +216,239 @@ LzmaUefiDecompress (
     return RETURN_INVALID_PARAMETER;
   }
 }
+
+/**
+  Validate the header and the block index of a chunked Lzma stream.
+
+  @param  Source          The source buffer containing the compressed data.
+  @param  SourceSize      The size, in bytes, of the source buffer.
+
+  @retval RETURN_SUCCESS            The header and the index are consistent
+                                    with each other and with SourceSize.
+  @retval RETURN_INVALID_PARAMETER  Source is not a valid chunked Lzma stream.
+  @retval RETURN_UNSUPPORTED        The uncompressed size does not fit in a
+                                    UINT32.
+**/
+STATIC
+RETURN_STATUS
+LzmaChunkedValidate (
+  IN CONST VOID  *Source,
+  IN UINTN       SourceSize
+  )
+{
+  CONST LZMA_CHUNKED_HEADER  *Header;
+  CONST LZMA_CHUNKED_BLOCK   *Blocks;
+  UINTN                      IndexEnd;
+  UINT32                     Index;
+
+  Header = (CONST LZMA_CHUNKED_HEADER *)Source;
+  if ((SourceSize < sizeof (LZMA_CHUNKED_HEADER)) ||
+      (Header->Signature != LZMA_CHUNKED_SIGNATURE) ||
+      (Header->BlockSize == 0) ||
+      (Header->BlockCount > (SourceSize - sizeof (LZMA_CHUNKED_HEADER)) / sizeof (LZMA_CHUNKED_BLOCK)))
+  {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  if (Header->DecodedSize > MAX_UINT32) {
+    return RETURN_UNSUPPORTED;
+  }
+
+  //
+  // DecodedSize fits in a UINT32, so the rounded up sum cannot overflow a UINT64
+  //
+  if (Header->BlockCount != DivU64x32 (Header->DecodedSize + (Header->BlockSize - 1), Header->BlockSize)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  Blocks   = (CONST LZMA_CHUNKED_BLOCK *)(Header + 1);
+  IndexEnd = sizeof (LZMA_CHUNKED_HEADER) + (UINTN)Header->BlockCount * sizeof (LZMA_CHUNKED_BLOCK);
+  for (Index = 0; Index < Header->BlockCount; Index++) {
+    if ((Blocks[Index].Offset < IndexEnd) ||
+        (Blocks[Index].Offset > SourceSize) ||
+        (Blocks[Index].Size < LZMA_HEADER_SIZE) ||
+        (Blocks[Index].Size > SourceSize - Blocks[Index].Offset))
+    {
+      return RETURN_INVALID_PARAMETER;
+    }
+  }
+
+  return RETURN_SUCCESS;
+}
+
+/**
+  Given a chunked Lzma compressed source buffer, this function retrieves the
+  size of the uncompressed buffer and the size of the scratch buffer required
+  to decompress it.
+
+  The index of the blocks is validated against SourceSize, so that
+  LzmaChunkedUefiDecompress() can trust it.
+
+  @param  Source          The source buffer containing the compressed data.
+  @param  SourceSize      The size, in bytes, of the source buffer.
+  @param  DestinationSize A pointer to the size, in bytes, of the uncompressed buffer.
+  @param  ScratchSize     A pointer to the size, in bytes, of the scratch buffer.
+
+  @retval RETURN_SUCCESS            The sizes were returned.
+  @retval RETURN_INVALID_PARAMETER  Source is not a valid chunked Lzma stream.
+  @retval RETURN_UNSUPPORTED        The uncompressed size does not fit in a
+                                    UINT32.
+**/
+RETURN_STATUS
+EFIAPI
+LzmaChunkedUefiDecompressGetInfo (
+  IN  CONST VOID  *Source,
+  IN  UINT32      SourceSize,
+  OUT UINT32      *DestinationSize,
+  OUT UINT32      *ScratchSize
+  )
+{
+  RETURN_STATUS  Status;
+
+  Status = LzmaChunkedValidate (Source, SourceSize);
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  LzmaPrepareChunkedDecode ();
+
+  *DestinationSize = (UINT32)((CONST LZMA_CHUNKED_HEADER *)Source)->DecodedSize;
+  *ScratchSize     = SCRATCH_BUFFER_REQUEST_SIZE;
+  return RETURN_SUCCESS;
+}
+
+/**
+  Decode one block of a chunked Lzma stream into its place in the
+  destination buffer. Context->Failed is set if the block cannot be decoded.
+
+  This only touches the block, its part of the destination buffer and
+  Scratch, so blocks may be decoded concurrently. The block index entry is
+  checked again against the stream, so that a corrupted index cannot make
+  the decoder read or write out of bounds.
+
+  @param  Context     The chunked stream being decoded.
+  @param  BlockIndex  The index of the block to decode.
+  @param  Scratch     A scratch buffer of SCRATCH_BUFFER_REQUEST_SIZE bytes
+                      that no other decoder is using.
+**/
+VOID
+LzmaDecodeChunkedBlock (
+  IN OUT LZMA_CHUNKED_CONTEXT  *Context,
+  IN     UINT32                BlockIndex,
+  IN OUT VOID                  *Scratch
+  )
+{
+  SRes                      LzmaResult;
+  ELzmaStatus               Status;
+  SizeT                     DecodedBufSize;
+  SizeT                     EncodedDataSize;
+  ISzAllocWithData          AllocFuncs;
+  CONST LZMA_CHUNKED_BLOCK  *BlockEntry;
+  UINT8                     *Block;
+  UINT64                    BlockOffset;
+  UINT32                    BlockSize;
+  UINTN                     IndexEnd;
+
+  if (BlockIndex >= Context->Header->BlockCount) {
+    Context->Failed = TRUE;
+    return;
+  }
+
+  BlockEntry = &Context->Blocks[BlockIndex];
+  IndexEnd   = sizeof (LZMA_CHUNKED_HEADER) + (UINTN)Context->Header->BlockCount * sizeof (LZMA_CHUNKED_BLOCK);
+  if ((IndexEnd > Context->SourceSize) ||
+      (BlockEntry->Offset < IndexEnd) ||
+      (BlockEntry->Offset > Context->SourceSize) ||
+      (BlockEntry->Size < LZMA_HEADER_SIZE) ||
+      (BlockEntry->Size > Context->SourceSize - BlockEntry->Offset))
+  {
+    Context->Failed = TRUE;
+    return;
+  }
+
+  //
+  // Every block but the last decodes to BlockSize bytes
+  //
+  BlockOffset = MultU64x32 (BlockIndex, Context->Header->BlockSize);
+  if ((Context->Header->DecodedSize > MAX_UINT32) || (BlockOffset >= Context->Header->DecodedSize)) {
+    Context->Failed = TRUE;
+    return;
+  }
+
+  BlockSize = (UINT32)MIN (Context->Header->BlockSize, Context->Header->DecodedSize - BlockOffset);
+  Block     = (UINT8 *)Context->Header + BlockEntry->Offset;
+
+  AllocFuncs.Functions.Alloc = SzAlloc;
+  AllocFuncs.Functions.Free  = SzFree;
+  AllocFuncs.Buffer          = Scratch;
+  AllocFuncs.BufferSize      = SCRATCH_BUFFER_REQUEST_SIZE;
+
+  if (GetDecodedSizeOfBuf (Block) != BlockSize) {
+    Context->Failed = TRUE;
+    return;
+  }
+
+  DecodedBufSize  = (SizeT)BlockSize;
+  EncodedDataSize = (SizeT)(BlockEntry->Size - LZMA_HEADER_SIZE);
+
+  LzmaResult = LzmaDecode (
+                 Context->Destination + (UINTN)BlockOffset,
+                 &DecodedBufSize,
+                 Block + LZMA_HEADER_SIZE,
+                 &EncodedDataSize,
+                 Block,
+                 LZMA_PROPS_SIZE,
+                 LZMA_FINISH_END,
+                 &Status,
+                 &(AllocFuncs.Functions)
+                 );
+
+  if ((LzmaResult != SZ_OK) || (DecodedBufSize != BlockSize)) {
+    Context->Failed = TRUE;
+  }
+}
+
+/**
+  Decompresses a chunked Lzma compressed source buffer.
+
+  The blocks are decoded by LzmaDecodeChunkedBlocks(), which may spread them
+  over several processors.
+
+  @param  Source      The source buffer containing the compressed data. It
+                      must have been validated by LzmaChunkedUefiDecompressGetInfo().
+  @param  SourceSize  The size of source buffer.
+  @param  Destination The destination buffer to store the decompressed data
+  @param  Scratch     A temporary scratch buffer of the size returned by
+                      LzmaChunkedUefiDecompressGetInfo().
+
+  @retval  RETURN_SUCCESS Decompression completed successfully, and
+                          the uncompressed buffer is returned in Destination.
+  @retval  RETURN_INVALID_PARAMETER
+                          The source buffer specified by Source is corrupted
+                          (not in a valid compressed format).
+**/
+RETURN_STATUS
+EFIAPI
+LzmaChunkedUefiDecompress (
+  IN CONST VOID  *Source,
+  IN UINTN       SourceSize,
+  IN OUT VOID    *Destination,
+  IN OUT VOID    *Scratch
+  )
+{
+  LZMA_CHUNKED_CONTEXT  Context;
+
+  if (RETURN_ERROR (LzmaChunkedValidate (Source, SourceSize))) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  Context.Header      = (CONST LZMA_CHUNKED_HEADER *)Source;
+  Context.Blocks      = (CONST LZMA_CHUNKED_BLOCK *)(Context.Header + 1);
+  Context.SourceSize  = SourceSize;
+  Context.Destination = Destination;
+  Context.Failed      = FALSE;
+
+  LzmaDecodeChunkedBlocks (&Context, Scratch);
+
+  return Context.Failed ? RETURN_INVALID_PARAMETER : RETURN_SUCCESS;
+}
@@ -17,6 +17,26 @@
 #include <Library/ExtractGuidedSectionLib.h>
 #include <Guid/LzmaDecompress.h>
 
+//
+// Size of the scratch buffer one LZMA decoder needs.
+//
+#define SCRATCH_BUFFER_REQUEST_SIZE  SIZE_64KB
+
+///
+/// State shared by the decoders of the blocks of a chunked LZMA stream.
+///
+typedef struct {
+  CONST LZMA_CHUNKED_HEADER    *Header;
+  CONST LZMA_CHUNKED_BLOCK     *Blocks;
+  UINTN                        SourceSize;
+  UINT8                        *Destination;
+  //
+  // Set by any decoder that fails. It is only ever set, never cleared, so
+  // concurrent decoders may write it without synchronization.
+  //
+  volatile BOOLEAN             Failed;
+} LZMA_CHUNKED_CONTEXT;
+
 /**
   Given a Lzma compressed source buffer, this function retrieves the size of
   the uncompressed buffer and the size of the scratch buffer required
@@ -91,4 +111,117 @@ LzmaUefiDecompress (
   IN OUT VOID    *Scratch
   );
 
+/**
+  Given a chunked Lzma compressed source buffer, this function retrieves the
+  size of the uncompressed buffer and the size of the scratch buffer required
+  to decompress it.
+
+  The index of the blocks is validated against SourceSize, so that
+  LzmaChunkedUefiDecompress() can trust it.
+
+  @param  Source          The source buffer containing the compressed data.
+  @param  SourceSize      The size, in bytes, of the source buffer.
+  @param  DestinationSize A pointer to the size, in bytes, of the uncompressed buffer.
+  @param  ScratchSize     A pointer to the size, in bytes, of the scratch buffer.
+
+  @retval RETURN_SUCCESS            The sizes were returned.
+  @retval RETURN_INVALID_PARAMETER  Source is not a valid chunked Lzma stream.
+  @retval RETURN_UNSUPPORTED        The uncompressed size does not fit in a
+                                    UINT32.
+**/
+RETURN_STATUS
+EFIAPI
+LzmaChunkedUefiDecompressGetInfo (
+  IN  CONST VOID  *Source,
+  IN  UINT32      SourceSize,
+  OUT UINT32      *DestinationSize,
+  OUT UINT32      *ScratchSize
+  );
+
+/**
+  Decompresses a chunked Lzma compressed source buffer.
+
+  The blocks are decoded by LzmaDecodeChunkedBlocks(), which may spread them
+  over several processors.
+
+  @param  Source      The source buffer containing the compressed data. It
+                      must have been validated by LzmaChunkedUefiDecompressGetInfo().
+  @param  SourceSize  The size of source buffer.
+  @param  Destination The destination buffer to store the decompressed data
+  @param  Scratch     A temporary scratch buffer of the size returned by
+                      LzmaChunkedUefiDecompressGetInfo().
+
+  @retval  RETURN_SUCCESS Decompression completed successfully, and
+                          the uncompressed buffer is returned in Destination.
+  @retval  RETURN_INVALID_PARAMETER
+                          The source buffer specified by Source is corrupted
+                          (not in a valid compressed format).
+**/
+RETURN_STATUS
+EFIAPI
+LzmaChunkedUefiDecompress (
+  IN CONST VOID  *Source,
+  IN UINTN       SourceSize,
+  IN OUT VOID    *Destination,
+  IN OUT VOID    *Scratch
+  );
+
+/**
+  Decode one block of a chunked Lzma stream into its place in the
+  destination buffer. Context->Failed is set if the block cannot be decoded.
+
+  This only touches the block, its part of the destination buffer and
+  Scratch, so blocks may be decoded concurrently.
+
+  @param  Context     The chunked stream being decoded.
+  @param  BlockIndex  The index of the block to decode.
+  @param  Scratch     A scratch buffer of SCRATCH_BUFFER_REQUEST_SIZE bytes
+                      that no other decoder is using.
+**/
+VOID
+LzmaDecodeChunkedBlock (
+  IN OUT LZMA_CHUNKED_CONTEXT  *Context,
+  IN     UINT32                BlockIndex,
+  IN OUT VOID                  *Scratch
+  );
+
+/**
+  Register LzmaDecompress and LzmaDecompressGetInfo handlers with LzmaCustomerDecompressGuid
+  and LzmaChunkedCustomDecompressGuid.
+
+  @retval  RETURN_SUCCESS            Register successfully.
+  @retval  RETURN_OUT_OF_RESOURCES   No enough memory to store this handler.
+**/
+EFI_STATUS
+EFIAPI
+LzmaDecompressLibConstructor (
+  VOID
+  );
+
+/**
+  Look up whatever LzmaDecodeChunkedBlocks() needs to use other processors.
+
+  It is called by LzmaChunkedUefiDecompressGetInfo(), which callers run on
+  the boot processor before they allocate the buffers for a decode.
+**/
+VOID
+LzmaPrepareChunkedDecode (
+  VOID
+  );
+
+/**
+  Decode all blocks of a chunked Lzma stream with LzmaDecodeChunkedBlock().
+
+  Each library instance provides its own implementation, depending on
+  whether it can use other processors.
+
+  @param  Context     The chunked stream being decoded.
+  @param  Scratch     A scratch buffer of SCRATCH_BUFFER_REQUEST_SIZE bytes.
+**/
+VOID
+LzmaDecodeChunkedBlocks (
+  IN OUT LZMA_CHUNKED_CONTEXT  *Context,
+  IN OUT VOID                  *Scratch
+  );
+
 #endif
@@ -0,0 +1,31 @@
+/** @file
+  Implements for functions declared in ZstdDecUefiSupport.h
+
+  Copyright (c) 2026, TianoCore and contributors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+#include <ZstdDecUefiSupport.h>
+
+/**
+  Dummy malloc function for compiler.
+**/
+VOID *
+ZstdDummyMalloc (
+  IN size_t  Size
+  )
+{
+  ASSERT (FALSE);
+  return NULL;
+}
+
+/**
+  Dummy free function for compiler.
+**/
+VOID
+ZstdDummyFree (
+  IN VOID  *Ptr
+  )
+{
+  ASSERT (FALSE);
+}
@@ -0,0 +1,141 @@
+/** @file
+  ZSTD UEFI header file for definitions
+
+  Allows ZSTD code to build under UEFI (edk2) build environment. The libc
+  headers that zstd includes resolve to this file, which also provides the
+  ZSTD_memcpy()/ZSTD_malloc() family of zstd_deps.h on top of BaseMemoryLib.
+
+  Copyright (c) 2026, TianoCore and contributors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __ZSTD_DECOMPRESS_UEFI_SUP_H__
+#define __ZSTD_DECOMPRESS_UEFI_SUP_H__
+
+#include <Base.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+
+typedef INT8     int8_t;
+typedef INT16    int16_t;
+typedef INT32    int32_t;
+typedef INT64    int64_t;
+typedef UINT8    uint8_t;
+typedef UINT16   uint16_t;
+typedef UINT32   uint32_t;
+typedef UINT64   uint64_t;
+typedef UINTN    size_t;
+typedef INTN     ptrdiff_t;
+typedef INTN     intptr_t;
+typedef UINTN    uintptr_t;
+
+#define CHAR_BIT    8
+#define SCHAR_MIN   MIN_INT8
+#define SCHAR_MAX   MAX_INT8
+#define UCHAR_MAX   MAX_UINT8
+#define SHRT_MIN    MIN_INT16
+#define SHRT_MAX    MAX_INT16
+#define USHRT_MAX   MAX_UINT16
+#define INT_MIN     MIN_INT32
+#define INT_MAX     MAX_INT32
+#define UINT_MAX    MAX_UINT32
+#define LLONG_MIN   MIN_INT64
+#define LLONG_MAX   MAX_INT64
+#define ULLONG_MAX  MAX_UINT64
+#define SIZE_MAX    MAX_UINTN
+
+#define offsetof(TYPE, Field)  OFFSET_OF (TYPE, Field)
+
+#if defined (_MSC_VER)
+//
+// Used by the bit counting helpers of zstd in place of <intrin.h>.
+//
+unsigned char
+_BitScanForward (
+  unsigned long  *Index,
+  unsigned long  Mask
+  );
+
+unsigned char
+_BitScanReverse (
+  unsigned long  *Index,
+  unsigned long  Mask
+  );
+
+  #pragma intrinsic(_BitScanForward, _BitScanReverse)
+
+  #if defined (_WIN64)
+unsigned char
+_BitScanForward64 (
+  unsigned long     *Index,
+  unsigned __int64  Mask
+  );
+
+unsigned char
+_BitScanReverse64 (
+  unsigned long     *Index,
+  unsigned __int64  Mask
+  );
+
+    #pragma intrinsic(_BitScanForward64, _BitScanReverse64)
+  #endif
+#endif
+
+//
+// zstd defines its own RETURN_ERROR() and BITn in its internal headers.
+//
+#undef RETURN_ERROR
+#undef BIT0
+#undef BIT1
+#undef BIT4
+#undef BIT5
+#undef BIT6
+#undef BIT7
+
+//
+// Replace the libc based definitions of zstd_deps.h, which the INF disables with
+// ZSTD_DEPS_COMMON and ZSTD_DEPS_MALLOC. Copies of a small constant size, such
+// as the unaligned loads and the 8/16 byte copies of the sequence execution
+// loop, are left to the compiler so that they are inlined.
+//
+#if defined (__GNUC__) || defined (__clang__)
+#define ZSTD_memcpy(d, s, l) \
+  ((__builtin_constant_p (l) && (l) <= 16) ? __builtin_memcpy ((d), (s), (l)) : CopyMem ((d), (s), (l)))
+#define ZSTD_memset(p, v, l) \
+  ((__builtin_constant_p (l) && (l) <= 16) ? __builtin_memset ((p), (v), (l)) : SetMem ((p), (l), (UINT8)(v)))
+#else
+#define ZSTD_memcpy(d, s, l)  CopyMem ((d), (s), (l))
+#define ZSTD_memset(p, v, l)  SetMem ((p), (l), (UINT8)(v))
+#endif
+
+#define ZSTD_memmove(d, s, l)  CopyMem ((d), (s), (l))
+
+//
+// The decoder works in the context placed in the caller's scratch buffer by
+// ZSTD_initStaticDCtx(), so it never allocates memory.
+//
+#define ZSTD_malloc(s)     ZstdDummyMalloc (s)
+#define ZSTD_calloc(n, s)  ZstdDummyMalloc ((n) * (s))
+#define ZSTD_free(p)       ZstdDummyFree (p)
+
+//
+// xxhash.h calls the libc memory functions directly. Its malloc() and free()
+// users are compiled out by XXH_NO_STDLIB.
+//
+#define memcpy   CopyMem
+#define memmove  CopyMem
+#define memset(dest, ch, count)  SetMem(dest,(UINTN)(count),(UINT8)(ch))
+
+VOID *
+ZstdDummyMalloc (
+  IN size_t  Size
+  );
+
+VOID
+ZstdDummyFree (
+  IN VOID  *Ptr
+  );
+
+#endif
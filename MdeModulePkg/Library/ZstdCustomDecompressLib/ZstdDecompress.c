@@ -0,0 +1,154 @@
+/** @file
+  Zstd Decompress interfaces
+
+  Copyright (c) 2026, TianoCore and contributors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+#include <ZstdDecompressLibInternal.h>
+
+/**
+  Get the size of the uncompressed buffer from the frame headers of the
+  compressed data.
+
+  ZstdCompress records the size of the input in the frame header, so the size
+  can be retrieved without decoding. Frames that do not record their size are
+  rejected, because the size of the output buffer must be known up front.
+
+  @param  Source      The source buffer containing the compressed data.
+  @param  SourceSize  The size, in bytes, of the source buffer.
+  @param  DecodedSize A pointer to the size, in bytes, of the uncompressed buffer.
+
+  @retval RETURN_SUCCESS            The size was returned in DecodedSize.
+  @retval RETURN_INVALID_PARAMETER  The size can not be retrieved or does not
+                                    fit in a GUIDed section.
+**/
+STATIC
+RETURN_STATUS
+ZstdGetDecodedSize (
+  IN  CONST VOID  *Source,
+  IN  UINTN       SourceSize,
+  OUT UINT32      *DecodedSize
+  )
+{
+  UINT64  FrameContentSize;
+
+  FrameContentSize = ZSTD_findDecompressedSize (Source, SourceSize);
+  if ((FrameContentSize == ZSTD_CONTENTSIZE_ERROR) ||
+      (FrameContentSize == ZSTD_CONTENTSIZE_UNKNOWN) ||
+      (FrameContentSize > MAX_UINT32))
+  {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  *DecodedSize = (UINT32)FrameContentSize;
+  return RETURN_SUCCESS;
+}
+
+/**
+  Given a Zstd compressed source buffer, this function retrieves the size of
+  the uncompressed buffer and the size of the scratch buffer required
+  to decompress the compressed source buffer.
+
+  Retrieves the size of the uncompressed buffer and the temporary scratch buffer
+  required to decompress the buffer specified by Source and SourceSize.
+  The size of the uncompressed buffer is returned in DestinationSize,
+  the size of the scratch buffer is returned in ScratchSize, and RETURN_SUCCESS is returned.
+  The size of the uncompressed buffer is the sum of the "Frame_Content_Size" fields of
+  the frames in the source data. The scratch buffer holds the decoder context, whose
+  size does not depend on the source data.
+
+  @param  Source          The source buffer containing the compressed data.
+  @param  SourceSize      The size, in bytes, of the source buffer.
+  @param  DestinationSize A pointer to the size, in bytes, of the uncompressed buffer
+                          that will be generated when the compressed buffer specified
+                          by Source and SourceSize is decompressed.
+  @param  ScratchSize     A pointer to the size, in bytes, of the scratch buffer that
+                          is required to decompress the compressed buffer specified
+                          by Source and SourceSize.
+
+  @retval RETURN_SUCCESS  The size of the uncompressed data was returned
+                          in DestinationSize and the size of the scratch
+                          buffer was returned in ScratchSize.
+  @retval RETURN_INVALID_PARAMETER
+                          The size of the uncompressed data can not be
+                          retrieved from the source buffer.
+**/
+RETURN_STATUS
+EFIAPI
+ZstdUefiDecompressGetInfo (
+  IN  CONST VOID  *Source,
+  IN  UINT32      SourceSize,
+  OUT UINT32      *DestinationSize,
+  OUT UINT32      *ScratchSize
+  )
+{
+  RETURN_STATUS  Status;
+
+  Status = ZstdGetDecodedSize (Source, SourceSize, DestinationSize);
+  if (Status != RETURN_SUCCESS) {
+    return Status;
+  }
+
+  *ScratchSize = (UINT32)ZSTD_estimateDCtxSize ();
+  return RETURN_SUCCESS;
+}
+
+/**
+  Decompresses a Zstd compressed source buffer.
+
+  Extracts decompressed data to its original form.
+  If the compressed source data specified by Source is successfully decompressed
+  into Destination, then RETURN_SUCCESS is returned.  If the compressed source data
+  specified by Source is not in a valid compressed data format,
+  then RETURN_INVALID_PARAMETER is returned.
+
+  The frames are decoded in a single pass straight into Destination, so no
+  window buffer is needed besides the decoder context in Scratch.
+
+  @param  Source      The source buffer containing the compressed data.
+  @param  SourceSize  The size of source buffer.
+  @param  Destination The destination buffer to store the decompressed data
+  @param  Scratch     A temporary scratch buffer that is used to perform the decompression.
+                      It must be 8 byte aligned and at least as large as the ScratchSize
+                      returned by ZstdUefiDecompressGetInfo().
+
+  @retval RETURN_SUCCESS Decompression completed successfully, and
+                      the uncompressed buffer is returned in Destination.
+  @retval RETURN_INVALID_PARAMETER
+                      The source buffer specified by Source is corrupted
+                      (not in a valid compressed format).
+**/
+RETURN_STATUS
+EFIAPI
+ZstdUefiDecompress (
+  IN CONST VOID  *Source,
+  IN UINTN       SourceSize,
+  IN OUT VOID    *Destination,
+  IN OUT VOID    *Scratch
+  )
+{
+  RETURN_STATUS  Status;
+  UINT32         DecodedSize;
+  ZSTD_DCtx      *DCtx;
+  size_t         Result;
+
+  Status = ZstdGetDecodedSize (Source, SourceSize, &DecodedSize);
+  if (Status != RETURN_SUCCESS) {
+    return Status;
+  }
+
+  DCtx = ZSTD_initStaticDCtx (Scratch, ZSTD_estimateDCtxSize ());
+  if (DCtx == NULL) {
+    ASSERT (DCtx != NULL);
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  Result = ZSTD_decompressDCtx (DCtx, Destination, DecodedSize, Source, SourceSize);
+  if (ZSTD_isError (Result) || (Result != DecodedSize)) {
+    DEBUG ((DEBUG_ERROR, "%a: Zstd error %u\n", __func__, (UINT32)ZSTD_getErrorCode (Result)));
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  return RETURN_SUCCESS;
+}
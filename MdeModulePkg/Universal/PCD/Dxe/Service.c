@@ -1568,6 +1568,63 @@ SetHiiVariable (
   return Status;
 }
 
+/**
+  Look up a dynamic-ex PCD in the ExMapTable of a PCD database.
+
+  The table is binary searched when the build tool recorded it as sorted by
+  {ExGuidIndex, ExTokenNumber}, and scanned linearly otherwise.
+
+  @param Database        PCD database holding the ExMapTable.
+  @param GuidTableIdx    Index of the token space guid in the GuidTable.
+  @param ExTokenNumber   Dynamic-ex PCD token number.
+
+  @return Token Number for dynamic-ex PCD, or PCD_INVALID_TOKEN_NUMBER if not found.
+
+**/
+UINTN
+LookupExMapTable (
+  IN PCD_DATABASE_INIT  *Database,
+  IN UINTN              GuidTableIdx,
+  IN UINTN              ExTokenNumber
+  )
+{
+  DYNAMICEX_MAPPING  *ExMap;
+  UINTN              Index;
+  UINTN              Low;
+  UINTN              High;
+
+  ExMap = (DYNAMICEX_MAPPING *)((UINT8 *)Database + Database->ExMapTableOffset);
+
+  if (Database->ExMapLayout != PCD_EXMAP_LAYOUT_SORTED) {
+    for (Index = 0; Index < Database->ExTokenCount; Index++) {
+      if ((ExTokenNumber == ExMap[Index].ExTokenNumber) &&
+          (GuidTableIdx == ExMap[Index].ExGuidIndex))
+      {
+        return ExMap[Index].TokenNumber;
+      }
+    }
+
+    return PCD_INVALID_TOKEN_NUMBER;
+  }
+
+  Low  = 0;
+  High = Database->ExTokenCount;
+  while (Low < High) {
+    Index = Low + (High - Low) / 2;
+    if ((ExMap[Index].ExGuidIndex < GuidTableIdx) ||
+        ((ExMap[Index].ExGuidIndex == GuidTableIdx) && (ExMap[Index].ExTokenNumber < ExTokenNumber)))
+    {
+      Low = Index + 1;
+    } else if ((ExMap[Index].ExGuidIndex == GuidTableIdx) && (ExMap[Index].ExTokenNumber == ExTokenNumber)) {
+      return ExMap[Index].TokenNumber;
+    } else {
+      High = Index;
+    }
+  }
+
+  return PCD_INVALID_TOKEN_NUMBER;
+}
+
 /**
   Get Token Number according to dynamic-ex PCD's {token space guid:token number}
 
@@ -1587,14 +1644,12 @@ GetExPcdTokenNumber (
   IN UINT32          ExTokenNumber
   )
 {
-  UINT32             Index;
-  DYNAMICEX_MAPPING  *ExMap;
-  EFI_GUID           *GuidTable;
-  EFI_GUID           *MatchGuid;
-  UINTN              MatchGuidIdx;
+  UINTN     TokenNumber;
+  EFI_GUID  *GuidTable;
+  EFI_GUID  *MatchGuid;
+  UINTN     MatchGuidIdx;
 
   if (!mPeiDatabaseEmpty) {
-    ExMap     = (DYNAMICEX_MAPPING *)((UINT8 *)mPcdDatabase.PeiDb + mPcdDatabase.PeiDb->ExMapTableOffset);
     GuidTable = (EFI_GUID *)((UINT8 *)mPcdDatabase.PeiDb + mPcdDatabase.PeiDb->GuidTableOffset);
 
     MatchGuid = ScanGuid (GuidTable, mPeiGuidTableSize, Guid);
@@ -1602,17 +1657,13 @@ GetExPcdTokenNumber (
     if (MatchGuid != NULL) {
       MatchGuidIdx = MatchGuid - GuidTable;
 
-      for (Index = 0; Index < mPcdDatabase.PeiDb->ExTokenCount; Index++) {
-        if ((ExTokenNumber == ExMap[Index].ExTokenNumber) &&
-            (MatchGuidIdx == ExMap[Index].ExGuidIndex))
-        {
-          return ExMap[Index].TokenNumber;
-        }
+      TokenNumber = LookupExMapTable (mPcdDatabase.PeiDb, MatchGuidIdx, ExTokenNumber);
+      if (TokenNumber != PCD_INVALID_TOKEN_NUMBER) {
+        return TokenNumber;
       }
     }
   }
 
-  ExMap     = (DYNAMICEX_MAPPING *)((UINT8 *)mPcdDatabase.DxeDb + mPcdDatabase.DxeDb->ExMapTableOffset);
   GuidTable = (EFI_GUID *)((UINT8 *)mPcdDatabase.DxeDb + mPcdDatabase.DxeDb->GuidTableOffset);
 
   MatchGuid = ScanGuid (GuidTable, mDxeGuidTableSize, Guid);
@@ -1624,12 +1675,9 @@ GetExPcdTokenNumber (
 
   MatchGuidIdx = MatchGuid - GuidTable;
 
-  for (Index = 0; Index < mPcdDatabase.DxeDb->ExTokenCount; Index++) {
-    if ((ExTokenNumber == ExMap[Index].ExTokenNumber) &&
-        (MatchGuidIdx == ExMap[Index].ExGuidIndex))
-    {
-      return ExMap[Index].TokenNumber;
-    }
+  TokenNumber = LookupExMapTable (mPcdDatabase.DxeDb, MatchGuidIdx, ExTokenNumber);
+  if (TokenNumber != PCD_INVALID_TOKEN_NUMBER) {
+    return TokenNumber;
   }
 
   DEBUG ((DEBUG_ERROR, "%a: Failed to find PCD with GUID: %g and token number: %d\n", __func__, Guid, ExTokenNumber));
@@ -959,6 +959,63 @@ GetWorker (
   return NULL;
 }
 
+/**
+  Look up a dynamic-ex PCD in the ExMapTable of a PCD database.
+
+  The table is binary searched when the build tool recorded it as sorted by
+  {ExGuidIndex, ExTokenNumber}, and scanned linearly otherwise.
+
+  @param Database        PCD database holding the ExMapTable.
+  @param GuidTableIdx    Index of the token space guid in the GuidTable.
+  @param ExTokenNumber   Dynamic-ex PCD token number.
+
+  @return Token Number for dynamic-ex PCD, or PCD_INVALID_TOKEN_NUMBER if not found.
+
+**/
+UINTN
+LookupExMapTable (
+  IN PCD_DATABASE_INIT  *Database,
+  IN UINTN              GuidTableIdx,
+  IN UINTN              ExTokenNumber
+  )
+{
+  DYNAMICEX_MAPPING  *ExMap;
+  UINTN              Index;
+  UINTN              Low;
+  UINTN              High;
+
+  ExMap = (DYNAMICEX_MAPPING *)((UINT8 *)Database + Database->ExMapTableOffset);
+
+  if (Database->ExMapLayout != PCD_EXMAP_LAYOUT_SORTED) {
+    for (Index = 0; Index < Database->ExTokenCount; Index++) {
+      if ((ExTokenNumber == ExMap[Index].ExTokenNumber) &&
+          (GuidTableIdx == ExMap[Index].ExGuidIndex))
+      {
+        return ExMap[Index].TokenNumber;
+      }
+    }
+
+    return PCD_INVALID_TOKEN_NUMBER;
+  }
+
+  Low  = 0;
+  High = Database->ExTokenCount;
+  while (Low < High) {
+    Index = Low + (High - Low) / 2;
+    if ((ExMap[Index].ExGuidIndex < GuidTableIdx) ||
+        ((ExMap[Index].ExGuidIndex == GuidTableIdx) && (ExMap[Index].ExTokenNumber < ExTokenNumber)))
+    {
+      Low = Index + 1;
+    } else if ((ExMap[Index].ExGuidIndex == GuidTableIdx) && (ExMap[Index].ExTokenNumber == ExTokenNumber)) {
+      return ExMap[Index].TokenNumber;
+    } else {
+      High = Index;
+    }
+  }
+
+  return PCD_INVALID_TOKEN_NUMBER;
+}
+
 /**
   Get Token Number according to dynamic-ex PCD's {token space guid:token number}
 
@@ -978,16 +1035,13 @@ GetExPcdTokenNumber (
   IN UINTN           ExTokenNumber
   )
 {
-  UINT32             Index;
-  DYNAMICEX_MAPPING  *ExMap;
-  EFI_GUID           *GuidTable;
-  EFI_GUID           *MatchGuid;
-  UINTN              MatchGuidIdx;
-  PEI_PCD_DATABASE   *PeiPcdDb;
+  EFI_GUID          *GuidTable;
+  EFI_GUID          *MatchGuid;
+  UINTN             MatchGuidIdx;
+  PEI_PCD_DATABASE  *PeiPcdDb;
 
   PeiPcdDb = GetPcdDatabase ();
 
-  ExMap     = (DYNAMICEX_MAPPING *)((UINT8 *)PeiPcdDb + PeiPcdDb->ExMapTableOffset);
   GuidTable = (EFI_GUID *)((UINT8 *)PeiPcdDb + PeiPcdDb->GuidTableOffset);
 
   MatchGuid = ScanGuid (GuidTable, PeiPcdDb->GuidTableCount * sizeof (EFI_GUID), Guid);
@@ -999,15 +1053,7 @@ GetExPcdTokenNumber (
 
   MatchGuidIdx = MatchGuid - GuidTable;
 
-  for (Index = 0; Index < PeiPcdDb->ExTokenCount; Index++) {
-    if ((ExTokenNumber == ExMap[Index].ExTokenNumber) &&
-        (MatchGuidIdx == ExMap[Index].ExGuidIndex))
-    {
-      return ExMap[Index].TokenNumber;
-    }
-  }
-
-  return PCD_INVALID_TOKEN_NUMBER;
+  return LookupExMapTable (PeiPcdDb, MatchGuidIdx, ExTokenNumber);
 }
 
 /**
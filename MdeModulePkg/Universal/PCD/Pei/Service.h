@@ -969,6 +969,26 @@ typedef struct {
   UINT32    LocalTokenNumberAlias;
 } EX_PCD_ENTRY_ATTRIBUTE;
 
+/**
+  Look up a dynamic-ex PCD in the ExMapTable of a PCD database.
+
+  The table is binary searched when the build tool recorded it as sorted by
+  {ExGuidIndex, ExTokenNumber}, and scanned linearly otherwise.
+
+  @param Database        PCD database holding the ExMapTable.
+  @param GuidTableIdx    Index of the token space guid in the GuidTable.
+  @param ExTokenNumber   Dynamic-ex PCD token number.
+
+  @return Token Number for dynamic-ex PCD, or PCD_INVALID_TOKEN_NUMBER if not found.
+
+**/
+UINTN
+LookupExMapTable (
+  IN PCD_DATABASE_INIT  *Database,
+  IN UINTN              GuidTableIdx,
+  IN UINTN              ExTokenNumber
+  );
+
 /**
   Get Token Number according to dynamic-ex PCD's {token space guid:token number}
 
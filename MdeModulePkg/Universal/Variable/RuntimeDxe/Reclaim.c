@@ -9,6 +9,12 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include "Variable.h"
 
+//
+// Granularity at which a reclaimed variable store is compared with the
+// current content of the store.
+//
+#define VARIABLE_SPACE_COMPARE_SIZE  128
+
 /**
   Gets LBA of block and offset by given address.
 
@@ -91,9 +97,13 @@ GetLbaAndOffsetByAddress (
   This function writes a buffer to variable storage space into a firmware
   volume block device. The destination is specified by parameter
   VariableBase. Fault Tolerant Write protocol is used for writing.
+  Only the range [Offset, Offset + Length) of the variable store is written,
+  the rest of the store must already match VariableBuffer.
 
   @param  VariableBase   Base address of variable to write
   @param  VariableBuffer Point to the variable data buffer.
+  @param  Offset         Offset of the range to write from the start of the variable store.
+  @param  Length         Length of the range to write.
 
   @retval EFI_SUCCESS    The function completed successfully.
   @retval EFI_NOT_FOUND  Fail to locate Fault Tolerant Write protocol.
@@ -103,7 +113,9 @@ GetLbaAndOffsetByAddress (
 EFI_STATUS
 FtwVariableSpace (
   IN EFI_PHYSICAL_ADDRESS   VariableBase,
-  IN VARIABLE_STORE_HEADER  *VariableBuffer
+  IN VARIABLE_STORE_HEADER  *VariableBuffer,
+  IN UINTN                  Offset,
+  IN UINTN                  Length
   )
 {
   EFI_STATUS                         Status;
@@ -132,26 +144,78 @@ FtwVariableSpace (
   //
   // Get LBA and Offset by address.
   //
-  Status = GetLbaAndOffsetByAddress (VariableBase, &VarLba, &VarOffset);
+  Status = GetLbaAndOffsetByAddress (VariableBase + Offset, &VarLba, &VarOffset);
   if (EFI_ERROR (Status)) {
     return EFI_ABORTED;
   }
 
   FtwBufferSize = ((VARIABLE_STORE_HEADER *)((UINTN)VariableBase))->Size;
   ASSERT (FtwBufferSize == VariableBuffer->Size);
+  ASSERT (Offset + Length <= FtwBufferSize);
 
   //
   // FTW write record.
   //
   Status = FtwProtocol->Write (
                           FtwProtocol,
-                          VarLba,                // LBA
-                          VarOffset,             // Offset
-                          FtwBufferSize,         // NumBytes
-                          NULL,                  // PrivateData NULL
-                          FvbHandle,             // Fvb Handle
-                          (VOID *)VariableBuffer // write buffer
+                          VarLba,                          // LBA
+                          VarOffset,                       // Offset
+                          Length,                          // NumBytes
+                          NULL,                            // PrivateData NULL
+                          FvbHandle,                       // Fvb Handle
+                          (UINT8 *)VariableBuffer + Offset // write buffer
                           );
 
   return Status;
 }
+
+/**
+  Get the range of a variable store that differs from a new image of the store.
+
+  Reclaim keeps the variables in front of the first deleted one in place and
+  leaves the free space past the last variable untouched, so usually only a
+  part of the store has to be rewritten.
+
+  @param  VariableStore  Pointer to the current content of the variable store.
+  @param  VariableBuffer Pointer to the new image of the variable store.
+  @param  Offset         Returns the offset of the range from the start of the variable store.
+  @param  Length         Returns the length of the range, 0 if the store does not change.
+
+**/
+VOID
+GetVariableSpaceChangedRange (
+  IN  VARIABLE_STORE_HEADER  *VariableStore,
+  IN  VARIABLE_STORE_HEADER  *VariableBuffer,
+  OUT UINTN                  *Offset,
+  OUT UINTN                  *Length
+  )
+{
+  UINTN  Start;
+  UINTN  End;
+  UINTN  Size;
+
+  ASSERT (VariableStore->Size == VariableBuffer->Size);
+
+  Start = 0;
+  while (Start < VariableBuffer->Size) {
+    Size = MIN (VARIABLE_SPACE_COMPARE_SIZE, VariableBuffer->Size - Start);
+    if (CompareMem ((UINT8 *)VariableStore + Start, (UINT8 *)VariableBuffer + Start, Size) != 0) {
+      break;
+    }
+
+    Start += Size;
+  }
+
+  End = VariableBuffer->Size;
+  while (End > Start) {
+    Size = MIN (VARIABLE_SPACE_COMPARE_SIZE, End - Start);
+    if (CompareMem ((UINT8 *)VariableStore + End - Size, (UINT8 *)VariableBuffer + End - Size, Size) != 0) {
+      break;
+    }
+
+    End -= Size;
+  }
+
+  *Offset = Start;
+  *Length = End - Start;
+}
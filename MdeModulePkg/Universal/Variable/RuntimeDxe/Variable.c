@@ -501,6 +501,11 @@ InitializeVariableQuota (
 
   Variable store garbage collection and reclaim operation.
 
+  Variables are compacted in a memory image of the store. For the
+  non-volatile store only the range of the store that differs from that
+  image is then rewritten through FTW, the variables in front of the first
+  deleted one and the free space past the last one are left alone.
+
   @param[in]      VariableBase            Base address of variable store.
   @param[out]     LastVariableOffset      Offset of last variable.
   @param[in]      IsVolatile              The variable store is volatile or not;
@@ -545,7 +550,12 @@ Reclaim (
   VARIABLE_HEADER        *UpdatingVariable;
   VARIABLE_HEADER        *UpdatingInDeletedTransition;
   BOOLEAN                AuthFormat;
+  UINTN                  BytesMoved;
+  UINTN                  BytesWritten;
+  UINTN                  WriteOffset;
 
+  BytesMoved                  = 0;
+  BytesWritten                = 0;
   AuthFormat                  = mVariableModuleGlobal->VariableGlobal.AuthFormat;
   UpdatingVariable            = NULL;
   UpdatingInDeletedTransition = NULL;
@@ -606,6 +616,13 @@ Reclaim (
     ValidBuffer       = (UINT8 *)mNvVariableCache;
   }
 
+  //
+  // The performance protocols cannot be used once the OS owns the machine.
+  //
+  if (!AtRuntime ()) {
+    PERF_INMODULE_BEGIN ("VariableReclaim");
+  }
+
   SetMem (ValidBuffer, MaximumBufferSize, 0xff);
 
   //
@@ -622,6 +639,10 @@ Reclaim (
     NextVariable = GetNextVariablePtr (Variable, AuthFormat);
     if ((Variable != UpdatingVariable) && (Variable->State == VAR_ADDED)) {
       VariableSize = (UINTN)NextVariable - (UINTN)Variable;
+      if (((UINTN)CurrPtr - (UINTN)ValidBuffer) != ((UINTN)Variable - (UINTN)VariableStoreHeader)) {
+        BytesMoved += VariableSize;
+      }
+
       CopyMem (CurrPtr, (UINT8 *)Variable, VariableSize);
       CurrPtr += VariableSize;
       if ((!IsVolatile) && ((Variable->Attributes & EFI_VARIABLE_HARDWARE_ERROR_RECORD) == EFI_VARIABLE_HARDWARE_ERROR_RECORD)) {
@@ -676,6 +697,7 @@ Reclaim (
         // Promote VAR_IN_DELETED_TRANSITION to VAR_ADDED.
         //
         VariableSize = (UINTN)NextVariable - (UINTN)Variable;
+        BytesMoved  += VariableSize;
         CopyMem (CurrPtr, (UINT8 *)Variable, VariableSize);
         ((VARIABLE_HEADER *)CurrPtr)->State = VAR_ADDED;
         CurrPtr                            += VariableSize;
@@ -743,6 +765,7 @@ Reclaim (
     //
     SetMem ((UINT8 *)(UINTN)VariableBase, VariableStoreHeader->Size, 0xff);
     CopyMem ((UINT8 *)(UINTN)VariableBase, ValidBuffer, (UINTN)CurrPtr - (UINTN)ValidBuffer);
+    BytesWritten        = (UINTN)CurrPtr - (UINTN)ValidBuffer;
     *LastVariableOffset = (UINTN)CurrPtr - (UINTN)ValidBuffer;
     if (!IsVolatile) {
       //
@@ -756,12 +779,24 @@ Reclaim (
     Status = EFI_SUCCESS;
   } else {
     //
-    // If non-volatile variable store, perform FTW here.
+    // If non-volatile variable store, perform FTW here, on the changed part of the store only.
     //
-    Status = FtwVariableSpace (
-               VariableBase,
-               (VARIABLE_STORE_HEADER *)ValidBuffer
-               );
+    GetVariableSpaceChangedRange (
+      VariableStoreHeader,
+      (VARIABLE_STORE_HEADER *)ValidBuffer,
+      &WriteOffset,
+      &BytesWritten
+      );
+    Status = EFI_SUCCESS;
+    if (BytesWritten != 0) {
+      Status = FtwVariableSpace (
+                 VariableBase,
+                 (VARIABLE_STORE_HEADER *)ValidBuffer,
+                 WriteOffset,
+                 BytesWritten
+                 );
+    }
+
     if (!EFI_ERROR (Status)) {
       *LastVariableOffset                                = (UINTN)CurrPtr - (UINTN)ValidBuffer;
       mVariableModuleGlobal->HwErrVariableTotalSize      = HwErrVariableTotalSize;
@@ -792,6 +827,15 @@ Reclaim (
   }
 
 Done:
+  //
+  // Variables have moved inside the store, and will move in the runtime
+  // caches once they are synchronized.
+  //
+  VariableIndexReset ();
+  if (mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext.UpdateCount != NULL) {
+    (*(mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext.UpdateCount))++;
+  }
+
   DoneStatus = EFI_SUCCESS;
   if (IsVolatile || mVariableModuleGlobal->VariableGlobal.EmuNvMode) {
     DoneStatus = SynchronizeRuntimeVariableCache (
@@ -818,6 +862,23 @@ Done:
     Status = DoneStatus;
   }
 
+  if (!AtRuntime ()) {
+    PERF_INMODULE_END ("VariableReclaim");
+  }
+
+  mVariableModuleGlobal->ReclaimCount++;
+  mVariableModuleGlobal->LastReclaimBytesMoved   = BytesMoved;
+  mVariableModuleGlobal->LastReclaimBytesWritten = BytesWritten;
+  DEBUG ((
+    DEBUG_INFO,
+    "Variable: %a reclaim %Lu - %r, moved 0x%Lx bytes, wrote 0x%Lx bytes\n",
+    IsVolatile ? "volatile" : "non-volatile",
+    (UINT64)mVariableModuleGlobal->ReclaimCount,
+    Status,
+    (UINT64)BytesMoved,
+    (UINT64)BytesWritten
+    ));
+
   return Status;
 }
 
@@ -1712,6 +1773,8 @@ UpdateVariable (
   BOOLEAN                             IsCommonUserVariable;
   AUTHENTICATED_VARIABLE_HEADER       *AuthVariable;
   BOOLEAN                             AuthFormat;
+  VARIABLE_STORE_HEADER               *AddedVariableStore;
+  UINTN                               AddedVariableOffset;
 
   if ((mVariableModuleGlobal->FvbInstance == NULL) && !mVariableModuleGlobal->VariableGlobal.EmuNvMode) {
     //
@@ -1733,7 +1796,9 @@ UpdateVariable (
     }
   }
 
-  AuthFormat = mVariableModuleGlobal->VariableGlobal.AuthFormat;
+  AuthFormat          = mVariableModuleGlobal->VariableGlobal.AuthFormat;
+  AddedVariableStore  = NULL;
+  AddedVariableOffset = 0;
 
   //
   // Check if CacheVariable points to the variable in variable HOB.
@@ -2233,6 +2298,8 @@ UpdateVariable (
       }
     }
 
+    AddedVariableStore                                    = mNvVariableCache;
+    AddedVariableOffset                                   = mVariableModuleGlobal->NonVolatileLastVariableOffset;
     mVariableModuleGlobal->NonVolatileLastVariableOffset += HEADER_ALIGN (VarSize);
 
     if ((Attributes & EFI_VARIABLE_HARDWARE_ERROR_RECORD) != 0) {
@@ -2293,6 +2360,8 @@ UpdateVariable (
       goto Done;
     }
 
+    AddedVariableStore                                 = (VARIABLE_STORE_HEADER *)(UINTN)mVariableModuleGlobal->VariableGlobal.VolatileVariableBase;
+    AddedVariableOffset                                = mVariableModuleGlobal->VolatileLastVariableOffset;
     mVariableModuleGlobal->VolatileLastVariableOffset += HEADER_ALIGN (VarSize);
   }
 
@@ -2344,6 +2413,11 @@ UpdateVariable (
   }
 
   if (!EFI_ERROR (Status)) {
+    VariableIndexRecordVariable (
+      GetStartPointer (AddedVariableStore),
+      (VARIABLE_HEADER *)((UINTN)AddedVariableStore + AddedVariableOffset),
+      AuthFormat
+      );
     UpdateVariableInfo (VariableName, VendorGuid, Volatile, FALSE, TRUE, FALSE, FALSE, &gVariableInfo);
     if (!Volatile) {
       FlushHobVariableToFlash (VariableName, VendorGuid);
@@ -2366,8 +2440,22 @@ Done:
                   );
       ASSERT_EFI_ERROR (Status);
     }
-  } else if (Status == EFI_OUT_OF_RESOURCES) {
-    DEBUG ((DEBUG_WARN, "UpdateVariable failed: Out of flash space\n"));
+  } else {
+    //
+    // A failed update may have left the new copy of the variable next to
+    // its old copies.
+    //
+    if (AddedVariableStore != NULL) {
+      VariableIndexInvalidateVariable (
+        GetStartPointer (AddedVariableStore),
+        (VARIABLE_HEADER *)((UINTN)AddedVariableStore + AddedVariableOffset),
+        AuthFormat
+        );
+    }
+
+    if (Status == EFI_OUT_OF_RESOURCES) {
+      DEBUG ((DEBUG_WARN, "UpdateVariable failed: Out of flash space\n"));
+    }
   }
 
   return Status;
@@ -2448,7 +2536,7 @@ VariableServiceGetVariable (
     CopyMem (Data, GetVariableDataPtr (Variable.CurrPtr, mVariableModuleGlobal->VariableGlobal.AuthFormat), VarDataSize);
 
     *DataSize = VarDataSize;
-    UpdateVariableInfo (VariableName, VendorGuid, Variable.Volatile, TRUE, FALSE, FALSE, FALSE, &gVariableInfo);
+    UpdateVariableInfo (VariableName, VendorGuid, Variable.Volatile, TRUE, FALSE, FALSE, Variable.IndexHit, &gVariableInfo);
 
     Status = EFI_SUCCESS;
     goto Done;
@@ -3798,6 +3886,12 @@ VariableCommonInitialize (
   VolatileVariableStore->Reserved  = 0;
   VolatileVariableStore->Reserved1 = 0;
 
+  //
+  // Index the variables already present in the HOB and non-volatile stores.
+  //
+  VariableIndexBuild ((VARIABLE_STORE_HEADER *)(UINTN)mVariableModuleGlobal->VariableGlobal.HobVariableBase, mVariableModuleGlobal->VariableGlobal.AuthFormat);
+  VariableIndexBuild (mNvVariableCache, mVariableModuleGlobal->VariableGlobal.AuthFormat);
+
   return EFI_SUCCESS;
 }
 
@@ -33,6 +33,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/VarCheckLib.h>
 #include <Library/VariableFlashInfoLib.h>
 #include <Library/SafeIntLib.h>
+#include <Library/PerformanceLib.h>
 #include <Guid/GlobalVariable.h>
 #include <Guid/EventGroup.h>
 #include <Guid/VariableFormat.h>
@@ -71,6 +72,7 @@ typedef struct {
   BOOLEAN                   *ReadLock;
   BOOLEAN                   *PendingUpdate;
   BOOLEAN                   *HobFlushComplete;
+  UINT32                    *UpdateCount;
   VARIABLE_RUNTIME_CACHE    VariableRuntimeHobCache;
   VARIABLE_RUNTIME_CACHE    VariableRuntimeNvCache;
   VARIABLE_RUNTIME_CACHE    VariableRuntimeVolatileCache;
@@ -88,6 +90,11 @@ typedef struct {
   VARIABLE_HEADER    *EndPtr;
   VARIABLE_HEADER    *StartPtr;
   BOOLEAN            Volatile;
+  //
+  // TRUE if the last lookup was answered by the variable name index
+  // without walking the variable store.
+  //
+  BOOLEAN            IndexHit;
 } VARIABLE_POINTER_TRACK;
 
 typedef struct {
@@ -121,6 +128,16 @@ typedef struct {
   CHAR8                                 *PlatformLang;
   CHAR8                                 Lang[ISO_639_2_ENTRY_SIZE + 1];
   EFI_FIRMWARE_VOLUME_BLOCK_PROTOCOL    *FvbInstance;
+  ///
+  /// Statistics of the variable store reclaim operations.
+  /// LastReclaimBytesMoved counts the variables that were relocated,
+  /// LastReclaimBytesWritten the part of the store that was rewritten.
+  /// The duration of each reclaim before ExitBootServices is recorded as a
+  /// "VariableReclaim" PerformanceLib measurement.
+  ///
+  UINTN                                 ReclaimCount;
+  UINTN                                 LastReclaimBytesMoved;
+  UINTN                                 LastReclaimBytesWritten;
 } VARIABLE_MODULE_GLOBAL;
 
 /**
@@ -142,9 +159,13 @@ FlushHobVariableToFlash (
   This function writes a buffer to variable storage space into a firmware
   volume block device. The destination is specified by the parameter
   VariableBase. Fault Tolerant Write protocol is used for writing.
+  Only the range [Offset, Offset + Length) of the variable store is written,
+  the rest of the store must already match VariableBuffer.
 
   @param  VariableBase   Base address of the variable to write.
   @param  VariableBuffer Point to the variable data buffer.
+  @param  Offset         Offset of the range to write from the start of the variable store.
+  @param  Length         Length of the range to write.
 
   @retval EFI_SUCCESS    The function completed successfully.
   @retval EFI_NOT_FOUND  Fail to locate Fault Tolerant Write protocol.
@@ -154,7 +175,26 @@ FlushHobVariableToFlash (
 EFI_STATUS
 FtwVariableSpace (
   IN EFI_PHYSICAL_ADDRESS   VariableBase,
-  IN VARIABLE_STORE_HEADER  *VariableBuffer
+  IN VARIABLE_STORE_HEADER  *VariableBuffer,
+  IN UINTN                  Offset,
+  IN UINTN                  Length
+  );
+
+/**
+  Get the range of a variable store that differs from a new image of the store.
+
+  @param  VariableStore  Pointer to the current content of the variable store.
+  @param  VariableBuffer Pointer to the new image of the variable store.
+  @param  Offset         Returns the offset of the range from the start of the variable store.
+  @param  Length         Returns the length of the range, 0 if the store does not change.
+
+**/
+VOID
+GetVariableSpaceChangedRange (
+  IN  VARIABLE_STORE_HEADER  *VariableStore,
+  IN  VARIABLE_STORE_HEADER  *VariableBuffer,
+  OUT UINTN                  *Offset,
+  OUT UINTN                  *Length
   );
 
 /**
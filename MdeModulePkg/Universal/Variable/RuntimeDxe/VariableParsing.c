@@ -9,6 +9,41 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include "VariableParsing.h"
 
+///
+/// Number of entries in the variable name index, must be a power of two.
+///
+#define VARIABLE_INDEX_ENTRY_COUNT  512
+
+///
+/// Special VARIABLE_INDEX_ENTRY.Offset value.
+///
+#define VARIABLE_INDEX_UNCACHEABLE  MAX_UINT32
+
+typedef struct {
+  ///
+  /// Start of the variable store the entry belongs to, NULL if unused.
+  ///
+  VARIABLE_HEADER    *StartPtr;
+  ///
+  /// Hash of the variable name and vendor GUID.
+  ///
+  UINT32             Hash;
+  ///
+  /// Offset of the VAR_ADDED variable header from StartPtr, or
+  /// VARIABLE_INDEX_UNCACHEABLE if the store has to be walked to find it.
+  ///
+  UINT32             Offset;
+} VARIABLE_INDEX_ENTRY;
+
+///
+/// Direct mapped index of the variables in the variable stores searched by
+/// FindVariableEx (). Entries are hints that are checked against the store
+/// before use, so an entry that went stale only costs a walk of the store.
+/// Only variables that were found are recorded: an entry only holds a hash of
+/// the name, which cannot prove that a variable is absent.
+///
+STATIC VARIABLE_INDEX_ENTRY  mVariableIndex[VARIABLE_INDEX_ENTRY_COUNT];
+
 /**
 
   This code checks if variable header is valid or not.
@@ -446,7 +481,321 @@ VariableCompareTimeStampInternal (
 }
 
 /**
-  Find the variable in the specified variable store.
+  Compute the variable name index hash of a variable name and vendor GUID.
+
+  @param[in] Name       Pointer to the variable name.
+  @param[in] NameSize   Size of the variable name in bytes, including the terminator.
+  @param[in] VendorGuid Pointer to the vendor GUID.
+
+  @return The 32-bit FNV-1a hash of the name followed by the GUID.
+
+**/
+STATIC
+UINT32
+VariableIndexHash (
+  IN CONST VOID      *Name,
+  IN UINTN           NameSize,
+  IN CONST EFI_GUID  *VendorGuid
+  )
+{
+  CONST UINT8  *Bytes;
+  UINT32       Hash;
+  UINTN        Index;
+
+  Hash  = 0x811C9DC5;
+  Bytes = Name;
+  for (Index = 0; Index < NameSize; Index++) {
+    Hash = (Hash ^ Bytes[Index]) * 0x01000193;
+  }
+
+  Bytes = (CONST UINT8 *)VendorGuid;
+  for (Index = 0; Index < sizeof (EFI_GUID); Index++) {
+    Hash = (Hash ^ Bytes[Index]) * 0x01000193;
+  }
+
+  return Hash;
+}
+
+/**
+  Get the variable name index entry a variable maps to.
+
+  The start of the variable store is mixed into the slot so that the same
+  variable in the volatile, HOB and non-volatile stores uses different entries.
+
+  @param[in] StartPtr   Start of the variable store.
+  @param[in] Hash       Hash of the variable name and vendor GUID.
+
+  @return The index entry for the variable.
+
+**/
+STATIC
+VARIABLE_INDEX_ENTRY *
+VariableIndexGetEntry (
+  IN VARIABLE_HEADER  *StartPtr,
+  IN UINT32           Hash
+  )
+{
+  UINT32  StoreHash;
+
+  StoreHash = (UINT32)(UINTN)StartPtr * 0x9E3779B1;
+  return &mVariableIndex[(Hash ^ (StoreHash >> 16)) & (VARIABLE_INDEX_ENTRY_COUNT - 1)];
+}
+
+/**
+  Discard every entry of the variable name index.
+
+  This must be called whenever variables may have moved inside a variable
+  store, e.g. after a reclaim or after a runtime cache has been rewritten.
+
+**/
+VOID
+VariableIndexReset (
+  VOID
+  )
+{
+  ZeroMem (mVariableIndex, sizeof (mVariableIndex));
+}
+
+/**
+  Set the variable name index entry of a variable that has just been added to
+  a variable store.
+
+  @param[in] StartPtr   Start of the variable store the variable was added to.
+  @param[in] Variable   Pointer to the VAR_ADDED header of the new variable.
+  @param[in] Offset     The offset to record for the variable.
+  @param[in] AuthFormat TRUE indicates authenticated variables are used.
+                        FALSE indicates authenticated variables are not used.
+
+**/
+STATIC
+VOID
+VariableIndexSetVariable (
+  IN VARIABLE_HEADER  *StartPtr,
+  IN VARIABLE_HEADER  *Variable,
+  IN UINT32           Offset,
+  IN BOOLEAN          AuthFormat
+  )
+{
+  VARIABLE_INDEX_ENTRY  *Entry;
+  UINT32                Hash;
+
+  Hash = VariableIndexHash (
+           GetVariableNamePtr (Variable, AuthFormat),
+           NameSizeOfVariable (Variable, AuthFormat),
+           GetVendorGuidPtr (Variable, AuthFormat)
+           );
+  Entry           = VariableIndexGetEntry (StartPtr, Hash);
+  Entry->StartPtr = StartPtr;
+  Entry->Hash     = Hash;
+  Entry->Offset   = Offset;
+}
+
+/**
+  Record a variable that has just been added to a variable store.
+
+  @param[in] StartPtr   Start of the variable store the variable was added to.
+  @param[in] Variable   Pointer to the VAR_ADDED header of the new variable.
+  @param[in] AuthFormat TRUE indicates authenticated variables are used.
+                        FALSE indicates authenticated variables are not used.
+
+**/
+VOID
+VariableIndexRecordVariable (
+  IN VARIABLE_HEADER  *StartPtr,
+  IN VARIABLE_HEADER  *Variable,
+  IN BOOLEAN          AuthFormat
+  )
+{
+  VariableIndexSetVariable (
+    StartPtr,
+    Variable,
+    (UINT32)((UINTN)Variable - (UINTN)StartPtr),
+    AuthFormat
+    );
+}
+
+/**
+  Make the variable name index resolve a variable by walking a variable store.
+
+  This is used when a new copy of a variable was added to a variable store
+  but its old copies could not all be deleted.
+
+  @param[in] StartPtr   Start of the variable store the variable was added to.
+  @param[in] Variable   Pointer to the VAR_ADDED header of the new variable.
+  @param[in] AuthFormat TRUE indicates authenticated variables are used.
+                        FALSE indicates authenticated variables are not used.
+
+**/
+VOID
+VariableIndexInvalidateVariable (
+  IN VARIABLE_HEADER  *StartPtr,
+  IN VARIABLE_HEADER  *Variable,
+  IN BOOLEAN          AuthFormat
+  )
+{
+  VariableIndexSetVariable (StartPtr, Variable, VARIABLE_INDEX_UNCACHEABLE, AuthFormat);
+}
+
+/**
+  Populate the variable name index from the content of a variable store.
+
+  @param[in] VariableStore  Pointer to the variable store header.
+  @param[in] AuthFormat     TRUE indicates authenticated variables are used.
+                            FALSE indicates authenticated variables are not used.
+
+**/
+VOID
+VariableIndexBuild (
+  IN VARIABLE_STORE_HEADER  *VariableStore,
+  IN BOOLEAN                AuthFormat
+  )
+{
+  VARIABLE_HEADER       *StartPtr;
+  VARIABLE_HEADER       *EndPtr;
+  VARIABLE_HEADER       *Variable;
+  VARIABLE_INDEX_ENTRY  *Entry;
+  UINT32                Hash;
+
+  if (VariableStore == NULL) {
+    return;
+  }
+
+  StartPtr = GetStartPointer (VariableStore);
+  EndPtr   = GetEndPointer (VariableStore);
+
+  for ( Variable = StartPtr
+        ; IsValidVariableHeader (Variable, EndPtr)
+        ; Variable = GetNextVariablePtr (Variable, AuthFormat)
+        )
+  {
+    if ((Variable->State != VAR_ADDED) &&
+        (Variable->State != (VAR_IN_DELETED_TRANSITION & VAR_ADDED)))
+    {
+      continue;
+    }
+
+    Hash = VariableIndexHash (
+             GetVariableNamePtr (Variable, AuthFormat),
+             NameSizeOfVariable (Variable, AuthFormat),
+             GetVendorGuidPtr (Variable, AuthFormat)
+             );
+    Entry = VariableIndexGetEntry (StartPtr, Hash);
+    if (Entry->StartPtr != NULL) {
+      //
+      // Only the first copy of a variable is what FindVariableEx () returns,
+      // and entries of colliding variables are left to be resolved by a walk.
+      //
+      continue;
+    }
+
+    Entry->StartPtr = StartPtr;
+    Entry->Hash     = Hash;
+    if (Variable->State == VAR_ADDED) {
+      Entry->Offset = (UINT32)((UINTN)Variable - (UINTN)StartPtr);
+    } else {
+      //
+      // The ADDED copy of an IN_DELETED_TRANSITION variable must be returned
+      // together with it, which only a walk of the store can do.
+      //
+      Entry->Offset = VARIABLE_INDEX_UNCACHEABLE;
+    }
+  }
+}
+
+/**
+  Look up a variable in the variable name index.
+
+  A recorded offset is only a hint. The variable header it refers to is
+  checked to still be the VAR_ADDED copy of the requested variable before it
+  is returned.
+
+  @param[in]       VariableName        Name of the variable to be found, not empty.
+  @param[in]       VendorGuid          Vendor GUID to be found.
+  @param[in]       Hash                Hash of VariableName and VendorGuid.
+  @param[in]       IgnoreRtCheck       Ignore EFI_VARIABLE_RUNTIME_ACCESS attribute
+                                       check at runtime when searching variable.
+  @param[in, out]  PtrTrack            Variable Track Pointer structure that contains Variable Information.
+  @param[in]       AuthFormat          TRUE indicates authenticated variables are used.
+                                       FALSE indicates authenticated variables are not used.
+
+  @retval EFI_SUCCESS         The variable was found, PtrTrack->CurrPtr points to it.
+  @retval EFI_NO_MAPPING      The index cannot answer, the store must be walked.
+
+**/
+STATIC
+EFI_STATUS
+VariableIndexLookup (
+  IN     CHAR16                  *VariableName,
+  IN     EFI_GUID                *VendorGuid,
+  IN     UINT32                  Hash,
+  IN     BOOLEAN                 IgnoreRtCheck,
+  IN OUT VARIABLE_POINTER_TRACK  *PtrTrack,
+  IN     BOOLEAN                 AuthFormat
+  )
+{
+  VARIABLE_INDEX_ENTRY  *Entry;
+  VARIABLE_HEADER       *Variable;
+
+  Entry = VariableIndexGetEntry (PtrTrack->StartPtr, Hash);
+  if ((Entry->StartPtr != PtrTrack->StartPtr) || (Entry->Hash != Hash)) {
+    return EFI_NO_MAPPING;
+  }
+
+  if (Entry->Offset == VARIABLE_INDEX_UNCACHEABLE) {
+    return EFI_NO_MAPPING;
+  }
+
+  Variable = (VARIABLE_HEADER *)((UINTN)PtrTrack->StartPtr + Entry->Offset);
+  if (!IsValidVariableHeader (Variable, PtrTrack->EndPtr) ||
+      (Variable->State != VAR_ADDED) ||
+      (!IgnoreRtCheck && AtRuntime () && ((Variable->Attributes & EFI_VARIABLE_RUNTIME_ACCESS) == 0)) ||
+      !CompareGuid (VendorGuid, GetVendorGuidPtr (Variable, AuthFormat)) ||
+      (CompareMem (VariableName, GetVariableNamePtr (Variable, AuthFormat), NameSizeOfVariable (Variable, AuthFormat)) != 0))
+  {
+    return EFI_NO_MAPPING;
+  }
+
+  PtrTrack->CurrPtr = Variable;
+  return EFI_SUCCESS;
+}
+
+/**
+  Record the result of a walk of a variable store in the variable name index.
+
+  Variables the walk did not find are not recorded.
+
+  @param[in] Hash           Hash of the variable name and vendor GUID.
+  @param[in] PtrTrack       Variable Track Pointer structure filled in by the walk.
+
+**/
+STATIC
+VOID
+VariableIndexUpdate (
+  IN UINT32                  Hash,
+  IN VARIABLE_POINTER_TRACK  *PtrTrack
+  )
+{
+  VARIABLE_INDEX_ENTRY  *Entry;
+  UINT32                Offset;
+
+  if (PtrTrack->CurrPtr == NULL) {
+    return;
+  }
+
+  if ((PtrTrack->InDeletedTransitionPtr != NULL) || (PtrTrack->CurrPtr->State != VAR_ADDED)) {
+    Offset = VARIABLE_INDEX_UNCACHEABLE;
+  } else {
+    Offset = (UINT32)((UINTN)PtrTrack->CurrPtr - (UINTN)PtrTrack->StartPtr);
+  }
+
+  Entry           = VariableIndexGetEntry (PtrTrack->StartPtr, Hash);
+  Entry->StartPtr = PtrTrack->StartPtr;
+  Entry->Hash     = Hash;
+  Entry->Offset   = Offset;
+}
+
+/**
+  Find the variable in the specified variable store by walking through it.
 
   @param[in]       VariableName        Name of the variable to be found
   @param[in]       VendorGuid          Vendor GUID to be found.
@@ -459,8 +808,9 @@ VariableCompareTimeStampInternal (
   @retval          EFI_SUCCESS         Variable found successfully
   @retval          EFI_NOT_FOUND       Variable not found
 **/
+STATIC
 EFI_STATUS
-FindVariableEx (
+FindVariableInStore (
   IN     CHAR16                  *VariableName,
   IN     EFI_GUID                *VendorGuid,
   IN     BOOLEAN                 IgnoreRtCheck,
@@ -471,8 +821,6 @@ FindVariableEx (
   VARIABLE_HEADER  *InDeletedVariable;
   VOID             *Point;
 
-  PtrTrack->InDeletedTransitionPtr = NULL;
-
   //
   // Find the variable by walk through HOB, volatile and non-volatile variable store.
   //
@@ -518,6 +866,51 @@ FindVariableEx (
   return (PtrTrack->CurrPtr  == NULL) ? EFI_NOT_FOUND : EFI_SUCCESS;
 }
 
+/**
+  Find the variable in the specified variable store.
+
+  @param[in]       VariableName        Name of the variable to be found
+  @param[in]       VendorGuid          Vendor GUID to be found.
+  @param[in]       IgnoreRtCheck       Ignore EFI_VARIABLE_RUNTIME_ACCESS attribute
+                                       check at runtime when searching variable.
+  @param[in, out]  PtrTrack            Variable Track Pointer structure that contains Variable Information.
+  @param[in]       AuthFormat          TRUE indicates authenticated variables are used.
+                                       FALSE indicates authenticated variables are not used.
+
+  @retval          EFI_SUCCESS         Variable found successfully
+  @retval          EFI_NOT_FOUND       Variable not found
+**/
+EFI_STATUS
+FindVariableEx (
+  IN     CHAR16                  *VariableName,
+  IN     EFI_GUID                *VendorGuid,
+  IN     BOOLEAN                 IgnoreRtCheck,
+  IN OUT VARIABLE_POINTER_TRACK  *PtrTrack,
+  IN     BOOLEAN                 AuthFormat
+  )
+{
+  EFI_STATUS  Status;
+  UINT32      Hash;
+
+  PtrTrack->InDeletedTransitionPtr = NULL;
+  PtrTrack->IndexHit               = FALSE;
+
+  if (VariableName[0] != 0) {
+    Hash   = VariableIndexHash (VariableName, StrSize (VariableName), VendorGuid);
+    Status = VariableIndexLookup (VariableName, VendorGuid, Hash, IgnoreRtCheck, PtrTrack, AuthFormat);
+    if (Status == EFI_SUCCESS) {
+      PtrTrack->IndexHit = TRUE;
+      return Status;
+    }
+
+    Status = FindVariableInStore (VariableName, VendorGuid, IgnoreRtCheck, PtrTrack, AuthFormat);
+    VariableIndexUpdate (Hash, PtrTrack);
+    return Status;
+  }
+
+  return FindVariableInStore (VariableName, VendorGuid, IgnoreRtCheck, PtrTrack, AuthFormat);
+}
+
 /**
   This code finds the next available variable.
 
@@ -721,7 +1114,8 @@ Done:
   @param[in]      Read           TRUE if GetVariable() was called.
   @param[in]      Write          TRUE if SetVariable() was called.
   @param[in]      Delete         TRUE if deleted via SetVariable().
-  @param[in]      Cache          TRUE for a cache hit.
+  @param[in]      Cache          TRUE for a cache hit, including a hit in the
+                                 variable name index.
   @param[in,out]  VariableInfo   Pointer to a pointer of VARIABLE_INFO_ENTRY structures.
 
 **/
@@ -257,6 +257,67 @@ VariableCompareTimeStampInternal (
   IN EFI_TIME  *SecondTime
   );
 
+/**
+  Discard every entry of the variable name index.
+
+  This must be called whenever variables may have moved inside a variable
+  store, e.g. after a reclaim or after a runtime cache has been rewritten.
+
+**/
+VOID
+VariableIndexReset (
+  VOID
+  );
+
+/**
+  Record a variable that has just been added to a variable store.
+
+  @param[in] StartPtr   Start of the variable store the variable was added to.
+  @param[in] Variable   Pointer to the VAR_ADDED header of the new variable.
+  @param[in] AuthFormat TRUE indicates authenticated variables are used.
+                        FALSE indicates authenticated variables are not used.
+
+**/
+VOID
+VariableIndexRecordVariable (
+  IN VARIABLE_HEADER  *StartPtr,
+  IN VARIABLE_HEADER  *Variable,
+  IN BOOLEAN          AuthFormat
+  );
+
+/**
+  Make the variable name index resolve a variable by walking a variable store.
+
+  This is used when a new copy of a variable was added to a variable store
+  but its old copies could not all be deleted.
+
+  @param[in] StartPtr   Start of the variable store the variable was added to.
+  @param[in] Variable   Pointer to the VAR_ADDED header of the new variable.
+  @param[in] AuthFormat TRUE indicates authenticated variables are used.
+                        FALSE indicates authenticated variables are not used.
+
+**/
+VOID
+VariableIndexInvalidateVariable (
+  IN VARIABLE_HEADER  *StartPtr,
+  IN VARIABLE_HEADER  *Variable,
+  IN BOOLEAN          AuthFormat
+  );
+
+/**
+  Populate the variable name index from the content of a variable store.
+
+  @param[in] VariableStore  Pointer to the variable store header.
+  @param[in] AuthFormat     TRUE indicates authenticated variables are used.
+                            FALSE indicates authenticated variables are not used.
+
+**/
+VOID
+VariableIndexBuild (
+  IN VARIABLE_STORE_HEADER  *VariableStore,
+  IN BOOLEAN                AuthFormat
+  );
+
 /**
   Find the variable in the specified variable store.
 
@@ -328,7 +389,8 @@ VariableServiceGetNextVariableInternal (
   @param[in]      Read           TRUE if GetVariable() was called.
   @param[in]      Write          TRUE if SetVariable() was called.
   @param[in]      Delete         TRUE if deleted via SetVariable().
-  @param[in]      Cache          TRUE for a cache hit.
+  @param[in]      Cache          TRUE for a cache hit, including a hit in the
+                                 variable name index.
   @param[in,out]  VariableInfo   Pointer to a pointer of VARIABLE_INFO_ENTRY structures.
 
 **/
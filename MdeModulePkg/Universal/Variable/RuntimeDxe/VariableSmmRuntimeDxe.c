@@ -61,6 +61,7 @@ EDKII_VARIABLE_LOCK_PROTOCOL    mVariableLock;
 EDKII_VAR_CHECK_PROTOCOL        mVarCheck;
 VARIABLE_RUNTIME_CACHE_INFO     mVariableRtCacheInfo;
 BOOLEAN                         mIsRuntimeCacheEnabled = FALSE;
+UINT32                          mVariableRtCacheUpdateCount;
 
 /**
   The logic to initialize the VariablePolicy engine is in its own file.
@@ -546,6 +547,14 @@ CheckForRuntimeCacheSync (
   if ((CacheInfoFlag->HobFlushComplete) && (mVariableRtCacheInfo.RuntimeHobCacheBuffer != 0)) {
     mVariableRtCacheInfo.RuntimeHobCacheBuffer = 0;
   }
+
+  //
+  // The variable name index is only valid while the variables stay where they were found.
+  //
+  if (CacheInfoFlag->UpdateCount != mVariableRtCacheUpdateCount) {
+    mVariableRtCacheUpdateCount = CacheInfoFlag->UpdateCount;
+    VariableIndexReset ();
+  }
 }
 
 /**
@@ -1728,6 +1737,7 @@ SendRuntimeVariableCacheContextToSmm (
     SmmRuntimeVarCacheContext->PendingUpdate        = &((CACHE_INFO_FLAG *)(UINTN)mVariableRtCacheInfo.CacheInfoFlagBuffer)->PendingUpdate;
     SmmRuntimeVarCacheContext->ReadLock             = &((CACHE_INFO_FLAG *)(UINTN)mVariableRtCacheInfo.CacheInfoFlagBuffer)->ReadLock;
     SmmRuntimeVarCacheContext->HobFlushComplete     = &((CACHE_INFO_FLAG *)(UINTN)mVariableRtCacheInfo.CacheInfoFlagBuffer)->HobFlushComplete;
+    SmmRuntimeVarCacheContext->UpdateCount          = &((CACHE_INFO_FLAG *)(UINTN)mVariableRtCacheInfo.CacheInfoFlagBuffer)->UpdateCount;
 
     //
     // Send data to SMM.
@@ -1756,6 +1766,7 @@ SendRuntimeVariableCacheContextToSmm (
     SmmRuntimeVarCacheContext->PendingUpdate        = &((CACHE_INFO_FLAG *)(UINTN)mVariableRtCacheInfo.CacheInfoFlagBuffer)->PendingUpdate;
     SmmRuntimeVarCacheContext->ReadLock             = &((CACHE_INFO_FLAG *)(UINTN)mVariableRtCacheInfo.CacheInfoFlagBuffer)->ReadLock;
     SmmRuntimeVarCacheContext->HobFlushComplete     = &((CACHE_INFO_FLAG *)(UINTN)mVariableRtCacheInfo.CacheInfoFlagBuffer)->HobFlushComplete;
+    SmmRuntimeVarCacheContext->UpdateCount          = &((CACHE_INFO_FLAG *)(UINTN)mVariableRtCacheInfo.CacheInfoFlagBuffer)->UpdateCount;
 
     //
     // Send data to SMM.
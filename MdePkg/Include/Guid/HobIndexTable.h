@@ -0,0 +1,49 @@
+/** @file
+  GUID for the HOB index table.
+
+  The DXE Core indexes the GUID HOBs of the HOB list passed from PEI by GUID
+  and publishes the index in the EFI System Configuration Table, so that the
+  HOB library instances of DXE can find GUID HOBs without walking the whole
+  HOB list.
+
+  Copyright (c) 2026, TianoCore and contributors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __HOB_INDEX_TABLE_GUID_H__
+#define __HOB_INDEX_TABLE_GUID_H__
+
+//
+// The HOB Index Table shall be stored in memory of type
+// EfiBootServicesData
+//
+#define EDKII_HOB_INDEX_TABLE_GUID \
+  { \
+    0x2f3c8e61, 0x5a0d, 0x4b97, {0xb1, 0x4e, 0x7c, 0x09, 0xd2, 0x63, 0xa8, 0x5f } \
+  }
+
+///
+/// One GUID HOB of the HOB list.
+///
+typedef struct {
+  EFI_GUID                Name;   ///< The GUID of the HOB.
+  EFI_PHYSICAL_ADDRESS    Hob;    ///< The address of the HOB.
+} EDKII_HOB_INDEX_ENTRY;
+
+///
+/// The table is followed by EntryCount entries, sorted by the bytes of Name
+/// as compared by CompareMem() and then by Hob. The GUID HOBs of the same
+/// GUID are adjacent and in HOB list order.
+///
+typedef struct {
+  EFI_PHYSICAL_ADDRESS    HobListStart;   ///< The first HOB of the indexed HOB list.
+  EFI_PHYSICAL_ADDRESS    HobListEnd;     ///< The end of HOB list HOB of the indexed HOB list.
+  UINT32                  EntryCount;     ///< The number of entries.
+  UINT32                  Reserved;
+  // EDKII_HOB_INDEX_ENTRY    Entry[EntryCount];
+} EDKII_HOB_INDEX_TABLE;
+
+extern EFI_GUID  gEdkiiHobIndexTableGuid;
+
+#endif
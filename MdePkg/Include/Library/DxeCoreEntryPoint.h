@@ -14,6 +14,12 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 ///
 extern VOID  *gHobList;
 
+///
+/// Global variable that contains a pointer to the HOB index table of the Hob List, set by the
+/// DXE Core once it has built the table. NULL until then.
+///
+extern VOID  *gHobIndex;
+
 /**
   The entry point of PE/COFF Image for the DXE Core.
 
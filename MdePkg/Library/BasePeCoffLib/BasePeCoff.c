@@ -937,6 +937,11 @@ PeCoffLoaderImageAddress (
 
   If ImageContext is NULL, then ASSERT().
 
+  Unlike PeCoffLoaderRelocateImage(), PeCoffLoaderRelocateImageExtraAction() is not called,
+  so that the relocation may run on a processor where the extra action is not allowed. The
+  caller is responsible for calling PeCoffLoaderRelocateImageExtraAction() once the image
+  has been relocated.
+
   Note that if the platform does not maintain coherency between the instruction cache(s) and the data
   cache(s) in hardware, then the caller is responsible for performing cache maintenance operations
   prior to transferring control to a PE/COFF image that is loaded using this library.
@@ -954,7 +959,7 @@ PeCoffLoaderImageAddress (
 **/
 RETURN_STATUS
 EFIAPI
-PeCoffLoaderRelocateImage (
+PeCoffLoaderRelocateImageWithoutExtraAction (
   IN OUT PE_COFF_LOADER_IMAGE_CONTEXT  *ImageContext
   )
 {
@@ -989,9 +994,6 @@ PeCoffLoaderRelocateImage (
   // If there are no relocation entries, then we are done
   //
   if (ImageContext->RelocationsStripped) {
-    // Applies additional environment specific actions to relocate fixups
-    // to a PE/COFF image if needed
-    PeCoffLoaderRelocateImageExtraAction (ImageContext);
     return RETURN_SUCCESS;
   }
 
@@ -1205,13 +1207,57 @@ PeCoffLoaderRelocateImage (
     }
   }
 
-  // Applies additional environment specific actions to relocate fixups
-  // to a PE/COFF image if needed
-  PeCoffLoaderRelocateImageExtraAction (ImageContext);
-
   return RETURN_SUCCESS;
 }
 
+/**
+  Applies relocation fixups to a PE/COFF image that was loaded with PeCoffLoaderLoadImage().
+
+  If the DestinationAddress field of ImageContext is 0, then use the ImageAddress field of
+  ImageContext as the relocation base address.  Otherwise, use the DestinationAddress field
+  of ImageContext as the relocation base address.  The caller must allocate the relocation
+  fixup log buffer and fill in the FixupData field of ImageContext prior to calling this function.
+
+  The ImageRead, Handle, PeCoffHeaderOffset,  IsTeImage, Machine, ImageType, ImageAddress,
+  ImageSize, DestinationAddress, RelocationsStripped, SectionAlignment, SizeOfHeaders,
+  DebugDirectoryEntryRva, EntryPoint, FixupDataSize, CodeView, PdbPointer, and FixupData of
+  the ImageContext structure must be valid prior to invoking this service.
+
+  If ImageContext is NULL, then ASSERT().
+
+  Note that if the platform does not maintain coherency between the instruction cache(s) and the data
+  cache(s) in hardware, then the caller is responsible for performing cache maintenance operations
+  prior to transferring control to a PE/COFF image that is loaded using this library.
+
+  @param  ImageContext        The pointer to the image context structure that describes the PE/COFF
+                              image that is being relocated.
+
+  @retval RETURN_SUCCESS      The PE/COFF image was relocated.
+                              Extended status information is in the ImageError field of ImageContext.
+  @retval RETURN_LOAD_ERROR   The image in not a valid PE/COFF image.
+                              Extended status information is in the ImageError field of ImageContext.
+  @retval RETURN_UNSUPPORTED  A relocation record type is not supported.
+                              Extended status information is in the ImageError field of ImageContext.
+
+**/
+RETURN_STATUS
+EFIAPI
+PeCoffLoaderRelocateImage (
+  IN OUT PE_COFF_LOADER_IMAGE_CONTEXT  *ImageContext
+  )
+{
+  RETURN_STATUS  Status;
+
+  Status = PeCoffLoaderRelocateImageWithoutExtraAction (ImageContext);
+  if (!RETURN_ERROR (Status)) {
+    // Applies additional environment specific actions to relocate fixups
+    // to a PE/COFF image if needed
+    PeCoffLoaderRelocateImageExtraAction (ImageContext);
+  }
+
+  return Status;
+}
+
 /**
   Loads a PE/COFF image into memory.
 
@@ -17,6 +17,11 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 //
 VOID  *gHobList = NULL;
 
+//
+// Cache copy of the HOB index table pointer, set by the DXE Core.
+//
+VOID  *gHobIndex = NULL;
+
 /**
   The entry point of PE/COFF Image for the DXE Core.
 
@@ -8,6 +8,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include <PiDxe.h>
 
+#include <Guid/HobIndexTable.h>
+
 #include <Library/HobLib.h>
 #include <Library/DebugLib.h>
 #include <Library/BaseMemoryLib.h>
@@ -107,6 +109,61 @@ GetFirstHob (
   return GetNextHob (Type, HobList);
 }
 
+/**
+  Returns the next instance of the matched GUID HOB from the starting HOB, as
+  found in the HOB index table built by the DXE Core.
+
+  A GUID HOB that was changed after the index was built, for example marked as
+  unused, is skipped.
+
+  @param  HobIndex      The HOB index table of the HOB list that HobStart belongs to.
+  @param  Guid          The GUID to match with in the HOB list.
+  @param  HobStart      A pointer to a Guid.
+
+  @return The next instance of the matched GUID HOB from the starting HOB.
+
+**/
+STATIC
+VOID *
+GetNextIndexedGuidHob (
+  IN CONST EDKII_HOB_INDEX_TABLE  *HobIndex,
+  IN CONST EFI_GUID               *Guid,
+  IN CONST VOID                   *HobStart
+  )
+{
+  CONST EDKII_HOB_INDEX_ENTRY  *Entry;
+  EFI_PEI_HOB_POINTERS         GuidHob;
+  UINTN                        Low;
+  UINTN                        High;
+  UINTN                        Middle;
+  INTN                         Result;
+
+  //
+  // Find the first entry of Guid that is not before HobStart.
+  //
+  Entry = (CONST EDKII_HOB_INDEX_ENTRY *)(HobIndex + 1);
+  Low   = 0;
+  High  = HobIndex->EntryCount;
+  while (Low < High) {
+    Middle = Low + (High - Low) / 2;
+    Result = CompareMem (&Entry[Middle].Name, Guid, sizeof (EFI_GUID));
+    if ((Result < 0) || ((Result == 0) && (Entry[Middle].Hob < (UINTN)HobStart))) {
+      Low = Middle + 1;
+    } else {
+      High = Middle;
+    }
+  }
+
+  for ( ; (Low < HobIndex->EntryCount) && CompareGuid (&Entry[Low].Name, Guid); Low++) {
+    GuidHob.Raw = (UINT8 *)(UINTN)Entry[Low].Hob;
+    if ((GuidHob.Header->HobType == EFI_HOB_TYPE_GUID_EXTENSION) && CompareGuid (Guid, &GuidHob.Guid->Name)) {
+      return GuidHob.Raw;
+    }
+  }
+
+  return NULL;
+}
+
 /**
   Returns the next instance of the matched GUID HOB from the starting HOB.
 
@@ -136,7 +193,19 @@ GetNextGuidHob (
   IN CONST VOID      *HobStart
   )
 {
-  EFI_PEI_HOB_POINTERS  GuidHob;
+  EFI_PEI_HOB_POINTERS   GuidHob;
+  EDKII_HOB_INDEX_TABLE  *HobIndex;
+
+  //
+  // Use the HOB index table if HobStart is in the HOB list it indexes.
+  //
+  HobIndex = (EDKII_HOB_INDEX_TABLE *)gHobIndex;
+  if ((HobIndex != NULL) &&
+      ((UINTN)HobStart >= HobIndex->HobListStart) &&
+      ((UINTN)HobStart <= HobIndex->HobListEnd))
+  {
+    return GetNextIndexedGuidHob (HobIndex, Guid, HobStart);
+  }
 
   GuidHob.Raw = (UINT8 *)HobStart;
   while ((GuidHob.Raw = GetNextHob (EFI_HOB_TYPE_GUID_EXTENSION, GuidHob.Raw)) != NULL) {
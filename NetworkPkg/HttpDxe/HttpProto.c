@@ -667,6 +667,22 @@ HttpInitProtocol (
       goto ON_ERROR;
     }
 
+    //
+    // The receive loan protocol is optional, TLS records are copied
+    // into HTTP buffers without it.
+    //
+    Status = gBS->OpenProtocol (
+                    HttpInstance->Tcp4ChildHandle,
+                    &gEdkiiTcpRxLoanProtocolGuid,
+                    (VOID **)&HttpInstance->TcpRxLoan,
+                    HttpInstance->Service->Ip4DriverBindingHandle,
+                    HttpInstance->Handle,
+                    EFI_OPEN_PROTOCOL_GET_PROTOCOL
+                    );
+    if (EFI_ERROR (Status)) {
+      HttpInstance->TcpRxLoan = NULL;
+    }
+
     Status = gBS->OpenProtocol (
                     HttpInstance->Service->Tcp4ChildHandle,
                     &gEfiTcp4ProtocolGuid,
@@ -719,6 +735,22 @@ HttpInitProtocol (
       goto ON_ERROR;
     }
 
+    //
+    // The receive loan protocol is optional, TLS records are copied
+    // into HTTP buffers without it.
+    //
+    Status = gBS->OpenProtocol (
+                    HttpInstance->Tcp6ChildHandle,
+                    &gEdkiiTcpRxLoanProtocolGuid,
+                    (VOID **)&HttpInstance->TcpRxLoan,
+                    HttpInstance->Service->Ip6DriverBindingHandle,
+                    HttpInstance->Handle,
+                    EFI_OPEN_PROTOCOL_GET_PROTOCOL
+                    );
+    if (EFI_ERROR (Status)) {
+      HttpInstance->TcpRxLoan = NULL;
+    }
+
     Status = gBS->OpenProtocol (
                     HttpInstance->Service->Tcp6ChildHandle,
                     &gEfiTcp6ProtocolGuid,
@@ -865,6 +897,7 @@ HttpCleanProtocol (
   }
 
   HttpInstance->ProxyConnected = FALSE;
+  HttpInstance->TcpRxLoan      = NULL;
 
   NetMapClean (&HttpInstance->TxTokens);
   NetMapClean (&HttpInstance->RxTokens);
@@ -1102,6 +1135,7 @@ HttpConfigureTcp4 (
   Tcp4Option->KeepAliveInterval   = HTTP_KEEP_ALIVE_INTERVAL;
   Tcp4Option->EnableNagle         = TRUE;
   Tcp4Option->EnableWindowScaling = TRUE;
+  Tcp4Option->EnableSelectiveAck  = TRUE;
   Tcp4CfgData->ControlOption      = Tcp4Option;
 
   if ((HttpInstance->State == HTTP_STATE_TCP_CONNECTED) ||
@@ -1186,6 +1220,7 @@ HttpConfigureTcp6 (
   Tcp6Option->KeepAliveInterval   = HTTP_KEEP_ALIVE_INTERVAL;
   Tcp6Option->EnableNagle         = TRUE;
   Tcp6Option->EnableWindowScaling = TRUE;
+  Tcp6Option->EnableSelectiveAck  = TRUE;
 
   if ((HttpInstance->State == HTTP_STATE_TCP_CONNECTED) ||
       (HttpInstance->State == HTTP_STATE_TCP_CLOSED))
@@ -205,6 +205,12 @@ typedef struct _HTTP_PROTOCOL {
   EFI_TCP6_RECEIVE_DATA             Tcp6TlsRxData;
   BOOLEAN                           TlsIsRxDone;
 
+  //
+  // TcpRxLoan used for receiving TLS records without copying them, if the
+  // TCP driver supports it.
+  //
+  EDKII_TCP_RX_LOAN_PROTOCOL        *TcpRxLoan;
+
   BOOLEAN                           ConnectionClose;
 } HTTP_PROTOCOL;
 
@@ -106,6 +106,38 @@ FreeNbufList (
   FreePool (Arg);
 }
 
+/**
+  The callback function to return the buffers of a loaned receive.
+
+  @param[in]  Arg The opaque parameter.
+
+**/
+VOID
+EFIAPI
+TlsLoanReturn (
+  IN VOID  *Arg
+  )
+{
+  HTTPS_RX_LOAN  *Loan;
+  EFI_STATUS     Status;
+
+  ASSERT (Arg != NULL);
+
+  Loan   = (HTTPS_RX_LOAN *)Arg;
+  Status = Loan->TcpRxLoan->ReturnData (Loan->TcpRxLoan, &Loan->RxData);
+  if (EFI_ERROR (Status)) {
+    //
+    // The TCP driver reclaims the buffers when the TCP child is destroyed,
+    // and may still refer to the fragment table of the loan until then, so
+    // the loan is left allocated.
+    //
+    DEBUG ((DEBUG_WARN, "TlsLoanReturn: Failed to return the receive buffers - %r\n", Status));
+    return;
+  }
+
+  FreePool (Loan);
+}
+
 /**
   Check whether the Url is from Https.
 
@@ -1024,6 +1056,130 @@ ON_EXIT:
   return Status;
 }
 
+/**
+  Receive Len bytes through the EDKII_TCP_RX_LOAN_PROTOCOL. The received data
+  isn't copied, each loaned receive is wrapped in a net buffer which returns
+  the receive buffers to the TCP driver when freed.
+
+  @param[in, out]   HttpInstance    Pointer to HTTP_PROTOCOL structure.
+  @param[in]        Len             The length of data to receive.
+  @param[in, out]   NbufList        The list the received net buffers are appended to.
+  @param[in]        Timeout         The time to wait for connection done.
+
+  @retval EFI_SUCCESS            Len bytes are received.
+  @retval EFI_INVALID_PARAMETER  HttpInstance or NbufList is NULL.
+  @retval EFI_OUT_OF_RESOURCES   Can't allocate memory resources.
+  @retval EFI_TIMEOUT            The operation is time out.
+  @retval Others                 Other error as indicated.
+
+**/
+EFI_STATUS
+EFIAPI
+TlsLoanReceive (
+  IN OUT HTTP_PROTOCOL  *HttpInstance,
+  IN     UINT32         Len,
+  IN OUT LIST_ENTRY     *NbufList,
+  IN     EFI_EVENT      Timeout
+  )
+{
+  EFI_TCP4_IO_TOKEN      *Token;
+  EFI_TCP4_RECEIVE_DATA  *RxData;
+  HTTPS_RX_LOAN          *Loan;
+  NET_BUF                *Nbuf;
+  EFI_STATUS             Status;
+
+  if ((HttpInstance == NULL) || (HttpInstance->TcpRxLoan == NULL) || (NbufList == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // EFI_TCP6_IO_TOKEN has the same layout as EFI_TCP4_IO_TOKEN.
+  //
+  if (!HttpInstance->LocalAddressIsIPv6) {
+    Token = &HttpInstance->Tcp4TlsRxToken;
+  } else {
+    Token = (EFI_TCP4_IO_TOKEN *)&HttpInstance->Tcp6TlsRxToken;
+  }
+
+  RxData = Token->Packet.RxData;
+  Status = EFI_SUCCESS;
+
+  while (Len > 0) {
+    Loan = AllocateZeroPool (sizeof (HTTPS_RX_LOAN));
+    if (Loan == NULL) {
+      Status = EFI_OUT_OF_RESOURCES;
+      break;
+    }
+
+    Loan->TcpRxLoan            = HttpInstance->TcpRxLoan;
+    Loan->RxData.DataLength    = Len;
+    Loan->RxData.FragmentCount = HTTPS_RX_LOAN_FRAGMENT_COUNT;
+
+    Token->Packet.RxData = &Loan->RxData;
+    Status               = HttpInstance->TcpRxLoan->Receive (HttpInstance->TcpRxLoan, Token);
+    if (EFI_ERROR (Status)) {
+      Token->Packet.RxData = RxData;
+      FreePool (Loan);
+      break;
+    }
+
+    while (!HttpInstance->TlsIsRxDone && ((Timeout == NULL) || EFI_ERROR (gBS->CheckEvent (Timeout)))) {
+      //
+      // Poll until some data is received or an error occurs.
+      //
+      if (!HttpInstance->LocalAddressIsIPv6) {
+        HttpInstance->Tcp4->Poll (HttpInstance->Tcp4);
+      } else {
+        HttpInstance->Tcp6->Poll (HttpInstance->Tcp6);
+      }
+    }
+
+    if (!HttpInstance->TlsIsRxDone) {
+      //
+      // Timeout occurs, cancel the receive request.
+      //
+      if (!HttpInstance->LocalAddressIsIPv6) {
+        HttpInstance->Tcp4->Cancel (HttpInstance->Tcp4, &HttpInstance->Tcp4TlsRxToken.CompletionToken);
+      } else {
+        HttpInstance->Tcp6->Cancel (HttpInstance->Tcp6, &HttpInstance->Tcp6TlsRxToken.CompletionToken);
+      }
+
+      Status = EFI_TIMEOUT;
+    } else {
+      HttpInstance->TlsIsRxDone = FALSE;
+      Status                    = Token->CompletionToken.Status;
+    }
+
+    Token->Packet.RxData = RxData;
+    if (EFI_ERROR (Status)) {
+      FreePool (Loan);
+      break;
+    }
+
+    //
+    // NET_FRAGMENT has the same layout as EFI_TCP4_FRAGMENT_DATA.
+    //
+    Nbuf = NetbufFromExt (
+             (NET_FRAGMENT *)Loan->RxData.FragmentTable,
+             Loan->RxData.FragmentCount,
+             0,
+             0,
+             TlsLoanReturn,
+             Loan
+             );
+    if (Nbuf == NULL) {
+      TlsLoanReturn (Loan);
+      Status = EFI_OUT_OF_RESOURCES;
+      break;
+    }
+
+    InsertTailList (NbufList, &Nbuf->List);
+    Len -= Nbuf->TotalSize;
+  }
+
+  return Status;
+}
+
 /**
   Receive one TLS PDU. An TLS PDU contains an TLS record header and its
   corresponding record data. These two parts will be put into two blocks of buffers in the
@@ -1120,6 +1276,18 @@ TlsReceiveOnePdu (
     goto FORM_PDU;
   }
 
+  if (HttpInstance->TcpRxLoan != NULL) {
+    //
+    // Second step, receive one TLS payload in the receive buffers of TCP.
+    //
+    Status = TlsLoanReceive (HttpInstance, Len, NbufList, Timeout);
+    if (EFI_ERROR (Status)) {
+      goto ON_EXIT;
+    }
+
+    goto FORM_PDU;
+  }
+
   //
   // Allocate buffer to receive one TLS payload.
   //
@@ -14,6 +14,18 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #define HTTPS_FLAG  "https://"
 
+//
+// Number of fragments a single loaned receive can describe, enough
+// for the segments of a maximum sized TLS record with a common MSS.
+//
+#define HTTPS_RX_LOAN_FRAGMENT_COUNT  16
+
+typedef struct {
+  EDKII_TCP_RX_LOAN_PROTOCOL    *TcpRxLoan;
+  EFI_TCP4_RECEIVE_DATA         RxData;
+  EFI_TCP4_FRAGMENT_DATA        MoreFragments[HTTPS_RX_LOAN_FRAGMENT_COUNT - 1];
+} HTTPS_RX_LOAN;
+
 /**
   Check whether the Url is from Https.
 
@@ -146,6 +158,32 @@ TlsCommonReceive (
   IN     EFI_EVENT      Timeout
   );
 
+/**
+  Receive Len bytes through the EDKII_TCP_RX_LOAN_PROTOCOL. The received data
+  isn't copied, each loaned receive is wrapped in a net buffer which returns
+  the receive buffers to the TCP driver when freed.
+
+  @param[in, out]   HttpInstance    Pointer to HTTP_PROTOCOL structure.
+  @param[in]        Len             The length of data to receive.
+  @param[in, out]   NbufList        The list the received net buffers are appended to.
+  @param[in]        Timeout         The time to wait for connection done.
+
+  @retval EFI_SUCCESS            Len bytes are received.
+  @retval EFI_INVALID_PARAMETER  HttpInstance or NbufList is NULL.
+  @retval EFI_OUT_OF_RESOURCES   Can't allocate memory resources.
+  @retval EFI_TIMEOUT            The operation is time out.
+  @retval Others                 Other error as indicated.
+
+**/
+EFI_STATUS
+EFIAPI
+TlsLoanReceive (
+  IN OUT HTTP_PROTOCOL  *HttpInstance,
+  IN     UINT32         Len,
+  IN OUT LIST_ENTRY     *NbufList,
+  IN     EFI_EVENT      Timeout
+  );
+
 /**
   Receive one TLS PDU. An TLS PDU contains an TLS record header and its
   corresponding record data. These two parts will be put into two blocks of buffers in the
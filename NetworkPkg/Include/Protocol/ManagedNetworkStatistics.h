@@ -0,0 +1,101 @@
+/** @file
+  This file defines the EDKII Managed Network Statistics Protocol interface.
+
+  The protocol is installed by the MNP driver on each MNP service handle, next to
+  the EFI_MANAGED_NETWORK_SERVICE_BINDING_PROTOCOL. It reports how the receive path
+  of the MNP service behaves, to help tuning the network stack of a platform.
+
+  Copyright (c) 2026, TianoCore and contributors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#ifndef EDKII_MANAGED_NETWORK_STATISTICS_H_
+#define EDKII_MANAGED_NETWORK_STATISTICS_H_
+
+#define EDKII_MANAGED_NETWORK_STATISTICS_PROTOCOL_GUID \
+  { \
+    0xb4b0379d, 0x34d6, 0x4929, {0xad, 0xb8, 0x38, 0xe0, 0xc0, 0xa8, 0xb3, 0x9a} \
+  }
+
+typedef struct _EDKII_MANAGED_NETWORK_STATISTICS_PROTOCOL EDKII_MANAGED_NETWORK_STATISTICS_PROTOCOL;
+
+typedef struct {
+  ///
+  /// Number of receive polls of the network device, by the system poll timer
+  /// or by the Poll() function of the MNP children.
+  ///
+  UINT64    Polls;
+  ///
+  /// Number of packets received from the network device.
+  ///
+  UINT64    RxPackets;
+  ///
+  /// Largest number of packets received by a single poll.
+  ///
+  UINT32    MaxPacketsPerPoll;
+  ///
+  /// Number of polls which stopped receiving because the poll budget ran out.
+  ///
+  UINT64    BudgetExhausted;
+  ///
+  /// Current period of the system poll timer, in 100ns units. 0 if the system
+  /// poll is disabled.
+  ///
+  UINT64    PollInterval;
+  ///
+  /// Number of packets dropped by the children of the MNP service because their
+  /// receive queue was full.
+  ///
+  UINT64    QueueFullDrops;
+  ///
+  /// Number of packets dropped by the children of the MNP service because they
+  /// stayed in the receive queue longer than ReceivedQueueTimeoutValue.
+  ///
+  UINT64    QueueTimeoutDrops;
+  ///
+  /// Number of packets currently in the receive queues of the children of the
+  /// MNP service.
+  ///
+  UINT32    QueueDepth;
+  ///
+  /// Largest number of packets held by the receive queue of one child.
+  ///
+  UINT32    MaxQueueDepth;
+} EDKII_MANAGED_NETWORK_STATISTICS;
+
+/**
+  Returns the receive statistics of the MNP service, and optionally resets them.
+
+  Polls, RxPackets, MaxPacketsPerPoll, BudgetExhausted and PollInterval describe the
+  network device, which is shared by all the MNP services of its VLANs. The other
+  counters are specific to the MNP service.
+
+  @param[in]   This              Pointer to the EDKII_MANAGED_NETWORK_STATISTICS_PROTOCOL
+                                 instance.
+  @param[in]   Reset             Set to TRUE to reset the counters after reading them.
+  @param[out]  Statistics        Pointer to the buffer to receive the statistics.
+                                 Optional if Reset is TRUE.
+
+  @retval EFI_SUCCESS            The statistics are returned.
+  @retval EFI_INVALID_PARAMETER  This is NULL, or Statistics is NULL and Reset is FALSE.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_MANAGED_NETWORK_GET_STATISTICS)(
+  IN  EDKII_MANAGED_NETWORK_STATISTICS_PROTOCOL  *This,
+  IN  BOOLEAN                                    Reset,
+  OUT EDKII_MANAGED_NETWORK_STATISTICS           *Statistics OPTIONAL
+  );
+
+///
+/// EDKII Managed Network Statistics Protocol reports the receive statistics of an
+/// MNP service.
+///
+struct _EDKII_MANAGED_NETWORK_STATISTICS_PROTOCOL {
+  EDKII_MANAGED_NETWORK_GET_STATISTICS    GetStatistics;
+};
+
+extern EFI_GUID  gEdkiiManagedNetworkStatisticsProtocolGuid;
+
+#endif /* EDKII_MANAGED_NETWORK_STATISTICS_H_ */
@@ -0,0 +1,99 @@
+/** @file
+  This file defines the EDKII TCP Receive Loan Protocol interface.
+
+  The protocol is installed by the TCP driver on each TCP4 and TCP6 child handle,
+  next to EFI_TCP4_PROTOCOL or EFI_TCP6_PROTOCOL. It receives data without copying
+  it into caller buffers: the fragment table of the receive token is set to point
+  to the buffers holding the received packets instead. These buffers are loaned to
+  the caller until it returns them.
+
+  Copyright (c) 2026, TianoCore and contributors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#ifndef EDKII_TCP_RX_LOAN_H_
+#define EDKII_TCP_RX_LOAN_H_
+
+#include <Protocol/Tcp4.h>
+
+#define EDKII_TCP_RX_LOAN_PROTOCOL_GUID \
+  { \
+    0x4aca4107, 0x0d9b, 0x4f0f, {0x88, 0x84, 0x83, 0xd8, 0x85, 0x88, 0x99, 0x83} \
+  }
+
+typedef struct _EDKII_TCP_RX_LOAN_PROTOCOL EDKII_TCP_RX_LOAN_PROTOCOL;
+
+/**
+  Places an asynchronous receive request into the receiving queue, the received
+  data being loaned to the caller.
+
+  This function behaves as the Receive() function of EFI_TCP4_PROTOCOL, except for
+  the receive data of the token:
+  - On input, DataLength is the maximum length of data to receive, FragmentCount
+    is the number of entries in FragmentTable. The FragmentBuffer of the entries
+    is ignored.
+  - When the token is signaled with EFI_SUCCESS, DataLength and FragmentCount are
+    updated to the length of data received and the number of entries used. Each
+    entry points to a receive buffer of the driver.
+
+  The receive buffers stay valid, and count against the receive window of the
+  connection, until the caller returns them with ReturnData(). They must be
+  returned before the child is destroyed.
+
+  On a TCP6 child, Token points to an EFI_TCP6_IO_TOKEN, which has the same layout.
+
+  @param[in]  This                 Pointer to the EDKII_TCP_RX_LOAN_PROTOCOL instance.
+  @param[in]  Token                Pointer to a token that is associated with the
+                                   receive data descriptor.
+
+  @retval EFI_SUCCESS              The receive completion token was cached.
+  @retval EFI_NOT_STARTED          The TCP instance hasn't been configured.
+  @retval EFI_NO_MAPPING           The default address configuration is not finished.
+  @retval EFI_INVALID_PARAMETER    One or more parameters are invalid.
+  @retval EFI_OUT_OF_RESOURCES     The receive completion token could not be queued
+                                   due to a lack of system resources.
+  @retval EFI_ACCESS_DENIED        The token is already queued, or the connection
+                                   isn't synchronized.
+  @retval EFI_CONNECTION_FIN       The communication peer has closed the connection,
+                                   and there is no buffered data in the receive
+                                   buffer of this instance.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_TCP_RX_LOAN_RECEIVE)(
+  IN EDKII_TCP_RX_LOAN_PROTOCOL  *This,
+  IN EFI_TCP4_IO_TOKEN           *Token
+  );
+
+/**
+  Returns the receive buffers loaned by Receive() to the driver.
+
+  @param[in]  This                 Pointer to the EDKII_TCP_RX_LOAN_PROTOCOL instance.
+  @param[in]  RxData               The receive data of a token completed by Receive().
+
+  @retval EFI_SUCCESS              The receive buffers are returned.
+  @retval EFI_INVALID_PARAMETER    This or RxData is NULL.
+  @retval EFI_ACCESS_DENIED        The instance is busy, retry later.
+  @retval EFI_NOT_FOUND            RxData doesn't describe buffers loaned by this
+                                   instance.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_TCP_RX_LOAN_RETURN)(
+  IN EDKII_TCP_RX_LOAN_PROTOCOL  *This,
+  IN EFI_TCP4_RECEIVE_DATA       *RxData
+  );
+
+///
+/// EDKII TCP Receive Loan Protocol receives TCP data without copying it.
+///
+struct _EDKII_TCP_RX_LOAN_PROTOCOL {
+  EDKII_TCP_RX_LOAN_RECEIVE    Receive;
+  EDKII_TCP_RX_LOAN_RETURN     ReturnData;
+};
+
+extern EFI_GUID  gEdkiiTcpRxLoanProtocolGuid;
+
+#endif /* EDKII_TCP_RX_LOAN_H_ */
@@ -25,6 +25,10 @@ EFI_MANAGED_NETWORK_PROTOCOL  mMnpProtocolTemplate = {
   MnpPoll
 };
 
+EDKII_MANAGED_NETWORK_STATISTICS_PROTOCOL  mMnpStatisticsProtocolTemplate = {
+  MnpGetStatistics
+};
+
 EFI_MANAGED_NETWORK_CONFIG_DATA  mMnpDefaultConfigData = {
   10000000,
   10000000,
@@ -721,6 +725,7 @@ MnpCreateServiceData (
   // Copy the ServiceBinding structure.
   //
   CopyMem (&MnpServiceData->ServiceBinding, &mMnpServiceBindingProtocol, sizeof (EFI_SERVICE_BINDING_PROTOCOL));
+  CopyMem (&MnpServiceData->Statistics, &mMnpStatisticsProtocolTemplate, sizeof (EDKII_MANAGED_NETWORK_STATISTICS_PROTOCOL));
 
   //
   // Initialize the lists.
@@ -776,12 +781,14 @@ MnpCreateServiceData (
   MnpServiceData->Priority      = Priority;
 
   //
-  // Install the MNP Service Binding Protocol
+  // Install the MNP Service Binding Protocol and the MNP Statistics Protocol
   //
   Status = gBS->InstallMultipleProtocolInterfaces (
                   &MnpServiceHandle,
                   &gEfiManagedNetworkServiceBindingProtocolGuid,
                   &MnpServiceData->ServiceBinding,
+                  &gEdkiiManagedNetworkStatisticsProtocolGuid,
+                  &MnpServiceData->Statistics,
                   NULL
                   );
 
@@ -811,12 +818,14 @@ MnpDestroyServiceData (
   EFI_STATUS  Status;
 
   //
-  // Uninstall the MNP Service Binding Protocol
+  // Uninstall the MNP Service Binding Protocol and the MNP Statistics Protocol
   //
   Status = gBS->UninstallMultipleProtocolInterfaces (
                   MnpServiceData->ServiceHandle,
                   &gEfiManagedNetworkServiceBindingProtocolGuid,
                   &MnpServiceData->ServiceBinding,
+                  &gEdkiiManagedNetworkStatisticsProtocolGuid,
+                  &MnpServiceData->Statistics,
                   NULL
                   );
   if (EFI_ERROR (Status)) {
@@ -1273,6 +1282,7 @@ MnpStart (
     }
 
     MnpDeviceData->EnableSystemPoll = EnableSystemPoll;
+    MnpDeviceData->PollInterval     = EnableSystemPoll ? MNP_SYS_POLL_INTERVAL : 0;
   }
 
   //
@@ -1332,6 +1342,7 @@ MnpStop (
     //
     Status                          = gBS->SetTimer (MnpDeviceData->PollTimer, TimerCancel, 0);
     MnpDeviceData->EnableSystemPoll = FALSE;
+    MnpDeviceData->PollInterval     = 0;
   }
 
   //
@@ -15,6 +15,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Protocol/SimpleNetwork.h>
 #include <Protocol/ServiceBinding.h>
 #include <Protocol/VlanConfig.h>
+#include <Protocol/ManagedNetworkStatistics.h>
 
 #include <Library/BaseLib.h>
 #include <Library/BaseMemoryLib.h>
@@ -69,6 +70,7 @@ typedef struct {
 
   EFI_EVENT                      PollTimer;
   BOOLEAN                        EnableSystemPoll;
+  UINT64                         PollInterval;
 
   EFI_EVENT                      TimeoutCheckTimer;
   EFI_EVENT                      MediaDetectTimer;
@@ -85,6 +87,14 @@ typedef struct {
   UINT32                         BufferLength;
   UINT32                         PaddingSize;
   NET_BUF                        *RxNbufCache;
+
+  //
+  // Receive statistics of the device.
+  //
+  UINT64                         RxPolls;
+  UINT64                         RxPackets;
+  UINT32                         RxMaxPacketsPerPoll;
+  UINT64                         RxBudgetExhausted;
 } MNP_DEVICE_DATA;
 
 #define MNP_DEVICE_DATA_FROM_THIS(a) \
@@ -98,22 +108,30 @@ typedef struct {
 #define MNP_SERVICE_DATA_SIGNATURE  SIGNATURE_32 ('M', 'n', 'p', 'S')
 
 typedef struct {
-  UINT32                          Signature;
+  UINT32                                       Signature;
 
-  LIST_ENTRY                      Link;
+  LIST_ENTRY                                   Link;
 
-  MNP_DEVICE_DATA                 *MnpDeviceData;
-  EFI_HANDLE                      ServiceHandle;
-  EFI_SERVICE_BINDING_PROTOCOL    ServiceBinding;
-  EFI_DEVICE_PATH_PROTOCOL        *DevicePath;
+  MNP_DEVICE_DATA                              *MnpDeviceData;
+  EFI_HANDLE                                   ServiceHandle;
+  EFI_SERVICE_BINDING_PROTOCOL                 ServiceBinding;
+  EFI_DEVICE_PATH_PROTOCOL                     *DevicePath;
 
-  LIST_ENTRY                      ChildrenList;
-  UINTN                           ChildrenNumber;
+  LIST_ENTRY                                   ChildrenList;
+  UINTN                                        ChildrenNumber;
 
-  UINT32                          Mtu;
+  UINT32                                       Mtu;
 
-  UINT16                          VlanId;
-  UINT8                           Priority;
+  UINT16                                       VlanId;
+  UINT8                                        Priority;
+
+  //
+  // Receive statistics of the service.
+  //
+  EDKII_MANAGED_NETWORK_STATISTICS_PROTOCOL    Statistics;
+  UINT64                                       QueueFullDrops;
+  UINT64                                       QueueTimeoutDrops;
+  UINT32                                       MaxQueueDepth;
 } MNP_SERVICE_DATA;
 
 #define MNP_SERVICE_DATA_FROM_THIS(a) \
@@ -124,6 +142,14 @@ typedef struct {
   MNP_SERVICE_DATA_SIGNATURE \
   )
 
+#define MNP_SERVICE_DATA_FROM_STATISTICS(a) \
+  CR ( \
+  (a), \
+  MNP_SERVICE_DATA, \
+  Statistics, \
+  MNP_SERVICE_DATA_SIGNATURE \
+  )
+
 #define MNP_SERVICE_DATA_FROM_LINK(a) \
   CR ( \
   (a), \
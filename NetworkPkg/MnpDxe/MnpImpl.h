@@ -14,6 +14,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define NET_ETHER_FCS_SIZE  4
 
 #define MNP_SYS_POLL_INTERVAL        (10 * TICKS_PER_MS)    // 10 milliseconds
+#define MNP_SYS_POLL_INTERVAL_MIN    (1 * TICKS_PER_MS)     // 1 millisecond
 #define MNP_TIMEOUT_CHECK_INTERVAL   (50 * TICKS_PER_MS)    // 50 milliseconds
 #define MNP_MEDIA_DETECT_INTERVAL    (500 * TICKS_PER_MS)   // 500 milliseconds
 #define MNP_TX_TIMEOUT_TIME          (500 * TICKS_PER_MS)   // 500 milliseconds
@@ -25,6 +26,11 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #define MNP_MAX_RCVD_PACKET_QUE_SIZE  256
 
+//
+// Maximum number of packets received from Snp by one poll.
+//
+#define MNP_RX_POLL_BUDGET  64
+
 #define MNP_RECEIVE_UNICAST    0x01
 #define MNP_RECEIVE_BROADCAST  0x02
 
@@ -430,6 +436,27 @@ MnpReceivePacket (
   IN OUT MNP_DEVICE_DATA  *MnpDeviceData
   );
 
+/**
+  Receive and deliver the packets pending in Snp, until there is none left or
+  Budget packets are received.
+
+  @param[in, out]  MnpDeviceData        Pointer to the mnp device context data.
+  @param[in]       Budget               The maximum number of packets to receive.
+  @param[out]      Received             The number of packets received.
+
+  @retval EFI_SUCCESS           At least one packet is received.
+  @retval EFI_NOT_STARTED       The simple network protocol is not started.
+  @retval EFI_NOT_READY         No packet received.
+  @retval EFI_DEVICE_ERROR      An unexpected error occurs.
+
+**/
+EFI_STATUS
+MnpReceivePackets (
+  IN OUT MNP_DEVICE_DATA  *MnpDeviceData,
+  IN     UINT32           Budget,
+  OUT    UINT32           *Received
+  );
+
 /**
   Allocate a free NET_BUF from MnpDeviceData->FreeNbufQue. If there is none
   in the queue, first try to allocate some and add them into the queue, then
@@ -532,6 +559,27 @@ MnpSystemPoll (
   IN VOID       *Context
   );
 
+/**
+  Returns the receive statistics of the MNP service, and optionally resets them.
+
+  @param[in]   This              Pointer to the EDKII_MANAGED_NETWORK_STATISTICS_PROTOCOL
+                                 instance.
+  @param[in]   Reset             Set to TRUE to reset the counters after reading them.
+  @param[out]  Statistics        Pointer to the buffer to receive the statistics.
+                                 Optional if Reset is TRUE.
+
+  @retval EFI_SUCCESS            The statistics are returned.
+  @retval EFI_INVALID_PARAMETER  This is NULL, or Statistics is NULL and Reset is FALSE.
+
+**/
+EFI_STATUS
+EFIAPI
+MnpGetStatistics (
+  IN  EDKII_MANAGED_NETWORK_STATISTICS_PROTOCOL  *This,
+  IN  BOOLEAN                                    Reset,
+  OUT EDKII_MANAGED_NETWORK_STATISTICS           *Statistics OPTIONAL
+  );
+
 /**
   Returns the operational parameters for the current MNP child driver. May also
   support returning the underlying SNP driver mode data.
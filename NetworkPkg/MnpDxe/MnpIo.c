@@ -496,6 +496,7 @@ MnpQueueRcvdPacket (
     //
     MnpRecycleRxData (NULL, (VOID *)OldRxDataWrap);
     Instance->RcvdPacketQueueSize--;
+    Instance->MnpServiceData->QueueFullDrops++;
   }
 
   //
@@ -508,6 +509,10 @@ MnpQueueRcvdPacket (
   //
   InsertTailList (&Instance->RcvdPacketQueue, &RxDataWrap->WrapEntry);
   Instance->RcvdPacketQueueSize++;
+
+  if (Instance->RcvdPacketQueueSize > Instance->MnpServiceData->MaxQueueDepth) {
+    Instance->MnpServiceData->MaxQueueDepth = (UINT32)Instance->RcvdPacketQueueSize;
+  }
 }
 
 /**
@@ -985,6 +990,59 @@ EXIT:
   return Status;
 }
 
+/**
+  Receive and deliver the packets pending in Snp, until there is none left or
+  Budget packets are received.
+
+  @param[in, out]  MnpDeviceData        Pointer to the mnp device context data.
+  @param[in]       Budget               The maximum number of packets to receive.
+  @param[out]      Received             The number of packets received.
+
+  @retval EFI_SUCCESS           At least one packet is received.
+  @retval EFI_NOT_STARTED       The simple network protocol is not started.
+  @retval EFI_NOT_READY         No packet received.
+  @retval EFI_DEVICE_ERROR      An unexpected error occurs.
+
+**/
+EFI_STATUS
+MnpReceivePackets (
+  IN OUT MNP_DEVICE_DATA  *MnpDeviceData,
+  IN     UINT32           Budget,
+  OUT    UINT32           *Received
+  )
+{
+  EFI_STATUS  Status;
+  UINT32      Count;
+
+  Status = EFI_NOT_READY;
+
+  for (Count = 0; Count < Budget; Count++) {
+    Status = MnpReceivePacket (MnpDeviceData);
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+
+    //
+    // Dispatch the DPC queued by the NotifyFunction of rx token's events, so
+    // that the receivers can queue new rx tokens before the next packet.
+    //
+    DispatchDpc ();
+  }
+
+  MnpDeviceData->RxPolls++;
+  MnpDeviceData->RxPackets += Count;
+  if (Count > MnpDeviceData->RxMaxPacketsPerPoll) {
+    MnpDeviceData->RxMaxPacketsPerPoll = Count;
+  }
+
+  if (Count == Budget) {
+    MnpDeviceData->RxBudgetExhausted++;
+  }
+
+  *Received = Count;
+  return (Count != 0) ? EFI_SUCCESS : Status;
+}
+
 /**
   Remove the received packets if timeout occurs.
 
@@ -1044,6 +1102,7 @@ MnpCheckPacketTimeout (
           DEBUG ((DEBUG_WARN, "MnpCheckPacketTimeout: Received packet timeout.\n"));
           MnpRecycleRxData (NULL, RxDataWrap);
           Instance->RcvdPacketQueueSize--;
+          MnpServiceData->QueueTimeoutDrops++;
         }
       }
 
@@ -1099,6 +1158,8 @@ MnpSystemPoll (
   )
 {
   MNP_DEVICE_DATA  *MnpDeviceData;
+  UINT32           Received;
+  UINT64           PollInterval;
 
   MnpDeviceData = (MNP_DEVICE_DATA *)Context;
   NET_CHECK_SIGNATURE (MnpDeviceData, MNP_DEVICE_DATA_SIGNATURE);
@@ -1106,10 +1167,34 @@ MnpSystemPoll (
   //
   // Try to receive packets from Snp.
   //
-  MnpReceivePacket (MnpDeviceData);
+  MnpReceivePackets (MnpDeviceData, MNP_RX_POLL_BUDGET, &Received);
 
   //
   // Dispatch the DPC queued by the NotifyFunction of rx token's events.
   //
   DispatchDpc ();
+
+  if (!MnpDeviceData->EnableSystemPoll) {
+    return;
+  }
+
+  //
+  // Adapt the poll interval to the traffic: poll at the fastest rate while
+  // the budget runs out, speed up while packets come in, and slow down back
+  // to MNP_SYS_POLL_INTERVAL when the link is idle.
+  //
+  PollInterval = MnpDeviceData->PollInterval;
+  if (Received == MNP_RX_POLL_BUDGET) {
+    PollInterval = MNP_SYS_POLL_INTERVAL_MIN;
+  } else if (Received != 0) {
+    PollInterval = MAX (PollInterval / 2, MNP_SYS_POLL_INTERVAL_MIN);
+  } else {
+    PollInterval = MIN (PollInterval * 2, MNP_SYS_POLL_INTERVAL);
+  }
+
+  if (PollInterval != MnpDeviceData->PollInterval) {
+    if (!EFI_ERROR (gBS->SetTimer (MnpDeviceData->PollTimer, TimerPeriodic, PollInterval))) {
+      MnpDeviceData->PollInterval = PollInterval;
+    }
+  }
 }
@@ -756,6 +756,7 @@ MnpPoll (
   EFI_STATUS         Status;
   MNP_INSTANCE_DATA  *Instance;
   EFI_TPL            OldTpl;
+  UINT32             Received;
 
   if (This == NULL) {
     return EFI_INVALID_PARAMETER;
@@ -773,7 +774,7 @@ MnpPoll (
   //
   // Try to receive packets.
   //
-  Status = MnpReceivePacket (Instance->MnpServiceData->MnpDeviceData);
+  Status = MnpReceivePackets (Instance->MnpServiceData->MnpDeviceData, MNP_RX_POLL_BUDGET, &Received);
 
   //
   // Dispatch the DPC queued by the NotifyFunction of rx token's events.
@@ -785,3 +786,73 @@ ON_EXIT:
 
   return Status;
 }
+
+/**
+  Returns the receive statistics of the MNP service, and optionally resets them.
+
+  @param[in]   This              Pointer to the EDKII_MANAGED_NETWORK_STATISTICS_PROTOCOL
+                                 instance.
+  @param[in]   Reset             Set to TRUE to reset the counters after reading them.
+  @param[out]  Statistics        Pointer to the buffer to receive the statistics.
+                                 Optional if Reset is TRUE.
+
+  @retval EFI_SUCCESS            The statistics are returned.
+  @retval EFI_INVALID_PARAMETER  This is NULL, or Statistics is NULL and Reset is FALSE.
+
+**/
+EFI_STATUS
+EFIAPI
+MnpGetStatistics (
+  IN  EDKII_MANAGED_NETWORK_STATISTICS_PROTOCOL  *This,
+  IN  BOOLEAN                                    Reset,
+  OUT EDKII_MANAGED_NETWORK_STATISTICS           *Statistics OPTIONAL
+  )
+{
+  MNP_SERVICE_DATA   *MnpServiceData;
+  MNP_DEVICE_DATA    *MnpDeviceData;
+  MNP_INSTANCE_DATA  *Instance;
+  LIST_ENTRY         *Entry;
+  EFI_TPL            OldTpl;
+
+  if ((This == NULL) || (!Reset && (Statistics == NULL))) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  MnpServiceData = MNP_SERVICE_DATA_FROM_STATISTICS (This);
+  MnpDeviceData  = MnpServiceData->MnpDeviceData;
+
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+
+  if (Statistics != NULL) {
+    Statistics->Polls             = MnpDeviceData->RxPolls;
+    Statistics->RxPackets         = MnpDeviceData->RxPackets;
+    Statistics->MaxPacketsPerPoll = MnpDeviceData->RxMaxPacketsPerPoll;
+    Statistics->BudgetExhausted   = MnpDeviceData->RxBudgetExhausted;
+    Statistics->PollInterval      = MnpDeviceData->PollInterval;
+    Statistics->QueueFullDrops    = MnpServiceData->QueueFullDrops;
+    Statistics->QueueTimeoutDrops = MnpServiceData->QueueTimeoutDrops;
+    Statistics->MaxQueueDepth     = MnpServiceData->MaxQueueDepth;
+
+    Statistics->QueueDepth = 0;
+    NET_LIST_FOR_EACH (Entry, &MnpServiceData->ChildrenList) {
+      Instance = NET_LIST_USER_STRUCT (Entry, MNP_INSTANCE_DATA, InstEntry);
+      NET_CHECK_SIGNATURE (Instance, MNP_INSTANCE_DATA_SIGNATURE);
+
+      Statistics->QueueDepth += (UINT32)Instance->RcvdPacketQueueSize;
+    }
+  }
+
+  if (Reset) {
+    MnpDeviceData->RxPolls             = 0;
+    MnpDeviceData->RxPackets           = 0;
+    MnpDeviceData->RxMaxPacketsPerPoll = 0;
+    MnpDeviceData->RxBudgetExhausted   = 0;
+    MnpServiceData->QueueFullDrops     = 0;
+    MnpServiceData->QueueTimeoutDrops  = 0;
+    MnpServiceData->MaxQueueDepth      = 0;
+  }
+
+  gBS->RestoreTPL (OldTpl);
+
+  return EFI_SUCCESS;
+}
@@ -0,0 +1,197 @@
+/** @file
+  Tests for TcpCongest.c.
+
+  Copyright (c) 2026, TianoCore and contributors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+#include <Library/GoogleTestLib.h>
+
+extern "C" {
+  #include <Uefi.h>
+  #include <Library/BaseLib.h>
+  #include <Library/BaseMemoryLib.h>
+  #include <Library/DebugLib.h>
+  #include "../TcpMain.h"
+}
+
+////////////////////////////////////////////////////////////////////////
+// TcpCubeRoot Tests
+////////////////////////////////////////////////////////////////////////
+
+TEST (TcpCubeRootTest, ExactAndRoundedDown) {
+  EXPECT_EQ (TcpCubeRoot (0), 0U);
+  EXPECT_EQ (TcpCubeRoot (1), 1U);
+  EXPECT_EQ (TcpCubeRoot (26), 2U);
+  EXPECT_EQ (TcpCubeRoot (27), 3U);
+  EXPECT_EQ (TcpCubeRoot (1000000000000000000ULL), 1000000U);
+  EXPECT_EQ (TcpCubeRoot (MAX_UINT64), 2642245U);
+}
+
+////////////////////////////////////////////////////////////////////////
+// TcpCongest Tests
+////////////////////////////////////////////////////////////////////////
+
+class TcpCongestTest : public ::testing::Test {
+protected:
+  TCP_CB    Tcb;
+  TCP_OPTION Option;
+
+  virtual void
+  SetUp (
+    )
+  {
+    ZeroMem (&Tcb, sizeof (Tcb));
+    ZeroMem (&Option, sizeof (Option));
+
+    Tcb.SndMss   = 1000;
+    Tcb.SndUna   = 10000;
+    Tcb.SndNxt   = 50000;
+    Tcb.CWnd     = 40000;
+    Tcb.Ssthresh = 0xffffffff;
+
+    TcpSackClear (&Tcb);
+    TcpCongestInit (&Tcb);
+  }
+
+  VOID
+  AddOptionBlock (
+    TCP_SEQNO  Left,
+    TCP_SEQNO  Right
+    )
+  {
+    Option.Sack[Option.SackCount].Left  = Left;
+    Option.Sack[Option.SackCount].Right = Right;
+    Option.SackCount++;
+    Option.Flag = TCP_OPTION_RCVD_SACK;
+  }
+};
+
+TEST_F (TcpCongestTest, ScoreboardKeepsRangesSorted) {
+  TcpSackInsert (&Tcb, 30000, 31000);
+  TcpSackInsert (&Tcb, 12000, 13000);
+  TcpSackInsert (&Tcb, 20000, 21000);
+
+  ASSERT_EQ (Tcb.SackCount, 3);
+  EXPECT_EQ (Tcb.SackBlock[0].Left, 12000U);
+  EXPECT_EQ (Tcb.SackBlock[1].Left, 20000U);
+  EXPECT_EQ (Tcb.SackBlock[2].Left, 30000U);
+}
+
+TEST_F (TcpCongestTest, ScoreboardMergesOverlappingRanges) {
+  TcpSackInsert (&Tcb, 12000, 13000);
+  TcpSackInsert (&Tcb, 14000, 15000);
+  TcpSackInsert (&Tcb, 20000, 21000);
+
+  //
+  // Touches the first range, and covers the second one.
+  //
+  TcpSackInsert (&Tcb, 13000, 16000);
+
+  ASSERT_EQ (Tcb.SackCount, 2);
+  EXPECT_EQ (Tcb.SackBlock[0].Left, 12000U);
+  EXPECT_EQ (Tcb.SackBlock[0].Right, 16000U);
+  EXPECT_EQ (Tcb.SackBlock[1].Left, 20000U);
+  EXPECT_EQ (Tcb.SackBlock[1].Right, 21000U);
+}
+
+TEST_F (TcpCongestTest, FullScoreboardForgetsHighestRange) {
+  UINT32  Index;
+
+  for (Index = 0; Index < TCP_SACK_SCOREBOARD_SIZE; Index++) {
+    TcpSackInsert (&Tcb, 12000 + Index * 2000, 13000 + Index * 2000);
+  }
+
+  TcpSackInsert (&Tcb, 11000, 11500);
+
+  ASSERT_EQ (Tcb.SackCount, TCP_SACK_SCOREBOARD_SIZE);
+  EXPECT_EQ (Tcb.SackBlock[0].Left, 11000U);
+  EXPECT_EQ (Tcb.SackBlock[TCP_SACK_SCOREBOARD_SIZE - 1].Left, 12000U + (TCP_SACK_SCOREBOARD_SIZE - 2) * 2000);
+}
+
+TEST_F (TcpCongestTest, UpdateTrimsAcknowledgedData) {
+  TcpSackInsert (&Tcb, 12000, 13000);
+  TcpSackInsert (&Tcb, 20000, 21000);
+
+  //
+  // The ACK covers the first range and part of the second.
+  //
+  TcpSackUpdate (&Tcb, 20500, &Option);
+
+  ASSERT_EQ (Tcb.SackCount, 1);
+  EXPECT_EQ (Tcb.SackBlock[0].Left, 20500U);
+  EXPECT_EQ (Tcb.SackBlock[0].Right, 21000U);
+}
+
+TEST_F (TcpCongestTest, UpdateIgnoresInvalidBlocks) {
+  AddOptionBlock (9000, 9500);   // D-SACK of data already acknowledged
+  AddOptionBlock (60000, 61000); // Beyond the data sent
+  AddOptionBlock (30000, 29000); // Empty
+  AddOptionBlock (25000, 26000);
+
+  TcpSackUpdate (&Tcb, 10000, &Option);
+
+  ASSERT_EQ (Tcb.SackCount, 1);
+  EXPECT_EQ (Tcb.SackBlock[0].Left, 25000U);
+  EXPECT_EQ (Tcb.SackBlock[0].Right, 26000U);
+}
+
+TEST_F (TcpCongestTest, NewRenoHalvesTheWindow) {
+  Tcb.CongestControl = TCP_CONGEST_CONTROL_NEWRENO;
+
+  EXPECT_EQ (TcpCongestSsthresh (&Tcb, 40000), 20000U);
+  EXPECT_EQ (TcpCongestSsthresh (&Tcb, 3000), 2000U);
+}
+
+TEST_F (TcpCongestTest, CubicReducesTheWindowByBeta) {
+  Tcb.CongestControl = TCP_CONGEST_CONTROL_CUBIC;
+
+  EXPECT_EQ (TcpCongestSsthresh (&Tcb, 40000), 28000U);
+  EXPECT_EQ (Tcb.CubicWMax, 40000U);
+
+  //
+  // Fast convergence: a loss below the last W_max lowers it further.
+  //
+  Tcb.CWnd = 30000;
+  EXPECT_EQ (TcpCongestSsthresh (&Tcb, 30000), 21000U);
+  EXPECT_EQ (Tcb.CubicWMax, 25500U);
+}
+
+TEST_F (TcpCongestTest, SlowStartThenAvoidance) {
+  Tcb.CongestControl = TCP_CONGEST_CONTROL_NEWRENO;
+  Tcb.Ssthresh       = 42000;
+
+  TcpCongestOpenWindow (&Tcb);
+  EXPECT_EQ (Tcb.CWnd, 41000U);
+
+  Tcb.CWnd = 50000;
+  TcpCongestOpenWindow (&Tcb);
+  EXPECT_EQ (Tcb.CWnd, 50020U);
+}
+
+TEST_F (TcpCongestTest, CubicGrowsBackToTheLastMaximum) {
+  UINT32  Acks;
+
+  Tcb.CongestControl = TCP_CONGEST_CONTROL_CUBIC;
+  Tcb.Ssthresh       = TcpCongestSsthresh (&Tcb, Tcb.CWnd);
+  Tcb.CWnd           = Tcb.Ssthresh;
+
+  //
+  // Only concave growth toward W_max right after the loss.
+  //
+  for (Acks = 0; Acks < 28; Acks++) {
+    TcpCongestOpenWindow (&Tcb);
+  }
+
+  EXPECT_GT (Tcb.CWnd, 28000U);
+  EXPECT_LT (Tcb.CWnd, 40000U);
+
+  //
+  // Two seconds after K, the window is above W_max.
+  //
+  mTcpTick += (Tcb.CubicK + 2000) / TCP_TICK;
+  for (Acks = 0; Acks < 200; Acks++) {
+    TcpCongestOpenWindow (&Tcb);
+  }
+
+  EXPECT_GE (Tcb.CWnd, 40000U);
+}
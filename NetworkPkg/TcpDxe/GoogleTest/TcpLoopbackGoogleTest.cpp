@@ -0,0 +1,645 @@
+/** @file
+  Loopback tests of the TCP loss recovery and congestion control.
+
+  Two TCP instances are connected back to back through a simulated link.
+  The data direction has a bottleneck rate with a drop tail queue and a
+  pseudo random loss rate, both directions have a fixed delay. The socket
+  and IP layers are replaced by the stubs of this file, and the TCP heart
+  beat is driven by the simulated clock. Each test transfers a fixed
+  amount of data and reports the goodput seen by the receiving application.
+
+  Copyright (c) 2026, TianoCore and contributors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+#include <Library/GoogleTestLib.h>
+#include <map>
+#include <vector>
+
+extern "C" {
+  #include <Uefi.h>
+  #include <Library/BaseLib.h>
+  #include <Library/BaseMemoryLib.h>
+  #include <Library/MemoryAllocationLib.h>
+  #include <Library/DebugLib.h>
+  #include "../TcpMain.h"
+
+  VOID
+  EFIAPI
+  TcpTickingDpc (
+    IN VOID  *Context
+    );
+}
+
+/////////////////////////////////////////////////////////////////////////
+// Defines
+/////////////////////////////////////////////////////////////////////////
+
+#define LOOPBACK_SENDER_IP      0x0A000001
+#define LOOPBACK_RECEIVER_IP    0x0A000002
+#define LOOPBACK_SENDER_PORT    49152
+#define LOOPBACK_RECEIVER_PORT  80
+#define LOOPBACK_IP_HEAD_LEN    20
+#define LOOPBACK_MSS            1460
+
+//
+// A simulated link. The rate and the queue only apply to the data
+// direction, the ACKs are only delayed.
+//
+typedef struct {
+  UINT32    RateKbps;   // Bottleneck rate
+  UINT32    DelayMs;    // One way delay
+  UINT32    QueueBytes; // Drop tail queue of the bottleneck
+  UINT32    LossPpm;    // Random loss of the data direction, in packets per million
+} LOOPBACK_LINK;
+
+//
+// The socket of a TCP instance, with the state of the application
+// that writes or reads the data.
+//
+typedef struct {
+  SOCKET     Sock;
+  UINT64     Produced;  // Bytes moved from the send buffer to TCP
+  UINT64     Consumed;  // Bytes delivered to the application
+  BOOLEAN    Corrupted; // The data delivered didn't match the data sent
+} LOOPBACK_SOCKET;
+
+typedef struct {
+  EFI_IP_ADDRESS        Src;
+  EFI_IP_ADDRESS        Dst;
+  std::vector<UINT8>    Data;
+} LOOPBACK_PACKET;
+
+class TcpLoopbackTest;
+
+//
+// The test that currently owns the link, used by the stubs.
+//
+static TcpLoopbackTest  *mLoopback = NULL;
+
+/////////////////////////////////////////////////////////////////////////
+// Loopback
+/////////////////////////////////////////////////////////////////////////
+
+class TcpLoopbackTest : public ::testing::Test {
+public:
+  LOOPBACK_LINK                             Link;
+  UINT64                                    Now;      // Simulated time in us
+  UINT64                                    LinkFree; // When the bottleneck is idle again
+  UINT64                                    Seed;
+  UINT32                                    RandomDrops;
+  UINT32                                    QueueDrops;
+  UINT32                                    Segments;
+  std::multimap<UINT64, LOOPBACK_PACKET>    InFlight;
+
+  LOOPBACK_SOCKET                           SenderSock;
+  LOOPBACK_SOCKET                           ReceiverSock;
+  TCP_CB                                    *Sender;
+  TCP_CB                                    *Receiver;
+
+  static UINT8
+  Pattern (
+    UINT64  Offset
+    )
+  {
+    return (UINT8)(Offset % 251);
+  }
+
+  UINT32
+  Random (
+    )
+  {
+    Seed = Seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    return (UINT32)((Seed >> 33) % 1000000);
+  }
+
+  //
+  // Called by the TcpSendIpPacket stub.
+  //
+  VOID
+  Send (
+    TCP_CB   *Tcb,
+    NET_BUF  *Nbuf
+    )
+  {
+    LOOPBACK_PACKET  Packet;
+    UINT64           Arrival;
+    UINT64           Start;
+    UINT32           Size;
+
+    Size = Nbuf->TotalSize;
+
+    if (Tcb == Sender) {
+      Segments++;
+
+      //
+      // Drop the packet if the queue of the bottleneck is full.
+      //
+      Start = MAX (Now, LinkFree);
+      if ((Start - Now) * Link.RateKbps / 8000 > Link.QueueBytes) {
+        QueueDrops++;
+        return;
+      }
+
+      LinkFree = Start + (UINT64)(Size + LOOPBACK_IP_HEAD_LEN) * 8000 / Link.RateKbps;
+
+      if (Random () < Link.LossPpm) {
+        RandomDrops++;
+        return;
+      }
+
+      Arrival = LinkFree + Link.DelayMs * 1000ULL;
+    } else {
+      Arrival = Now + Link.DelayMs * 1000ULL;
+    }
+
+    CopyMem (&Packet.Src, &Tcb->LocalEnd.Ip, sizeof (EFI_IP_ADDRESS));
+    CopyMem (&Packet.Dst, &Tcb->RemoteEnd.Ip, sizeof (EFI_IP_ADDRESS));
+    Packet.Data.resize (Size);
+    NetbufCopy (Nbuf, 0, Size, Packet.Data.data ());
+
+    InFlight.insert (std::make_pair (Arrival, Packet));
+  }
+
+  VOID
+  Deliver (
+    )
+  {
+    LOOPBACK_PACKET  Packet;
+    NET_BUF          *Nbuf;
+    UINT8            *Data;
+
+    Now    = InFlight.begin ()->first;
+    Packet = InFlight.begin ()->second;
+    InFlight.erase (InFlight.begin ());
+
+    Nbuf = NetbufAlloc ((UINT32)Packet.Data.size ());
+    ASSERT_NE (Nbuf, nullptr);
+
+    Data = NetbufAllocSpace (Nbuf, (UINT32)Packet.Data.size (), NET_BUF_TAIL);
+    ASSERT_NE (Data, nullptr);
+    CopyMem (Data, Packet.Data.data (), Packet.Data.size ());
+
+    TcpInput (Nbuf, &Packet.Src, &Packet.Dst, IP_VERSION_4);
+  }
+
+  TCP_CB *
+  CreateTcb (
+    LOOPBACK_SOCKET  *Lb,
+    UINT32           LocalIp,
+    UINT16           LocalPort,
+    UINT32           RemoteIp,
+    UINT16           RemotePort,
+    TCP_SEQNO        Iss,
+    TCP_SEQNO        Irs,
+    BOOLEAN          Sack,
+    UINT8            CongestControl
+    )
+  {
+    TCP_CB  *Tcb;
+
+    ZeroMem (Lb, sizeof (LOOPBACK_SOCKET));
+    Lb->Sock.IpVersion            = IP_VERSION_4;
+    Lb->Sock.State                = SO_CONNECTED;
+    Lb->Sock.RcvBuffer.DataQueue  = NetbufQueAlloc ();
+    Lb->Sock.SndBuffer.DataQueue  = NetbufQueAlloc ();
+    Lb->Sock.RcvBuffer.HighWater  = TCP_RCV_BUF_SIZE;
+    Lb->Sock.SndBuffer.HighWater  = TCP_SND_BUF_SIZE;
+
+    Tcb = (TCP_CB *)AllocateZeroPool (sizeof (TCP_CB));
+    if (Tcb == NULL) {
+      return NULL;
+    }
+
+    InitializeListHead (&Tcb->SndQue);
+    InitializeListHead (&Tcb->RcvQue);
+    InsertTailList (&mTcpRunQue, &Tcb->List);
+
+    Tcb->Sk                = &Lb->Sock;
+    Tcb->IpInfo            = (IP_IO_IP_INFO *)AllocateZeroPool (sizeof (IP_IO_IP_INFO));
+    Tcb->IpInfo->IpVersion = IP_VERSION_4;
+
+    Tcb->LocalEnd.Ip.Addr[0]  = HTONL (LocalIp);
+    Tcb->LocalEnd.Port        = HTONS (LocalPort);
+    Tcb->RemoteEnd.Ip.Addr[0] = HTONL (RemoteIp);
+    Tcb->RemoteEnd.Port       = HTONS (RemotePort);
+    Tcb->HeadSum              = NetPseudoHeadChecksum (
+                                  Tcb->LocalEnd.Ip.Addr[0],
+                                  Tcb->RemoteEnd.Ip.Addr[0],
+                                  0x06,
+                                  0
+                                  );
+
+    //
+    // The state left by a three way handshake that negotiated the
+    // window scale, and SACK if requested, but no timestamps.
+    //
+    Tcb->State    = TCP_ESTABLISHED;
+    Tcb->CtrlFlag = TCP_CTRL_NO_KEEPALIVE | TCP_CTRL_NO_TS | TCP_CTRL_RCVD_WS;
+    if (Sack) {
+      TCP_SET_FLG (Tcb->CtrlFlag, TCP_CTRL_RCVD_SACK);
+    } else {
+      TCP_SET_FLG (Tcb->CtrlFlag, TCP_CTRL_NO_SACK);
+    }
+
+    Tcb->Iss    = Iss;
+    Tcb->SndUna = Iss + 1;
+    Tcb->SndNxt = Iss + 1;
+    Tcb->SndPsh = Iss + 1;
+    Tcb->SndUp  = Iss + 1;
+    Tcb->Irs    = Irs;
+    Tcb->RcvNxt = Irs + 1;
+    Tcb->RcvWl2 = Irs + 1;
+    Tcb->RcvUp  = Irs + 1;
+    Tcb->SndWl1 = Irs;
+    Tcb->SndWl2 = Iss + 1;
+
+    Tcb->RcvWndScale = TcpComputeScale (Tcb);
+    Tcb->SndWndScale = Tcb->RcvWndScale;
+    Tcb->RcvWnd      = TCP_RCV_BUF_SIZE;
+    Tcb->SndWnd      = TCP_RCV_BUF_SIZE;
+    Tcb->SndWndMax   = TCP_RCV_BUF_SIZE;
+    Tcb->SndMss      = LOOPBACK_MSS;
+    Tcb->RcvMss      = LOOPBACK_MSS;
+
+    Tcb->Rto            = 3 * TCP_TICK_HZ;
+    Tcb->CWnd           = Tcb->SndMss;
+    Tcb->Ssthresh       = 0xffffffff;
+    Tcb->CongestState   = TCP_CONGEST_OPEN;
+    Tcb->CongestControl = CongestControl;
+    Tcb->MaxRexmit      = TCP_MAX_LOSS;
+
+    TcpSackClear (Tcb);
+    Tcb->RcvSackSeq = Tcb->RcvNxt;
+    TcpCongestInit (Tcb);
+
+    return Tcb;
+  }
+
+  VOID
+  DestroyTcb (
+    TCP_CB  *Tcb
+    )
+  {
+    RemoveEntryList (&Tcb->List);
+    NetbufFreeList (&Tcb->SndQue);
+    NetbufFreeList (&Tcb->RcvQue);
+
+    Tcb->Sk->SndBuffer.DataQueue->BufSize = 0;
+    NetbufQueFree (Tcb->Sk->SndBuffer.DataQueue);
+    NetbufQueFree (Tcb->Sk->RcvBuffer.DataQueue);
+
+    FreePool (Tcb->IpInfo);
+    FreePool (Tcb);
+  }
+
+  //
+  // Transfer Length bytes from the sender to the receiver, and return
+  // the goodput in Kbps, or 0 if the transfer didn't complete within
+  // the time limit.
+  //
+  UINT64
+  Transfer (
+    BOOLEAN  Sack,
+    UINT8    CongestControl,
+    UINT32   Length,
+    UINT32   LimitSeconds
+    )
+  {
+    UINT64  NextTick;
+    UINT64  Start;
+    UINT64  Kbps;
+
+    Sender = CreateTcb (
+               &SenderSock,
+               LOOPBACK_SENDER_IP,
+               LOOPBACK_SENDER_PORT,
+               LOOPBACK_RECEIVER_IP,
+               LOOPBACK_RECEIVER_PORT,
+               0x10000000,
+               0x20000000,
+               Sack,
+               CongestControl
+               );
+    Receiver = CreateTcb (
+                 &ReceiverSock,
+                 LOOPBACK_RECEIVER_IP,
+                 LOOPBACK_RECEIVER_PORT,
+                 LOOPBACK_SENDER_IP,
+                 LOOPBACK_SENDER_PORT,
+                 0x20000000,
+                 0x10000000,
+                 Sack,
+                 CongestControl
+                 );
+    if ((Sender == NULL) || (Receiver == NULL)) {
+      return 0;
+    }
+
+    //
+    // The application writes all the data at once.
+    //
+    SenderSock.Sock.SndBuffer.DataQueue->BufSize = Length;
+    TcpToSendData (Sender, 0);
+
+    Start    = Now;
+    NextTick = Now + TCP_TICK * 1000;
+    while ((ReceiverSock.Consumed < Length) && (Now - Start < LimitSeconds * 1000000ULL)) {
+      if (!InFlight.empty () && (InFlight.begin ()->first <= NextTick)) {
+        Deliver ();
+      } else {
+        Now = NextTick;
+        TcpTickingDpc (NULL);
+        NextTick += TCP_TICK * 1000;
+      }
+    }
+
+    Kbps = 0;
+    if ((ReceiverSock.Consumed == Length) && !ReceiverSock.Corrupted) {
+      Kbps = (UINT64)Length * 8000 / (Now - Start);
+    }
+
+    printf (
+      "[ GOODPUT  ] %s%s: %llu Kbps, %u segments, %u random drops, %u queue drops\n",
+      (CongestControl == TCP_CONGEST_CONTROL_CUBIC) ? "CUBIC" : "NewReno",
+      Sack ? "+SACK" : "",
+      (unsigned long long)Kbps,
+      Segments,
+      RandomDrops,
+      QueueDrops
+      );
+
+    return Kbps;
+  }
+
+protected:
+  virtual void
+  SetUp (
+    )
+  {
+    Now         = 0;
+    LinkFree    = 0;
+    Seed        = 0x5EED;
+    RandomDrops = 0;
+    QueueDrops  = 0;
+    Segments    = 0;
+    Sender      = NULL;
+    Receiver    = NULL;
+    mLoopback   = this;
+  }
+
+  virtual void
+  TearDown (
+    )
+  {
+    InFlight.clear ();
+    if (Sender != NULL) {
+      DestroyTcb (Sender);
+    }
+
+    if (Receiver != NULL) {
+      DestroyTcb (Receiver);
+    }
+
+    mLoopback = NULL;
+  }
+};
+
+////////////////////////////////////////////////////////////////////////
+// Symbol Definitions
+// These functions are not directly under test - but required to compile
+////////////////////////////////////////////////////////////////////////
+
+UINT32
+SockGetDataToSend (
+  IN  SOCKET  *Sock,
+  IN  UINT32  Offset,
+  IN  UINT32  Len,
+  OUT UINT8   *Dest
+  )
+{
+  LOOPBACK_SOCKET  *Lb;
+  UINT32           Index;
+
+  Lb = (LOOPBACK_SOCKET *)Sock;
+  if (Offset >= GET_SND_DATASIZE (Sock)) {
+    return 0;
+  }
+
+  Len = MIN (Len, GET_SND_DATASIZE (Sock) - Offset);
+  for (Index = 0; Index < Len; Index++) {
+    Dest[Index] = TcpLoopbackTest::Pattern (Lb->Produced + Offset + Index);
+  }
+
+  return Len;
+}
+
+VOID
+SockDataSent (
+  IN OUT SOCKET  *Sock,
+  IN     UINT32  Count
+  )
+{
+  ((LOOPBACK_SOCKET *)Sock)->Produced += Count;
+  Sock->SndBuffer.DataQueue->BufSize  -= Count;
+}
+
+VOID
+SockDataRcvd (
+  IN OUT SOCKET   *Sock,
+  IN OUT NET_BUF  *NetBuffer,
+  IN     UINT32   UrgLen
+  )
+{
+  LOOPBACK_SOCKET     *Lb;
+  std::vector<UINT8>  Data;
+  UINT32              Index;
+
+  Lb = (LOOPBACK_SOCKET *)Sock;
+  Data.resize (NetBuffer->TotalSize);
+  NetbufCopy (NetBuffer, 0, NetBuffer->TotalSize, Data.data ());
+
+  for (Index = 0; Index < Data.size (); Index++) {
+    if (Data[Index] != TcpLoopbackTest::Pattern (Lb->Consumed + Index)) {
+      Lb->Corrupted = TRUE;
+    }
+  }
+
+  Lb->Consumed += Data.size ();
+}
+
+UINT32
+SockGetFreeSpace (
+  IN SOCKET  *Sock,
+  IN UINT32  Which
+  )
+{
+  //
+  // The application reads the data as soon as it is delivered.
+  //
+  if (Which == SOCK_SND_BUF) {
+    return GET_SND_BUFFSIZE (Sock) - MIN (GET_SND_BUFFSIZE (Sock), GET_SND_DATASIZE (Sock));
+  }
+
+  return GET_RCV_BUFFSIZE (Sock);
+}
+
+VOID
+SockNoMoreData (
+  IN OUT SOCKET  *Sock
+  )
+{
+}
+
+VOID
+SockConnEstablished (
+  IN OUT SOCKET  *Sock
+  )
+{
+}
+
+VOID
+SockConnClosed (
+  IN OUT SOCKET  *Sock
+  )
+{
+}
+
+SOCKET *
+SockClone (
+  IN SOCKET  *Sock
+  )
+{
+  return NULL;
+}
+
+INTN
+TcpSendIpPacket (
+  IN TCP_CB          *Tcb,
+  IN NET_BUF         *Nbuf,
+  IN EFI_IP_ADDRESS  *Src,
+  IN EFI_IP_ADDRESS  *Dest,
+  IN UINT8           Version
+  )
+{
+  if (mLoopback != NULL) {
+    mLoopback->Send (Tcb, Nbuf);
+  }
+
+  return 0;
+}
+
+EFI_STATUS
+Tcp6RefreshNeighbor (
+  IN TCP_CB          *Tcb,
+  IN EFI_IP_ADDRESS  *Neighbor,
+  IN UINT32          Timeout
+  )
+{
+  return EFI_SUCCESS;
+}
+
+EFI_STATUS
+EFIAPI
+IpIoGetIcmpErrStatus (
+  IN  UINT8    IcmpError,
+  IN  UINT8    IpVersion,
+  OUT BOOLEAN  *IsHard  OPTIONAL,
+  OUT BOOLEAN  *Notify  OPTIONAL
+  )
+{
+  return EFI_UNSUPPORTED;
+}
+
+EFI_STATUS
+EFIAPI
+QueueDpc (
+  IN EFI_TPL            DpcTpl,
+  IN EFI_DPC_PROCEDURE  DpcProcedure,
+  IN VOID               *DpcContext    OPTIONAL
+  )
+{
+  return EFI_UNSUPPORTED;
+}
+
+////////////////////////////////////////////////////////////////////////
+// Goodput Tests
+////////////////////////////////////////////////////////////////////////
+
+//
+// 10 Mbps with a 20 ms round trip and 0.5% loss.
+//
+TEST_F (TcpLoopbackTest, LanRandomLoss) {
+  UINT64  NewReno;
+  UINT64  NewRenoSack;
+
+  Link.RateKbps   = 10000;
+  Link.DelayMs    = 10;
+  Link.QueueBytes = 64 * 1024;
+  Link.LossPpm    = 5000;
+
+  NewReno = Transfer (FALSE, TCP_CONGEST_CONTROL_NEWRENO, 4 * 1024 * 1024, 600);
+  TearDown ();
+  SetUp ();
+  NewRenoSack = Transfer (TRUE, TCP_CONGEST_CONTROL_NEWRENO, 4 * 1024 * 1024, 600);
+
+  ASSERT_GT (NewReno, 0);
+  ASSERT_GT (NewRenoSack, 0);
+  EXPECT_GE (NewRenoSack, NewReno);
+}
+
+//
+// 50 Mbps with a 100 ms round trip and 1% loss.
+//
+TEST_F (TcpLoopbackTest, WanRandomLoss) {
+  UINT64  NewReno;
+  UINT64  NewRenoSack;
+  UINT64  CubicSack;
+
+  Link.RateKbps   = 50000;
+  Link.DelayMs    = 50;
+  Link.QueueBytes = 512 * 1024;
+  Link.LossPpm    = 10000;
+
+  NewReno = Transfer (FALSE, TCP_CONGEST_CONTROL_NEWRENO, 8 * 1024 * 1024, 1200);
+  TearDown ();
+  SetUp ();
+  NewRenoSack = Transfer (TRUE, TCP_CONGEST_CONTROL_NEWRENO, 8 * 1024 * 1024, 1200);
+  TearDown ();
+  SetUp ();
+  CubicSack = Transfer (TRUE, TCP_CONGEST_CONTROL_CUBIC, 8 * 1024 * 1024, 1200);
+
+  ASSERT_GT (NewReno, 0);
+  ASSERT_GT (NewRenoSack, 0);
+  ASSERT_GT (CubicSack, 0);
+  EXPECT_GE (NewRenoSack, NewReno);
+}
+
+//
+// No random loss, the only losses are the overflows of the
+// queue of the bottleneck, which drop several segments of
+// the same window.
+//
+TEST_F (TcpLoopbackTest, WanQueueOverflow) {
+  UINT64  NewReno;
+  UINT64  NewRenoSack;
+  UINT64  CubicSack;
+
+  Link.RateKbps   = 50000;
+  Link.DelayMs    = 50;
+  Link.QueueBytes = 128 * 1024;
+  Link.LossPpm    = 0;
+
+  NewReno = Transfer (FALSE, TCP_CONGEST_CONTROL_NEWRENO, 16 * 1024 * 1024, 1200);
+  TearDown ();
+  SetUp ();
+  NewRenoSack = Transfer (TRUE, TCP_CONGEST_CONTROL_NEWRENO, 16 * 1024 * 1024, 1200);
+  TearDown ();
+  SetUp ();
+  CubicSack = Transfer (TRUE, TCP_CONGEST_CONTROL_CUBIC, 16 * 1024 * 1024, 1200);
+
+  ASSERT_GT (NewReno, 0);
+  ASSERT_GT (NewRenoSack, 0);
+  ASSERT_GT (CubicSack, 0);
+  EXPECT_GT (NewRenoSack, NewReno);
+  EXPECT_GE (CubicSack, NewRenoSack);
+}
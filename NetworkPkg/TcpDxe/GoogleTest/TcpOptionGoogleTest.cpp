@@ -0,0 +1,225 @@
+/** @file
+  Tests for the SACK options of TcpOption.c.
+
+  Copyright (c) 2026, TianoCore and contributors. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+#include <Library/GoogleTestLib.h>
+
+extern "C" {
+  #include <Uefi.h>
+  #include <Library/BaseLib.h>
+  #include <Library/BaseMemoryLib.h>
+  #include <Library/MemoryAllocationLib.h>
+  #include <Library/DebugLib.h>
+  #include "../TcpMain.h"
+}
+
+////////////////////////////////////////////////////////////////////////
+// TcpSackOption Tests
+////////////////////////////////////////////////////////////////////////
+
+class TcpSackOptionTest : public ::testing::Test {
+protected:
+  SOCKET     Sock;
+  TCP_CB     Tcb;
+  NET_BUF    *Nbuf;
+  TCP_HEAD   *Head;
+  TCP_OPTION Option;
+
+  virtual void
+  SetUp (
+    )
+  {
+    ZeroMem (&Sock, sizeof (Sock));
+    ZeroMem (&Tcb, sizeof (Tcb));
+    ZeroMem (&Option, sizeof (Option));
+
+    Sock.RcvBuffer.HighWater = TCP_RCV_BUF_SIZE;
+
+    Tcb.Sk     = &Sock;
+    Tcb.SndMss = 1460;
+    Tcb.RcvMss = 1460;
+    Tcb.RcvNxt = 1000;
+    InitializeListHead (&Tcb.SndQue);
+    InitializeListHead (&Tcb.RcvQue);
+
+    Nbuf = NetbufAlloc (TCP_MAX_HEAD);
+    ASSERT_NE (Nbuf, nullptr);
+    NetbufReserve (Nbuf, TCP_MAX_HEAD);
+  }
+
+  virtual void
+  TearDown (
+    )
+  {
+    NetbufFree (Nbuf);
+    NetbufFreeList (&Tcb.RcvQue);
+  }
+
+  //
+  // Queue an out-of-order segment on the reassemble queue.
+  //
+  VOID
+  QueueSegment (
+    TCP_SEQNO  Seq,
+    TCP_SEQNO  End
+    )
+  {
+    NET_BUF  *Seg;
+
+    Seg = NetbufAlloc (0);
+    ASSERT_NE (Seg, nullptr);
+    TCPSEG_NETBUF (Seg)->Seq = Seq;
+    TCPSEG_NETBUF (Seg)->End = End;
+    InsertTailList (&Tcb.RcvQue, &Seg->List);
+
+    Tcb.RcvSackSeq = Seq;
+  }
+
+  //
+  // Put a TCP header in front of the options built, and parse them.
+  //
+  INTN
+  Parse (
+    UINT16  Len
+    )
+  {
+    Head = (TCP_HEAD *)NetbufAllocSpace (Nbuf, sizeof (TCP_HEAD), NET_BUF_HEAD);
+    if (Head == NULL) {
+      return -1;
+    }
+
+    ZeroMem (Head, sizeof (TCP_HEAD));
+    Head->HeadLen = (UINT8)((sizeof (TCP_HEAD) + Len) >> 2);
+
+    return TcpParseOption (Head, &Option);
+  }
+};
+
+TEST_F (TcpSackOptionTest, SynCarriesSackPermitted) {
+  UINT16  Len;
+
+  TCPSEG_NETBUF (Nbuf)->Flag = TCP_FLG_SYN;
+  Len                        = TcpSynBuildOption (&Tcb, Nbuf);
+
+  ASSERT_EQ (Parse (Len), 0);
+  EXPECT_TRUE (TCP_FLG_ON (Option.Flag, TCP_OPTION_RCVD_SACK_PERM));
+  EXPECT_TRUE (TCP_FLG_ON (Option.Flag, TCP_OPTION_RCVD_MSS));
+  EXPECT_EQ (Option.Mss, 1460);
+}
+
+TEST_F (TcpSackOptionTest, SynWithoutSackWhenDisabled) {
+  UINT16  Len;
+
+  TCP_SET_FLG (Tcb.CtrlFlag, TCP_CTRL_NO_SACK);
+  TCPSEG_NETBUF (Nbuf)->Flag = TCP_FLG_SYN;
+  Len                        = TcpSynBuildOption (&Tcb, Nbuf);
+
+  ASSERT_EQ (Parse (Len), 0);
+  EXPECT_FALSE (TCP_FLG_ON (Option.Flag, TCP_OPTION_RCVD_SACK_PERM));
+}
+
+TEST_F (TcpSackOptionTest, SynAckOnlyAnswersSackPermitted) {
+  UINT16  Len;
+
+  TCPSEG_NETBUF (Nbuf)->Flag = TCP_FLG_SYN | TCP_FLG_ACK;
+  Len                        = TcpSynBuildOption (&Tcb, Nbuf);
+
+  ASSERT_EQ (Parse (Len), 0);
+  EXPECT_FALSE (TCP_FLG_ON (Option.Flag, TCP_OPTION_RCVD_SACK_PERM));
+}
+
+TEST_F (TcpSackOptionTest, NoSackWithoutOutOfOrderData) {
+  TCP_SET_FLG (Tcb.CtrlFlag, TCP_CTRL_RCVD_SACK);
+  TCPSEG_NETBUF (Nbuf)->Flag = TCP_FLG_ACK;
+
+  EXPECT_EQ (TcpBuildOption (&Tcb, Nbuf), 0);
+}
+
+TEST_F (TcpSackOptionTest, MostRecentBlockFirst) {
+  UINT16  Len;
+
+  TCP_SET_FLG (Tcb.CtrlFlag, TCP_CTRL_RCVD_SACK);
+  TCPSEG_NETBUF (Nbuf)->Flag = TCP_FLG_ACK;
+
+  //
+  // Two ranges, the first one made of two contiguous segments.
+  //
+  QueueSegment (2000, 3000);
+  QueueSegment (3000, 4000);
+  QueueSegment (5000, 6000);
+
+  Len = TcpBuildOption (&Tcb, Nbuf);
+  ASSERT_EQ (Len, TCP_OPTION_SACK_ALIGNED_LEN (2));
+
+  ASSERT_EQ (Parse (Len), 0);
+  ASSERT_TRUE (TCP_FLG_ON (Option.Flag, TCP_OPTION_RCVD_SACK));
+  ASSERT_EQ (Option.SackCount, 2);
+  EXPECT_EQ (Option.Sack[0].Left, 5000);
+  EXPECT_EQ (Option.Sack[0].Right, 6000);
+  EXPECT_EQ (Option.Sack[1].Left, 2000);
+  EXPECT_EQ (Option.Sack[1].Right, 4000);
+}
+
+TEST_F (TcpSackOptionTest, BlocksLimitedByTimestamp) {
+  UINT16  Len;
+  UINT32  Index;
+
+  TCP_SET_FLG (Tcb.CtrlFlag, TCP_CTRL_RCVD_SACK | TCP_CTRL_SND_TS);
+  TCPSEG_NETBUF (Nbuf)->Flag = TCP_FLG_ACK;
+
+  for (Index = 0; Index < 5; Index++) {
+    QueueSegment (2000 + Index * 2000, 3000 + Index * 2000);
+  }
+
+  //
+  // Only three blocks fit with the timestamp, the first one
+  // reports the last segment received.
+  //
+  Len = TcpBuildOption (&Tcb, Nbuf);
+  ASSERT_EQ (Len, TCP_OPTION_TS_ALIGNED_LEN + TCP_OPTION_SACK_ALIGNED_LEN (3));
+
+  ASSERT_EQ (Parse (Len), 0);
+  ASSERT_TRUE (TCP_FLG_ON (Option.Flag, TCP_OPTION_RCVD_TS));
+  ASSERT_EQ (Option.SackCount, 3);
+  EXPECT_EQ (Option.Sack[0].Left, 10000);
+  EXPECT_EQ (Option.Sack[1].Left, 2000);
+  EXPECT_EQ (Option.Sack[2].Left, 4000);
+}
+
+TEST_F (TcpSackOptionTest, FullSegmentLeavesNoRoom) {
+  TCP_SET_FLG (Tcb.CtrlFlag, TCP_CTRL_RCVD_SACK);
+  QueueSegment (2000, 3000);
+
+  //
+  // SndMss doesn't leave room for the SACK option in
+  // a full sized segment.
+  //
+  NetbufFree (Nbuf);
+  Nbuf = NetbufAlloc (TCP_MAX_HEAD + Tcb.SndMss);
+  ASSERT_NE (Nbuf, nullptr);
+  NetbufReserve (Nbuf, TCP_MAX_HEAD);
+  ASSERT_NE (NetbufAllocSpace (Nbuf, Tcb.SndMss, NET_BUF_TAIL), nullptr);
+  TCPSEG_NETBUF (Nbuf)->Flag = TCP_FLG_ACK;
+
+  EXPECT_EQ (TcpBuildOption (&Tcb, Nbuf), 0);
+}
+
+TEST_F (TcpSackOptionTest, MalformedSackIsRejected) {
+  UINT8  *Data;
+
+  Data = NetbufAllocSpace (Nbuf, 12, NET_BUF_HEAD);
+  ASSERT_NE (Data, nullptr);
+
+  //
+  // A SACK option whose length isn't a whole number of blocks.
+  //
+  ZeroMem (Data, 12);
+  Data[0] = TCP_OPTION_NOP;
+  Data[1] = TCP_OPTION_NOP;
+  Data[2] = TCP_OPTION_SACK;
+  Data[3] = 9;
+
+  EXPECT_EQ (Parse (12), -1);
+}
@@ -220,6 +220,129 @@ SockSetTcpRxData (
   }
 }
 
+/**
+  Loan data in socket buffer to an application provided receive buffer.
+
+  Instead of copying the data, the fragment table of the receive buffer is set
+  to point to the blocks of the net buffers holding it. These net buffers are
+  referenced by a SOCK_RX_LOAN until the application returns them.
+
+  @param[in]  Sock        Pointer to the socket.
+  @param[in]  TcpRxData   Pointer to the application provided receive buffer.
+  @param[in]  RcvdBytes   The maximum length of the data can be loaned.
+  @param[in]  IsUrg       If TRUE the data is Out of Bound, FALSE the data is normal.
+
+  @return The length of the data loaned, 0 if failed due to resource limits.
+
+**/
+UINT32
+SockLoanTcpRxData (
+  IN SOCKET   *Sock,
+  IN VOID     *TcpRxData,
+  IN UINT32   RcvdBytes,
+  IN BOOLEAN  IsUrg
+  )
+{
+  EFI_TCP4_RECEIVE_DATA  *RxData;
+  SOCK_RX_LOAN           *Loan;
+  NET_BUF                *RcvBufEntry;
+  NET_BUF                *Fragment;
+  UINT32                 FragmentCount;
+  UINT32                 Count;
+  UINT32                 Index;
+  UINT32                 Len;
+
+  RxData = (EFI_TCP4_RECEIVE_DATA *)TcpRxData;
+
+  Loan = AllocatePool (sizeof (SOCK_RX_LOAN));
+  if (Loan == NULL) {
+    return 0;
+  }
+
+  Loan->RxData = RxData;
+  Loan->Size   = 0;
+  InitializeListHead (&Loan->NbufList);
+
+  FragmentCount = 0;
+  RcvBufEntry   = SockBufFirst (&Sock->RcvBuffer);
+
+  while ((RcvBufEntry != NULL) && (Loan->Size < RcvdBytes)) {
+    //
+    // Only loan the blocks that fit in the entries left in the
+    // fragment table.
+    //
+    Len   = 0;
+    Count = 0;
+    for (Index = 0; (Index < RcvBufEntry->BlockOpNum) && (FragmentCount + Count < RxData->FragmentCount); Index++) {
+      if (RcvBufEntry->BlockOp[Index].Size != 0) {
+        Len += RcvBufEntry->BlockOp[Index].Size;
+        Count++;
+      }
+    }
+
+    Len = MIN (Len, RcvdBytes - Loan->Size);
+    if (Len == 0) {
+      break;
+    }
+
+    //
+    // The fragment shares the blocks of the net buffer, which will be
+    // trimmed from the socket buffer.
+    //
+    Fragment = NetbufGetFragment (RcvBufEntry, 0, Len, 0);
+    if (Fragment == NULL) {
+      break;
+    }
+
+    Count = RxData->FragmentCount - FragmentCount;
+    NetbufBuildExt (Fragment, (NET_FRAGMENT *)&RxData->FragmentTable[FragmentCount], &Count);
+    InsertTailList (&Loan->NbufList, &Fragment->List);
+
+    FragmentCount += Count;
+    Loan->Size    += Len;
+
+    if (Len < RcvBufEntry->TotalSize) {
+      break;
+    }
+
+    RcvBufEntry = SockBufNext (&Sock->RcvBuffer, RcvBufEntry);
+  }
+
+  if (Loan->Size == 0) {
+    FreePool (Loan);
+    return 0;
+  }
+
+  RxData->DataLength    = Loan->Size;
+  RxData->UrgentFlag    = IsUrg;
+  RxData->FragmentCount = FragmentCount;
+
+  InsertTailList (&Sock->RcvLoanList, &Loan->Link);
+  Sock->RcvLoanSize += Loan->Size;
+
+  return Loan->Size;
+}
+
+/**
+  Release the net buffers of the received data loaned to the application.
+
+  @param[in, out]  Sock        Pointer to the socket.
+  @param[in]       Loan        Pointer to the loan to release.
+
+**/
+VOID
+SockFreeLoan (
+  IN OUT SOCKET        *Sock,
+  IN     SOCK_RX_LOAN  *Loan
+  )
+{
+  RemoveEntryList (&Loan->Link);
+  Sock->RcvLoanSize -= Loan->Size;
+
+  NetbufFreeList (&Loan->NbufList);
+  FreePool (Loan);
+}
+
 /**
   Process the send token.
 
@@ -296,14 +419,18 @@ OnError:
 
   @param[in, out]  Sock       Pointer to the socket.
   @param[in, out]  RcvToken   Pointer to the application provided receive token.
+  @param[in]       Loan       TRUE to loan the data to the token instead of
+                              copying it.
 
-  @return The length of data received in this token.
+  @return The length of data received in this token, 0 if the token is
+          signaled with an error.
 
 **/
 UINT32
 SockProcessRcvToken (
   IN OUT SOCKET         *Sock,
-  IN OUT SOCK_IO_TOKEN  *RcvToken
+  IN OUT SOCK_IO_TOKEN  *RcvToken,
+  IN     BOOLEAN        Loan
   )
 {
   UINT32                 TokenRcvdBytes;
@@ -322,11 +449,19 @@ SockProcessRcvToken (
                      RxData->DataLength
                      );
 
-  //
-  // Copy data from RcvBuffer of socket to user
-  // provided RxData and set the fields in TCP RxData
-  //
-  SockSetTcpRxData (Sock, RxData, TokenRcvdBytes, IsUrg);
+  if (Loan) {
+    TokenRcvdBytes = SockLoanTcpRxData (Sock, RxData, TokenRcvdBytes, IsUrg);
+    if (TokenRcvdBytes == 0) {
+      SIGNAL_TOKEN (&(RcvToken->Token), EFI_OUT_OF_RESOURCES);
+      return 0;
+    }
+  } else {
+    //
+    // Copy data from RcvBuffer of socket to user
+    // provided RxData and set the fields in TCP RxData
+    //
+    SockSetTcpRxData (Sock, RxData, TokenRcvdBytes, IsUrg);
+  }
 
   NetbufQueTrim (Sock->RcvBuffer.DataQueue, TokenRcvdBytes);
   SIGNAL_TOKEN (&(RcvToken->Token), EFI_SUCCESS);
@@ -546,14 +681,15 @@ SockWakeRcvToken (
                   );
 
     RcvToken       = (SOCK_IO_TOKEN *)SockToken->Token;
-    TokenRcvdBytes = SockProcessRcvToken (Sock, RcvToken);
+    TokenRcvdBytes = SockProcessRcvToken (Sock, RcvToken, SockToken->Loan);
+
+    RemoveEntryList (&(SockToken->TokenList));
+    FreePool (SockToken);
 
     if (0 == TokenRcvdBytes) {
       return;
     }
 
-    RemoveEntryList (&(SockToken->TokenList));
-    FreePool (SockToken);
     RcvdBytes -= TokenRcvdBytes;
   }
 }
@@ -677,6 +813,7 @@ SockCreate (
   InitializeListHead (&Sock->RcvTokenList);
   InitializeListHead (&Sock->SndTokenList);
   InitializeListHead (&Sock->ProcessingSndTokenList);
+  InitializeListHead (&Sock->RcvLoanList);
 
   EfiInitializeLock (&(Sock->Lock), TPL_CALLBACK);
 
@@ -724,6 +861,7 @@ SockCreate (
   // Install protocol on Sock->SockHandle
   //
   CopyMem (&Sock->NetProtocol, SockInitData->Protocol, ProtocolLength);
+  CopyMem (&Sock->RxLoan, SockInitData->RxLoan, sizeof (EDKII_TCP_RX_LOAN_PROTOCOL));
 
   //
   // copy the protodata into socket
@@ -734,6 +872,8 @@ SockCreate (
                   &Sock->SockHandle,
                   TcpProtocolGuid,
                   &Sock->NetProtocol,
+                  &gEdkiiTcpRxLoanProtocolGuid,
+                  &Sock->RxLoan,
                   NULL
                   );
 
@@ -782,6 +922,8 @@ OnError:
            Sock->SockHandle,
            TcpProtocolGuid,
            &Sock->NetProtocol,
+           &gEdkiiTcpRxLoanProtocolGuid,
+           &Sock->RxLoan,
            NULL
            );
   }
@@ -810,6 +952,8 @@ SockDestroy (
   IN OUT SOCKET  *Sock
   )
 {
+  SOCK_RX_LOAN  *Loan;
+
   ASSERT (SockStream == Sock->Type);
 
   //
@@ -822,6 +966,21 @@ SockDestroy (
     Sock->ConfigureState = SO_UNCONFIGURED;
   }
 
+  //
+  // Reclaim the received data the application hasn't returned.
+  //
+  while (!IsListEmpty (&Sock->RcvLoanList)) {
+    Loan = NET_LIST_HEAD (&Sock->RcvLoanList, SOCK_RX_LOAN, Link);
+
+    DEBUG (
+      (DEBUG_WARN,
+       "SockDestroy: Reclaim %d bytes still loaned to the application\n",
+       Loan->Size)
+      );
+
+    SockFreeLoan (Sock, Loan);
+  }
+
   //
   // Destroy the RcvBuffer Queue and SendBuffer Queue
   //
@@ -951,6 +1110,7 @@ SockClone (
   InitData.DriverBinding   = Sock->DriverBinding;
   InitData.IpVersion       = Sock->IpVersion;
   InitData.Protocol        = &(Sock->NetProtocol);
+  InitData.RxLoan          = &(Sock->RxLoan);
   InitData.CreateCallback  = Sock->CreateCallback;
   InitData.DestroyCallback = Sock->DestroyCallback;
   InitData.Context         = Sock->Context;
@@ -1171,6 +1331,14 @@ SockGetFreeSpace (
 
   BufferCC = (SockBuffer->DataQueue)->BufSize;
 
+  //
+  // The data loaned to the application still takes room in the
+  // receive buffer until it is returned.
+  //
+  if (SOCK_RCV_BUF == Which) {
+    BufferCC += Sock->RcvLoanSize;
+  }
+
   if (BufferCC >= SockBuffer->HighWater) {
     return 0;
   }
@@ -50,14 +50,31 @@ SockProcessTcpSndData (
 
   @param[in, out]  Sock       Pointer to the socket.
   @param[in, out]  RcvToken   Pointer to the application provided receive token.
+  @param[in]       Loan       TRUE to loan the data to the token instead of
+                              copying it.
 
-  @return The length of data received in this token.
+  @return The length of data received in this token, 0 if the token is
+          signaled with an error.
 
 **/
 UINT32
 SockProcessRcvToken (
   IN OUT SOCKET         *Sock,
-  IN OUT SOCK_IO_TOKEN  *RcvToken
+  IN OUT SOCK_IO_TOKEN  *RcvToken,
+  IN     BOOLEAN        Loan
+  );
+
+/**
+  Release the net buffers of the received data loaned to the application.
+
+  @param[in, out]  Sock        Pointer to the socket.
+  @param[in]       Loan        Pointer to the loan to release.
+
+**/
+VOID
+SockFreeLoan (
+  IN OUT SOCKET        *Sock,
+  IN     SOCK_RX_LOAN  *Loan
   );
 
 /**
@@ -202,6 +202,8 @@ SockDestroyChild (
          Sock->SockHandle,
          TcpProtocolGuid,
          SockProtocol,
+         &gEdkiiTcpRxLoanProtocolGuid,
+         &Sock->RxLoan,
          NULL
          );
 
@@ -333,6 +335,8 @@ ERROR:
          Sock->SockHandle,
          TcpProtocolGuid,
          SockProtocol,
+         &gEdkiiTcpRxLoanProtocolGuid,
+         &Sock->RxLoan,
          NULL
          );
   SockDestroy (Sock);
@@ -688,6 +692,8 @@ Exit:
   @param[in]  Sock             Pointer to the socket to get data from.
   @param[in]  Token            The token to store the received data from the
                                socket.
+  @param[in]  Loan             TRUE to loan the received data to the token
+                               instead of copying it to the token's buffers.
 
   @retval EFI_SUCCESS          The token processed successfully.
   @retval EFI_ACCESS_DENIED    Failed to get the lock to access the socket, or the
@@ -703,11 +709,13 @@ Exit:
 **/
 EFI_STATUS
 SockRcv (
-  IN SOCKET  *Sock,
-  IN VOID    *Token
+  IN SOCKET   *Sock,
+  IN VOID     *Token,
+  IN BOOLEAN  Loan
   )
 {
   SOCK_IO_TOKEN  *RcvToken;
+  SOCK_TOKEN     *SockToken;
   UINT32         RcvdBytes;
   EFI_STATUS     Status;
   EFI_EVENT      Event;
@@ -773,12 +781,15 @@ SockRcv (
   }
 
   if (RcvdBytes != 0) {
-    SockProcessRcvToken (Sock, RcvToken);
-
-    Status = Sock->ProtoHandler (Sock, SOCK_CONSUMED, NULL);
+    if (SockProcessRcvToken (Sock, RcvToken, Loan) != 0) {
+      Status = Sock->ProtoHandler (Sock, SOCK_CONSUMED, NULL);
+    }
   } else {
-    if (NULL == SockBufferToken (Sock, &Sock->RcvTokenList, RcvToken, 0)) {
+    SockToken = SockBufferToken (Sock, &Sock->RcvTokenList, RcvToken, 0);
+    if (NULL == SockToken) {
       Status = EFI_OUT_OF_RESOURCES;
+    } else {
+      SockToken->Loan = Loan;
     }
   }
 
@@ -787,6 +798,62 @@ Exit:
   return Status;
 }
 
+/**
+  Return the received data loaned by a receive token to the socket.
+
+  @param[in]  Sock             Pointer to the socket the data was received from.
+  @param[in]  RxData           The receive data of the token the data was loaned to.
+
+  @retval EFI_SUCCESS          The loaned data is returned.
+  @retval EFI_ACCESS_DENIED    Failed to get the lock to access the socket.
+  @retval EFI_NOT_FOUND        No data is loaned to RxData.
+
+**/
+EFI_STATUS
+SockReturnLoan (
+  IN SOCKET  *Sock,
+  IN VOID    *RxData
+  )
+{
+  LIST_ENTRY    *Entry;
+  SOCK_RX_LOAN  *Loan;
+  EFI_STATUS    Status;
+
+  Status = EfiAcquireLockOrFail (&(Sock->Lock));
+  if (EFI_ERROR (Status)) {
+    DEBUG (
+      (DEBUG_ERROR,
+       "SockReturnLoan: Get the access for socket failed with %r",
+       Status)
+      );
+
+    return EFI_ACCESS_DENIED;
+  }
+
+  Status = EFI_NOT_FOUND;
+
+  NET_LIST_FOR_EACH (Entry, &Sock->RcvLoanList) {
+    Loan = NET_LIST_USER_STRUCT (Entry, SOCK_RX_LOAN, Link);
+
+    if (Loan->RxData == RxData) {
+      SockFreeLoan (Sock, Loan);
+      Status = EFI_SUCCESS;
+      break;
+    }
+  }
+
+  //
+  // The receive buffer has more room, give the protocol a chance
+  // to send out a window update.
+  //
+  if (!EFI_ERROR (Status) && SOCK_IS_CONNECTED (Sock)) {
+    Sock->ProtoHandler (Sock, SOCK_CONSUMED, NULL);
+  }
+
+  EfiReleaseLock (&(Sock->Lock));
+  return Status;
+}
+
 /**
   Reset the socket and its associated protocol control block.
 
@@ -14,6 +14,7 @@
 
 #include <Protocol/Tcp4.h>
 #include <Protocol/Tcp6.h>
+#include <Protocol/TcpRxLoan.h>
 
 #include <Library/NetLib.h>
 #include <Library/DebugLib.h>
@@ -315,6 +316,8 @@
 
 #define SOCK_FROM_THIS(a)  CR ((a), SOCKET, NetProtocol, SOCK_SIGNATURE)
 
+#define SOCK_FROM_RX_LOAN(a)  CR ((a), SOCKET, RxLoan, SOCK_SIGNATURE)
+
 #define SOCK_FROM_TOKEN(Token)  (((SOCK_TOKEN *) (Token))->Sock)
 
 #define PROTO_TOKEN_FORM_SOCK(SockToken, Type)  ((Type *) (((SOCK_TOKEN *) (SockToken))->Token))
@@ -424,6 +427,8 @@ typedef struct _SOCK_INIT_DATA {
   UINT8                    IpVersion;
   VOID                     *Protocol;    ///< The pointer to protocol function template
                                          ///< wanted to install on socket
+  VOID                     *RxLoan;      ///< The pointer to the receive loan function
+                                         ///< template wanted to install on socket
 
   //
   // Callbacks after socket is created and before socket is to be destroyed.
@@ -470,6 +475,7 @@ struct _TCP_SOCKET {
   EFI_LOCK                    Lock;         ///< The lock of socket
   SOCK_BUFFER                 SndBuffer;    ///< Send buffer of application's data
   SOCK_BUFFER                 RcvBuffer;    ///< Receive buffer of received data
+  UINT32                      RcvLoanSize;  ///< Received data loaned to the application
   EFI_STATUS                  SockError;    ///< The error returned by low layer protocol
   BOOLEAN                     InDestroy;
 
@@ -487,6 +493,7 @@ struct _TCP_SOCKET {
   LIST_ENTRY                  RcvTokenList;
   LIST_ENTRY                  SndTokenList;
   LIST_ENTRY                  ProcessingSndTokenList;
+  LIST_ENTRY                  RcvLoanList; ///< The SOCK_RX_LOANs not returned yet
 
   SOCK_COMPLETION_TOKEN       *ConnectionToken; ///< app's token to signal if connected
   SOCK_COMPLETION_TOKEN       *CloseToken;      ///< app's token to signal if closed
@@ -497,6 +504,7 @@ struct _TCP_SOCKET {
   UINT8                       ProtoReserved[PROTO_RESERVED_LEN]; ///< Data fields reserved for protocol
   UINT8                       IpVersion;
   NET_PROTOCOL                NetProtocol;                      ///< TCP4 or TCP6 protocol socket used
+  EDKII_TCP_RX_LOAN_PROTOCOL  RxLoan;                           ///< Zero copy receive interface
   //
   // Callbacks after socket is created and before socket is to be destroyed.
   //
@@ -514,8 +522,20 @@ typedef struct _SOCK_TOKEN {
   UINT32                   RemainDataLen; ///< Unprocessed data length
   SOCKET                   *Sock;         ///< The pointer to the socket this token
                                           ///< belongs to
+  BOOLEAN                  Loan;          ///< Loan the received data to the token
+                                          ///< instead of copying it
 } SOCK_TOKEN;
 
+///
+///  The received data loaned to the application by a receive token.
+///
+typedef struct _SOCK_RX_LOAN {
+  LIST_ENTRY    Link;     ///< The entry in the RcvLoanList of the socket
+  VOID          *RxData;  ///< The application's receive data describing the loan
+  LIST_ENTRY    NbufList; ///< The net buffers referencing the data loaned
+  UINT32        Size;     ///< The length of the data loaned
+} SOCK_RX_LOAN;
+
 ///
 /// Reserved data to access the NET_BUF delivered by TCP driver.
 ///
@@ -799,6 +819,8 @@ SockSend (
   @param[in]  Sock             Pointer to the socket to get data from.
   @param[in]  Token            The token to store the received data from the
                                socket.
+  @param[in]  Loan             TRUE to loan the received data to the token
+                               instead of copying it to the token's buffers.
 
   @retval EFI_SUCCESS          The token processed successfully.
   @retval EFI_ACCESS_DENIED    Failed to get the lock to access the socket, or the
@@ -814,8 +836,26 @@ SockSend (
 **/
 EFI_STATUS
 SockRcv (
+  IN SOCKET   *Sock,
+  IN VOID     *Token,
+  IN BOOLEAN  Loan
+  );
+
+/**
+  Return the received data loaned by a receive token to the socket.
+
+  @param[in]  Sock             Pointer to the socket the data was received from.
+  @param[in]  RxData           The receive data of the token the data was loaned to.
+
+  @retval EFI_SUCCESS          The loaned data is returned.
+  @retval EFI_ACCESS_DENIED    Failed to get the lock to access the socket.
+  @retval EFI_NOT_FOUND        No data is loaned to RxData.
+
+**/
+EFI_STATUS
+SockReturnLoan (
   IN SOCKET  *Sock,
-  IN VOID    *Token
+  IN VOID    *RxData
   );
 
 /**
@@ -0,0 +1,454 @@
+/** @file
+  TCP congestion control and SACK loss recovery routines.
+
+  The congestion window is opened by slow start, then by either the
+  congestion avoidance of RFC5681 or by CUBIC as defined in RFC9438,
+  as selected for the TCP instance. When the peer supports selective
+  acknowledgment, the ranges it reports above SND.UNA are kept on a
+  scoreboard so that fast recovery can retransmit every hole of the
+  window instead of one segment per round trip.
+
+  Copyright (c) 2026, TianoCore and contributors. All rights reserved.<BR>
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "TcpMain.h"
+
+//
+// CUBIC constants of RFC9438: the window is reduced to
+// BETA_NUM/BETA_DEN on congestion, and the cubic function
+// grows it by C segments per second cubed, with C = C_NUM/C_DEN.
+//
+#define TCP_CUBIC_BETA_NUM  7
+#define TCP_CUBIC_BETA_DEN  10
+#define TCP_CUBIC_C_NUM     4
+#define TCP_CUBIC_C_DEN     10
+
+//
+// Fast convergence reduces W_max to (1 + BETA) / 2 of the
+// window when the window is still below the previous W_max.
+//
+#define TCP_CUBIC_FAST_CONVERGENCE_NUM  17
+#define TCP_CUBIC_FAST_CONVERGENCE_DEN  20
+
+//
+// ALPHA = 3 * (1 - BETA) / (1 + BETA) makes the Reno-friendly
+// estimate grow as fast as Reno with the same average window.
+//
+#define TCP_CUBIC_ALPHA_NUM  9
+#define TCP_CUBIC_ALPHA_DEN  17
+
+//
+// The time from the plateau, in ms, is capped to keep the cube
+// in 64 bits. The window would exceed any TCP window before.
+//
+#define TCP_CUBIC_MAX_OFFSET  0x20000
+
+#define TCP_CUBE_ROOT_MAX  2642245
+
+/**
+  Compute the integer cube root of a value.
+
+  @param[in]  Value   The value.
+
+  @return The largest integer whose cube is not above Value.
+
+**/
+UINT32
+TcpCubeRoot (
+  IN UINT64  Value
+  )
+{
+  UINT64  Root;
+  UINT64  Bit;
+  UINT64  Try;
+
+  //
+  // The root of a 64 bit value is at most TCP_CUBE_ROOT_MAX, whose
+  // cube is the largest one that fits in 64 bits.
+  //
+  Root = 0;
+  for (Bit = BIT21; Bit != 0; Bit >>= 1) {
+    Try = Root | Bit;
+    if ((Try <= TCP_CUBE_ROOT_MAX) && (MultU64x64 (MultU64x64 (Try, Try), Try) <= Value)) {
+      Root = Try;
+    }
+  }
+
+  return (UINT32)Root;
+}
+
+/**
+  Reset the congestion control state of a connection.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+**/
+VOID
+TcpCongestInit (
+  IN OUT TCP_CB  *Tcb
+  )
+{
+  Tcb->CubicEpochOn = FALSE;
+  Tcb->CubicEpoch   = 0;
+  Tcb->CubicK       = 0;
+  Tcb->CubicWMax    = 0;
+  Tcb->CubicOrigin  = 0;
+  Tcb->CubicWEst    = 0;
+}
+
+/**
+  Compute how much CUBIC opens the congestion window for an ACK of
+  new data in congestion avoidance.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+  @return The number of bytes to add to the congestion window.
+
+**/
+UINT32
+TcpCubicIncrease (
+  IN OUT TCP_CB  *Tcb
+  )
+{
+  UINT32  Elapsed;
+  UINT32  Offset;
+  UINT64  Delta;
+  UINT32  Target;
+  UINT32  Limit;
+
+  if (!Tcb->CubicEpochOn) {
+    //
+    // Start a new epoch, and place the plateau of the curve at
+    // the window of the last congestion event.
+    //
+    Tcb->CubicEpochOn = TRUE;
+    Tcb->CubicEpoch   = mTcpTick;
+    Tcb->CubicWEst    = Tcb->CWnd;
+
+    if (Tcb->CWnd < Tcb->CubicWMax) {
+      //
+      // K = cubic_root ((W_max - cwnd) / C) seconds, with the
+      // windows in segments. Compute it in ms.
+      //
+      Delta = MultU64x32 (Tcb->CubicWMax - Tcb->CWnd, 1000000000U / TCP_CUBIC_C_NUM * TCP_CUBIC_C_DEN);
+      Delta = DivU64x32 (Delta, Tcb->SndMss);
+
+      Tcb->CubicK      = TcpCubeRoot (Delta);
+      Tcb->CubicOrigin = Tcb->CubicWMax;
+    } else {
+      Tcb->CubicK      = 0;
+      Tcb->CubicOrigin = Tcb->CWnd;
+    }
+  }
+
+  //
+  // Evaluate the curve one RTT ahead, W_cubic (t + RTT).
+  //
+  Elapsed = (TCP_SUB_TIME (mTcpTick, Tcb->CubicEpoch) + (Tcb->SRtt >> TCP_RTT_SHIFT)) * TCP_TICK;
+
+  if (Elapsed < Tcb->CubicK) {
+    Offset = Tcb->CubicK - Elapsed;
+  } else {
+    Offset = Elapsed - Tcb->CubicK;
+  }
+
+  Offset = MIN (Offset, TCP_CUBIC_MAX_OFFSET);
+
+  //
+  // C * Offset^3 segments with Offset in ms, in bytes.
+  //
+  Delta = DivU64x32 (MultU64x64 (MultU64x32 (Offset, Offset), Offset), 1000);
+  Delta = MultU64x32 (Delta, TCP_CUBIC_C_NUM * Tcb->SndMss);
+  Delta = DivU64x32 (DivU64x32 (Delta, TCP_CUBIC_C_DEN), 1000000);
+
+  if (Elapsed < Tcb->CubicK) {
+    Target = (Delta < Tcb->CubicOrigin) ? Tcb->CubicOrigin - (UINT32)Delta : 0;
+  } else {
+    Target = (UINT32)MIN (Tcb->CubicOrigin + Delta, MAX_UINT32);
+  }
+
+  //
+  // Don't grow by more than half a window per RTT.
+  //
+  Limit  = Tcb->CWnd + Tcb->CWnd / 2;
+  Target = MIN (Target, Limit);
+
+  //
+  // In the Reno-friendly region, grow at least as fast as Reno.
+  //
+  Delta           = MultU64x32 (MultU64x32 (Tcb->SndMss, Tcb->SndMss), TCP_CUBIC_ALPHA_NUM);
+  Tcb->CubicWEst += MAX ((UINT32)DivU64x32 (Delta, TCP_CUBIC_ALPHA_DEN * Tcb->CWnd), 1);
+
+  if (Target < Tcb->CubicWEst) {
+    Target = MIN (Tcb->CubicWEst, Limit);
+  }
+
+  if (Target > Tcb->CWnd) {
+    return MAX ((UINT32)DivU64x32 (MultU64x32 (Target - Tcb->CWnd, Tcb->SndMss), Tcb->CWnd), 1);
+  }
+
+  return MAX (Tcb->SndMss * Tcb->SndMss / Tcb->CWnd / 100, 1);
+}
+
+/**
+  Open the congestion window on an ACK of new data.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+**/
+VOID
+TcpCongestOpenWindow (
+  IN OUT TCP_CB  *Tcb
+  )
+{
+  if (Tcb->CWnd < Tcb->Ssthresh) {
+    Tcb->CWnd += Tcb->SndMss;
+  } else if (Tcb->CongestControl == TCP_CONGEST_CONTROL_CUBIC) {
+    Tcb->CWnd += TcpCubicIncrease (Tcb);
+  } else {
+    Tcb->CWnd += MAX (Tcb->SndMss * Tcb->SndMss / Tcb->CWnd, 1);
+  }
+
+  Tcb->CWnd = MIN (Tcb->CWnd, TCP_MAX_WIN << Tcb->SndWndScale);
+}
+
+/**
+  Compute the slow start threshold on a congestion event, either three
+  duplicate ACKs or a retransmission timeout.
+
+  @param[in, out]  Tcb         Pointer to the TCP_CB of this TCP instance.
+  @param[in]       FlightSize  The amount of data sent but not yet ACKed.
+
+  @return The new slow start threshold.
+
+**/
+UINT32
+TcpCongestSsthresh (
+  IN OUT TCP_CB  *Tcb,
+  IN     UINT32  FlightSize
+  )
+{
+  if (Tcb->CongestControl != TCP_CONGEST_CONTROL_CUBIC) {
+    return MAX (FlightSize / 2, (UINT32)(2 * Tcb->SndMss));
+  }
+
+  //
+  // Repeated timeouts of the same loss don't move the plateau.
+  //
+  if (Tcb->CongestState != TCP_CONGEST_LOSS) {
+    if (Tcb->CWnd < Tcb->CubicWMax) {
+      Tcb->CubicWMax = Tcb->CWnd / TCP_CUBIC_FAST_CONVERGENCE_DEN * TCP_CUBIC_FAST_CONVERGENCE_NUM;
+    } else {
+      Tcb->CubicWMax = Tcb->CWnd;
+    }
+  }
+
+  Tcb->CubicEpochOn = FALSE;
+
+  return MAX (FlightSize / TCP_CUBIC_BETA_DEN * TCP_CUBIC_BETA_NUM, (UINT32)(2 * Tcb->SndMss));
+}
+
+/**
+  Forget all the ranges SACKed by the peer.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+**/
+VOID
+TcpSackClear (
+  IN OUT TCP_CB  *Tcb
+  )
+{
+  Tcb->SackCount   = 0;
+  Tcb->SackRetxNxt = Tcb->SndUna;
+}
+
+/**
+  Add a range SACKed by the peer to the scoreboard, merging it with
+  the ranges it overlaps or touches.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Left     The first sequence number of the range.
+  @param[in]       Right    The sequence number following the range.
+
+**/
+VOID
+TcpSackInsert (
+  IN OUT TCP_CB     *Tcb,
+  IN     TCP_SEQNO  Left,
+  IN     TCP_SEQNO  Right
+  )
+{
+  TCP_SACK_BLOCK  *Block;
+  UINT8           First;
+  UINT8           Last;
+
+  Block = Tcb->SackBlock;
+
+  First = 0;
+  while ((First < Tcb->SackCount) && TCP_SEQ_LT (Block[First].Right, Left)) {
+    First++;
+  }
+
+  Last = First;
+  while ((Last < Tcb->SackCount) && TCP_SEQ_LEQ (Block[Last].Left, Right)) {
+    if (TCP_SEQ_LT (Block[Last].Left, Left)) {
+      Left = Block[Last].Left;
+    }
+
+    if (TCP_SEQ_GT (Block[Last].Right, Right)) {
+      Right = Block[Last].Right;
+    }
+
+    Last++;
+  }
+
+  if (Last == First) {
+    //
+    // A new range. When the scoreboard is full, forget the
+    // highest range, which is the last one to be needed.
+    //
+    if (Tcb->SackCount == TCP_SACK_SCOREBOARD_SIZE) {
+      if (First == Tcb->SackCount) {
+        return;
+      }
+
+      Tcb->SackCount--;
+    }
+
+    CopyMem (&Block[First + 1], &Block[First], (Tcb->SackCount - First) * sizeof (TCP_SACK_BLOCK));
+    Tcb->SackCount++;
+  } else {
+    //
+    // The range replaces the ranges from First to Last - 1.
+    //
+    CopyMem (&Block[First + 1], &Block[Last], (Tcb->SackCount - Last) * sizeof (TCP_SACK_BLOCK));
+    Tcb->SackCount = (UINT8)(Tcb->SackCount - (Last - First - 1));
+  }
+
+  Block[First].Left  = Left;
+  Block[First].Right = Right;
+}
+
+/**
+  Update the scoreboard on an ACK: drop the data acknowledged
+  cumulatively, and add the ranges reported in the SACK option.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Ack      The acknowledge sequence number of the segment.
+  @param[in]       Option   Pointer to the options of the segment.
+
+**/
+VOID
+TcpSackUpdate (
+  IN OUT TCP_CB      *Tcb,
+  IN     TCP_SEQNO   Ack,
+  IN     TCP_OPTION  *Option
+  )
+{
+  TCP_SACK_BLOCK  *Block;
+  TCP_SEQNO       Left;
+  TCP_SEQNO       Right;
+  UINT8           Index;
+  UINT8           Count;
+
+  Block = Tcb->SackBlock;
+  Count = 0;
+
+  for (Index = 0; Index < Tcb->SackCount; Index++) {
+    if (TCP_SEQ_LEQ (Block[Index].Right, Ack)) {
+      continue;
+    }
+
+    Block[Count] = Block[Index];
+    if (TCP_SEQ_LT (Block[Count].Left, Ack)) {
+      Block[Count].Left = Ack;
+    }
+
+    Count++;
+  }
+
+  Tcb->SackCount = Count;
+
+  if (!TCP_FLG_ON (Option->Flag, TCP_OPTION_RCVD_SACK)) {
+    return;
+  }
+
+  for (Index = 0; Index < Option->SackCount; Index++) {
+    Left  = Option->Sack[Index].Left;
+    Right = Option->Sack[Index].Right;
+
+    //
+    // Ignore the ranges that are empty, already acknowledged
+    // (such as D-SACK), or beyond the data sent.
+    //
+    if (TCP_SEQ_GEQ (Left, Right) || TCP_SEQ_LEQ (Right, Ack) || TCP_SEQ_GT (Right, Tcb->SndNxt)) {
+      continue;
+    }
+
+    if (TCP_SEQ_LT (Left, Ack)) {
+      Left = Ack;
+    }
+
+    TcpSackInsert (Tcb, Left, Right);
+  }
+}
+
+/**
+  Retransmit the next hole of the scoreboard that hasn't been
+  retransmitted in the current fast recovery.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Una      The first unacknowledged sequence number.
+
+  @retval 1       A hole was retransmitted.
+  @retval 0       There is no hole below the highest SACKed data,
+                  or the retransmission failed.
+
+**/
+INTN
+TcpSackRetransmit (
+  IN OUT TCP_CB     *Tcb,
+  IN     TCP_SEQNO  Una
+  )
+{
+  TCP_SEQNO  Seq;
+  UINT32     Len;
+  UINT8      Index;
+
+  Seq = Una;
+  if (TCP_SEQ_GT (Tcb->SackRetxNxt, Seq)) {
+    Seq = Tcb->SackRetxNxt;
+  }
+
+  for (Index = 0; Index < Tcb->SackCount; Index++) {
+    if (TCP_SEQ_LT (Seq, Tcb->SackBlock[Index].Left)) {
+      Len = MIN (TCP_SUB_SEQ (Tcb->SackBlock[Index].Left, Seq), Tcb->SndMss);
+
+      if (TcpRetransmit (Tcb, Seq) != 0) {
+        return 0;
+      }
+
+      Tcb->SackRetxNxt = Seq + Len;
+
+      DEBUG (
+        (DEBUG_NET,
+         "TcpSackRetransmit: retransmitted hole %d of length %d for TCB %p\n",
+         Seq,
+         Len,
+         Tcb)
+        );
+
+      return 1;
+    }
+
+    if (TCP_SEQ_LT (Seq, Tcb->SackBlock[Index].Right)) {
+      Seq = Tcb->SackBlock[Index].Right;
+    }
+  }
+
+  return 0;
+}
@@ -118,7 +118,7 @@ Tcp4GetMode (
       Option->EnableTimeStamp     = (BOOLEAN)(!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_TS));
       Option->EnableWindowScaling = (BOOLEAN)(!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_WS));
 
-      Option->EnableSelectiveAck     = FALSE;
+      Option->EnableSelectiveAck     = (BOOLEAN)(!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_SACK));
       Option->EnablePathMtuDiscovery = FALSE;
     }
   }
@@ -195,7 +195,7 @@ Tcp6GetMode (
       Option->EnableTimeStamp     = (BOOLEAN)(!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_TS));
       Option->EnableWindowScaling = (BOOLEAN)(!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_WS));
 
-      Option->EnableSelectiveAck     = FALSE;
+      Option->EnableSelectiveAck     = (BOOLEAN)(!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_SACK));
       Option->EnablePathMtuDiscovery = FALSE;
     }
   }
@@ -564,6 +564,15 @@ TcpConfigurePcb (
 
   Tcb->CongestState = TCP_CONGEST_OPEN;
 
+  //
+  // The congestion control algorithm is selected when the instance
+  // is configured, so it can be changed by a reconfiguration.
+  //
+  Tcb->CongestControl = PcdGet8 (PcdTcpCongestionControl);
+  if (Tcb->CongestControl != TCP_CONGEST_CONTROL_CUBIC) {
+    Tcb->CongestControl = TCP_CONGEST_CONTROL_NEWRENO;
+  }
+
   Tcb->KeepAliveIdle   = TCP_KEEPALIVE_IDLE_MIN;
   Tcb->KeepAlivePeriod = TCP_KEEPALIVE_PERIOD;
   Tcb->MaxKeepAlive    = TCP_MAX_KEEPALIVE;
@@ -703,6 +712,10 @@ TcpConfigurePcb (
     if (!Option->EnableWindowScaling) {
       TCP_SET_FLG (Tcb->CtrlFlag, TCP_CTRL_NO_WS);
     }
+
+    if (!Option->EnableSelectiveAck) {
+      TCP_SET_FLG (Tcb->CtrlFlag, TCP_CTRL_NO_SACK);
+    }
   }
 
   //
@@ -42,6 +42,11 @@ EFI_TCP6_PROTOCOL  gTcp6ProtocolTemplate = {
   Tcp6Poll
 };
 
+EDKII_TCP_RX_LOAN_PROTOCOL  gTcpRxLoanProtocolTemplate = {
+  TcpRxLoanReceive,
+  TcpRxLoanReturn
+};
+
 SOCK_INIT_DATA  mTcpDefaultSockData = {
   SockStream,
   SO_CLOSED,
@@ -51,6 +56,7 @@ SOCK_INIT_DATA  mTcpDefaultSockData = {
   TCP_RCV_BUF_SIZE,
   IP_VERSION_4,
   NULL,
+  &gTcpRxLoanProtocolTemplate,
   TcpCreateSocketCallback,
   TcpDestroySocketCallback,
   NULL,
@@ -657,6 +657,122 @@ Tcp6RefreshNeighbor (
   IN UINT32          Timeout
   );
 
+//
+// Functions in TcpCongest.c
+//
+
+/**
+  Compute the integer cube root of a value.
+
+  @param[in]  Value   The value.
+
+  @return The largest integer whose cube is not above Value.
+
+**/
+UINT32
+TcpCubeRoot (
+  IN UINT64  Value
+  );
+
+/**
+  Initialize the congestion control and SACK state of a connection.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+**/
+VOID
+TcpCongestInit (
+  IN OUT TCP_CB  *Tcb
+  );
+
+/**
+  Open the congestion window on an ACK of new data.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+**/
+VOID
+TcpCongestOpenWindow (
+  IN OUT TCP_CB  *Tcb
+  );
+
+/**
+  Compute the slow start threshold on a congestion event, either three
+  duplicate ACKs or a retransmission timeout.
+
+  @param[in, out]  Tcb         Pointer to the TCP_CB of this TCP instance.
+  @param[in]       FlightSize  The amount of data sent but not yet ACKed.
+
+  @return The new slow start threshold.
+
+**/
+UINT32
+TcpCongestSsthresh (
+  IN OUT TCP_CB  *Tcb,
+  IN     UINT32  FlightSize
+  );
+
+/**
+  Forget all the ranges SACKed by the peer.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+**/
+VOID
+TcpSackClear (
+  IN OUT TCP_CB  *Tcb
+  );
+
+/**
+  Add a range SACKed by the peer to the scoreboard, merging it with
+  the ranges it overlaps or touches.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Left     The first sequence number of the range.
+  @param[in]       Right    The sequence number following the range.
+
+**/
+VOID
+TcpSackInsert (
+  IN OUT TCP_CB     *Tcb,
+  IN     TCP_SEQNO  Left,
+  IN     TCP_SEQNO  Right
+  );
+
+/**
+  Update the scoreboard on an ACK: drop the data acknowledged
+  cumulatively, and add the ranges reported in the SACK option.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Ack      The acknowledge sequence number of the segment.
+  @param[in]       Option   Pointer to the options of the segment.
+
+**/
+VOID
+TcpSackUpdate (
+  IN OUT TCP_CB      *Tcb,
+  IN     TCP_SEQNO   Ack,
+  IN     TCP_OPTION  *Option
+  );
+
+/**
+  Retransmit the next hole of the scoreboard that hasn't been
+  retransmitted in the current fast recovery.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Una      The first unacknowledged sequence number.
+
+  @retval 1       A hole was retransmitted.
+  @retval 0       There is no hole below the highest SACKed data,
+                  or the retransmission failed.
+
+**/
+INTN
+TcpSackRetransmit (
+  IN OUT TCP_CB     *Tcb,
+  IN     TCP_SEQNO  Una
+  );
+
 //
 // Functions in TcpDispatcher.c
 //
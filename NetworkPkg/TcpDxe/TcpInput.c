@@ -30,7 +30,9 @@ TcpSeqAcceptable (
 }
 
 /**
-  NewReno fast recovery defined in RFC3782.
+  NewReno fast recovery defined in RFC3782. When the peer supports SACK,
+  the holes of the scoreboard are retransmitted as defined in RFC6675
+  instead of inflating the congestion window.
 
   @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
   @param[in]       Seg      Segment that triggers the fast recovery.
@@ -54,7 +56,7 @@ TcpFastRecover (
     //
     FlightSize = TCP_SUB_SEQ (Tcb->SndNxt, Tcb->SndUna);
 
-    Tcb->Ssthresh = MAX (FlightSize >> 1, (UINT32)(2 * Tcb->SndMss));
+    Tcb->Ssthresh = TcpCongestSsthresh (Tcb, FlightSize);
     Tcb->Recover  = Tcb->SndNxt;
 
     Tcb->CongestState = TCP_CONGEST_RECOVER;
@@ -64,7 +66,8 @@ TcpFastRecover (
     // Step 2: Entering fast retransmission
     //
     TcpRetransmit (Tcb, Tcb->SndUna);
-    Tcb->CWnd = Tcb->Ssthresh + 3 * Tcb->SndMss;
+    Tcb->CWnd        = Tcb->Ssthresh + 3 * Tcb->SndMss;
+    Tcb->SackRetxNxt = Tcb->SndUna + Tcb->SndMss;
 
     DEBUG (
       (DEBUG_NET,
@@ -81,13 +84,19 @@ TcpFastRecover (
   if (Seg->Ack == Tcb->SndUna) {
     //
     // Step 3: Fast Recovery,
-    // If this is a duplicated ACK, increse Cwnd by SMSS.
+    // If this is a duplicated ACK, retransmit the next hole
+    // reported by SACK, or else increse Cwnd by SMSS.
     //
 
     // Step 4 is skipped here only to be executed later
     // by TcpToSendData
     //
-    Tcb->CWnd += Tcb->SndMss;
+    if (!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_RCVD_SACK) ||
+        (TcpSackRetransmit (Tcb, Tcb->SndUna) == 0))
+    {
+      Tcb->CWnd += Tcb->SndMss;
+    }
+
     DEBUG (
       (DEBUG_NET,
        "TcpFastRecover: received another duplicated ACK (%d) for TCB %p\n",
@@ -119,9 +128,19 @@ TcpFastRecover (
       //
       // Step 5 - Partial ACK:
       // fast retransmit the first unacknowledge field
-      // , then deflate the CWnd
+      // , then deflate the CWnd. With SACK, the first
+      // hole may already be retransmitted, then retransmit
+      // the next one.
       //
-      TcpRetransmit (Tcb, Seg->Ack);
+      if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_RCVD_SACK) &&
+          TCP_SEQ_GT (Tcb->SackRetxNxt, Seg->Ack))
+      {
+        TcpSackRetransmit (Tcb, Seg->Ack);
+      } else {
+        TcpRetransmit (Tcb, Seg->Ack);
+        Tcb->SackRetxNxt = Seg->Ack + Tcb->SndMss;
+      }
+
       Acked = TCP_SUB_SEQ (Seg->Ack, Tcb->SndUna);
 
       //
@@ -133,7 +152,11 @@ TcpFastRecover (
         Acked -= Tcb->SndMss;
       }
 
-      Tcb->CWnd -= Acked;
+      if (Tcb->CWnd > Acked) {
+        Tcb->CWnd -= Acked;
+      } else {
+        Tcb->CWnd = Tcb->SndMss;
+      }
 
       DEBUG (
         (DEBUG_NET,
@@ -563,6 +586,11 @@ TcpQueueData (
   Seg  = TCPSEG_NETBUF (Nbuf);
   Head = &Tcb->RcvQue;
 
+  //
+  // The first SACK block reports the most recently received segment.
+  //
+  Tcb->RcvSackSeq = Seg->Seq;
+
   //
   // Fast path to process normal case. That is,
   // no out-of-order segments are received.
@@ -1213,6 +1241,10 @@ TcpInput (
     TcpSetTimer (Tcb, TCP_TIMER_REXMIT, Tcb->Rto);
   }
 
+  if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_RCVD_SACK)) {
+    TcpSackUpdate (Tcb, Seg->Ack, &Option);
+  }
+
   //
   // Count duplicate acks.
   //
@@ -1233,13 +1265,7 @@ TcpInput (
       (Tcb->CongestState == TCP_CONGEST_LOSS))
   {
     if (TCP_SEQ_GT (Seg->Ack, Tcb->SndUna)) {
-      if (Tcb->CWnd < Tcb->Ssthresh) {
-        Tcb->CWnd += Tcb->SndMss;
-      } else {
-        Tcb->CWnd += MAX (Tcb->SndMss * Tcb->SndMss / Tcb->CWnd, 1);
-      }
-
-      Tcb->CWnd = MIN (Tcb->CWnd, TCP_MAX_WIN << Tcb->SndWndScale);
+      TcpCongestOpenWindow (Tcb);
     }
 
     if (Tcb->CongestState == TCP_CONGEST_LOSS) {
@@ -17,6 +17,7 @@
 #include <Library/IpIoLib.h>
 #include <Library/DevicePathLib.h>
 #include <Library/PrintLib.h>
+#include <Library/PcdLib.h>
 
 #include "Socket.h"
 #include "TcpProto.h"
@@ -767,6 +768,61 @@ Tcp6Poll (
   IN EFI_TCP6_PROTOCOL  *This
   );
 
+/**
+  Places an asynchronous receive request into the receiving queue, the received
+  data being loaned to the caller.
+
+  The token completes as with Tcp4Receive() or Tcp6Receive(), but the fragment
+  table of the receive data is set to point to the buffers of the TCP driver
+  holding the data, instead of copying it. The buffers are loaned to the caller
+  until it returns them with TcpRxLoanReturn().
+
+  @param[in]  This                 Pointer to the EDKII_TCP_RX_LOAN_PROTOCOL instance.
+  @param[in]  Token                Pointer to a token that is associated with the
+                                   receive data descriptor. It is an EFI_TCP6_IO_TOKEN
+                                   on a TCP6 instance.
+
+  @retval EFI_SUCCESS              The receive completion token was cached.
+  @retval EFI_NOT_STARTED          The TCP instance hasn't been configured.
+  @retval EFI_NO_MAPPING           When using a default address, configuration
+                                   (DHCP, BOOTP, RARP, etc.) is not finished yet.
+  @retval EFI_INVALID_PARAMETER    One or more parameters are invalid.
+  @retval EFI_OUT_OF_RESOURCES     The receive completion token could not be queued
+                                   due to a lack of system resources.
+  @retval EFI_ACCESS_DENIED        The token is already in the receive queue, or the
+                                   instance isn't in a synchronized state.
+  @retval EFI_CONNECTION_FIN       The communication peer has closed the connection,
+                                   and there is no any buffered data in the receive
+                                   buffer of this instance.
+
+**/
+EFI_STATUS
+EFIAPI
+TcpRxLoanReceive (
+  IN EDKII_TCP_RX_LOAN_PROTOCOL  *This,
+  IN EFI_TCP4_IO_TOKEN           *Token
+  );
+
+/**
+  Return the buffers loaned by TcpRxLoanReceive() to the TCP driver.
+
+  @param[in]  This                 Pointer to the EDKII_TCP_RX_LOAN_PROTOCOL instance.
+  @param[in]  RxData               The receive data of a token completed by
+                                   TcpRxLoanReceive().
+
+  @retval EFI_SUCCESS              The buffers are returned.
+  @retval EFI_INVALID_PARAMETER    This or RxData is NULL.
+  @retval EFI_ACCESS_DENIED        The instance is busy, retry later.
+  @retval EFI_NOT_FOUND            No buffers are loaned to RxData.
+
+**/
+EFI_STATUS
+EFIAPI
+TcpRxLoanReturn (
+  IN EDKII_TCP_RX_LOAN_PROTOCOL  *This,
+  IN EFI_TCP4_RECEIVE_DATA       *RxData
+  );
+
 /**
   Retrieves the Initial Sequence Number (ISN) for a TCP connection identified by local
   and remote IP addresses and ports.
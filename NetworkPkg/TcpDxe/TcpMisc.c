@@ -221,6 +221,20 @@ TcpInitTcbPeer (
     //
     Tcb->SndMss -= TCP_OPTION_TS_ALIGNED_LEN;
   }
+
+  if (TCP_FLG_ON (Opt->Flag, TCP_OPTION_RCVD_SACK_PERM) && !TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_SACK)) {
+    TCP_SET_FLG (Tcb->CtrlFlag, TCP_CTRL_RCVD_SACK);
+  } else {
+    //
+    // One end doesn't support SACK, use cumulative ACK only.
+    //
+    TCP_CLEAR_FLG (Tcb->CtrlFlag, TCP_CTRL_RCVD_SACK);
+  }
+
+  TcpSackClear (Tcb);
+  Tcb->RcvSackSeq = Tcb->RcvNxt;
+
+  TcpCongestInit (Tcb);
 }
 
 /**
@@ -160,6 +160,28 @@ TcpSynBuildOption (
     TcpPutUint32 (Data, TCP_OPTION_WS_FAST | TcpComputeScale (Tcb));
   }
 
+  //
+  // Build the SACK permitted option, only when SACK isn't
+  // disabled by the application, and either we are doing
+  // active open or the peer has sent us the option.
+  //
+  if (!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_SACK) &&
+      (!TCP_FLG_ON (TCPSEG_NETBUF (Nbuf)->Flag, TCP_FLG_ACK) ||
+       TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_RCVD_SACK))
+      )
+  {
+    Data = NetbufAllocSpace (
+             Nbuf,
+             TCP_OPTION_SACK_PERM_ALIGNED_LEN,
+             NET_BUF_HEAD
+             );
+
+    ASSERT (Data != NULL);
+
+    Len += TCP_OPTION_SACK_PERM_ALIGNED_LEN;
+    TcpPutUint32 (Data, TCP_OPTION_SACK_PERM_FAST);
+  }
+
   //
   // Build the MSS option.
   //
@@ -172,6 +194,124 @@ TcpSynBuildOption (
   return Len;
 }
 
+/**
+  Get the next range of out-of-order data on the reassemble queue.
+  Segments that are contiguous are merged into one range.
+
+  @param[in]       Tcb     Pointer to the TCP_CB of this TCP instance.
+  @param[in, out]  Entry   On input, the entry of the queue to start from.
+                           On output, the entry following the range.
+  @param[out]      Block   Pointer to the range found.
+
+  @retval          TRUE    A range is found.
+  @retval          FALSE   There is no more out-of-order data.
+
+**/
+BOOLEAN
+TcpGetRcvSackBlock (
+  IN     TCP_CB          *Tcb,
+  IN OUT LIST_ENTRY      **Entry,
+  OUT    TCP_SACK_BLOCK  *Block
+  )
+{
+  NET_BUF  *Nbuf;
+  TCP_SEG  *Seg;
+  BOOLEAN  Found;
+
+  Found = FALSE;
+
+  while (*Entry != &Tcb->RcvQue) {
+    Nbuf = NET_LIST_USER_STRUCT (*Entry, NET_BUF, List);
+    Seg  = TCPSEG_NETBUF (Nbuf);
+
+    if (!Found) {
+      if (TCP_SEQ_GT (Seg->Seq, Tcb->RcvNxt)) {
+        Block->Left  = Seg->Seq;
+        Block->Right = Seg->End;
+        Found        = TRUE;
+      }
+    } else if (Seg->Seq == Block->Right) {
+      Block->Right = Seg->End;
+    } else {
+      break;
+    }
+
+    *Entry = (*Entry)->ForwardLink;
+  }
+
+  return Found;
+}
+
+/**
+  Build the SACK option to report the out-of-order data received as
+  defined in RFC2018. The first block reports the range holding the
+  most recently received segment, and the other blocks follow in
+  sequence order.
+
+  @param[in]  Tcb       Pointer to the TCP_CB of this TCP instance.
+  @param[in]  Nbuf      Pointer to the buffer to store the option.
+  @param[in]  MaxBlock  The maximum number of blocks to report.
+
+  @return               The length of the option, 0 if nothing to report.
+
+**/
+UINT16
+TcpBuildSackOption (
+  IN TCP_CB   *Tcb,
+  IN NET_BUF  *Nbuf,
+  IN UINT32   MaxBlock
+  )
+{
+  TCP_SACK_BLOCK  Block[TCP_OPTION_SACK_MAX_BLOCK];
+  TCP_SACK_BLOCK  Cur;
+  LIST_ENTRY      *Entry;
+  UINT32          Count;
+  UINT32          Index;
+  UINT8           *Data;
+  UINT16          Len;
+
+  MaxBlock = MIN (MaxBlock, TCP_OPTION_SACK_MAX_BLOCK);
+  Count    = 0;
+
+  if (MaxBlock == 0) {
+    return 0;
+  }
+
+  Entry = Tcb->RcvQue.ForwardLink;
+  while (TcpGetRcvSackBlock (Tcb, &Entry, &Cur)) {
+    if (TCP_SEQ_LEQ (Cur.Left, Tcb->RcvSackSeq) && TCP_SEQ_LT (Tcb->RcvSackSeq, Cur.Right)) {
+      Block[Count++] = Cur;
+      break;
+    }
+  }
+
+  Entry = Tcb->RcvQue.ForwardLink;
+  while ((Count < MaxBlock) && TcpGetRcvSackBlock (Tcb, &Entry, &Cur)) {
+    if ((Count > 0) && (Cur.Left == Block[0].Left)) {
+      continue;
+    }
+
+    Block[Count++] = Cur;
+  }
+
+  if (Count == 0) {
+    return 0;
+  }
+
+  Len  = (UINT16)TCP_OPTION_SACK_ALIGNED_LEN (Count);
+  Data = NetbufAllocSpace (Nbuf, Len, NET_BUF_HEAD);
+  ASSERT (Data != NULL);
+
+  TcpPutUint32 (Data, TCP_OPTION_SACK_FAST | (Len - 2));
+
+  for (Index = 0; Index < Count; Index++) {
+    TcpPutUint32 (Data + 4 + Index * TCP_OPTION_SACK_BLOCK_LEN, Block[Index].Left);
+    TcpPutUint32 (Data + 8 + Index * TCP_OPTION_SACK_BLOCK_LEN, Block[Index].Right);
+  }
+
+  return Len;
+}
+
 /**
   Build the TCP option in synchronized states.
 
@@ -189,6 +329,7 @@ TcpBuildOption (
 {
   UINT8   *Data;
   UINT16  Len;
+  UINT32  Room;
 
   ASSERT ((Tcb != NULL) && (Nbuf != NULL) && (Nbuf->Tcp == NULL));
   Len = 0;
@@ -214,6 +355,28 @@ TcpBuildOption (
     TcpPutUint32 (Data + 8, Tcb->TsRecent);
   }
 
+  //
+  // Build the SACK option if there is out-of-order data.
+  // SndMss only reserves room for the timestamp option,
+  // so the blocks must also fit in the room left by the
+  // data of the segment.
+  //
+  if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_RCVD_SACK) &&
+      !TCP_FLG_ON (TCPSEG_NETBUF (Nbuf)->Flag, TCP_FLG_RST) &&
+      !IsListEmpty (&Tcb->RcvQue)
+      )
+  {
+    Room = TCP_OPTION_MAX_LEN - Len;
+
+    if (Nbuf->TotalSize != 0) {
+      Room = MIN (Room, (Tcb->SndMss > Nbuf->TotalSize) ? Tcb->SndMss - Nbuf->TotalSize : 0);
+    }
+
+    if (Room >= TCP_OPTION_SACK_ALIGNED_LEN (1)) {
+      Len = (UINT16)(Len + TcpBuildSackOption (Tcb, Nbuf, (Room - 4) / TCP_OPTION_SACK_BLOCK_LEN));
+    }
+  }
+
   return Len;
 }
 
@@ -239,10 +402,12 @@ TcpParseOption (
   UINT8  Cur;
   UINT8  Type;
   UINT8  Len;
+  UINT8  Index;
 
   ASSERT ((Tcp != NULL) && (Option != NULL));
 
-  Option->Flag = 0;
+  Option->Flag      = 0;
+  Option->SackCount = 0;
 
   TotalLen = (UINT8)((Tcp->HeadLen << 2) - sizeof (TCP_HEAD));
   if (TotalLen <= 0) {
@@ -311,6 +476,47 @@ TcpParseOption (
         Cur += TCP_OPTION_TS_LEN;
         break;
 
+      case TCP_OPTION_SACK_PERM:
+        if ((TotalLen - Cur < TCP_OPTION_SACK_PERM_LEN) || (Head[Cur + 1] != TCP_OPTION_SACK_PERM_LEN)) {
+          return -1;
+        }
+
+        TCP_SET_FLG (Option->Flag, TCP_OPTION_RCVD_SACK_PERM);
+
+        Cur += TCP_OPTION_SACK_PERM_LEN;
+        break;
+
+      case TCP_OPTION_SACK:
+        if (TotalLen - Cur < 2) {
+          return -1;
+        }
+
+        Len = Head[Cur + 1];
+
+        if ((TotalLen - Cur < Len) ||
+            (Len < 2 + TCP_OPTION_SACK_BLOCK_LEN) ||
+            ((Len - 2) % TCP_OPTION_SACK_BLOCK_LEN != 0)
+            )
+        {
+          return -1;
+        }
+
+        //
+        // The option space limits a SACK option to four blocks.
+        //
+        Option->SackCount = (UINT8)((Len - 2) / TCP_OPTION_SACK_BLOCK_LEN);
+        ASSERT (Option->SackCount <= TCP_OPTION_SACK_MAX_BLOCK);
+
+        for (Index = 0; Index < Option->SackCount; Index++) {
+          Option->Sack[Index].Left  = TcpGetUint32 (&Head[Cur + 2 + Index * TCP_OPTION_SACK_BLOCK_LEN]);
+          Option->Sack[Index].Right = TcpGetUint32 (&Head[Cur + 6 + Index * TCP_OPTION_SACK_BLOCK_LEN]);
+        }
+
+        TCP_SET_FLG (Option->Flag, TCP_OPTION_RCVD_SACK);
+
+        Cur = (UINT8)(Cur + Len);
+        break;
+
       case TCP_OPTION_NOP:
         Cur++;
         break;
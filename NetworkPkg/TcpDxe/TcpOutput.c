@@ -636,13 +636,15 @@ TcpRetransmit (
 {
   NET_BUF  *Nbuf;
   UINT32   Len;
+  UINT8    Index;
 
   //
   // Compute the maximum length of retransmission. It is
-  // limited by three factors:
+  // limited by four factors:
   // 1. Less than SndMss
   // 2. Must in the current send window
   // 3. Will not change the boundaries of queued segments.
+  // 4. Will not resend the data SACKed by the peer.
   //
 
   //
@@ -675,6 +677,13 @@ TcpRetransmit (
 
   Len = MIN (Len, Tcb->SndMss);
 
+  for (Index = 0; Index < Tcb->SackCount; Index++) {
+    if (TCP_SEQ_GT (Tcb->SackBlock[Index].Left, Seq)) {
+      Len = MIN (Len, TCP_SUB_SEQ (Tcb->SackBlock[Index].Left, Seq));
+      break;
+    }
+  }
+
   Nbuf = TcpGetSegmentSndQue (Tcb, Seq, Len);
   if (Nbuf == NULL) {
     return -1;
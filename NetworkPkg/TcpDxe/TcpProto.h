@@ -52,6 +52,13 @@
 #define TCP_CONGEST_LOSS     2      ///< Retxmit because of retxmit time out.
 #define TCP_CONGEST_OPEN     3      ///< TCP is opening its congestion window.
 
+//
+// Congestion control algorithm of a TCP instance, selected by
+// PcdTcpCongestionControl when the instance is configured.
+//
+#define TCP_CONGEST_CONTROL_NEWRENO  0  ///< RFC5681 congestion avoidance.
+#define TCP_CONGEST_CONTROL_CUBIC    1  ///< RFC9438 CUBIC congestion avoidance.
+
 //
 // TCP control flags
 //
@@ -70,6 +77,8 @@
 #define TCP_CTRL_TIMER_ON      0x1000   ///< At least one of the timer is on.
 #define TCP_CTRL_RTT_ON        0x2000   ///< The RTT measurement is on.
 #define TCP_CTRL_ACK_NOW       0x4000   ///< Send the ACK now, don't delay.
+#define TCP_CTRL_NO_SACK       0x8000   ///< Disable selective acknowledgment.
+#define TCP_CTRL_RCVD_SACK     0x10000  ///< Received a SACK-permitted option in syn.
 
 //
 // Timer related values
@@ -106,6 +115,12 @@
 //
 #define TCP_MAX_HEAD  192
 
+//
+// The number of ranges above SND.UNA selectively acknowledged by
+// the peer that are remembered by the sender.
+//
+#define TCP_SACK_SCOREBOARD_SIZE  16
+
 //
 // Value ranges for some control option
 //
@@ -216,6 +231,14 @@ typedef struct _TCP_SEG {
   UINT32       Wnd;  ///< TCP window size field.
 } TCP_SEG;
 
+///
+/// A range of sequence numbers, as carried in the SACK option.
+///
+typedef struct _TCP_SACK_BLOCK {
+  TCP_SEQNO    Left;  ///< The first sequence number of the range.
+  TCP_SEQNO    Right; ///< The sequence number following the range.
+} TCP_SACK_BLOCK;
+
 ///
 /// Network endpoint, IP plus Port structure.
 ///
@@ -306,6 +329,25 @@ struct _TCP_CONTROL_BLOCK {
   UINT8               LossTimes;    ///< Number of retxmit timeouts in a row.
   TCP_SEQNO           LossRecover;  ///< Recover point for retxmit.
 
+  //
+  // RFC2018 selective acknowledgment.
+  //
+  TCP_SACK_BLOCK      SackBlock[TCP_SACK_SCOREBOARD_SIZE]; ///< Ranges SACKed by the peer, in order.
+  UINT8               SackCount;                           ///< Number of ranges in SackBlock.
+  TCP_SEQNO           SackRetxNxt;                         ///< The holes below it are retxmitted.
+  TCP_SEQNO           RcvSackSeq;                          ///< Last out-of-order segment received.
+
+  //
+  // RFC9438 CUBIC congestion avoidance.
+  //
+  UINT8               CongestControl; ///< Such as TCP_CONGEST_CONTROL_CUBIC.
+  BOOLEAN             CubicEpochOn;   ///< If TRUE, the current epoch has started.
+  UINT32              CubicEpoch;     ///< The tick the current epoch started at.
+  UINT32              CubicK;         ///< Time to reach CubicWMax in the epoch, in ms.
+  UINT32              CubicWMax;      ///< CWnd before the last window reduction.
+  UINT32              CubicOrigin;    ///< CWnd at the plateau of the cubic curve.
+  UINT32              CubicWEst;      ///< CWnd that Reno would have in the epoch.
+
   //
   // RFC7323
   // Addressing Window Retraction for TCP Window Scale Option.
@@ -194,7 +194,7 @@ TcpRexmitTimeout (
   // yet ACKed.
   //
   FlightSize    = TCP_SUB_SEQ (Tcb->SndNxt, Tcb->SndUna);
-  Tcb->Ssthresh = MAX ((UINT32)(2 * Tcb->SndMss), FlightSize / 2);
+  Tcb->Ssthresh = TcpCongestSsthresh (Tcb, FlightSize);
 
   Tcb->CWnd        = Tcb->SndMss;
   Tcb->LossRecover = Tcb->SndNxt;
@@ -215,6 +215,12 @@ TcpRexmitTimeout (
     return;
   }
 
+  //
+  // The peer may have discarded the data it SACKed (RFC2018
+  // section 8), so retransmit from SND.UNA regardless.
+  //
+  TcpSackClear (Tcb);
+
   TcpBackoffRto (Tcb);
   TcpRetransmit (Tcb, Tcb->SndUna);
   TcpSetTimer (Tcb, TCP_TIMER_REXMIT, Tcb->Rto);
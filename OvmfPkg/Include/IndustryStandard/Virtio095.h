@@ -100,7 +100,7 @@ typedef struct {
   volatile UINT16    *Idx;
 
   volatile UINT16    *Ring;      // QueueSize elements
-  volatile UINT16    *UsedEvent; // unused as per negotiation
+  volatile UINT16    *UsedEvent; // with VIRTIO_F_RING_EVENT_IDX only
 } VRING_AVAIL;
 
 //
@@ -119,7 +119,7 @@ typedef struct {
   volatile UINT16             *Flags;
   volatile UINT16             *Idx;
   volatile VRING_USED_ELEM    *UsedElem;   // QueueSize elements
-  volatile UINT16             *AvailEvent; // unused as per negotiation
+  volatile UINT16             *AvailEvent; // with VIRTIO_F_RING_EVENT_IDX only
 } VRING_USED;
 
 //
@@ -138,13 +138,63 @@ typedef struct {
 } VRING_DESC;
 #pragma pack()
 
+//
+// virtio-1.1, 2.7 Packed Virtqueues
+//
+// The packed layout requires VIRTIO_F_VERSION_1, but its structures are
+// defined here, as VRING below describes both layouts. The NEXT and WRITE
+// descriptor flags keep their values from the split layout.
+//
+#define VRING_PACKED_DESC_F_AVAIL  BIT7
+#define VRING_PACKED_DESC_F_USED   BIT15
+
+#pragma pack(1)
+typedef struct {
+  UINT64    Addr;
+  UINT32    Len;
+  UINT16    Id;
+  UINT16    Flags;
+} VRING_PACKED_DESC;
+#pragma pack()
+
+//
+// virtio-1.1, 2.7.14 Event Suppression Structure Format
+//
+#define VRING_PACKED_EVENT_FLAG_ENABLE   0x0
+#define VRING_PACKED_EVENT_FLAG_DISABLE  0x1
+#define VRING_PACKED_EVENT_FLAG_DESC     0x2 // with VIRTIO_F_RING_EVENT_IDX only
+
+#define VRING_PACKED_EVENT_F_WRAP_CTR  BIT15
+
+#pragma pack(1)
+typedef struct {
+  UINT16    OffWrap;
+  UINT16    Flags;
+} VRING_PACKED_EVENT;
+#pragma pack()
+
+//
+// With the packed layout, Desc, Avail.Flags and Used.Flags point to the
+// descriptor ring and to the driver and device event suppression structures
+// respectively, so that the transports can program the queue addresses
+// without knowing the layout. The other pointers of Avail and Used are NULL.
+//
 typedef struct {
-  UINTN                  NumPages;
-  VOID                   *Base;  // deallocate only this field
-  volatile VRING_DESC    *Desc;  // QueueSize elements
-  VRING_AVAIL            Avail;
-  VRING_USED             Used;
-  UINT16                 QueueSize;
+  UINTN                          NumPages;
+  VOID                           *Base;        // deallocate only this field
+  volatile VRING_DESC            *Desc;        // QueueSize elements
+  VRING_AVAIL                    Avail;
+  VRING_USED                     Used;
+  UINT16                         QueueSize;
+  BOOLEAN                        EventIdx;     // VIRTIO_F_RING_EVENT_IDX
+  BOOLEAN                        Packed;       // VIRTIO_F_RING_PACKED
+  volatile VRING_PACKED_DESC     *PackedDesc;  // QueueSize elements
+  volatile VRING_PACKED_EVENT    *DriverEvent;
+  volatile VRING_PACKED_EVENT    *DeviceEvent;
+  UINT16                         NextAvail;    // packed layout only
+  UINT16                         NextUsed;     // packed layout only
+  BOOLEAN                        AvailWrapCounter;
+  BOOLEAN                        UsedWrapCounter;
 } VRING;
 
 //
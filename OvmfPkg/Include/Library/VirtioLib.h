@@ -51,6 +51,50 @@ VirtioRingInit (
   OUT VRING                   *Ring
   );
 
+/**
+
+  Configure a virtio ring, with the layout and notification scheme selected by
+  the negotiated features.
+
+  With VIRTIO_F_RING_PACKED, the ring uses the packed layout of virtio-1.1,
+  2.7 Packed Virtqueues; otherwise the split layout of VirtioRingInit(). With
+  VIRTIO_F_RING_EVENT_IDX, VirtioPrepare() and VirtioFlush() use the event
+  index (or event offset) fields of the ring to suppress notifications, rather
+  than the flags.
+
+  Only the VirtioPrepare(), VirtioAppendDesc() and VirtioFlush() functions
+  support the packed layout; drivers accessing the ring directly must not
+  negotiate VIRTIO_F_RING_PACKED, nor VIRTIO_F_RING_EVENT_IDX unless they
+  handle the event index fields themselves.
+
+  @param[in]  VirtIo            The virtio device which will use the ring.
+
+  @param[in]  QueueSize         The number of descriptors to allocate for the
+                                virtio ring, as requested by the host.
+
+  @param[in]  Features          The features negotiated with the device. Only
+                                VIRTIO_F_RING_PACKED and
+                                VIRTIO_F_RING_EVENT_IDX are taken into account.
+
+  @param[out] Ring              The virtio ring to set up.
+
+  @return                       Status codes propagated from
+                                VirtIo->AllocateSharedPages().
+
+  @retval EFI_SUCCESS           Allocation and setup successful. Ring->Base
+                                (and nothing else) is responsible for
+                                deallocation.
+
+**/
+EFI_STATUS
+EFIAPI
+VirtioRingInitEx (
+  IN  VIRTIO_DEVICE_PROTOCOL  *VirtIo,
+  IN  UINT16                  QueueSize,
+  IN  UINT64                  Features,
+  OUT VRING                   *Ring
+  );
+
 /**
 
   Map the ring buffer so that it can be accessed equally by both guest
@@ -156,7 +200,8 @@ VirtioPrepare (
                                     always set, but the host only interprets
                                     it dependent on VRING_DESC_F_NEXT.
 
-  @param[in,out] Indices            Indices->HeadDescIdx is not accessed.
+  @param[in,out] Indices            Indices->HeadDescIdx is only accessed
+                                    with the packed layout, as buffer ID.
                                     On input, Indices->NextDescIdx identifies
                                     the next descriptor to carry the buffer.
                                     On output, Indices->NextDescIdx is
@@ -178,15 +223,19 @@ VirtioAppendDesc (
   Notify the host about the descriptor chain just built, and wait until the
   host processes it.
 
+  The host is not notified if it asked not to be, with the flags or (with
+  VIRTIO_F_RING_EVENT_IDX) the event index of the ring.
+
   @param[in] VirtIo       The target virtio device to notify.
 
   @param[in] VirtQueueId  Identifies the queue for the target device.
 
   @param[in,out] Ring     The virtio ring with descriptors to submit.
 
-  @param[in] Indices      Indices->NextDescIdx is not accessed.
-                          Indices->HeadDescIdx identifies the head descriptor
-                          of the descriptor chain.
+  @param[in] Indices      Indices->HeadDescIdx identifies the head descriptor
+                          of the descriptor chain. Indices->NextDescIdx is
+                          only accessed with the packed layout, to determine
+                          the length of the chain.
 
   @param[out] UsedLen     On success, the total number of bytes, consecutively
                           across the buffers linked by the descriptor chain,
@@ -17,6 +17,13 @@
 
 #include <Library/VirtioLib.h>
 
+//
+// Number of times VirtioFlush() polls the ring before it starts stalling
+// between polls. Polling the ring only reads guest memory, while each stall
+// reads the platform timer, which traps to the hypervisor.
+//
+#define VIRTIO_FLUSH_SPIN_COUNT  4096
+
 /**
 
   Configure a virtio ring.
@@ -51,11 +58,148 @@ VirtioRingInit (
   IN  UINT16                  QueueSize,
   OUT VRING                   *Ring
   )
+{
+  return VirtioRingInitEx (VirtIo, QueueSize, 0, Ring);
+}
+
+/**
+
+  Configure a virtio ring with the packed layout.
+
+  Relevant sections from the virtio-1.1 spec:
+  - 2.7 Packed Virtqueues,
+  - 2.7.10 Driver and Device Event Suppression.
+
+  @param[in]  VirtIo            The virtio device which will use the ring.
+
+  @param[in]  QueueSize         The number of descriptors to allocate for the
+                                virtio ring, as requested by the host.
+
+  @param[out] Ring              The virtio ring to set up. The caller is
+                                responsible for zeroing it.
+
+  @return                       Status codes propagated from
+                                VirtIo->AllocateSharedPages().
+
+  @retval EFI_SUCCESS           Allocation and setup successful.
+
+**/
+STATIC
+EFI_STATUS
+VirtioPackedRingInit (
+  IN  VIRTIO_DEVICE_PROTOCOL  *VirtIo,
+  IN  UINT16                  QueueSize,
+  OUT VRING                   *Ring
+  )
+{
+  EFI_STATUS      Status;
+  UINTN           RingSize;
+  volatile UINT8  *RingPagesPtr;
+
+  RingSize = ALIGN_VALUE (
+               sizeof *Ring->PackedDesc * QueueSize +
+               sizeof *Ring->DriverEvent            +
+               sizeof *Ring->DeviceEvent,
+               EFI_PAGE_SIZE
+               );
+
+  Ring->NumPages = EFI_SIZE_TO_PAGES (RingSize);
+  Status         = VirtIo->AllocateSharedPages (
+                             VirtIo,
+                             Ring->NumPages,
+                             &Ring->Base
+                             );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  SetMem (Ring->Base, RingSize, 0x00);
+  RingPagesPtr = Ring->Base;
+
+  Ring->PackedDesc = (volatile VOID *)RingPagesPtr;
+  RingPagesPtr    += sizeof *Ring->PackedDesc * QueueSize;
+
+  Ring->DriverEvent = (volatile VOID *)RingPagesPtr;
+  RingPagesPtr     += sizeof *Ring->DriverEvent;
+
+  Ring->DeviceEvent = (volatile VOID *)RingPagesPtr;
+  RingPagesPtr     += sizeof *Ring->DeviceEvent;
+
+  //
+  // Let the transports find the descriptor ring, and the driver and device
+  // areas, where they expect them.
+  //
+  Ring->Desc        = (volatile VOID *)Ring->PackedDesc;
+  Ring->Avail.Flags = (volatile VOID *)Ring->DriverEvent;
+  Ring->Used.Flags  = (volatile VOID *)Ring->DeviceEvent;
+
+  //
+  // virtio-1.1, 2.7.1 Driver and Device Ring Wrap Counters: both start at 1.
+  // The zeroed descriptors are neither available nor used then.
+  //
+  Ring->AvailWrapCounter = TRUE;
+  Ring->UsedWrapCounter  = TRUE;
+
+  Ring->Packed    = TRUE;
+  Ring->QueueSize = QueueSize;
+  return EFI_SUCCESS;
+}
+
+/**
+
+  Configure a virtio ring, with the layout and notification scheme selected by
+  the negotiated features.
+
+  With VIRTIO_F_RING_PACKED, the ring uses the packed layout of virtio-1.1,
+  2.7 Packed Virtqueues; otherwise the split layout of VirtioRingInit(). With
+  VIRTIO_F_RING_EVENT_IDX, VirtioPrepare() and VirtioFlush() use the event
+  index (or event offset) fields of the ring to suppress notifications, rather
+  than the flags.
+
+  Only the VirtioPrepare(), VirtioAppendDesc() and VirtioFlush() functions
+  support the packed layout; drivers accessing the ring directly must not
+  negotiate VIRTIO_F_RING_PACKED, nor VIRTIO_F_RING_EVENT_IDX unless they
+  handle the event index fields themselves.
+
+  @param[in]  VirtIo            The virtio device which will use the ring.
+
+  @param[in]  QueueSize         The number of descriptors to allocate for the
+                                virtio ring, as requested by the host.
+
+  @param[in]  Features          The features negotiated with the device. Only
+                                VIRTIO_F_RING_PACKED and
+                                VIRTIO_F_RING_EVENT_IDX are taken into account.
+
+  @param[out] Ring              The virtio ring to set up.
+
+  @return                       Status codes propagated from
+                                VirtIo->AllocateSharedPages().
+
+  @retval EFI_SUCCESS           Allocation and setup successful. Ring->Base
+                                (and nothing else) is responsible for
+                                deallocation.
+
+**/
+EFI_STATUS
+EFIAPI
+VirtioRingInitEx (
+  IN  VIRTIO_DEVICE_PROTOCOL  *VirtIo,
+  IN  UINT16                  QueueSize,
+  IN  UINT64                  Features,
+  OUT VRING                   *Ring
+  )
 {
   EFI_STATUS      Status;
   UINTN           RingSize;
   volatile UINT8  *RingPagesPtr;
 
+  SetMem (Ring, sizeof *Ring, 0x00);
+  Ring->EventIdx = (BOOLEAN)((Features & VIRTIO_F_RING_EVENT_IDX) != 0);
+
+  if ((Features & VIRTIO_F_RING_PACKED) != 0) {
+    return VirtioPackedRingInit (VirtIo, QueueSize, Ring);
+  }
+
   RingSize = ALIGN_VALUE (
                sizeof *Ring->Desc            * QueueSize +
                sizeof *Ring->Avail.Flags                 +
@@ -169,12 +313,37 @@ VirtioPrepare (
   OUT    DESC_INDICES  *Indices
   )
 {
+  if (Ring->Packed) {
+    //
+    // virtio-1.1, 2.7.10 Driver and Device Event Suppression -- we're going to
+    // poll the answer.
+    //
+    Ring->DriverEvent->Flags = VRING_PACKED_EVENT_FLAG_DISABLE;
+
+    //
+    // The chain starts at the next available descriptor, whose index also
+    // serves as buffer ID.
+    //
+    Indices->HeadDescIdx = Ring->NextAvail;
+    Indices->NextDescIdx = Indices->HeadDescIdx;
+    return;
+  }
+
   //
   // Prepare for virtio-0.9.5, 2.4.2 Receiving Used Buffers From the Device.
   // We're going to poll the answer, the host should not send an interrupt.
   //
   *Ring->Avail.Flags = (UINT16)VRING_AVAIL_F_NO_INTERRUPT;
 
+  if (Ring->EventIdx) {
+    //
+    // With VIRTIO_F_RING_EVENT_IDX, the host ignores the above flag, and
+    // interrupts when the used index moves past the used event index. Keep
+    // the latter right behind the current used index.
+    //
+    *Ring->Avail.UsedEvent = (UINT16)(*Ring->Used.Idx - 1);
+  }
+
   //
   // Prepare for virtio-0.9.5, 2.4.1 Supplying Buffers to the Device.
   //
@@ -216,7 +385,8 @@ VirtioPrepare (
                                     always set, but the host only interprets
                                     it dependent on VRING_DESC_F_NEXT.
 
-  @param[in,out] Indices            Indices->HeadDescIdx is not accessed.
+  @param[in,out] Indices            Indices->HeadDescIdx is only accessed
+                                    with the packed layout, as buffer ID.
                                     On input, Indices->NextDescIdx identifies
                                     the next descriptor to carry the buffer.
                                     On output, Indices->NextDescIdx is
@@ -233,7 +403,34 @@ VirtioAppendDesc (
   IN OUT DESC_INDICES  *Indices
   )
 {
-  volatile VRING_DESC  *Desc;
+  volatile VRING_DESC         *Desc;
+  volatile VRING_PACKED_DESC  *PackedDesc;
+  BOOLEAN                     WrapCounter;
+
+  if (Ring->Packed) {
+    //
+    // virtio-1.1, 2.7.13.1 Placing Available Buffers Into The Descriptor Ring
+    //
+    // Descriptors past the end of the ring belong to the next lap. The head
+    // descriptor is made available only by VirtioFlush(), once the rest of the
+    // chain is in place; until then, its AVAIL and USED flags are equal.
+    //
+    WrapCounter = Ring->AvailWrapCounter;
+    if (Indices->NextDescIdx >= Ring->QueueSize) {
+      WrapCounter = !WrapCounter;
+    }
+
+    if (Indices->NextDescIdx != Indices->HeadDescIdx) {
+      Flags |= WrapCounter ? VRING_PACKED_DESC_F_AVAIL : VRING_PACKED_DESC_F_USED;
+    }
+
+    PackedDesc        = &Ring->PackedDesc[Indices->NextDescIdx++ % Ring->QueueSize];
+    PackedDesc->Addr  = BufferDeviceAddress;
+    PackedDesc->Len   = BufferSize;
+    PackedDesc->Id    = Indices->HeadDescIdx;
+    PackedDesc->Flags = Flags;
+    return;
+  }
 
   Desc        = &Ring->Desc[Indices->NextDescIdx++ % Ring->QueueSize];
   Desc->Addr  = BufferDeviceAddress;
@@ -242,20 +439,252 @@ VirtioAppendDesc (
   Desc->Next  = Indices->NextDescIdx % Ring->QueueSize;
 }
 
+/**
+
+  Check if the host asked to be notified about the descriptors made available
+  between two indices, with VIRTIO_F_RING_EVENT_IDX. This is the
+  vring_need_event() function of the virtio specification.
+
+  @param[in] EventIdx  The event index set by the host.
+
+  @param[in] NewIdx    The index following the descriptors made available.
+
+  @param[in] OldIdx    The index of the first descriptor made available.
+
+  @retval TRUE   EventIdx is between OldIdx (inclusive) and NewIdx (exclusive),
+                 modulo 2^16.
+
+  @retval FALSE  Otherwise.
+
+**/
+STATIC
+BOOLEAN
+VirtioNeedEvent (
+  IN UINT16  EventIdx,
+  IN UINT16  NewIdx,
+  IN UINT16  OldIdx
+  )
+{
+  return (BOOLEAN)((UINT16)(NewIdx - EventIdx - 1) < (UINT16)(NewIdx - OldIdx));
+}
+
+/**
+
+  Check if the host has used the descriptor chain submitted last.
+
+  @param[in] Ring         The virtio ring the descriptor chain was submitted
+                          to.
+
+  @param[in] NextUsedIdx  The used index the host produces when it uses the
+                          descriptor chain. Only accessed with the split
+                          layout.
+
+  @retval TRUE   The host has used the descriptor chain.
+
+  @retval FALSE  Otherwise.
+
+**/
+STATIC
+BOOLEAN
+VirtioIsUsed (
+  IN VRING   *Ring,
+  IN UINT16  NextUsedIdx
+  )
+{
+  UINT16  Flags;
+  UINT16  UsedFlags;
+
+  if (!Ring->Packed) {
+    return (BOOLEAN)(*Ring->Used.Idx == NextUsedIdx);
+  }
+
+  //
+  // virtio-1.1, 2.7.1 Driver and Device Ring Wrap Counters -- the AVAIL and
+  // USED flags of a used descriptor are both equal to the used wrap counter.
+  //
+  Flags     = Ring->PackedDesc[Ring->NextUsed].Flags;
+  Flags    &= VRING_PACKED_DESC_F_AVAIL | VRING_PACKED_DESC_F_USED;
+  UsedFlags = Ring->UsedWrapCounter ?
+              VRING_PACKED_DESC_F_AVAIL | VRING_PACKED_DESC_F_USED :
+              0;
+  return (BOOLEAN)(Flags == UsedFlags);
+}
+
+/**
+
+  Wait until the host uses the descriptor chain submitted last.
+
+  @param[in] Ring         The virtio ring the descriptor chain was submitted
+                          to.
+
+  @param[in] NextUsedIdx  The used index the host produces when it uses the
+                          descriptor chain. Only accessed with the split
+                          layout.
+
+**/
+STATIC
+VOID
+VirtioWaitUsed (
+  IN VRING   *Ring,
+  IN UINT16  NextUsedIdx
+  )
+{
+  UINTN  SpinCount;
+  UINTN  PollPeriodUsecs;
+
+  //
+  // Most requests complete within a few microseconds, so poll the ring
+  // back-to-back first. Then keep slowing down until we reach a poll period
+  // of slightly above 1 ms.
+  //
+  SpinCount       = 0;
+  PollPeriodUsecs = 1;
+  MemoryFence ();
+  while (!VirtioIsUsed (Ring, NextUsedIdx)) {
+    if (SpinCount < VIRTIO_FLUSH_SPIN_COUNT) {
+      CpuPause ();
+      SpinCount++;
+    } else {
+      gBS->Stall (PollPeriodUsecs); // calls AcpiTimerLib::MicroSecondDelay
+
+      if (PollPeriodUsecs < 1024) {
+        PollPeriodUsecs *= 2;
+      }
+    }
+
+    MemoryFence ();
+  }
+
+  MemoryFence ();
+}
+
+/**
+
+  Notify the host about the descriptor chain just built in a packed ring, and
+  wait until the host processes it.
+
+  See VirtioFlush() for the parameters and return values.
+
+**/
+STATIC
+EFI_STATUS
+VirtioPackedFlush (
+  IN     VIRTIO_DEVICE_PROTOCOL  *VirtIo,
+  IN     UINT16                  VirtQueueId,
+  IN OUT VRING                   *Ring,
+  IN     DESC_INDICES            *Indices,
+  OUT    UINT32                  *UsedLen    OPTIONAL
+  )
+{
+  volatile VRING_PACKED_DESC  *Desc;
+  UINT16                      Count;
+  UINT16                      Flags;
+  UINT16                      OffWrap;
+  UINT16                      EventIdx;
+  BOOLEAN                     Notify;
+  EFI_STATUS                  Status;
+
+  Count = (UINT16)(Indices->NextDescIdx - Indices->HeadDescIdx);
+  ASSERT (Count > 0 && Count <= Ring->QueueSize);
+  ASSERT (Indices->HeadDescIdx == Ring->NextAvail);
+
+  //
+  // virtio-1.1, 2.7.13.3 Updating flags -- making the head descriptor
+  // available publishes the whole chain.
+  //
+  Desc   = &Ring->PackedDesc[Indices->HeadDescIdx];
+  Flags  = Desc->Flags;
+  Flags &= (UINT16) ~(VRING_PACKED_DESC_F_AVAIL | VRING_PACKED_DESC_F_USED);
+  Flags |= Ring->AvailWrapCounter ? VRING_PACKED_DESC_F_AVAIL : VRING_PACKED_DESC_F_USED;
+  MemoryFence ();
+  Desc->Flags = Flags;
+
+  Ring->NextAvail = (UINT16)(Ring->NextAvail + Count);
+  if (Ring->NextAvail >= Ring->QueueSize) {
+    Ring->NextAvail        = (UINT16)(Ring->NextAvail - Ring->QueueSize);
+    Ring->AvailWrapCounter = !Ring->AvailWrapCounter;
+  }
+
+  //
+  // virtio-1.1, 2.7.10 Driver and Device Event Suppression
+  //
+  MemoryFence ();
+  switch (Ring->DeviceEvent->Flags) {
+    case VRING_PACKED_EVENT_FLAG_DISABLE:
+      Notify = FALSE;
+      break;
+
+    case VRING_PACKED_EVENT_FLAG_DESC:
+      //
+      // The host wants to be notified when the descriptor at EventIdx is made
+      // available; EventIdx may still refer to the previous lap of the ring.
+      //
+      OffWrap  = Ring->DeviceEvent->OffWrap;
+      EventIdx = (UINT16)(OffWrap & ~VRING_PACKED_EVENT_F_WRAP_CTR);
+      if (((OffWrap & VRING_PACKED_EVENT_F_WRAP_CTR) != 0) != Ring->AvailWrapCounter) {
+        EventIdx = (UINT16)(EventIdx - Ring->QueueSize);
+      }
+
+      Notify = VirtioNeedEvent (
+                 EventIdx,
+                 Ring->NextAvail,
+                 (UINT16)(Ring->NextAvail - Count)
+                 );
+      break;
+
+    default:
+      Notify = TRUE;
+      break;
+  }
+
+  if (Notify) {
+    Status = VirtIo->SetQueueNotify (VirtIo, VirtQueueId);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  //
+  // virtio-1.1, 2.7.9 -- the host writes a single used descriptor for the
+  // chain, in place of its head, and skips over the rest of the chain. Due to
+  // our lock-step progress, the head is the next descriptor to be used.
+  //
+  ASSERT (Ring->NextUsed == Indices->HeadDescIdx);
+  VirtioWaitUsed (Ring, 0);
+
+  Desc = &Ring->PackedDesc[Ring->NextUsed];
+  ASSERT (Desc->Id == Indices->HeadDescIdx);
+  if (UsedLen != NULL) {
+    *UsedLen = Desc->Len;
+  }
+
+  Ring->NextUsed = (UINT16)(Ring->NextUsed + Count);
+  if (Ring->NextUsed >= Ring->QueueSize) {
+    Ring->NextUsed        = (UINT16)(Ring->NextUsed - Ring->QueueSize);
+    Ring->UsedWrapCounter = !Ring->UsedWrapCounter;
+  }
+
+  return EFI_SUCCESS;
+}
+
 /**
 
   Notify the host about the descriptor chain just built, and wait until the
   host processes it.
 
+  The host is not notified if it asked not to be, with the flags or (with
+  VIRTIO_F_RING_EVENT_IDX) the event index of the ring.
+
   @param[in] VirtIo       The target virtio device to notify.
 
   @param[in] VirtQueueId  Identifies the queue for the target device.
 
   @param[in,out] Ring     The virtio ring with descriptors to submit.
 
-  @param[in] Indices      Indices->NextDescIdx is not accessed.
-                          Indices->HeadDescIdx identifies the head descriptor
-                          of the descriptor chain.
+  @param[in] Indices      Indices->HeadDescIdx identifies the head descriptor
+                          of the descriptor chain. Indices->NextDescIdx is
+                          only accessed with the packed layout, to determine
+                          the length of the chain.
 
   @param[out] UsedLen     On success, the total number of bytes, consecutively
                           across the buffers linked by the descriptor chain,
@@ -282,7 +711,11 @@ VirtioFlush (
   UINT16      NextAvailIdx;
   UINT16      LastUsedIdx;
   EFI_STATUS  Status;
-  UINTN       PollPeriodUsecs;
+  BOOLEAN     Notify;
+
+  if (Ring->Packed) {
+    return VirtioPackedFlush (VirtIo, VirtQueueId, Ring, Indices, UsedLen);
+  }
 
   //
   // virtio-0.9.5, 2.4.1.2 Updating the Available Ring
@@ -308,12 +741,22 @@ VirtioFlush (
 
   //
   // virtio-0.9.5, 2.4.1.4 Notifying the Device -- gratuitous notifications are
-  // OK.
+  // OK, but each one traps to the hypervisor, so skip it if the host asked us
+  // to. With VIRTIO_F_RING_EVENT_IDX, the host asks through the available
+  // event index rather than the flags.
   //
   MemoryFence ();
-  Status = VirtIo->SetQueueNotify (VirtIo, VirtQueueId);
-  if (EFI_ERROR (Status)) {
-    return Status;
+  if (Ring->EventIdx) {
+    Notify = VirtioNeedEvent (*Ring->Used.AvailEvent, NextAvailIdx, LastUsedIdx);
+  } else {
+    Notify = (BOOLEAN)((*Ring->Used.Flags & VRING_USED_F_NO_NOTIFY) == 0);
+  }
+
+  if (Notify) {
+    Status = VirtIo->SetQueueNotify (VirtIo, VirtQueueId);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
   }
 
   //
@@ -322,21 +765,7 @@ VirtioFlush (
   // condition we use for polling is greatly simplified and relies on the
   // synchronous, lock-step progress.
   //
-  // Keep slowing down until we reach a poll period of slightly above 1 ms.
-  //
-  PollPeriodUsecs = 1;
-  MemoryFence ();
-  while (*Ring->Used.Idx != NextAvailIdx) {
-    gBS->Stall (PollPeriodUsecs); // calls AcpiTimerLib::MicroSecondDelay
-
-    if (PollPeriodUsecs < 1024) {
-      PollPeriodUsecs *= 2;
-    }
-
-    MemoryFence ();
-  }
-
-  MemoryFence ();
+  VirtioWaitUsed (Ring, NextAvailIdx);
 
   if (UsedLen != NULL) {
     volatile CONST VRING_USED_ELEM  *UsedElem;
@@ -831,7 +831,8 @@ VirtioBlkInit (
 
   Features &= VIRTIO_BLK_F_BLK_SIZE | VIRTIO_BLK_F_TOPOLOGY | VIRTIO_BLK_F_RO |
               VIRTIO_BLK_F_FLUSH | VIRTIO_F_VERSION_1 |
-              VIRTIO_F_IOMMU_PLATFORM;
+              VIRTIO_F_IOMMU_PLATFORM | VIRTIO_F_RING_PACKED |
+              VIRTIO_F_RING_EVENT_IDX;
 
   //
   // In virtio-1.0, feature negotiation is expected to complete before queue
@@ -863,7 +864,7 @@ VirtioBlkInit (
     goto Failed;
   }
 
-  Status = VirtioRingInit (Dev->VirtIo, QueueSize, &Dev->Ring);
+  Status = VirtioRingInitEx (Dev->VirtIo, QueueSize, Features, &Dev->Ring);
   if (EFI_ERROR (Status)) {
     goto Failed;
   }
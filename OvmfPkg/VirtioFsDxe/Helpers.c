@@ -136,7 +136,8 @@ VirtioFsInit (
   // of the virtio spec at <https://github.com/oasis-tcs/virtio-spec.git>, as
   // of commit 87fa6b5d8155.
   //
-  Features &= VIRTIO_F_VERSION_1 | VIRTIO_F_IOMMU_PLATFORM;
+  Features &= VIRTIO_F_VERSION_1 | VIRTIO_F_IOMMU_PLATFORM |
+              VIRTIO_F_RING_PACKED | VIRTIO_F_RING_EVENT_IDX;
 
   //
   // ... and write the subset of feature bits understood by the [...] driver to
@@ -212,9 +213,10 @@ VirtioFsInit (
   //
   // 7.d. [...] population of virtqueues [...]
   //
-  Status = VirtioRingInit (
+  Status = VirtioRingInitEx (
              VirtioFs->Virtio,
              VirtioFs->QueueSize,
+             Features,
              &VirtioFs->Ring
              );
   if (EFI_ERROR (Status)) {
@@ -75,7 +75,7 @@ typedef struct {
   VIRTIO_DEVICE_PROTOCOL             *Virtio;   // DriverBindingStart  0
   VIRTIO_FS_LABEL                    Label;     // VirtioFsInit        1
   UINT16                             QueueSize; // VirtioFsInit        1
-  VRING                              Ring;      // VirtioRingInit      2
+  VRING                              Ring;      // VirtioRingInitEx    2
   VOID                               *RingMap;  // VirtioRingMap       2
   UINT64                             RequestId; // FuseInitSession     1
   UINT32                             MaxWrite;  // FuseInitSession     1
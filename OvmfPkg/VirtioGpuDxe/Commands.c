@@ -86,7 +86,8 @@ VirtioGpuInit (
   //
   // We only want the most basic 2D features.
   //
-  Features &= VIRTIO_F_VERSION_1 | VIRTIO_F_IOMMU_PLATFORM;
+  Features &= VIRTIO_F_VERSION_1 | VIRTIO_F_IOMMU_PLATFORM |
+              VIRTIO_F_RING_PACKED | VIRTIO_F_RING_EVENT_IDX;
 
   //
   // ... and write the subset of feature bits understood by the [...] driver to
@@ -128,7 +129,12 @@ VirtioGpuInit (
   //
   // [...] population of virtqueues [...]
   //
-  Status = VirtioRingInit (VgpuDev->VirtIo, QueueSize, &VgpuDev->Ring);
+  Status = VirtioRingInitEx (
+             VgpuDev->VirtIo,
+             QueueSize,
+             Features,
+             &VgpuDev->Ring
+             );
   if (EFI_ERROR (Status)) {
     goto Failed;
   }
@@ -79,9 +79,11 @@ VirtioNetGetStatus (
   }
 
   //
-  // update link status
+  // update link status, unless the caller only recycles transmit buffers:
+  // reading the device configuration is expensive, and MNP reaps each
+  // transmit completion with a separate call
   //
-  if (Dev->Snm.MediaPresentSupported) {
+  if (Dev->Snm.MediaPresentSupported && ((InterruptStatus != NULL) || (TxBuf == NULL))) {
     UINT16  LinkStatus;
 
     Status = VIRTIO_CFG_READ (Dev, LinkStatus, &LinkStatus);
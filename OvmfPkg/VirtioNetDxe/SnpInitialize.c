@@ -68,7 +68,7 @@ VirtioNetInitRing (
   }
 
   //
-  // For each packet (RX and TX alike), we need two descriptors:
+  // For each packet (RX and TX alike), we need at most two descriptors:
   // one for the virtio-net request header, and another one for the data
   //
   if (QueueSize < 2) {
@@ -214,9 +214,10 @@ VirtioNetInitTx (
 
   //
   // In VirtIo 1.0, the NumBuffers field is mandatory. In 0.9.5, it depends on
-  // VIRTIO_NET_F_MRG_RXBUF, which we never negotiate.
+  // VIRTIO_NET_F_MRG_RXBUF.
   //
-  TxSharedReqSize = (Dev->VirtIo->Revision < VIRTIO_SPEC_REVISION (1, 0, 0)) ?
+  TxSharedReqSize = ((Dev->VirtIo->Revision < VIRTIO_SPEC_REVISION (1, 0, 0)) &&
+                     !Dev->RxMergeable) ?
                     sizeof (Dev->TxSharedReq->V0_9_5) :
                     sizeof *Dev->TxSharedReq;
 
@@ -294,7 +295,8 @@ FreeTxFreeStack:
     packet data into,
   - select polling over RX interrupt,
   - fully populate the RX queue with a static pattern of virtio descriptor
-    chains.
+    chains. With VIRTIO_NET_F_MRG_RXBUF, each chain is a single descriptor
+    receiving both the virtio-net request header and the packet data.
 
   @param[in,out] Dev       The VNET_DEV driver instance about to enter the
                            EfiSimpleNetworkInitialized state.
@@ -315,6 +317,7 @@ VirtioNetInitRx (
   EFI_STATUS            Status;
   UINTN                 VirtioNetReqSize;
   UINTN                 RxBufSize;
+  UINT16                RxDescPerPkt;
   UINT16                RxAlwaysPending;
   UINTN                 PktIdx;
   UINT16                DescIdx;
@@ -324,11 +327,13 @@ VirtioNetInitRx (
 
   //
   // In VirtIo 1.0, the NumBuffers field is mandatory. In 0.9.5, it depends on
-  // VIRTIO_NET_F_MRG_RXBUF, which we never negotiate.
+  // VIRTIO_NET_F_MRG_RXBUF.
   //
-  VirtioNetReqSize = (Dev->VirtIo->Revision < VIRTIO_SPEC_REVISION (1, 0, 0)) ?
+  VirtioNetReqSize = ((Dev->VirtIo->Revision < VIRTIO_SPEC_REVISION (1, 0, 0)) &&
+                      !Dev->RxMergeable) ?
                      sizeof (VIRTIO_NET_REQ) :
                      sizeof (VIRTIO_1_0_NET_REQ);
+  Dev->RxHdrSize = VirtioNetReqSize;
 
   //
   // For each incoming packet we must supply two descriptors:
@@ -336,14 +341,20 @@ VirtioNetInitRx (
   // - the recipient for the network data (which consists of Ethernet header
   //   and Ethernet payload).
   //
+  // With mergeable receive buffers, the virtio-net request header is placed
+  // at the start of the buffer, and one descriptor suffices.
+  //
   RxBufSize = VirtioNetReqSize +
               (Dev->Snm.MediaHeaderSize + Dev->Snm.MaxPacketSize);
+  RxDescPerPkt = Dev->RxMergeable ? 1 : 2;
 
   //
-  // Limit the number of pending RX packets if the queue is big. The division
-  // by two is due to the above "two descriptors per packet" trait.
+  // Limit the number of pending RX packets if the queue is big.
   //
-  RxAlwaysPending = (UINT16)MIN (Dev->RxRing.QueueSize / 2, VNET_MAX_PENDING);
+  RxAlwaysPending = (UINT16)MIN (
+                              Dev->RxRing.QueueSize / RxDescPerPkt,
+                              VNET_MAX_PENDING
+                              );
 
   //
   // The RxBuf is shared between guest and hypervisor, use
@@ -393,8 +404,9 @@ VirtioNetInitRx (
   *Dev->RxRing.Avail.Flags = (UINT16)VRING_AVAIL_F_NO_INTERRUPT;
 
   //
-  // now set up a separate, two-part descriptor chain for each RX packet, and
-  // link each chain into (from) the available ring as well
+  // now set up a separate, two-part (or, with mergeable receive buffers,
+  // single) descriptor chain for each RX packet, and link each chain into
+  // (from) the available ring as well
   //
   DescIdx            = 0;
   RxBufDeviceAddress = Dev->RxBufDeviceBase;
@@ -408,6 +420,14 @@ VirtioNetInitRx (
     //
     // virtio-0.9.5, 2.4.1.1 Placing Buffers into the Descriptor Table
     //
+    if (Dev->RxMergeable) {
+      Dev->RxRing.Desc[DescIdx].Addr  = RxBufDeviceAddress;
+      Dev->RxRing.Desc[DescIdx].Len   = (UINT32)RxBufSize;
+      Dev->RxRing.Desc[DescIdx].Flags = VRING_DESC_F_WRITE;
+      RxBufDeviceAddress             += Dev->RxRing.Desc[DescIdx++].Len;
+      continue;
+    }
+
     Dev->RxRing.Desc[DescIdx].Addr  = RxBufDeviceAddress;
     Dev->RxRing.Desc[DescIdx].Len   = (UINT32)VirtioNetReqSize;
     Dev->RxRing.Desc[DescIdx].Flags = VRING_DESC_F_WRITE | VRING_DESC_F_NEXT;
@@ -425,6 +445,7 @@ VirtioNetInitRx (
   //
   MemoryFence ();
   *Dev->RxRing.Avail.Idx = RxAlwaysPending;
+  Dev->RxNextAvail       = RxAlwaysPending;
 
   //
   // At this point reception may already be running. In order to make it sure,
@@ -557,8 +578,14 @@ VirtioNetInitialize (
     !!(Features & VIRTIO_NET_F_STATUS)
     );
 
-  Features &= VIRTIO_NET_F_MAC | VIRTIO_NET_F_STATUS | VIRTIO_F_VERSION_1 |
-              VIRTIO_F_IOMMU_PLATFORM;
+  Features &= VIRTIO_NET_F_MAC | VIRTIO_NET_F_STATUS | VIRTIO_NET_F_MRG_RXBUF |
+              VIRTIO_F_VERSION_1 | VIRTIO_F_IOMMU_PLATFORM;
+
+  //
+  // Mergeable receive buffers let each RX buffer take a single descriptor,
+  // so twice as many packets can be pending in the RX queue.
+  //
+  Dev->RxMergeable = (BOOLEAN)((Features & VIRTIO_NET_F_MRG_RXBUF) != 0);
 
   //
   // In virtio-1.0, feature negotiation is expected to complete before queue
@@ -15,6 +15,70 @@
 
 #include "VirtioNet.h"
 
+/**
+  Return the address of the receive buffer a descriptor points to.
+
+  @param[in] Dev      The VNET_DEV driver instance.
+  @param[in] DescIdx  The index of the descriptor in the RX ring.
+
+  @return  The address of the receive buffer, inside Dev->RxBuf.
+**/
+STATIC
+UINT8 *
+VirtioNetRxBufPtr (
+  IN VNET_DEV  *Dev,
+  IN UINT32    DescIdx
+  )
+{
+  return Dev->RxBuf + (UINTN)(Dev->RxRing.Desc[DescIdx].Addr -
+                              Dev->RxBufDeviceBase);
+}
+
+/**
+  Hand the receive buffers recycled by VirtioNetReceive() back to the device.
+
+  The buffers are only made visible to the device by updating the Index Field
+  of the available ring, and the device is only notified if it asks for it.
+
+  @param[in,out] Dev  The VNET_DEV driver instance.
+
+  @return              Status codes from
+                       VIRTIO_DEVICE_PROTOCOL.SetQueueNotify().
+  @retval EFI_SUCCESS  The recycled buffers are available to the device.
+**/
+STATIC
+EFI_STATUS
+VirtioNetRxRefill (
+  IN OUT VNET_DEV  *Dev
+  )
+{
+  //
+  // the available index is never written by the host, we can read it back
+  // without a barrier
+  //
+  if (*Dev->RxRing.Avail.Idx == Dev->RxNextAvail) {
+    return EFI_SUCCESS;
+  }
+
+  //
+  // virtio-0.9.5, 2.4.1.3 Updating the Index Field
+  //
+  MemoryFence ();
+  *Dev->RxRing.Avail.Idx = Dev->RxNextAvail;
+
+  //
+  // virtio-0.9.5, 2.4.1.4 Notifying the Device -- the host sets
+  // VRING_USED_F_NO_NOTIFY while it doesn't need to be kicked to pick up new
+  // buffers.
+  //
+  MemoryFence ();
+  if ((*Dev->RxRing.Used.Flags & VRING_USED_F_NO_NOTIFY) != 0) {
+    return EFI_SUCCESS;
+  }
+
+  return Dev->VirtIo->SetQueueNotify (Dev->VirtIo, VIRTIO_NET_Q_RX);
+}
+
 /**
   Receives a packet from a network interface.
 
@@ -69,13 +133,15 @@ VirtioNetReceive (
   EFI_STATUS  Status;
   UINT16      RxCurUsed;
   UINT16      UsedElemIdx;
+  UINT16      NumBuffers;
+  UINT16      BufIdx;
   UINT32      DescIdx;
   UINT32      RxLen;
+  UINT32      BufLen;
   UINTN       OrigBufferSize;
   UINT8       *RxPtr;
-  UINT16      AvailIdx;
+  UINT8       *BufPtr;
   EFI_STATUS  NotifyStatus;
-  UINTN       RxBufOffset;
 
   if ((This == NULL) || (BufferSize == NULL) || (Buffer == NULL)) {
     return EFI_INVALID_PARAMETER;
@@ -102,23 +168,57 @@ VirtioNetReceive (
   MemoryFence ();
 
   if (Dev->RxLastUsed == RxCurUsed) {
-    Status = EFI_NOT_READY;
+    //
+    // all the packets have been received, give all the recycled buffers back
+    // to the host
+    //
+    Status = VirtioNetRxRefill (Dev);
+    if (!EFI_ERROR (Status)) {
+      Status = EFI_NOT_READY;
+    }
+
     goto Exit;
   }
 
   UsedElemIdx = Dev->RxLastUsed % Dev->RxRing.QueueSize;
   DescIdx     = Dev->RxRing.Used.UsedElem[UsedElemIdx].Id;
   RxLen       = Dev->RxRing.Used.UsedElem[UsedElemIdx].Len;
+  NumBuffers  = 1;
 
   //
   // the virtio-net request header must be complete; we skip it
   //
-  ASSERT (RxLen >= Dev->RxRing.Desc[DescIdx].Len);
-  RxLen -= Dev->RxRing.Desc[DescIdx].Len;
-  //
-  // the host must not have filled in more data than requested
-  //
-  ASSERT (RxLen <= Dev->RxRing.Desc[DescIdx + 1].Len);
+  ASSERT (RxLen >= Dev->RxHdrSize);
+  RxLen -= (UINT32)Dev->RxHdrSize;
+
+  if (Dev->RxMergeable) {
+    //
+    // The packet may span several buffers, the first of which starts with the
+    // virtio-net request header, that tells their number. The host places all
+    // of them on the Used Ring at once.
+    //
+    NumBuffers = ((VIRTIO_1_0_NET_REQ *)VirtioNetRxBufPtr (Dev, DescIdx))->NumBuffers;
+    if (NumBuffers == 0) {
+      NumBuffers = 1;
+      Status     = EFI_DEVICE_ERROR;
+      goto RecycleDesc; // drop malformed packet
+    }
+
+    if (NumBuffers > (UINT16)(RxCurUsed - Dev->RxLastUsed)) {
+      Status = EFI_NOT_READY;
+      goto Exit;
+    }
+
+    for (BufIdx = 1; BufIdx < NumBuffers; ++BufIdx) {
+      UsedElemIdx = (UINT16)(Dev->RxLastUsed + BufIdx) % Dev->RxRing.QueueSize;
+      RxLen      += Dev->RxRing.Used.UsedElem[UsedElemIdx].Len;
+    }
+  } else {
+    //
+    // the host must not have filled in more data than requested
+    //
+    ASSERT (RxLen <= Dev->RxRing.Desc[DescIdx + 1].Len);
+  }
 
   OrigBufferSize = *BufferSize;
   *BufferSize    = RxLen;
@@ -137,10 +237,26 @@ VirtioNetReceive (
     *HeaderSize = Dev->Snm.MediaHeaderSize;
   }
 
-  RxBufOffset = (UINTN)(Dev->RxRing.Desc[DescIdx + 1].Addr -
-                        Dev->RxBufDeviceBase);
-  RxPtr = Dev->RxBuf + RxBufOffset;
-  CopyMem (Buffer, RxPtr, RxLen);
+  //
+  // Copy the packet data out of each buffer. Without mergeable receive
+  // buffers, the packet data sub-slice immediately follows the virtio-net
+  // request header sub-slice too.
+  //
+  BufPtr = Buffer;
+  for (BufIdx = 0; BufIdx < NumBuffers; ++BufIdx) {
+    UsedElemIdx = (UINT16)(Dev->RxLastUsed + BufIdx) % Dev->RxRing.QueueSize;
+    RxPtr       = VirtioNetRxBufPtr (Dev, Dev->RxRing.Used.UsedElem[UsedElemIdx].Id);
+    BufLen      = Dev->RxRing.Used.UsedElem[UsedElemIdx].Len;
+    if (BufIdx == 0) {
+      RxPtr  += Dev->RxHdrSize;
+      BufLen -= (UINT32)Dev->RxHdrSize;
+    }
+
+    CopyMem (BufPtr, RxPtr, BufLen);
+    BufPtr += BufLen;
+  }
+
+  RxPtr = Buffer;
 
   if (DestAddr != NULL) {
     CopyMem (DestAddr, RxPtr, SIZE_OF_VNET (Mac));
@@ -163,23 +279,25 @@ VirtioNetReceive (
   Status = EFI_SUCCESS;
 
 RecycleDesc:
-  ++Dev->RxLastUsed;
-
   //
   // virtio-0.9.5, 2.4.1 Supplying Buffers to The Device
+  // invisible to the host until VirtioNetRxRefill() updates the Index Field
   //
-  AvailIdx                                                   = *Dev->RxRing.Avail.Idx;
-  Dev->RxRing.Avail.Ring[AvailIdx++ % Dev->RxRing.QueueSize] =
-    (UINT16)DescIdx;
-
-  MemoryFence ();
-  *Dev->RxRing.Avail.Idx = AvailIdx;
+  for (BufIdx = 0; BufIdx < NumBuffers; ++BufIdx) {
+    UsedElemIdx = Dev->RxLastUsed++ % Dev->RxRing.QueueSize;
+    Dev->RxRing.Avail.Ring[Dev->RxNextAvail++ % Dev->RxRing.QueueSize] =
+      (UINT16)Dev->RxRing.Used.UsedElem[UsedElemIdx].Id;
+  }
 
-  MemoryFence ();
-  NotifyStatus = Dev->VirtIo->SetQueueNotify (Dev->VirtIo, VIRTIO_NET_Q_RX);
-  if (!EFI_ERROR (Status)) {
-    // earlier error takes precedence
-    Status = NotifyStatus;
+  //
+  // give the recycled buffers back to the host in batches
+  //
+  if ((UINT16)(Dev->RxNextAvail - *Dev->RxRing.Avail.Idx) >= VNET_RX_REFILL_BATCH) {
+    NotifyStatus = VirtioNetRxRefill (Dev);
+    if (!EFI_ERROR (Status)) {
+      // earlier error takes precedence
+      Status = NotifyStatus;
+    }
   }
 
 Exit:
@@ -173,7 +173,17 @@ VirtioNetTransmit (
   MemoryFence ();
   *Dev->TxRing.Avail.Idx = AvailIdx;
 
+  //
+  // virtio-0.9.5, 2.4.1.4 Notifying the Device -- the host sets
+  // VRING_USED_F_NO_NOTIFY while it is still processing the queue, and will
+  // pick up this packet without a kick.
+  //
   MemoryFence ();
+  if ((*Dev->TxRing.Used.Flags & VRING_USED_F_NO_NOTIFY) != 0) {
+    Status = EFI_SUCCESS;
+    goto Exit;
+  }
+
   Status = Dev->VirtIo->SetQueueNotify (Dev->VirtIo, VIRTIO_NET_Q_TX);
 
 Exit:
@@ -27,7 +27,13 @@
 //
 // maximum number of pending packets, separately for each direction
 //
-#define VNET_MAX_PENDING  64
+#define VNET_MAX_PENDING  256
+
+//
+// number of receive buffers recycled by VirtioNetReceive() before they are
+// handed back to the device together
+//
+#define VNET_RX_REFILL_BATCH  16
 
 //
 // State diagram:
@@ -80,8 +86,11 @@ typedef struct {
   VRING                          RxRing;          // VirtioNetInitRing
   VOID                           *RxRingMap;      // VirtioRingMap and
                                                   // VirtioNetInitRing
+  BOOLEAN                        RxMergeable;     // VirtioNetInitialize
+  UINTN                          RxHdrSize;       // VirtioNetInitRx
   UINT8                          *RxBuf;          // VirtioNetInitRx
   UINT16                         RxLastUsed;      // VirtioNetInitRx
+  UINT16                         RxNextAvail;     // VirtioNetInitRx
   UINTN                          RxBufNrPages;    // VirtioNetInitRx
   EFI_PHYSICAL_ADDRESS           RxBufDeviceBase; // VirtioNetInitRx
   VOID                           *RxBufMap;       // VirtioNetInitRx
@@ -284,7 +284,8 @@ VirtioRngInit (
     goto Failed;
   }
 
-  Features &= VIRTIO_F_VERSION_1 | VIRTIO_F_IOMMU_PLATFORM;
+  Features &= VIRTIO_F_VERSION_1 | VIRTIO_F_IOMMU_PLATFORM |
+              VIRTIO_F_RING_PACKED | VIRTIO_F_RING_EVENT_IDX;
 
   //
   // In virtio-1.0, feature negotiation is expected to complete before queue
@@ -318,7 +319,7 @@ VirtioRngInit (
     goto Failed;
   }
 
-  Status = VirtioRingInit (Dev->VirtIo, QueueSize, &Dev->Ring);
+  Status = VirtioRingInitEx (Dev->VirtIo, QueueSize, Features, &Dev->Ring);
   if (EFI_ERROR (Status)) {
     goto Failed;
   }
@@ -30,7 +30,7 @@ typedef struct {
   UINT32                    Signature;      // DriverBindingStart   0
   VIRTIO_DEVICE_PROTOCOL    *VirtIo;        // DriverBindingStart   0
   EFI_EVENT                 ExitBoot;       // DriverBindingStart   0
-  VRING                     Ring;           // VirtioRingInit       2
+  VRING                     Ring;           // VirtioRingInitEx     2
   EFI_RNG_PROTOCOL          Rng;            // VirtioRngInit        1
   VOID                      *RingMap;       // VirtioRingMap        2
   BOOLEAN                   Ready;
@@ -49,7 +49,7 @@ typedef struct {
   UINT16                             MaxTarget;      // VirtioScsiInit      1
   UINT32                             MaxLun;         // VirtioScsiInit      1
   UINT32                             MaxSectors;     // VirtioScsiInit      1
-  VRING                              Ring;           // VirtioRingInit      2
+  VRING                              Ring;           // VirtioRingInitEx    2
   EFI_EXT_SCSI_PASS_THRU_PROTOCOL    PassThru;       // VirtioScsiInit      1
   EFI_EXT_SCSI_PASS_THRU_MODE        PassThruMode;   // VirtioScsiInit      1
   VOID                               *RingMap;       // VirtioRingMap       2
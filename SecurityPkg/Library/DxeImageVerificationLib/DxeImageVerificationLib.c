@@ -36,6 +36,13 @@ UINT8  *mImageBase = NULL;
 UINT8  mImageDigest[MAX_DIGEST_SIZE];
 UINTN  mImageDigestSize;
 
+//
+// Authenticode digests of current image, indexed by hash algorithm type, and
+// the mask of the algorithms computed so far
+//
+UINT8   mImageDigestCache[HASHALG_MAX][MAX_DIGEST_SIZE];
+UINT32  mImageDigestCached;
+
 //
 // Notify string for authorization UI.
 //
@@ -272,9 +279,59 @@ GetImageType (
 }
 
 /**
-  Calculate hash of Pe/Coff image based on the authenticode image hashing in
+  Feed a range of the PE/COFF image to the hash contexts of several algorithms.
+
+  The range is fed in chunks small enough to stay in the data cache, so that the
+  image is read from memory once however many algorithms are computed.
+
+  @param[in]    HashCtx       Hash contexts, indexed by hash algorithm type.
+  @param[in]    HashAlgMask   Hash algorithms to update, one bit per algorithm type.
+  @param[in]    HashBase      Start of the range.
+  @param[in]    HashSize      Size of the range in bytes.
+
+  @retval TRUE            All the hash contexts were updated.
+  @retval FALSE           Fail in updating a hash context.
+
+**/
+STATIC
+BOOLEAN
+HashPeImageUpdate (
+  IN VOID    **HashCtx,
+  IN UINT32  HashAlgMask,
+  IN UINT8   *HashBase,
+  IN UINTN   HashSize
+  )
+{
+  UINTN   ChunkSize;
+  UINT32  HashAlg;
+
+  while (HashSize != 0) {
+    ChunkSize = MIN (HashSize, HASH_CHUNK_SIZE);
+    for (HashAlg = 0; HashAlg < HASHALG_MAX; HashAlg++) {
+      if ((HashAlgMask & HASHALG_BIT (HashAlg)) == 0) {
+        continue;
+      }
+
+      if (!mHash[HashAlg].HashUpdate (HashCtx[HashAlg], HashBase, ChunkSize)) {
+        return FALSE;
+      }
+    }
+
+    HashBase += ChunkSize;
+    HashSize -= ChunkSize;
+  }
+
+  return TRUE;
+}
+
+/**
+  Calculate hashes of Pe/Coff image based on the authenticode image hashing in
   PE/COFF Specification 8.0 Appendix A
 
+  All the requested algorithms are computed in a single pass over the image, and
+  the digests are kept in mImageDigestCache[] until the next image is verified.
+  Algorithms already computed for the current image are not computed again.
+
   Caution: This function may receive untrusted input.
   PE/COFF image is external input, so this function will validate its data structure
   within this image buffer before use.
@@ -282,21 +339,21 @@ GetImageType (
   Notes: PE/COFF image has been checked by BasePeCoffLib PeCoffLoaderGetImageInfo() in
   its caller function DxeImageVerificationHandler().
 
-  @param[in]    HashAlg   Hash algorithm type.
+  @param[in]    HashAlgMask   Hash algorithm types, one bit per algorithm type.
 
   @retval TRUE            Successfully hash image.
   @retval FALSE           Fail in hash image.
 
 **/
 BOOLEAN
-HashPeImage (
-  IN  UINT32  HashAlg
+HashPeImageDigests (
+  IN  UINT32  HashAlgMask
   )
 {
   BOOLEAN                   Status;
   EFI_IMAGE_SECTION_HEADER  *Section;
-  VOID                      *HashCtx;
-  UINTN                     CtxSize;
+  VOID                      *HashCtx[HASHALG_MAX];
+  UINT32                    HashAlg;
   UINT8                     *HashBase;
   UINTN                     HashSize;
   UINTN                     SumOfBytesHashed;
@@ -306,61 +363,42 @@ HashPeImage (
   UINT32                    CertSize;
   UINT32                    NumberOfRvaAndSizes;
 
-  HashCtx       = NULL;
+  ZeroMem (HashCtx, sizeof (HashCtx));
   SectionHeader = NULL;
   Status        = FALSE;
 
-  if ((HashAlg >= HASHALG_MAX)) {
-    return FALSE;
-  }
-
-  //
-  // Initialize context of hash.
-  //
-  ZeroMem (mImageDigest, MAX_DIGEST_SIZE);
-
-  switch (HashAlg) {
- #ifndef DISABLE_SHA1_DEPRECATED_INTERFACES
-    case HASHALG_SHA1:
-      mImageDigestSize = SHA1_DIGEST_SIZE;
-      mCertType        = gEfiCertSha1Guid;
-      break;
- #endif
-
-    case HASHALG_SHA256:
-      mImageDigestSize = SHA256_DIGEST_SIZE;
-      mCertType        = gEfiCertSha256Guid;
-      break;
-
-    case HASHALG_SHA384:
-      mImageDigestSize = SHA384_DIGEST_SIZE;
-      mCertType        = gEfiCertSha384Guid;
-      break;
-
-    case HASHALG_SHA512:
-      mImageDigestSize = SHA512_DIGEST_SIZE;
-      mCertType        = gEfiCertSha512Guid;
-      break;
-
-    default:
-      return FALSE;
+  HashAlgMask &= ~mImageDigestCached;
+  if (HashAlgMask == 0) {
+    return TRUE;
   }
 
-  mHashTypeStr = mHash[HashAlg].Name;
-  CtxSize      = mHash[HashAlg].GetContextSize ();
-
-  HashCtx = AllocatePool (CtxSize);
-  if (HashCtx == NULL) {
+  if ((HashAlgMask & ~(HASHALG_BIT (HASHALG_MAX) - 1)) != 0) {
     return FALSE;
   }
 
   // 1.  Load the image header into memory.
 
-  // 2.  Initialize a SHA hash context.
-  Status = mHash[HashAlg].HashInit (HashCtx);
+  // 2.  Initialize a SHA hash context for each algorithm.
+  for (HashAlg = 0; HashAlg < HASHALG_MAX; HashAlg++) {
+    if ((HashAlgMask & HASHALG_BIT (HashAlg)) == 0) {
+      continue;
+    }
 
-  if (!Status) {
-    goto Done;
+    if ((mHash[HashAlg].GetContextSize == NULL) || (mHash[HashAlg].HashInit == NULL) ||
+        (mHash[HashAlg].HashUpdate == NULL) || (mHash[HashAlg].HashFinal == NULL))
+    {
+      goto Done;
+    }
+
+    HashCtx[HashAlg] = AllocatePool (mHash[HashAlg].GetContextSize ());
+    if (HashCtx[HashAlg] == NULL) {
+      goto Done;
+    }
+
+    Status = mHash[HashAlg].HashInit (HashCtx[HashAlg]);
+    if (!Status) {
+      goto Done;
+    }
   }
 
   //
@@ -393,7 +431,7 @@ HashPeImage (
     goto Done;
   }
 
-  Status = mHash[HashAlg].HashUpdate (HashCtx, HashBase, HashSize);
+  Status = HashPeImageUpdate (HashCtx, HashAlgMask, HashBase, HashSize);
   if (!Status) {
     goto Done;
   }
@@ -421,7 +459,7 @@ HashPeImage (
     }
 
     if (HashSize != 0) {
-      Status = mHash[HashAlg].HashUpdate (HashCtx, HashBase, HashSize);
+      Status = HashPeImageUpdate (HashCtx, HashAlgMask, HashBase, HashSize);
       if (!Status) {
         goto Done;
       }
@@ -445,7 +483,7 @@ HashPeImage (
     }
 
     if (HashSize != 0) {
-      Status = mHash[HashAlg].HashUpdate (HashCtx, HashBase, HashSize);
+      Status = HashPeImageUpdate (HashCtx, HashAlgMask, HashBase, HashSize);
       if (!Status) {
         goto Done;
       }
@@ -470,7 +508,7 @@ HashPeImage (
     }
 
     if (HashSize != 0) {
-      Status = mHash[HashAlg].HashUpdate (HashCtx, HashBase, HashSize);
+      Status = HashPeImageUpdate (HashCtx, HashAlgMask, HashBase, HashSize);
       if (!Status) {
         goto Done;
       }
@@ -545,7 +583,7 @@ HashPeImage (
     HashBase = mImageBase + Section->PointerToRawData;
     HashSize = (UINTN)Section->SizeOfRawData;
 
-    Status = mHash[HashAlg].HashUpdate (HashCtx, HashBase, HashSize);
+    Status = HashPeImageUpdate (HashCtx, HashAlgMask, HashBase, HashSize);
     if (!Status) {
       goto Done;
     }
@@ -581,7 +619,7 @@ HashPeImage (
     if (mImageSize > CertSize + SumOfBytesHashed) {
       HashSize = (UINTN)(mImageSize - CertSize - SumOfBytesHashed);
 
-      Status = mHash[HashAlg].HashUpdate (HashCtx, HashBase, HashSize);
+      Status = HashPeImageUpdate (HashCtx, HashAlgMask, HashBase, HashSize);
       if (!Status) {
         goto Done;
       }
@@ -591,11 +629,27 @@ HashPeImage (
     }
   }
 
-  Status = mHash[HashAlg].HashFinal (HashCtx, mImageDigest);
+  //
+  // 17.  Finalize the SHA hash contexts.
+  //
+  for (HashAlg = 0; HashAlg < HASHALG_MAX; HashAlg++) {
+    if ((HashAlgMask & HASHALG_BIT (HashAlg)) == 0) {
+      continue;
+    }
+
+    Status = mHash[HashAlg].HashFinal (HashCtx[HashAlg], mImageDigestCache[HashAlg]);
+    if (!Status) {
+      goto Done;
+    }
+  }
+
+  mImageDigestCached |= HashAlgMask;
 
 Done:
-  if (HashCtx != NULL) {
-    FreePool (HashCtx);
+  for (HashAlg = 0; HashAlg < HASHALG_MAX; HashAlg++) {
+    if (HashCtx[HashAlg] != NULL) {
+      FreePool (HashCtx[HashAlg]);
+    }
   }
 
   if (SectionHeader != NULL) {
@@ -605,6 +659,74 @@ Done:
   return Status;
 }
 
+/**
+  Calculate hash of Pe/Coff image based on the authenticode image hashing in
+  PE/COFF Specification 8.0 Appendix A
+
+  The digest is taken from mImageDigestCache[] if it was already computed for
+  the current image.
+
+  Caution: This function may receive untrusted input.
+  PE/COFF image is external input, so this function will validate its data structure
+  within this image buffer before use.
+
+  Notes: PE/COFF image has been checked by BasePeCoffLib PeCoffLoaderGetImageInfo() in
+  its caller function DxeImageVerificationHandler().
+
+  @param[in]    HashAlg   Hash algorithm type.
+
+  @retval TRUE            Successfully hash image.
+  @retval FALSE           Fail in hash image.
+
+**/
+BOOLEAN
+HashPeImage (
+  IN  UINT32  HashAlg
+  )
+{
+  if ((HashAlg >= HASHALG_MAX)) {
+    return FALSE;
+  }
+
+  ZeroMem (mImageDigest, MAX_DIGEST_SIZE);
+
+  switch (HashAlg) {
+ #ifndef DISABLE_SHA1_DEPRECATED_INTERFACES
+    case HASHALG_SHA1:
+      mImageDigestSize = SHA1_DIGEST_SIZE;
+      mCertType        = gEfiCertSha1Guid;
+      break;
+ #endif
+
+    case HASHALG_SHA256:
+      mImageDigestSize = SHA256_DIGEST_SIZE;
+      mCertType        = gEfiCertSha256Guid;
+      break;
+
+    case HASHALG_SHA384:
+      mImageDigestSize = SHA384_DIGEST_SIZE;
+      mCertType        = gEfiCertSha384Guid;
+      break;
+
+    case HASHALG_SHA512:
+      mImageDigestSize = SHA512_DIGEST_SIZE;
+      mCertType        = gEfiCertSha512Guid;
+      break;
+
+    default:
+      return FALSE;
+  }
+
+  mHashTypeStr = mHash[HashAlg].Name;
+
+  if (!HashPeImageDigests (HASHALG_BIT (HashAlg))) {
+    return FALSE;
+  }
+
+  CopyMem (mImageDigest, mImageDigestCache[HashAlg], mImageDigestSize);
+  return TRUE;
+}
+
 /**
   Recognize the Hash algorithm in PE/COFF Authenticode and calculate hash of
   Pe/Coff image based on the authenticode image hashing in PE/COFF Specification
@@ -1692,6 +1814,7 @@ DxeImageVerificationHandler (
   UINT32                        VarAttr;
   BOOLEAN                       IsFound;
   UINT8                         HashAlg;
+  UINT32                        HashAlgMask;
   BOOLEAN                       IsFoundInDatabase;
 
   SignatureList     = NULL;
@@ -1783,8 +1906,9 @@ DxeImageVerificationHandler (
     return EFI_ACCESS_DENIED;
   }
 
-  mImageBase = (UINT8 *)FileBuffer;
-  mImageSize = FileSize;
+  mImageBase         = (UINT8 *)FileBuffer;
+  mImageSize         = FileSize;
+  mImageDigestCached = 0;
 
   ZeroMem (&ImageContext, sizeof (ImageContext));
   ImageContext.Handle    = (VOID *)FileBuffer;
@@ -1851,6 +1975,18 @@ DxeImageVerificationHandler (
     // This image is not signed. The hash value of the image must match a record in the security database "db",
     // and not be reflected in the security data base "dbx".
     //
+    // Compute the digests of all the supported algorithms in one pass over the
+    // image. An algorithm that fails here is retried on its own by HashPeImage().
+    //
+    HashAlgMask = 0;
+    for (HashAlg = 0; HashAlg < HASHALG_MAX; HashAlg++) {
+      if ((mHash[HashAlg].GetContextSize != NULL) && (mHash[HashAlg].HashInit != NULL) && (mHash[HashAlg].HashUpdate != NULL) && (mHash[HashAlg].HashFinal != NULL)) {
+        HashAlgMask |= HASHALG_BIT (HashAlg);
+      }
+    }
+
+    HashPeImageDigests (HashAlgMask);
+
     HashAlg = sizeof (mHash) / sizeof (HASH_TABLE);
     while (HashAlg > 0) {
       HashAlg--;
@@ -69,6 +69,14 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define HASHALG_SHA512  0x00000004
 #define HASHALG_MAX     0x00000005
 
+#define HASHALG_BIT(HashAlg)  ((UINT32)1 << (HashAlg))
+
+//
+// Size of the chunks of the image fed in turn to each hash algorithm, so that
+// a chunk is still in the data cache when the next algorithm reads it
+//
+#define HASH_CHUNK_SIZE  SIZE_16KB
+
 //
 // Set max digest size as SHA512 Output (64 bytes) by far
 //
@@ -85,6 +85,8 @@ STATIC CONST SHELL_PARAM_ITEM  ParamList[] = {
   { L"-c", TypeValue }, // -c   Display cumulative data.
   { L"-n", TypeValue }, // -n # Number of records to display for A and R
   { L"-t", TypeValue }, // -t # Threshold of interest
+  { L"-l", TypeFlag  }, // -l   Boot service Latency
+  { L"-w", TypeFlag  }, // -w   Timer Wheel statistics
   { NULL,  TypeMax   }
 };
 
@@ -683,6 +685,8 @@ RunDp (
   BOOLEAN        RawMode;
   BOOLEAN        ExcludeMode;
   BOOLEAN        CumulativeMode;
+  BOOLEAN        LatencyMode;
+  BOOLEAN        TimerWheelMode;
   CONST CHAR16   *CustomCumulativeToken;
   PERF_CUM_DATA  *CustomCumulativeData;
   UINTN          NameSize;
@@ -697,6 +701,8 @@ RunDp (
   RawMode              = FALSE;
   ExcludeMode          = FALSE;
   CumulativeMode       = FALSE;
+  LatencyMode          = FALSE;
+  TimerWheelMode       = FALSE;
   CustomCumulativeData = NULL;
   ShellStatus          = SHELL_SUCCESS;
 
@@ -728,6 +734,8 @@ RunDp (
   ExcludeMode    = ShellCommandLineGetFlag (ParamPackage, L"-x");
   mShowId        = ShellCommandLineGetFlag (ParamPackage, L"-i");
   CumulativeMode = ShellCommandLineGetFlag (ParamPackage, L"-c");
+  LatencyMode    = ShellCommandLineGetFlag (ParamPackage, L"-l");
+  TimerWheelMode = ShellCommandLineGetFlag (ParamPackage, L"-w");
 
   if (AllMode && RawMode) {
     ShellPrintHiiDefaultEx (STRING_TOKEN (STR_DP_CONFLICT_ARG), mDpHiiHandle, L"-A", L"-R");
@@ -741,7 +749,7 @@ RunDp (
       ShellPrintHiiDefaultEx (STRING_TOKEN (STR_DP_TOO_FEW), mDpHiiHandle);
       return SHELL_INVALID_PARAMETER;
     } else {
-      if (!(RawMode || AllMode)) {
+      if (!(RawMode || AllMode || LatencyMode)) {
         ShellPrintHiiDefaultEx (STRING_TOKEN (STR_DP_NO_RAW_ALL), mDpHiiHandle);
         return SHELL_INVALID_PARAMETER;
       }
@@ -776,6 +784,8 @@ RunDp (
         mInterestThreshold = Intermediate;
       }
     }
+  } else if (LatencyMode) {
+    mInterestThreshold = 0;
   } else {
     mInterestThreshold = DEFAULT_THRESHOLD;  // 1ms := 1,000 us
   }
@@ -807,6 +817,34 @@ RunDp (
     }
   }
 
+  //
+  // The boot service latency is recorded by the DXE Core, independently of FPDT.
+  //
+  if (LatencyMode) {
+    Status = ProcessBootServiceTrace (Number2Display, VerboseMode);
+    if (Status == EFI_ABORTED) {
+      ShellStatus = SHELL_ABORTED;
+    } else if (Status == EFI_NOT_FOUND) {
+      ShellStatus = SHELL_NOT_FOUND;
+    } else if (EFI_ERROR (Status)) {
+      ShellStatus = SHELL_OUT_OF_RESOURCES;
+    }
+
+    goto Done;
+  }
+
+  //
+  // The timer wheel statistics are also published by the DXE Core.
+  //
+  if (TimerWheelMode) {
+    Status = ProcessTimerWheelStatistics ();
+    if (Status == EFI_NOT_FOUND) {
+      ShellStatus = SHELL_NOT_FOUND;
+    }
+
+    goto Done;
+  }
+
   //
   // DP dump performance data by parsing FPDT table in ACPI table.
   // Folloing 3 steps are to get the measurement form the FPDT table.
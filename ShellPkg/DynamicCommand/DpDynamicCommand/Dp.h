@@ -14,6 +14,8 @@
 #include <Guid/Performance.h>
 #include <Guid/ExtendedFirmwarePerformance.h>
 #include <Guid/FirmwarePerformance.h>
+#include <Guid/BootServiceTrace.h>
+#include <Guid/TimerWheelStatistics.h>
 
 #include <Protocol/HiiPackageList.h>
 #include <Protocol/DevicePath.h>
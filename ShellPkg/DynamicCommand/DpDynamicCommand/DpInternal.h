@@ -312,4 +312,36 @@ ProcessCumulative (
   IN PERF_CUM_DATA  *CustomCumulativeData OPTIONAL
   );
 
+/**
+  Gather and print the boot service latency recorded by the DXE Core.
+
+  For each image and boot service, print the number of calls and their total,
+  average and longest durations. In verbose mode, also print the histogram of
+  the durations and the slowest calls still held in the ring of the trace.
+
+  @param[in]    Limit         The number of slowest calls to display.
+  @param[in]    VerboseFlag   Print the histograms and the slowest calls.
+
+  @retval EFI_SUCCESS           The operation was successful.
+  @retval EFI_NOT_FOUND         The DXE Core did not trace the boot services.
+  @retval EFI_ABORTED           The user aborts the operation.
+  @retval EFI_OUT_OF_RESOURCES  Memory could not be allocated.
+**/
+EFI_STATUS
+ProcessBootServiceTrace (
+  IN UINTN    Limit,
+  IN BOOLEAN  VerboseFlag
+  );
+
+/**
+  Print the statistics of the timer event wheel of the DXE Core.
+
+  @retval EFI_SUCCESS           The operation was successful.
+  @retval EFI_NOT_FOUND         The DXE Core did not publish the statistics.
+**/
+EFI_STATUS
+ProcessTimerWheelStatistics (
+  VOID
+  );
+
 #endif
@@ -991,3 +991,413 @@ ProcessCumulative (
       );
   }
 }
+
+//
+// Names of the boot services, in BOOT_SERVICE_TRACE_* order.
+//
+STATIC CONST CHAR16  *CONST  mBootServiceNames[] = {
+  L"AllocatePages",
+  L"FreePages",
+  L"GetMemoryMap",
+  L"AllocatePool",
+  L"FreePool",
+  L"CreateEvent",
+  L"SetTimer",
+  L"WaitForEvent",
+  L"SignalEvent",
+  L"CloseEvent",
+  L"CheckEvent",
+  L"InstallProtocolInterface",
+  L"ReinstallProtocolInterface",
+  L"UninstallProtocolInterface",
+  L"HandleProtocol",
+  L"RegisterProtocolNotify",
+  L"LocateHandle",
+  L"LocateDevicePath",
+  L"Stall",
+  L"ConnectController",
+  L"DisconnectController",
+  L"OpenProtocol",
+  L"CloseProtocol",
+  L"OpenProtocolInformation",
+  L"ProtocolsPerHandle",
+  L"LocateHandleBuffer",
+  L"LocateProtocol",
+  L"CreateEventEx"
+};
+
+/**
+  Convert a number of performance counter ticks of the boot service trace to
+  microseconds.
+
+  @param[in]  Ticks       The number of ticks.
+  @param[in]  Frequency   The frequency of the counter in Hz.
+
+  @return The number of microseconds.
+**/
+STATIC
+UINT64
+TraceTicksInMicroSeconds (
+  IN UINT64  Ticks,
+  IN UINT64  Frequency
+  )
+{
+  return DivU64x64Remainder (MultU64x32 (Ticks, 1000000), Frequency, NULL);
+}
+
+/**
+  Get the name of an image of the boot service trace.
+
+  The name of the driver is used while the image is still loaded, otherwise the
+  name of its FFS file.
+
+  @param[in]  TraceImage    The image.
+  @param[in]  UnknownName   The name to use for the callers outside any image.
+
+  @post   The resulting Unicode name string is stored in the
+          mGaugeString global array.
+**/
+STATIC
+VOID
+GetTraceImageName (
+  IN CONST BOOT_SERVICE_TRACE_IMAGE  *TraceImage,
+  IN CONST CHAR16                    *UnknownName
+  )
+{
+  EFI_STATUS                 Status;
+  EFI_HANDLE                 Handle;
+  EFI_LOADED_IMAGE_PROTOCOL  *LoadedImage;
+
+  if (TraceImage->ImageBase == 0) {
+    StrnCpyS (mGaugeString, ARRAY_SIZE (mGaugeString), UnknownName, DP_GAUGE_STRING_LENGTH);
+    return;
+  }
+
+  //
+  // The handle of an unloaded image may have been reused by another image.
+  //
+  Handle = (EFI_HANDLE)(UINTN)TraceImage->Handle;
+  Status = gBS->HandleProtocol (Handle, &gEfiLoadedImageProtocolGuid, (VOID **)&LoadedImage);
+  if (!EFI_ERROR (Status) && ((UINTN)LoadedImage->ImageBase == TraceImage->ImageBase)) {
+    DpGetNameFromHandle (Handle);
+  } else {
+    UnicodeSPrint (mGaugeString, sizeof (mGaugeString), L"%g", &TraceImage->FileName);
+  }
+
+  mGaugeString[DP_GAUGE_STRING_LENGTH] = 0;
+}
+
+/**
+  Print the latency histogram of the calls made by one image to one service.
+
+  @param[in]  Stats         The statistics of the calls.
+  @param[in]  BucketCount   The number of buckets of the histogram.
+**/
+STATIC
+VOID
+PrintTraceHistogram (
+  IN CONST BOOT_SERVICE_TRACE_STATS  *Stats,
+  IN UINTN                           BucketCount
+  )
+{
+  CHAR16  Line[BOOT_SERVICE_TRACE_BUCKET_COUNT * 24];
+  UINTN   Length;
+  UINTN   Bucket;
+  UINT64  Limit;
+
+  Line[0] = 0;
+  Length  = 0;
+  for (Bucket = 0; Bucket < BucketCount; Bucket++) {
+    if (Stats->Histogram[Bucket] == 0) {
+      continue;
+    }
+
+    if (Bucket < BucketCount - 1) {
+      Limit   = LShiftU64 (1, Bucket + BOOT_SERVICE_TRACE_BUCKET_SHIFT);
+      Length += UnicodeSPrint (&Line[Length], sizeof (Line) - Length * sizeof (CHAR16), L" <%Ld:%d", Limit, Stats->Histogram[Bucket]);
+    } else {
+      Limit   = LShiftU64 (1, Bucket - 1 + BOOT_SERVICE_TRACE_BUCKET_SHIFT);
+      Length += UnicodeSPrint (&Line[Length], sizeof (Line) - Length * sizeof (CHAR16), L" >=%Ld:%d", Limit, Stats->Histogram[Bucket]);
+    }
+  }
+
+  ShellPrintHiiDefaultEx (STRING_TOKEN (STR_DP_TRACE_HISTOGRAM), mDpHiiHandle, Line);
+}
+
+/**
+  Print the slowest boot service calls found in the ring of the trace.
+
+  @param[in]  Table         The boot service trace table.
+  @param[in]  Limit         The maximum number of calls to display.
+  @param[in]  UnknownName   The name to use for the callers outside any image.
+
+  @retval EFI_SUCCESS           The operation was successful.
+  @retval EFI_ABORTED           The user aborts the operation.
+  @retval EFI_OUT_OF_RESOURCES  Memory could not be allocated.
+**/
+STATIC
+EFI_STATUS
+ProcessSlowestServiceCalls (
+  IN CONST EDKII_BOOT_SERVICE_TRACE_TABLE  *Table,
+  IN UINTN                                 Limit,
+  IN CONST CHAR16                          *UnknownName
+  )
+{
+  CONST BOOT_SERVICE_TRACE_IMAGE   *Images;
+  CONST BOOT_SERVICE_TRACE_RECORD  *Ring;
+  CONST BOOT_SERVICE_TRACE_RECORD  *Record;
+  CONST BOOT_SERVICE_TRACE_RECORD  **Slowest;
+  UINTN                            RecordCount;
+  UINTN                            SlowestCount;
+  UINTN                            Index;
+  UINTN                            Position;
+  EFI_STRING                       StringPtr;
+
+  Images      = (CONST BOOT_SERVICE_TRACE_IMAGE *)(UINTN)Table->Images;
+  Ring        = (CONST BOOT_SERVICE_TRACE_RECORD *)(UINTN)Table->Ring;
+  RecordCount = (Table->RingCount < Table->RingSize) ? (UINTN)Table->RingCount : Table->RingSize;
+  if ((RecordCount == 0) || (Limit == 0)) {
+    return EFI_SUCCESS;
+  }
+
+  Slowest = AllocatePool (MIN (Limit, RecordCount) * sizeof (*Slowest));
+  if (Slowest == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  //
+  // Keep the slowest calls sorted by decreasing time.
+  //
+  SlowestCount = 0;
+  for (Index = 0; Index < RecordCount; Index++) {
+    Record = &Ring[Index];
+    if ((SlowestCount == Limit) && (Record->Ticks <= Slowest[SlowestCount - 1]->Ticks)) {
+      continue;
+    }
+
+    if (SlowestCount < Limit) {
+      SlowestCount++;
+    }
+
+    for (Position = SlowestCount - 1; Position > 0; Position--) {
+      if (Slowest[Position - 1]->Ticks >= Record->Ticks) {
+        break;
+      }
+
+      Slowest[Position] = Slowest[Position - 1];
+    }
+
+    Slowest[Position] = Record;
+  }
+
+  StringPtr = HiiGetString (mDpHiiHandle, STRING_TOKEN (STR_DP_SECTION_SLOWEST_CALLS), NULL);
+  ShellPrintHiiDefaultEx (
+    STRING_TOKEN (STR_DP_SECTION_HEADER),
+    mDpHiiHandle,
+    (StringPtr == NULL) ? UnknownName : StringPtr
+    );
+  SHELL_FREE_NON_NULL (StringPtr);
+
+  ShellPrintHiiDefaultEx (STRING_TOKEN (STR_DP_TRACE_CALL_HEADR), mDpHiiHandle);
+  ShellPrintHiiDefaultEx (STRING_TOKEN (STR_DP_RAW_DASHES), mDpHiiHandle);
+
+  for (Index = 0; Index < SlowestCount; Index++) {
+    Record = Slowest[Index];
+    if ((Record->ImageIndex >= Table->ImageCount) || (Record->Service >= ARRAY_SIZE (mBootServiceNames))) {
+      continue;
+    }
+
+    GetTraceImageName (&Images[Record->ImageIndex], UnknownName);
+    ShellPrintHiiDefaultEx (
+      STRING_TOKEN (STR_DP_TRACE_CALL_VARS),
+      mDpHiiHandle,
+      Index + 1,
+      mGaugeString,
+      mBootServiceNames[Record->Service],
+      Record->StartTicks,
+      TraceTicksInMicroSeconds (Record->Ticks, Table->Frequency)
+      );
+
+    if (ShellGetExecutionBreakFlag ()) {
+      FreePool (Slowest);
+      return EFI_ABORTED;
+    }
+  }
+
+  FreePool (Slowest);
+  return EFI_SUCCESS;
+}
+
+/**
+  Gather and print the boot service latency recorded by the DXE Core.
+
+  For each image and boot service, print the number of calls and their total,
+  average and longest durations. In verbose mode, also print the histogram of
+  the durations and the slowest calls still held in the ring of the trace.
+
+  @param[in]    Limit         The number of slowest calls to display.
+  @param[in]    VerboseFlag   Print the histograms and the slowest calls.
+
+  @retval EFI_SUCCESS           The operation was successful.
+  @retval EFI_NOT_FOUND         The DXE Core did not trace the boot services.
+  @retval EFI_ABORTED           The user aborts the operation.
+  @retval EFI_OUT_OF_RESOURCES  Memory could not be allocated.
+**/
+EFI_STATUS
+ProcessBootServiceTrace (
+  IN UINTN    Limit,
+  IN BOOLEAN  VerboseFlag
+  )
+{
+  EFI_STATUS                       Status;
+  EDKII_BOOT_SERVICE_TRACE_TABLE   *Table;
+  CONST BOOT_SERVICE_TRACE_IMAGE   *Images;
+  CONST BOOT_SERVICE_TRACE_STATS   *Stats;
+  CONST BOOT_SERVICE_TRACE_STATS   *ServiceStats;
+  UINTN                            ImageIndex;
+  UINTN                            Service;
+  UINTN                            ServiceCount;
+  UINTN                            BucketCount;
+  UINT64                           Duration;
+  BOOLEAN                          NameValid;
+  EFI_STRING                       StringPtr;
+  EFI_STRING                       StringPtrUnknown;
+
+  Status = EfiGetSystemConfigurationTable (&gEdkiiBootServiceTraceTableGuid, (VOID **)&Table);
+  if (EFI_ERROR (Status) || (Table == NULL) || (Table->Revision != EDKII_BOOT_SERVICE_TRACE_TABLE_REVISION)) {
+    ShellPrintHiiDefaultEx (STRING_TOKEN (STR_DP_TRACE_NOT_FOUND), mDpHiiHandle);
+    return EFI_NOT_FOUND;
+  }
+
+  StringPtrUnknown = HiiGetString (mDpHiiHandle, STRING_TOKEN (STR_ALIT_UNKNOWN), NULL);
+  StringPtr        = HiiGetString (mDpHiiHandle, STRING_TOKEN (STR_DP_SECTION_SERVICE_TRACE), NULL);
+  ShellPrintHiiDefaultEx (
+    STRING_TOKEN (STR_DP_SECTION_HEADER),
+    mDpHiiHandle,
+    (StringPtr == NULL) ? StringPtrUnknown : StringPtr
+    );
+  SHELL_FREE_NON_NULL (StringPtr);
+
+  if (StringPtrUnknown == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  if (Table->DroppedImageCount != 0) {
+    ShellPrintHiiDefaultEx (STRING_TOKEN (STR_DP_TRACE_DROPPED), mDpHiiHandle, Table->DroppedImageCount);
+  }
+
+  ShellPrintHiiDefaultEx (STRING_TOKEN (STR_DP_TRACE_SECT_1), mDpHiiHandle);
+  ShellPrintHiiDefaultEx (STRING_TOKEN (STR_DP_TRACE_SECT_2), mDpHiiHandle);
+  ShellPrintHiiDefaultEx (STRING_TOKEN (STR_DP_RAW_DASHES), mDpHiiHandle);
+
+  Images       = (CONST BOOT_SERVICE_TRACE_IMAGE *)(UINTN)Table->Images;
+  Stats        = (CONST BOOT_SERVICE_TRACE_STATS *)(UINTN)Table->Stats;
+  ServiceCount = MIN (Table->ServiceCount, ARRAY_SIZE (mBootServiceNames));
+  BucketCount  = MIN (Table->BucketCount, BOOT_SERVICE_TRACE_BUCKET_COUNT);
+  Status       = EFI_SUCCESS;
+
+  for (ImageIndex = 0; ImageIndex < Table->ImageCount; ImageIndex++) {
+    NameValid = FALSE;
+    for (Service = 0; Service < ServiceCount; Service++) {
+      ServiceStats = &Stats[ImageIndex * Table->ServiceCount + Service];
+      if (ServiceStats->CallCount == 0) {
+        continue;
+      }
+
+      Duration = TraceTicksInMicroSeconds (ServiceStats->TotalTicks, Table->Frequency);
+      if (Duration < mInterestThreshold) {
+        continue;
+      }
+
+      if (!NameValid) {
+        GetTraceImageName (&Images[ImageIndex], StringPtrUnknown);
+        NameValid = TRUE;
+      }
+
+      ShellPrintHiiDefaultEx (
+        STRING_TOKEN (STR_DP_TRACE_STATS),
+        mDpHiiHandle,
+        mGaugeString,
+        mBootServiceNames[Service],
+        ServiceStats->CallCount,
+        Duration,
+        TraceTicksInMicroSeconds (DivU64x64Remainder (ServiceStats->TotalTicks, ServiceStats->CallCount, NULL), Table->Frequency),
+        TraceTicksInMicroSeconds (ServiceStats->MaxTicks, Table->Frequency)
+        );
+
+      if (VerboseFlag) {
+        PrintTraceHistogram (ServiceStats, BucketCount);
+      }
+
+      if (ShellGetExecutionBreakFlag ()) {
+        Status = EFI_ABORTED;
+        break;
+      }
+    }
+
+    if (Status == EFI_ABORTED) {
+      break;
+    }
+  }
+
+  if (VerboseFlag && !EFI_ERROR (Status)) {
+    Status = ProcessSlowestServiceCalls (Table, Limit, StringPtrUnknown);
+  }
+
+  FreePool (StringPtrUnknown);
+  return Status;
+}
+
+/**
+  Print the statistics of the timer event wheel of the DXE Core.
+
+  @retval EFI_SUCCESS           The operation was successful.
+  @retval EFI_NOT_FOUND         The DXE Core did not publish the statistics.
+**/
+EFI_STATUS
+ProcessTimerWheelStatistics (
+  VOID
+  )
+{
+  EFI_STATUS                    Status;
+  EDKII_TIMER_WHEEL_STATISTICS  *Statistics;
+  EFI_STRING                    StringPtr;
+
+  Status = EfiGetSystemConfigurationTable (&gEdkiiTimerWheelStatisticsGuid, (VOID **)&Statistics);
+  if (EFI_ERROR (Status) || (Statistics == NULL) || (Statistics->Revision != EDKII_TIMER_WHEEL_STATISTICS_REVISION)) {
+    ShellPrintHiiDefaultEx (STRING_TOKEN (STR_DP_TIMER_WHEEL_NOT_FOUND), mDpHiiHandle);
+    return EFI_NOT_FOUND;
+  }
+
+  StringPtr = HiiGetString (mDpHiiHandle, STRING_TOKEN (STR_DP_SECTION_TIMER_WHEEL), NULL);
+  ShellPrintHiiDefaultEx (
+    STRING_TOKEN (STR_DP_SECTION_HEADER),
+    mDpHiiHandle,
+    (StringPtr == NULL) ? L"" : StringPtr
+    );
+  SHELL_FREE_NON_NULL (StringPtr);
+
+  ShellPrintHiiDefaultEx (
+    STRING_TOKEN (STR_DP_TIMER_WHEEL_CHECKS),
+    mDpHiiHandle,
+    Statistics->Checks,
+    Statistics->TimersFired,
+    Statistics->MaxTimersFiredPerCheck
+    );
+  ShellPrintHiiDefaultEx (
+    STRING_TOKEN (STR_DP_TIMER_WHEEL_INSERTS),
+    mDpHiiHandle,
+    Statistics->TimersInserted,
+    Statistics->InsertComparisons,
+    (Statistics->TimersInserted == 0) ? 0 : DivU64x64Remainder (Statistics->InsertComparisons, Statistics->TimersInserted, NULL),
+    Statistics->MaxInsertComparisons
+    );
+  ShellPrintHiiDefaultEx (
+    STRING_TOKEN (STR_DP_TIMER_WHEEL_QUEUE),
+    mDpHiiHandle,
+    Statistics->TimersCascaded,
+    Statistics->PendingTimers
+    );
+
+  return EFI_SUCCESS;
+}